@@ -421,3 +421,131 @@ ConfigureCpmemFrameBuffer (
 Exit:
   return Status;
 }
+
+EFI_STATUS
+SetCpmemBufferAddress (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      Buffer,
+  IN  UINT32                      PhyAddr
+  )
+{
+  CPMEM_PARAM *pCpmemChannel;
+  CPMEM_WORD1_PACKED_REG CpmemWord1PackedReg;
+
+  // The IPU fetches from a 8 byte aligned [31:3] address
+  if (((PhyAddr & 0x7) != 0) || (Buffer > 1)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  pCpmemChannel = (CPMEM_PARAM *)DisplayInterfaceContextPtr->CpMemParamBasePtr + Channel;
+
+  // The IDMAC latches the new address at the start of the next frame
+  CopyMem (
+    &CpmemWord1PackedReg,
+    &pCpmemChannel->Word1Pack,
+    sizeof (CpmemWord1PackedReg)
+  );
+  if (Buffer == 0) {
+    CpmemWord1PackedReg.ExtMemBuffer0Address = PhyAddr >> 3;
+  } else {
+    CpmemWord1PackedReg.ExtMemBuffer1Address = PhyAddr >> 3;
+  }
+  CopyMem (
+    &pCpmemChannel->Word1Pack,
+    &CpmemWord1PackedReg,
+    sizeof (pCpmemChannel->Word1Pack)
+  );
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+SetCpmemFrameBufferAddress (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      PhyAddr
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = SetCpmemBufferAddress (
+             DisplayInterfaceContextPtr,
+             Channel,
+             0,
+             PhyAddr
+           );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return SetCpmemBufferAddress (
+           DisplayInterfaceContextPtr,
+           Channel,
+           1,
+           PhyAddr
+         );
+}
+
+VOID
+EnableIdmacDoubleBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel
+  )
+{
+  UINT32 Offset;
+  UINT32 Value;
+
+  if (Channel < 32) {
+    Offset = IPU_IPU_CH_DB_MODE_SEL0_OFFSET;
+  } else {
+    Offset = IPU_IPU_CH_DB_MODE_SEL1_OFFSET;
+  }
+
+  Value = IpuRead32 (DisplayInterfaceContextPtr->IpuMmioBasePtr, Offset);
+  Value |= 1 << (Channel % 32);
+  IpuWrite32 (DisplayInterfaceContextPtr->IpuMmioBasePtr, Offset, Value);
+}
+
+UINT32
+GetIdmacCurrentBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel
+  )
+{
+  UINT32 Offset;
+
+  if (Channel < 32) {
+    Offset = IPU_IPU_CUR_BUF_0_OFFSET;
+  } else {
+    Offset = IPU_IPU_CUR_BUF_1_OFFSET;
+  }
+
+  return (IpuRead32 (DisplayInterfaceContextPtr->IpuMmioBasePtr, Offset) >>
+          (Channel % 32)) & 1;
+}
+
+VOID
+SelectIdmacBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      Buffer
+  )
+{
+  UINT32 Offset;
+
+  // Ready bits are write 1 to set, the IDMAC clears them once it switched
+  if (Buffer == 0) {
+    Offset = (Channel < 32) ? IPU_IPU_CH_BUF0_RDY0_OFFSET :
+                              IPU_IPU_CH_BUF0_RDY1_OFFSET;
+  } else {
+    Offset = (Channel < 32) ? IPU_IPU_CH_BUF1_RDY0_OFFSET :
+                              IPU_IPU_CH_BUF1_RDY1_OFFSET;
+  }
+
+  IpuWrite32 (
+    DisplayInterfaceContextPtr->IpuMmioBasePtr,
+    Offset,
+    1 << (Channel % 32)
+  );
+}
@@ -274,4 +274,38 @@ ConfigureCpmemFrameBuffer (
   IN  SURFACE_INFO                *FrameBufferPtr
   );
 
+EFI_STATUS
+SetCpmemBufferAddress (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      Buffer,
+  IN  UINT32                      PhyAddr
+  );
+
+EFI_STATUS
+SetCpmemFrameBufferAddress (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      PhyAddr
+  );
+
+VOID
+EnableIdmacDoubleBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel
+  );
+
+UINT32
+GetIdmacCurrentBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel
+  );
+
+VOID
+SelectIdmacBuffer (
+  IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
+  IN  UINT32                      Channel,
+  IN  UINT32                      Buffer
+  );
+
 #endif  /* _CPMEM_H_ */
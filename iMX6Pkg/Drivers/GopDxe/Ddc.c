@@ -48,6 +48,7 @@ Imx6DdcRead (
     Status = HdmiDdcRead (
                &DisplayContextPtr->DiContext[HdmiDisplay],
                SlaveAddress,
+               0,
                RegisterAddress,
                ReadSize,
                HDMI_DDC_STANDARD_MODE,
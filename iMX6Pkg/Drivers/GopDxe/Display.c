@@ -16,7 +16,9 @@
 #include <Uefi.h>
 
 #include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
 #include <Library/DebugLib.h>
+#include <Library/DxeServicesTableLib.h>
 #include <Library/IoLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -116,6 +118,124 @@ GetPreferredTiming (
   return Status;
 }
 
+/**
+  Build the list of timings a display interface can be set to.
+
+  The preferred timing is always the first entry. The other timings the
+  EDID advertises follow, without duplicates and without those faster than
+  DISPLAY_MAX_PIXEL_CLOCK.
+
+  @param[in, out] DisplayInterfaceContextPtr  Display interface with its
+                                              EDID and preferred timing.
+
+  @retval EFI_SUCCESS   ModeList holds at least the preferred timing.
+
+**/
+EFI_STATUS
+GetDisplayModes (
+  IN OUT  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr
+  )
+{
+  UINT32              EdidModeCount;
+  UINT32              Index;
+  IMX_DISPLAY_TIMING  *pMode;
+  UINT32              ModeCount;
+  UINT32              Previous;
+  EFI_STATUS          Status;
+
+  DisplayInterfaceContextPtr->ModeList[0] =
+    DisplayInterfaceContextPtr->PreferredTiming;
+  ModeCount = 1;
+
+  // Panels without EDID only offer their preferred timing
+  EdidModeCount = 0;
+  if (DisplayInterfaceContextPtr->EdidDataSize >= IMX_EDID_MIN_SIZE) {
+    Status = ImxGetEdidModes (
+               DisplayInterfaceContextPtr->EdidData,
+               DisplayInterfaceContextPtr->EdidDataSize,
+               &DisplayInterfaceContextPtr->ModeList[1],
+               DISPLAY_MAX_MODES - 1,
+               &EdidModeCount
+             );
+    if (Status != EFI_SUCCESS) {
+      EdidModeCount = 0;
+    }
+  }
+
+  for (Index = 1; Index <= EdidModeCount; Index++) {
+    pMode = &DisplayInterfaceContextPtr->ModeList[Index];
+    if (pMode->PixelClock > DISPLAY_MAX_PIXEL_CLOCK) {
+      continue;
+    }
+
+    for (Previous = 0; Previous < ModeCount; Previous++) {
+      if ((DisplayInterfaceContextPtr->ModeList[Previous].HActive == pMode->HActive) &&
+          (DisplayInterfaceContextPtr->ModeList[Previous].VActive == pMode->VActive) &&
+          (DisplayInterfaceContextPtr->ModeList[Previous].PixelClock == pMode->PixelClock)) {
+        break;
+      }
+    }
+    if (Previous < ModeCount) {
+      continue;
+    }
+
+    // Same restrictions as the preferred timing
+    pMode->PixelRepetition = 1;
+    pMode->PixelFormat = PIXEL_FORMAT_BGRA32;
+    pMode->Bpp = 32;
+    DisplayInterfaceContextPtr->ModeList[ModeCount] = *pMode;
+    ModeCount++;
+  }
+
+  DisplayInterfaceContextPtr->ModeCount = ModeCount;
+  DEBUG ((DEBUG_INFO, "%a: %d modes\n", __FUNCTION__, ModeCount));
+  return EFI_SUCCESS;
+}
+
+/**
+  Warn if a mirrored display does not advertise the timing it is driven with.
+
+  Most monitors still accept the common panel timings, so this is not fatal.
+
+  @param[in]  MirrorContextPtr  Mirrored display interface.
+  @param[in]  TimingPtr         Timing of the display being mirrored.
+
+**/
+STATIC
+VOID
+CheckMirrorTiming (
+  IN  DISPLAY_INTERFACE_CONTEXT   *MirrorContextPtr,
+  IN  IMX_DISPLAY_TIMING          *TimingPtr
+  )
+{
+  UINT32              Index;
+  UINT32              ModeCount;
+  IMX_DISPLAY_TIMING  ModeList[DISPLAY_MAX_MODES];
+  EFI_STATUS          Status;
+
+  // Without EDID there is nothing to check against
+  Status = ImxGetEdidModes (
+             MirrorContextPtr->EdidData,
+             MirrorContextPtr->EdidDataSize,
+             ModeList,
+             DISPLAY_MAX_MODES,
+             &ModeCount
+           );
+  if (Status != EFI_SUCCESS) {
+    return;
+  }
+
+  for (Index = 0; Index < ModeCount; Index++) {
+    if ((ModeList[Index].HActive == TimingPtr->HActive) &&
+        (ModeList[Index].VActive == TimingPtr->VActive)) {
+      return;
+    }
+  }
+
+  DEBUG ((DEBUG_WARN, "%a: Mirrored display does not list %dx%d\n",
+    __FUNCTION__, TimingPtr->HActive, TimingPtr->VActive));
+}
+
 EFI_STATUS
 InitDisplay (
   IN  DISPLAY_CONTEXT   **DisplayConfigPPtr
@@ -160,12 +280,28 @@ InitDisplay (
       DisplayCounter;
   }
 
+  pTempDisplayContext->MirrorDisplay = NoDisplayType;
   if (FeaturePcdGet (PcdLvdsEnable)) {
     Status = InitLvds (pTempDisplayContext);
     if (Status != EFI_SUCCESS) {
       DEBUG ((DEBUG_ERROR, "%a: Fail to intialize LVDS\n", __FUNCTION__));
       goto Exit;
     }
+
+    // The panel keeps working if the HDMI side cannot be set up
+    if (FeaturePcdGet (PcdLvdsHdmiMirror)) {
+      Status = InitHdmi (pTempDisplayContext);
+      if (Status == EFI_SUCCESS) {
+        pTempDisplayContext->MirrorDisplay = HdmiDisplay;
+        CheckMirrorTiming (
+          &pTempDisplayContext->DiContext[HdmiDisplay],
+          &pTempDisplayContext->DiContext[Lvds0Display].PreferredTiming
+        );
+      } else {
+        DEBUG ((DEBUG_WARN, "%a: Fail to intialize HDMI mirror\n", __FUNCTION__));
+        Status = EFI_SUCCESS;
+      }
+    }
   } else {
     Status = InitHdmi (pTempDisplayContext);
     if (Status != EFI_SUCCESS) {
@@ -202,6 +338,13 @@ ValidateDisplayConfig (
     goto Exit;
   }
 
+  // A mirror shares the DI of the only display
+  if ((DisplayContextPtr->MirrorDisplay != NoDisplayType) &&
+      (DisplayMode != SINGLE_MODE)) {
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
   // Currently going to a very simplistic approach of enabling HDMI/LVDS single
   // display on HDMI/LVDS port. This configuration is applied regardless if
   // there is a monitor connected. No hot plug, monitor detection support.
@@ -279,6 +422,46 @@ Exit:
   return Status;
 }
 
+/**
+  Program the output specific part of a timing, after its DI is configured.
+
+  @param[in]  DisplayContextPtr   Display context.
+  @param[in]  DisplayInterface    Output to program.
+  @param[in]  TimingPtr           Timing of the DI feeding the output.
+
+  @retval EFI_SUCCESS       The output was programmed.
+  @retval EFI_UNSUPPORTED   The output type is not supported.
+
+**/
+STATIC
+EFI_STATUS
+SetDisplayTiming (
+  IN  DISPLAY_CONTEXT         *DisplayContextPtr,
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface,
+  IN  IMX_DISPLAY_TIMING      *TimingPtr
+  )
+{
+  EFI_STATUS  Status;
+
+  switch (DisplayInterface) {
+  case HdmiDisplay:
+    Status = SetHdmiDisplay (&DisplayContextPtr->DiContext[HdmiDisplay], TimingPtr);
+    if (Status != EFI_SUCCESS) {
+      DEBUG ((DEBUG_ERROR, "%a: Fail to set HDMI timing\n", __FUNCTION__));
+    }
+    break;
+  case Lvds0Display:
+  case Lvds1Display:
+    Status = EFI_SUCCESS;
+    break;
+  default:
+    Status = EFI_UNSUPPORTED;
+    break;
+  }
+
+  return Status;
+}
+
 EFI_STATUS
 ApplyDisplayConfig (
   IN OUT  DISPLAY_CONTEXT     *DisplayContextPtr,
@@ -342,25 +525,28 @@ ApplyDisplayConfig (
       goto Exit;
     }
 
-    switch (CurrentDisplayInterface) {
-    case HdmiDisplay:
-      Status = SetHdmiDisplay (pDisplayInterfaceContext, pCurrentDisplayTiming);
-      if (Status != EFI_SUCCESS) {
-        DEBUG ((DEBUG_ERROR, "%a: Fail to set HDMI timing\n", __FUNCTION__));
-        goto Exit;
-      }
-      break;
-    case Lvds0Display:
-    case Lvds1Display:
-      break;
-    default:
-      Status = EFI_UNSUPPORTED;
-      break;
-    }
+    Status = SetDisplayTiming (
+               DisplayContextPtr,
+               CurrentDisplayInterface,
+               pCurrentDisplayTiming
+             );
     if (EFI_ERROR (Status)) {
       goto Exit;
     }
 
+    if ((DisplayModeIndex == 0) &&
+        (DisplayContextPtr->MirrorDisplay != NoDisplayType)) {
+      Status = SetDisplayTiming (
+                 DisplayContextPtr,
+                 DisplayContextPtr->MirrorDisplay,
+                 pCurrentDisplayTiming
+               );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: Fail to set mirror timing\n", __FUNCTION__));
+        goto Exit;
+      }
+    }
+
     Status = ConfigureFrameBuffer (
                pDisplayInterfaceContext,
                &pDisplayConfig->DisplaySurface[DisplayModeIndex]
@@ -377,12 +563,93 @@ Exit:
   return Status;
 }
 
+/**
+  Free the display memory allocated for a surface.
+
+  The fixed display memory at PcdFrameBufferBase is left alone. The IPU
+  must no longer scan out of the memory.
+
+  @param[in, out]  SurfaceInfoPtr   Surface to release the memory of.
+
+**/
+VOID
+FreeFrameBuffer (
+  IN OUT  SURFACE_INFO  *SurfaceInfoPtr
+  )
+{
+  if ((FixedPcdGet32 (PcdFrameBufferBase) != 0) ||
+      (SurfaceInfoPtr->PhyAddr == 0)) {
+    return;
+  }
+
+  if (!FeaturePcdGet (PcdFrameBufferCacheable)) {
+    gDS->SetMemorySpaceAttributes (
+           SurfaceInfoPtr->PhyAddr,
+           SurfaceInfoPtr->Size,
+           EFI_MEMORY_WB
+         );
+  }
+  gBS->FreePages (
+         SurfaceInfoPtr->PhyAddr,
+         EFI_SIZE_TO_PAGES (SurfaceInfoPtr->Size)
+       );
+  SurfaceInfoPtr->PhyAddr = 0;
+  SurfaceInfoPtr->VirtAddrPtr = NULL;
+  SurfaceInfoPtr->Size = 0;
+}
+
+/**
+  Get the pitch of the frame buffer lines for a surface width.
+
+  Lines of allocated display memory are padded to the IDMAC burst. The
+  fixed display memory at PcdFrameBufferBase keeps unpadded lines, as its
+  layout may be shared with the boot loader and sized for it.
+
+  @param[in]  Width   Surface width in pixels.
+
+  @retval The pitch in pixels.
+
+**/
+UINT32
+GetFrameBufferPitch (
+  IN  UINT32  Width
+  )
+{
+  if (FixedPcdGet32 (PcdFrameBufferBase) != 0) {
+    return Width;
+  }
+
+  return ALIGN_VALUE (Width, FRAME_BUFFER_PITCH_ALIGNMENT);
+}
+
+/**
+  Set up the display memory of a surface.
+
+  Unless the platform fixes the display memory with PcdFrameBufferBase,
+  reserved pages holding FRAME_BUFFER_SCREEN_COUNT screens of padded lines
+  are allocated below 4GB. The memory of the previous mode is left to the
+  caller, the IPU scans out of it until the display is reprogrammed.
+
+  @param[in, out]  SurfaceInfoPtr   Surface with Width, Height and Bpp set.
+
+  @retval EFI_SUCCESS               PhyAddr, Size and Pitch are set.
+  @retval EFI_INVALID_PARAMETER     The surface is empty.
+  @retval EFI_BUFFER_TOO_SMALL      The surface does not fit the fixed
+                                    display memory.
+  @retval Others                    The display memory could not be
+                                    allocated.
+
+**/
 EFI_STATUS
 AllocateFrameBuffer (
   IN OUT  SURFACE_INFO  *SurfaceInfoPtr
   )
 {
-  EFI_STATUS  Status;
+  EFI_PHYSICAL_ADDRESS  Buffer;
+  UINT32                BufferSize;
+  UINT32                Pitch;
+  UINT32                ScreenSize;
+  EFI_STATUS            Status;
 
   DEBUG ((DEBUG_INFO, "%a: Enter\n", __FUNCTION__));
   if ((SurfaceInfoPtr->Width == 0) || (SurfaceInfoPtr->Height == 0)) {
@@ -390,18 +657,57 @@ AllocateFrameBuffer (
     goto Exit;
   }
 
-  DEBUG ((DEBUG_INFO, "%a: Frame Buffer AddrP=%Xh\n",
-    __FUNCTION__, FixedPcdGet32 (PcdFrameBufferBase)));
-  DEBUG ((DEBUG_INFO, "%a: Frame Buffer Size=%Xh\n",
-    __FUNCTION__, FixedPcdGet32 (PcdFrameBufferSize)));
+  Pitch = GetFrameBufferPitch (SurfaceInfoPtr->Width);
+  ScreenSize = Pitch * SurfaceInfoPtr->Height * (SurfaceInfoPtr->Bpp / 8);
+  if (FixedPcdGet32 (PcdFrameBufferBase) != 0) {
+    Buffer = FixedPcdGet32 (PcdFrameBufferBase);
+    BufferSize = FixedPcdGet32 (PcdFrameBufferSize);
+    if (ScreenSize > BufferSize) {
+      Status = EFI_BUFFER_TOO_SMALL;
+      goto Exit;
+    }
+  } else {
+    BufferSize = EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (ScreenSize)) *
+                   FRAME_BUFFER_SCREEN_COUNT;
+
+    // The IDMAC takes 32-bit addresses. Reserved so the OS keeps scanning
+    // out of it after ExitBootServices.
+    Buffer = MAX_UINT32;
+    Status = gBS->AllocatePages (
+                    AllocateMaxAddress,
+                    EfiReservedMemoryType,
+                    EFI_SIZE_TO_PAGES (BufferSize),
+                    &Buffer
+                  );
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    // Pages come from write-back system memory. Drop their cache lines
+    // before remapping them write-combining, like the fixed display memory.
+    if (!FeaturePcdGet (PcdFrameBufferCacheable)) {
+      WriteBackInvalidateDataCacheRange ((VOID *)(UINTN)Buffer, BufferSize);
+      Status = gDS->SetMemorySpaceAttributes (
+                      Buffer,
+                      BufferSize,
+                      EFI_MEMORY_WC
+                    );
+      if (EFI_ERROR (Status)) {
+        gBS->FreePages (Buffer, EFI_SIZE_TO_PAGES (BufferSize));
+        goto Exit;
+      }
+    }
+  }
 
-  SurfaceInfoPtr->VirtAddrPtr = (VOID *)(UINTN)FixedPcdGet32 (PcdFrameBufferBase);
-  SurfaceInfoPtr->PhyAddr = (UINT32)(SurfaceInfoPtr->VirtAddrPtr);
-  SurfaceInfoPtr->Pitch = SurfaceInfoPtr->Width;
+  SurfaceInfoPtr->PhyAddr = (UINT32)Buffer;
+  SurfaceInfoPtr->VirtAddrPtr = (VOID *)(UINTN)Buffer;
+  SurfaceInfoPtr->Size = BufferSize;
+  SurfaceInfoPtr->Pitch = Pitch;
 
   DEBUG ((DEBUG_INFO,
-    "%a: Allocate FB PhyAddr %x VirtAddr %x\n",
-    __FUNCTION__, SurfaceInfoPtr->PhyAddr, SurfaceInfoPtr->VirtAddrPtr));
+    "%a: Allocate FB PhyAddr %x Size %x Pitch %d\n",
+    __FUNCTION__, SurfaceInfoPtr->PhyAddr, SurfaceInfoPtr->Size,
+    SurfaceInfoPtr->Pitch));
 
   Status = EFI_SUCCESS;
 
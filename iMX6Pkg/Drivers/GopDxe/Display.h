@@ -16,6 +16,20 @@
 #ifndef _DISPLAY_H_
 #define _DISPLAY_H_
 
+// Most timings kept for a display interface
+#define DISPLAY_MAX_MODES           16
+
+// Fastest pixel clock offered beside the preferred timing, 1080p60
+#define DISPLAY_MAX_PIXEL_CLOCK     148500000
+
+// Allocated frame buffer lines are padded to the IDMAC burst of 16 BGRA32
+// pixels
+#define FRAME_BUFFER_PITCH_ALIGNMENT  16
+
+// Screens held by an allocated frame buffer, the second one is used to
+// page flip or scroll
+#define FRAME_BUFFER_SCREEN_COUNT     2
+
 typedef enum {
   UNKNOWN_MODE,
   SINGLE_MODE,
@@ -47,6 +61,7 @@ typedef enum {
 
 typedef struct _SURFACE_INFO {
   UINT32 PhyAddr;
+  UINT32 Size;
   UINT32 *VirtAddrPtr;
   UINT32 Width;
   UINT32 Height;
@@ -104,6 +119,8 @@ typedef struct _DISPLAY_INTERFACE_CONTEXT {
   UINT32 EdidDataSize;
   UINT8 EdidData[256];
   IMX_DISPLAY_TIMING PreferredTiming;
+  UINT32 ModeCount;
+  IMX_DISPLAY_TIMING ModeList[DISPLAY_MAX_MODES];
 } DISPLAY_INTERFACE_CONTEXT, *PDISPLAY_INTERFACE_CONTEXT;
 
 typedef struct _DISPLAY_CONFIG {
@@ -119,6 +136,8 @@ typedef struct _DISPLAY_CONTEXT {
   VOID *IoMuxMmioBasePtr;
   VOID *IpuMmioBasePtr[IPU_TOTAL];
   DISPLAY_INTERFACE_CONTEXT DiContext[DisplayTypeMax];
+  // Output fed by the same DI as DiOrder[0], NoDisplayType if none
+  DISPLAY_INTERFACE_TYPE MirrorDisplay;
 } DISPLAY_CONTEXT, *PDISPLAY_CONTEXT;
 
 extern IMX_DISPLAY_TIMING DefaultTiming;
@@ -130,6 +149,11 @@ GetPreferredTiming (
   IN  IMX_DISPLAY_TIMING  *PreferredTimingPtr
   );
 
+EFI_STATUS
+GetDisplayModes (
+  IN OUT  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr
+  );
+
 EFI_STATUS
 InitDisplay (
   IN  DISPLAY_CONTEXT   **DisplayConfigPPtr
@@ -156,11 +180,21 @@ ApplyDisplayConfig (
   IN      DISPLAY_INTERFACE_TYPE   *DiOrder
   );
 
+UINT32
+GetFrameBufferPitch (
+  IN  UINT32  Width
+  );
+
 EFI_STATUS
 AllocateFrameBuffer (
   IN OUT  SURFACE_INFO  *SurfaceInfoPtr
   );
 
+VOID
+FreeFrameBuffer (
+  IN OUT  SURFACE_INFO  *SurfaceInfoPtr
+  );
+
 EFI_STATUS
 ConfigureFrameBuffer (
   IN  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr,
@@ -14,11 +14,17 @@
 
 #include <Uefi.h>
 
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include <Protocol/VariableWrite.h>
 
 #include <iMX6.h>
 #include <iMX6ClkPwr.h>
@@ -28,6 +34,35 @@
 #include "Edid.h"
 #include "Ddc.h"
 
+// The header and the manufacturer, product and serial number identify the
+// display, refer to 3.3 and 3.4 VESA EDID spec
+#define EDID_IDENTITY_SIZE    0x12
+
+// Offset of the checksum within an EDID block
+#define EDID_CHECKSUM_OFFSET  (IMX_EDID_BLOCK_SIZE - 1)
+
+#define EDID_CACHE_VARIABLE_ATTRIBUTES  (EFI_VARIABLE_NON_VOLATILE | \
+                                         EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+// Validated EDID. The timings are derived again from it on every boot so
+// they follow changes to the EDID parsing.
+typedef struct _EDID_CACHE {
+  UINT32 EdidDataSize;
+  UINT8 EdidData[IMX_EDID_MAX_SIZE];
+} EDID_CACHE;
+
+STATIC CHAR16 *EdidCacheVariableName[DisplayTypeMax] = {
+  L"HdmiEdidCache",
+  L"MipiEdidCache",
+  L"Lvds0EdidCache",
+  L"Lvds1EdidCache",
+};
+
+// Cache entries waiting for the variable write service
+STATIC EDID_CACHE *PendingEdidCache[DisplayTypeMax];
+STATIC EFI_EVENT VariableWriteEvent;
+STATIC VOID *VariableWriteRegistration;
+
 EFI_STATUS
 ReadEdid (
   IN  DISPLAY_CONTEXT     *DisplayContextPtr,
@@ -36,8 +71,11 @@ ReadEdid (
   OUT UINT32              *EdidDataSizePtr
   )
 {
+  EFI_STATUS  ExtensionStatus;
+  UINT64      StartTime;
   EFI_STATUS  Status;
 
+  StartTime = GetPerformanceCounter ();
   Status = Imx6DdcRead (
              DisplayContextPtr,
              DisplayInterface,
@@ -58,10 +96,32 @@ ReadEdid (
     goto Exit;
   }
 
-  DEBUG ((DEBUG_INFO, "%a: EDID initialized\n", __FUNCTION__));
-
   *EdidDataSizePtr = IMX_EDID_MIN_SIZE;
 
+  // A corrupt extension block still leaves the base block usable
+  if (ImxGetEdidSize (EdidDataPtr) > IMX_EDID_BLOCK_SIZE) {
+    ExtensionStatus = Imx6DdcRead (
+                        DisplayContextPtr,
+                        DisplayInterface,
+                        IMX_EDID_I2C_ADDRESS,
+                        IMX_EDID_BLOCK_SIZE,
+                        IMX_EDID_BLOCK_SIZE,
+                        &EdidDataPtr[IMX_EDID_BLOCK_SIZE]
+                      );
+    if (ExtensionStatus == EFI_SUCCESS) {
+      ExtensionStatus = ImxValidateEdidBlock (&EdidDataPtr[IMX_EDID_BLOCK_SIZE]);
+    }
+    if (ExtensionStatus == EFI_SUCCESS) {
+      *EdidDataSizePtr = ImxGetEdidSize (EdidDataPtr);
+    } else {
+      DEBUG ((DEBUG_WARN, "%a: Ignoring EDID extension block\n", __FUNCTION__));
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: EDID initialized, %d bytes in %ld us\n",
+    __FUNCTION__, *EdidDataSizePtr,
+    DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTime), 1000)));
+
 Exit:
   return Status;
 }
@@ -73,24 +133,303 @@ GetEdidPreferredTiming (
   OUT IMX_DISPLAY_TIMING  *PreferredTiming
   )
 {
-  IMX_DETAILED_TIMING_DESCRIPTOR  *pEdidPreferredTiming;
-  EFI_STATUS                      Status;
+  UINT32      ModeCount;
+  EFI_STATUS  Status;
 
-  if (EdidDataSizePtr < IMX_EDID_MIN_SIZE) {
-    DEBUG ((DEBUG_WARN, "%a: Insufficient EDID data\n", __FUNCTION__));
-    Status = EFI_INVALID_PARAMETER;
+  // The best ranked timing, which is not always in the base block
+  Status = ImxGetEdidModes (EdidDataPtr, EdidDataSizePtr, PreferredTiming, 1, &ModeCount);
+  if (Status != EFI_SUCCESS) {
     goto Exit;
   }
 
-  pEdidPreferredTiming = (IMX_DETAILED_TIMING_DESCRIPTOR *)&EdidDataPtr[IMX_EDID_DTD_1_OFFSET];
-  Status = ImxConvertDTDToDisplayTiming (pEdidPreferredTiming, PreferredTiming);
-  if (Status != EFI_SUCCESS) {
+  if (ModeCount == 0) {
     DEBUG ((DEBUG_ERROR, "%a: Conversion to display timing failed\n",
       __FUNCTION__));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+Exit:
+
+  return Status;
+}
+
+/**
+  Restore the EDID of a display from the EDID cache.
+
+  The cache is only used if the attached display reports the same identity
+  and the same checksum for every block, which takes a few bytes of DDC
+  traffic instead of the whole EDID.
+
+  GopDxe does not wait for the variable services, the cache reads as empty
+  when they are not available yet.
+
+  @param[in]  DisplayContextPtr   Display context.
+  @param[in]  DisplayInterface    Display interface to restore.
+
+  @retval EFI_SUCCESS     EdidData and EdidDataSize of the display interface
+                          were restored.
+  @retval EFI_NOT_FOUND   The cache is empty, unavailable or holds another
+                          display.
+  @retval Others          The display could not be read.
+
+**/
+EFI_STATUS
+ReadCachedEdid (
+  IN  DISPLAY_CONTEXT         *DisplayContextPtr,
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface
+  )
+{
+  EDID_CACHE                  *pCache;
+  UINT8                       Checksum;
+  DISPLAY_INTERFACE_CONTEXT   *pDisplayInterfaceContext;
+  UINT8                       Identity[EDID_IDENTITY_SIZE];
+  UINT32                      Offset;
+  UINTN                       Size;
+  EFI_STATUS                  Status;
+
+  pDisplayInterfaceContext = &DisplayContextPtr->DiContext[DisplayInterface];
+  pCache = AllocatePool (sizeof (*pCache));
+  if (pCache == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Size = sizeof (*pCache);
+  Status = gRT->GetVariable (
+                  EdidCacheVariableName[DisplayInterface],
+                  &giMX6GopEdidCacheGuid,
+                  NULL,
+                  &Size,
+                  pCache
+                );
+  if ((Status != EFI_SUCCESS) || (Size != sizeof (*pCache))) {
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  // Drop a cache entry that was corrupted or written by another layout
+  if ((pCache->EdidDataSize < IMX_EDID_MIN_SIZE) ||
+      ((pCache->EdidDataSize % IMX_EDID_BLOCK_SIZE) != 0) ||
+      (pCache->EdidDataSize > ImxGetEdidSize (pCache->EdidData)) ||
+      (ImxValidateEdidData (pCache->EdidData) != EFI_SUCCESS)) {
+    DEBUG ((DEBUG_WARN, "%a: Invalid EDID cache\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  Status = Imx6DdcRead (
+             DisplayContextPtr,
+             DisplayInterface,
+             IMX_EDID_I2C_ADDRESS,
+             0,
+             sizeof (Identity),
+             Identity
+           );
+  if (Status != EFI_SUCCESS) {
+    goto Exit;
+  }
+
+  if (CompareMem (Identity, pCache->EdidData, sizeof (Identity)) != 0) {
+    DEBUG ((DEBUG_INFO, "%a: Display changed\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
     goto Exit;
   }
 
+  for (Offset = EDID_CHECKSUM_OFFSET;
+       Offset < pCache->EdidDataSize;
+       Offset += IMX_EDID_BLOCK_SIZE) {
+    Status = Imx6DdcRead (
+               DisplayContextPtr,
+               DisplayInterface,
+               IMX_EDID_I2C_ADDRESS,
+               (UINT8)Offset,
+               sizeof (Checksum),
+               &Checksum
+             );
+    if (Status != EFI_SUCCESS) {
+      goto Exit;
+    }
+
+    if (Checksum != pCache->EdidData[Offset]) {
+      DEBUG ((DEBUG_INFO, "%a: EDID changed\n", __FUNCTION__));
+      Status = EFI_NOT_FOUND;
+      goto Exit;
+    }
+  }
+
+  CopyMem (
+    pDisplayInterfaceContext->EdidData,
+    pCache->EdidData,
+    pCache->EdidDataSize
+  );
+  pDisplayInterfaceContext->EdidDataSize = pCache->EdidDataSize;
+  DEBUG ((DEBUG_INFO, "%a: EDID restored from cache\n", __FUNCTION__));
+
 Exit:
+  if (pCache != NULL) {
+    FreePool (pCache);
+  }
+
+  return Status;
+}
+
+/**
+  Write a cache entry to its variable.
+
+  @param[in]  DisplayInterface    Display interface of the entry.
+  @param[in]  CachePtr            Cache entry.
+
+  @retval EFI_SUCCESS   The variable was written.
+  @retval Others        The variable could not be written.
+
+**/
+STATIC
+EFI_STATUS
+SetEdidCacheVariable (
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface,
+  IN  EDID_CACHE              *CachePtr
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gRT->SetVariable (
+                  EdidCacheVariableName[DisplayInterface],
+                  &giMX6GopEdidCacheGuid,
+                  EDID_CACHE_VARIABLE_ATTRIBUTES,
+                  sizeof (*CachePtr),
+                  CachePtr
+                );
+  if (Status != EFI_SUCCESS) {
+    DEBUG ((DEBUG_WARN, "%a: Fail to write EDID cache %r\n", __FUNCTION__,
+      Status));
+  }
+
+  return Status;
+}
+
+/**
+  Write the cache entries that were waiting for the variable write service.
+
+  @param[in]  Event     Variable write protocol notification event.
+  @param[in]  Context   Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+VariableWriteNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  UINT32      DisplayInterface;
+  VOID        *Interface;
+  EFI_STATUS  Status;
+
+  Status = gBS->LocateProtocol (
+                  &gEfiVariableWriteArchProtocolGuid,
+                  NULL,
+                  &Interface
+                );
+  if (Status != EFI_SUCCESS) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+  VariableWriteEvent = NULL;
+
+  for (DisplayInterface = 0; DisplayInterface < DisplayTypeMax; DisplayInterface++) {
+    if (PendingEdidCache[DisplayInterface] != NULL) {
+      SetEdidCacheVariable (
+        (DISPLAY_INTERFACE_TYPE)DisplayInterface,
+        PendingEdidCache[DisplayInterface]
+      );
+      FreePool (PendingEdidCache[DisplayInterface]);
+      PendingEdidCache[DisplayInterface] = NULL;
+    }
+  }
+}
+
+/**
+  Store the EDID of a display in the EDID cache.
+
+  GopDxe does not wait for the variable services. If the variable write
+  service is not available yet, the entry is written once it is installed.
+
+  @param[in]  DisplayContextPtr   Display context.
+  @param[in]  DisplayInterface    Display interface whose EDID was read and
+                                  validated.
+
+  @retval EFI_SUCCESS   The cache was updated or will be once the variable
+                        write service is available.
+  @retval Others        The cache could not be updated.
+
+**/
+EFI_STATUS
+WriteEdidCache (
+  IN  DISPLAY_CONTEXT         *DisplayContextPtr,
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface
+  )
+{
+  EDID_CACHE                  *pCache;
+  DISPLAY_INTERFACE_CONTEXT   *pDisplayInterfaceContext;
+  VOID                        *Interface;
+  EFI_STATUS                  Status;
+
+  pDisplayInterfaceContext = &DisplayContextPtr->DiContext[DisplayInterface];
+  pCache = AllocateZeroPool (sizeof (*pCache));
+  if (pCache == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  pCache->EdidDataSize = pDisplayInterfaceContext->EdidDataSize;
+  CopyMem (
+    pCache->EdidData,
+    pDisplayInterfaceContext->EdidData,
+    pDisplayInterfaceContext->EdidDataSize
+  );
+
+  Status = gBS->LocateProtocol (
+                  &gEfiVariableWriteArchProtocolGuid,
+                  NULL,
+                  &Interface
+                );
+  if (Status == EFI_SUCCESS) {
+    Status = SetEdidCacheVariable (DisplayInterface, pCache);
+    goto Exit;
+  }
+
+  if (VariableWriteEvent == NULL) {
+    VariableWriteEvent = EfiCreateProtocolNotifyEvent (
+                           &gEfiVariableWriteArchProtocolGuid,
+                           TPL_CALLBACK,
+                           VariableWriteNotify,
+                           NULL,
+                           &VariableWriteRegistration
+                         );
+    if (VariableWriteEvent == NULL) {
+      DEBUG ((DEBUG_WARN, "%a: Fail to wait for variable write service\n",
+        __FUNCTION__));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+  }
+
+  if (PendingEdidCache[DisplayInterface] != NULL) {
+    FreePool (PendingEdidCache[DisplayInterface]);
+  }
+  PendingEdidCache[DisplayInterface] = pCache;
+  pCache = NULL;
+  Status = EFI_SUCCESS;
+  DEBUG ((DEBUG_INFO, "%a: EDID cache written once variables are available\n",
+    __FUNCTION__));
+
+Exit:
+  if (pCache != NULL) {
+    FreePool (pCache);
+  }
 
   return Status;
 }
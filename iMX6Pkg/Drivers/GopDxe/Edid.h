@@ -30,4 +30,16 @@ GetEdidPreferredTiming (
   OUT IMX_DISPLAY_TIMING  *PreferredTiming
   );
 
+EFI_STATUS
+ReadCachedEdid (
+  IN  DISPLAY_CONTEXT         *DisplayContextPtr,
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface
+  );
+
+EFI_STATUS
+WriteEdidCache (
+  IN  DISPLAY_CONTEXT         *DisplayContextPtr,
+  IN  DISPLAY_INTERFACE_TYPE  DisplayInterface
+  );
+
 #endif  /* _EDID_H_ */
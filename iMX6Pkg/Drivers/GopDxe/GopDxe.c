@@ -20,6 +20,7 @@
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
 #include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 #include <Protocol/EmbeddedExternalDevice.h>
@@ -32,15 +33,16 @@
 
 #include <iMX6.h>
 #include <iMX6ClkPwr.h>
+#include <iMXBltLib.h>
 #include <iMXDisplay.h>
+#include <iMXDisplayPageFlip.h>
 
 #include "Display.h"
+#include "CPMem.h"
 #include "GopDxe.h"
 #include "Hdmi.h"
 #include "Lvds.h"
 
-#define PIXEL_BYTES 4
-
 typedef struct {
   VENDOR_DEVICE_PATH Mmc;
   EFI_DEVICE_PATH End;
@@ -96,6 +98,31 @@ VidGopBlt (
   IN UINTN                              Delta
   );
 
+EFI_STATUS
+EFIAPI
+VidGopPageFlipBlt (
+  IN IMX_DISPLAY_PAGE_FLIP_PROTOCOL     *This,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer,
+  IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN UINTN                              SourceX,
+  IN UINTN                              SourceY,
+  IN UINTN                              DestinationX,
+  IN UINTN                              DestinationY,
+  IN UINTN                              Width,
+  IN UINTN                              Height,
+  IN UINTN                              Delta
+  );
+
+EFI_STATUS
+EFIAPI
+VidGopPageFlipPresent (
+  IN IMX_DISPLAY_PAGE_FLIP_PROTOCOL   *This
+  );
+
+// Longest wait for the IDMAC to pick up a flipped buffer, a few frames
+#define VID_GOP_PAGE_FLIP_TIMEOUT_US    100000
+#define VID_GOP_PAGE_FLIP_POLL_US       100
+
 STATIC VID_DEVICE_PATH VidDevicePath = {
   {
     {
@@ -147,109 +174,329 @@ DISPLAY_CONTEXT *DisplayContextPtr;
 
 DISPLAY_INTERFACE_TYPE DisplayDevice;
 
-EFI_STATUS
-GopDxeInitialize (
-  IN EFI_HANDLE         ImageHandle,
-  IN EFI_SYSTEM_TABLE   *SystemTable
+// Display timings exposed as GOP modes
+STATIC IMX_DISPLAY_TIMING VidGopTimings[DISPLAY_MAX_MODES];
+
+STATIC IMX_BLT_CONTEXT VidGopBltContext;
+
+// Off-screen surface for IMX_DISPLAY_PAGE_FLIP_PROTOCOL
+STATIC IMX_BLT_CONTEXT VidGopBackBltContext;
+STATIC BOOLEAN VidGopPageFlipAvailable;
+STATIC BOOLEAN VidGopDoubleBufferEnabled;
+
+STATIC IMX_DISPLAY_PAGE_FLIP_PROTOCOL VidGopPageFlip = {
+  VidGopPageFlipBlt,      // Blt
+  VidGopPageFlipPresent   // Present
+};
+
+/**
+  Point the primary display plane at a line of the frame buffer.
+
+  @param[in]  Context   Unused.
+  @param[in]  Offset    Offset of the first visible line in bytes.
+
+**/
+STATIC
+VOID
+EFIAPI
+VidGopSetScanout (
+  IN  VOID    *Context,
+  IN  UINTN   Offset
   )
 {
-  DISPLAY_INTERFACE_TYPE  DisplayInterfaceOrder[DisplayTypeMax];
-  UINT32                  i;
-  UINT32                  RequestedDisplayMemorySize;
-  UINT32                  ReservedDisplayMemorySize;
-  EFI_STATUS              Status;
+  SetCpmemFrameBufferAddress (
+    &DisplayContextPtr->DiContext[DisplayDevice],
+    IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE,
+    DisplayContextPtr->DisplayConfig.DisplaySurface[0].PhyAddr + (UINT32)Offset
+  );
+}
 
-  DEBUG ((DEBUG_INFO, "%a: Enter \n", __FUNCTION__));
+/**
+  Set up the off-screen surface used for page flipping.
 
-  for (i = 0; i < DisplayTypeMax; i++) {
-    DisplayInterfaceOrder[i] = NoDisplayType;
+  The second surface follows the visible one in the display memory of the
+  visible surface, which must hold two screens.
+
+  @param[in]  SurfacePtr        Visible surface.
+
+  @retval EFI_SUCCESS           The off-screen surface is ready.
+  @retval EFI_BUFFER_TOO_SMALL  The display memory does not hold two screens.
+  @retval EFI_UNSUPPORTED       The visible surface scrolls through the
+                                scanout address, or its shadow buffer setting
+                                could not be matched.
+
+**/
+STATIC
+EFI_STATUS
+VidGopInitializePageFlip (
+  IN  SURFACE_INFO  *SurfacePtr
+  )
+{
+  UINT32      BackBuffer;
+  UINT32      BlackPixel;
+  UINT32      SurfaceSize;
+  EFI_STATUS  Status;
+
+  // Both features move the scanout address of the same channel
+  if (VidGopBltContext.SetScanout != NULL) {
+    return EFI_UNSUPPORTED;
   }
-  ReservedDisplayMemorySize = FixedPcdGet32 (PcdFrameBufferSize);
-  if (FeaturePcdGet (PcdLvdsEnable)) {
-    DisplayDevice = Lvds0Display;
-  } else {
-    DisplayDevice = HdmiDisplay;
+
+  SurfaceSize = SurfacePtr->Pitch * SurfacePtr->Height * (SurfacePtr->Bpp / 8);
+  SurfaceSize = EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (SurfaceSize));
+  if (SurfacePtr->Size / 2 < SurfaceSize) {
+    return EFI_BUFFER_TOO_SMALL;
   }
 
-  Status = InitDisplay (&DisplayContextPtr);
+  BackBuffer = SurfacePtr->PhyAddr + SurfaceSize;
+  Status = iMXBltInitialize (
+             &VidGopBackBltContext,
+             (VOID *)BackBuffer,
+             SurfacePtr->Width,
+             SurfacePtr->Height,
+             SurfacePtr->Pitch,
+             VidGopBltContext.Flags
+           );
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR,
-      "%a: Fail to init display, Status=%r\n", __FUNCTION__,
-      Status));
-    goto Exit;
+    return Status;
   }
 
-  DEBUG ((DEBUG_INFO, "%a: - Allocate frame buffer\n", __FUNCTION__));
-  // To allocate frame buffer dynamically, there isn`t a built in graphic memory
-  // manager for UEFI, so we are allocating frame buffer manually. Currently only
-  // support single display, so allocate single(1) frame buffer
-  // Allocate frame buffer
-  DisplayContextPtr->DisplayConfig.DisplaySurface[0].Width =
-    DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming.HActive;
-  DisplayContextPtr->DisplayConfig.DisplaySurface[0].Height =
-    DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming.VActive;
-  DisplayContextPtr->DisplayConfig.DisplaySurface[0].Bpp =
-    DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming.Bpp;
-  DisplayContextPtr->DisplayConfig.DisplaySurface[0].PixelFormat =
-    DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming.PixelFormat;
-
-  // iMX6 UEFI reserves display memory for fullHD buffer size.
+  if (VidGopBackBltContext.Flags != VidGopBltContext.Flags) {
+    return EFI_UNSUPPORTED;
+  }
+
+  BlackPixel = 0xFF000000;
+  iMXBlt (
+    &VidGopBackBltContext,
+    (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)&BlackPixel,
+    EfiBltVideoFill,
+    0,
+    0,
+    0,
+    0,
+    SurfacePtr->Width,
+    SurfacePtr->Height,
+    0
+  );
+  iMXBltFlush (&VidGopBackBltContext);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Fill VidGopTimings with the display timings that fit the display memory
+  and pick the mode to start with.
+
+  The preferred timing is picked unless PcdGopDefaultModeMaxPixels asks for
+  a smaller mode, which the console draws and scrolls faster. When no timing
+  fits, 1080p is offered instead.
+
+  @param[in]  ReservedSize    Size of the fixed display memory, MAX_UINT32
+                              when it is allocated to fit each mode.
+
+  @retval The default mode number.
+
+**/
+STATIC
+UINT32
+VidGopBuildModeList (
+  IN  UINT32  ReservedSize
+  )
+{
+  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr;
+  UINT32                      DefaultMode;
+  UINT32                      DefaultPixels;
+  UINT32                      Index;
+  UINT32                      MaxPixels;
+  UINT32                      ModeCount;
+  UINT32                      Pixels;
+  IMX_DISPLAY_TIMING          *TimingPtr;
+
+  DisplayInterfaceContextPtr = &DisplayContextPtr->DiContext[DisplayDevice];
+  ModeCount = 0;
+  for (Index = 0; Index < DisplayInterfaceContextPtr->ModeCount; Index++) {
+    TimingPtr = &DisplayInterfaceContextPtr->ModeList[Index];
+    if (GetFrameBufferPitch (TimingPtr->HActive) * TimingPtr->VActive *
+        (TimingPtr->Bpp / 8) > ReservedSize) {
+      DEBUG ((DEBUG_INFO, "%a: %dx%d does not fit the display memory\n",
+        __FUNCTION__, TimingPtr->HActive, TimingPtr->VActive));
+      continue;
+    }
+    VidGopTimings[ModeCount] = *TimingPtr;
+    ModeCount++;
+  }
+
+  // Fixed display memory is sized for fullHD by default.
   // PcdFrameBufferSize=800000h or 8388608 bytes - 1920x1080x4 bytes
-  // to prevent larger displays overrun our reserved memory size,
-  // cap display resolution to fullHD
   // NOTE: Displays which do not have support for 1920x1080 mode may
   // have poor or missing picture
-  RequestedDisplayMemorySize =
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Width *
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Height *
-    (DisplayContextPtr->DisplayConfig.DisplaySurface[0].Bpp / 8);
-
-  DEBUG ((DEBUG_INFO, "%a: Display Memory: Needed=%d, Available=%d\n",
-    __FUNCTION__, RequestedDisplayMemorySize, ReservedDisplayMemorySize));
-
-  if (RequestedDisplayMemorySize > ReservedDisplayMemorySize) {
-    DEBUG ((DEBUG_INFO,
-      "%a: WARNING. Need more video memory than reserved by %d bytes\n",
-      __FUNCTION__, RequestedDisplayMemorySize - ReservedDisplayMemorySize));
+  if (ModeCount == 0) {
     DEBUG ((DEBUG_ERROR,
       "%a: - display resolution too big. Cap to HD 1080p\n",
       __FUNCTION__));
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Width = FullHDTiming.HActive;
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Height =
-      FullHDTiming.VActive;
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Bpp = FullHDTiming.Bpp;
-    CopyMem (
-      &DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming,
-      &FullHDTiming,
-      sizeof (IMX_DISPLAY_TIMING)
-    );
+    VidGopTimings[0] = FullHDTiming;
+    ModeCount = 1;
   }
+  VidGopMode.MaxMode = ModeCount;
 
-  DEBUG ((DEBUG_INFO, "%a: - allocating frame buffer... \n",
-    __FUNCTION__));
-  Status = AllocateFrameBuffer (&DisplayContextPtr->DisplayConfig.DisplaySurface[0]);
+  MaxPixels = FixedPcdGet32 (PcdGopDefaultModeMaxPixels);
+  if (MaxPixels == 0) {
+    MaxPixels = MAX_UINT32;
+  }
+
+  DefaultMode = 0;
+  if (VidGopTimings[0].HActive * VidGopTimings[0].VActive > MaxPixels) {
+    // Largest mode within the limit, or the smallest mode if none is
+    DefaultPixels = 0;
+    for (Index = 0; Index < ModeCount; Index++) {
+      Pixels = VidGopTimings[Index].HActive * VidGopTimings[Index].VActive;
+      if ((Pixels <= MaxPixels) && (Pixels > DefaultPixels)) {
+        DefaultMode = Index;
+        DefaultPixels = Pixels;
+      }
+    }
+
+    if (DefaultPixels == 0) {
+      DefaultPixels = MAX_UINT32;
+      for (Index = 0; Index < ModeCount; Index++) {
+        Pixels = VidGopTimings[Index].HActive * VidGopTimings[Index].VActive;
+        if (Pixels < DefaultPixels) {
+          DefaultMode = Index;
+          DefaultPixels = Pixels;
+        }
+      }
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: %d modes, default %dx%d\n",
+    __FUNCTION__, ModeCount, VidGopTimings[DefaultMode].HActive,
+    VidGopTimings[DefaultMode].VActive));
+  return DefaultMode;
+}
+
+/**
+  Program the display for a GOP mode and clear it to black.
+
+  Sets up the frame buffer and its Blt contexts for the mode, then
+  reprograms the DC, the DI including the PLL5 pixel clock and the HDMI
+  transmitter for the mode's timing.
+
+  @param[in]  ModeNumber    Index into VidGopTimings.
+
+  @retval EFI_SUCCESS       The display shows the mode.
+  @retval Others            The mode could not be set.
+
+**/
+STATIC
+EFI_STATUS
+VidGopApplyMode (
+  IN  UINT32  ModeNumber
+  )
+{
+  UINT32                  BlackPixel;
+  UINT32                  BltFlags;
+  DISPLAY_INTERFACE_TYPE  DisplayInterfaceOrder[DisplayTypeMax];
+  UINT32                  i;
+  SURFACE_INFO            OldSurface;
+  EFI_STATUS              Status;
+  SURFACE_INFO            *SurfacePtr;
+  IMX_DISPLAY_TIMING      *TimingPtr;
+
+  for (i = 0; i < DisplayTypeMax; i++) {
+    DisplayInterfaceOrder[i] = NoDisplayType;
+  }
+  TimingPtr = &VidGopTimings[ModeNumber];
+  SurfacePtr = &DisplayContextPtr->DisplayConfig.DisplaySurface[0];
+
+  // Drop the surfaces of the previous mode, this also undoes page flips
+  iMXBltFree (&VidGopBltContext);
+  iMXBltFree (&VidGopBackBltContext);
+  VidGopPageFlipAvailable = FALSE;
+
+  DEBUG ((DEBUG_INFO, "%a: - Allocate frame buffer\n", __FUNCTION__));
+  // The IPU scans out of the previous buffer until the display is
+  // reprogrammed, it is freed once that succeeded
+  OldSurface = *SurfacePtr;
+
+  // Currently only support single display, so allocate single(1) frame buffer
+  SurfacePtr->Width = TimingPtr->HActive;
+  SurfacePtr->Height = TimingPtr->VActive;
+  SurfacePtr->Bpp = TimingPtr->Bpp;
+  SurfacePtr->PixelFormat = TimingPtr->PixelFormat;
+  Status = AllocateFrameBuffer (SurfacePtr);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: Fail to allocate fb, Status=%r\n",
       __FUNCTION__, Status));
     goto Exit;
   };
 
+  BltFlags = 0;
+  if (FeaturePcdGet (PcdFrameBufferShadow)) {
+    BltFlags |= IMX_BLT_FLAG_SHADOW;
+  }
+  if (FeaturePcdGet (PcdFrameBufferCacheable)) {
+    BltFlags |= IMX_BLT_FLAG_CLEAN_FRAME_BUFFER;
+  }
+  Status = iMXBltInitialize (
+             &VidGopBltContext,
+             (VOID *)SurfacePtr->PhyAddr,
+             SurfacePtr->Width,
+             SurfacePtr->Height,
+             SurfacePtr->Pitch,
+             BltFlags
+           );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to init Blt, Status=%r\n",
+      __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  // Scroll through the display memory beyond the visible lines
+  if (FeaturePcdGet (PcdFrameBufferScroll)) {
+    Status = iMXBltEnableScroll (
+               &VidGopBltContext,
+               SurfacePtr->Size /
+                 (SurfacePtr->Pitch * (SurfacePtr->Bpp / 8)),
+               VidGopSetScanout,
+               NULL
+             );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: Scanout scroll not used, Status=%r\n",
+        __FUNCTION__, Status));
+    }
+  }
+
   DEBUG ((DEBUG_INFO, "%a: - Initialize the frame buffer to black\n",
     __FUNCTION__));
   // Initialize the frame buffer to black
-  SetMem32 (
-    (VOID *)DisplayContextPtr->DisplayConfig.DisplaySurface[0].PhyAddr,
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Width *
-    DisplayContextPtr->DisplayConfig.DisplaySurface[0].Height * 4,
-    0xFF000000
+  BlackPixel = 0xFF000000;
+  iMXBlt (
+    &VidGopBltContext,
+    (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)&BlackPixel,
+    EfiBltVideoFill,
+    0,
+    0,
+    0,
+    0,
+    SurfacePtr->Width,
+    SurfacePtr->Height,
+    0
   );
+  iMXBltFlush (&VidGopBltContext);
+
+  Status = VidGopInitializePageFlip (SurfacePtr);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: Page flip not available, Status=%r\n",
+      __FUNCTION__, Status));
+  } else {
+    VidGopPageFlipAvailable = TRUE;
+  }
 
   DEBUG ((DEBUG_INFO, "%a: - set display configuration to single HDMI\n",
     __FUNCTION__));
   // Set the display configuration to single HDMI/LVDS mode
   DisplayInterfaceOrder[0] = DisplayDevice;
-  DisplayContextPtr->DisplayConfig.DisplayTiming[0] =
-    DisplayContextPtr->DiContext[DisplayDevice].PreferredTiming;
+  DisplayContextPtr->DisplayConfig.DisplayTiming[0] = *TimingPtr;
 
   Status = ApplyDisplayConfig (
               DisplayContextPtr,
@@ -262,28 +509,83 @@ GopDxeInitialize (
     goto Exit;
   }
 
+  if (OldSurface.PhyAddr != SurfacePtr->PhyAddr) {
+    FreeFrameBuffer (&OldSurface);
+  }
+
   VidGopModeInfo.Version = 0;
-  VidGopModeInfo.HorizontalResolution =
-    DisplayContextPtr->DisplayConfig.DisplayTiming[0].HActive;
-  VidGopModeInfo.VerticalResolution =
-    DisplayContextPtr->DisplayConfig.DisplayTiming[0].VActive;
+  VidGopModeInfo.HorizontalResolution = TimingPtr->HActive;
+  VidGopModeInfo.VerticalResolution = TimingPtr->VActive;
   VidGopModeInfo.PixelFormat = PixelBlueGreenRedReserved8BitPerColor;
   ZeroMem (
     &VidGopModeInfo.PixelInformation,
     sizeof (VidGopModeInfo.PixelInformation)
   );
 
-  VidGopModeInfo.PixelsPerScanLine = VidGopModeInfo.HorizontalResolution;
-  VidGopMode.MaxMode = 1;
-  VidGopMode.Mode = 0;
+  VidGopModeInfo.PixelsPerScanLine = SurfacePtr->Pitch;
+  VidGopMode.Mode = ModeNumber;
   VidGopMode.Info = &VidGopModeInfo;
   VidGopMode.SizeOfInfo = sizeof (VidGopModeInfo);
-  VidGopMode.FrameBufferBase =
-    (EFI_PHYSICAL_ADDRESS) DisplayContextPtr->DisplayConfig.DisplaySurface[0].PhyAddr;
+  VidGopMode.FrameBufferBase = (EFI_PHYSICAL_ADDRESS)SurfacePtr->PhyAddr;
   VidGopMode.FrameBufferSize =
-    VidGopModeInfo.HorizontalResolution *
+    VidGopModeInfo.PixelsPerScanLine *
     VidGopModeInfo.VerticalResolution *
-    (DisplayContextPtr->DisplayConfig.DisplaySurface[0].Bpp / 8);
+    (SurfacePtr->Bpp / 8);
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    // Keep the buffer the display still shows and drop the new one
+    iMXBltFree (&VidGopBltContext);
+    iMXBltFree (&VidGopBackBltContext);
+    VidGopPageFlipAvailable = FALSE;
+    if (OldSurface.PhyAddr != SurfacePtr->PhyAddr) {
+      FreeFrameBuffer (SurfacePtr);
+    }
+    *SurfacePtr = OldSurface;
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+GopDxeInitialize (
+  IN EFI_HANDLE         ImageHandle,
+  IN EFI_SYSTEM_TABLE   *SystemTable
+  )
+{
+  UINT32                  DefaultMode;
+  UINT32                  ReservedDisplayMemorySize;
+  EFI_STATUS              Status;
+
+  DEBUG ((DEBUG_INFO, "%a: Enter \n", __FUNCTION__));
+
+  if (FixedPcdGet32 (PcdFrameBufferBase) != 0) {
+    ReservedDisplayMemorySize = FixedPcdGet32 (PcdFrameBufferSize);
+  } else {
+    ReservedDisplayMemorySize = MAX_UINT32;
+  }
+  if (FeaturePcdGet (PcdLvdsEnable)) {
+    DisplayDevice = Lvds0Display;
+  } else {
+    DisplayDevice = HdmiDisplay;
+  }
+
+  Status = InitDisplay (&DisplayContextPtr);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR,
+      "%a: Fail to init display, Status=%r\n", __FUNCTION__,
+      Status));
+    goto Exit;
+  }
+
+  DefaultMode = VidGopBuildModeList (ReservedDisplayMemorySize);
+  Status = VidGopApplyMode (DefaultMode);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to set mode %d. Exit Status=%r\n",
+      __FUNCTION__, DefaultMode, Status));
+    goto Exit;
+  }
+
   DisplayContextPtr->DisplayConfig.OsHandle[0] = (UINT32)&ImageHandle;
 
   Status = gBS->InstallMultipleProtocolInterfaces (
@@ -300,6 +602,20 @@ GopDxeInitialize (
     goto Exit;
   }
 
+  if (VidGopPageFlipAvailable) {
+    Status = gBS->InstallProtocolInterface (
+                    &ImageHandle,
+                    &giMXDisplayPageFlipProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &VidGopPageFlip
+                  );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: Fail to install page flip, Status=%r\n",
+        __FUNCTION__, Status));
+      Status = EFI_SUCCESS;
+    }
+  }
+
 Exit:
   DEBUG ((DEBUG_INFO, "%a: Exit = %Xh\n",
     __FUNCTION__, Status));
@@ -341,7 +657,7 @@ VidGopQueryMode (
       __FUNCTION__, Status));
   }
 
-  if (ModeNumber != 0) {
+  if (ModeNumber >= VidGopMode.MaxMode) {
     DEBUG ((DEBUG_ERROR, "%a: Saw request to query mode %d\n",
       __FUNCTION__, ModeNumber));
     Status = EFI_INVALID_PARAMETER;
@@ -356,10 +672,13 @@ VidGopQueryMode (
   }
 
   OutputMode->Version = 0;
-  OutputMode->HorizontalResolution = VidGopModeInfo.HorizontalResolution;
-  OutputMode->VerticalResolution = VidGopModeInfo.VerticalResolution;
+  OutputMode->HorizontalResolution = VidGopTimings[ModeNumber].HActive;
+  OutputMode->VerticalResolution = VidGopTimings[ModeNumber].VActive;
   OutputMode->PixelFormat = PixelBlueGreenRedReserved8BitPerColor;
-  OutputMode->PixelsPerScanLine = VidGopModeInfo.HorizontalResolution;
+  ZeroMem (&OutputMode->PixelInformation, sizeof (OutputMode->PixelInformation));
+  OutputMode->PixelsPerScanLine = GetFrameBufferPitch (
+                                   VidGopTimings[ModeNumber].HActive
+                                 );
   *SizeOfInfo = sizeof (EFI_GRAPHICS_OUTPUT_MODE_INFORMATION);
   *Info = OutputMode;
 
@@ -377,14 +696,19 @@ VidGopSetMode (
 {
   EFI_STATUS  Status;
 
-  if (ModeNumber != 0) {
+  if (ModeNumber >= VidGopMode.MaxMode) {
     DEBUG ((DEBUG_ERROR, "%a: Saw request to set mode to %d\n",
       __FUNCTION__, ModeNumber));
     Status = EFI_UNSUPPORTED;
     goto Exit;
   }
 
-  Status = EFI_SUCCESS;
+  Status = VidGopApplyMode (ModeNumber);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to set mode %d, Status=%r\n",
+      __FUNCTION__, ModeNumber, Status));
+    Status = EFI_DEVICE_ERROR;
+  }
 
 Exit:
   return Status;
@@ -404,72 +728,126 @@ VidGopBlt (
   IN UINTN                              Delta OPTIONAL
   )
 {
-  UINT32  *FrameBuffer;
-  UINT32  BufferOffset;
-  UINT32  BufferWidth;
-  UINT32  FrameOffset;
-  UINT32  FrameWidth;
-  UINT32  i;
-
-  FrameBuffer = (UINT32 *)((UINTN)VidGopMode.FrameBufferBase);
-  FrameWidth = VidGopModeInfo.HorizontalResolution;
-  if (Delta == 0) {
-    BufferWidth = Width;
-  } else {
-    BufferWidth = Delta / PIXEL_BYTES;
-  }
-
-  if (BltOperation == EfiBltVideoFill) {
-    FrameOffset = FrameWidth * DestinationY + DestinationX;
-    for (i = DestinationY; i < DestinationY + Height; i++) {
-      SetMem32 (
-        FrameBuffer + FrameOffset,
-        Width * PIXEL_BYTES,
-        *(UINT32 *)BltBuffer
-      );
-      FrameOffset += FrameWidth;
-    }
-  } else if (BltOperation == EfiBltVideoToBltBuffer) {
-    FrameOffset = FrameWidth * SourceY + SourceX;
-    BufferOffset = BufferWidth * DestinationY + DestinationX;
-    for (i = SourceY; i < SourceY + Height; i++) {
-      CopyMem (
-        BltBuffer + BufferOffset,
-        FrameBuffer + FrameOffset,
-        Width * PIXEL_BYTES
-      );
-      FrameOffset += FrameWidth;
-      BufferOffset += BufferWidth;
-    }
-  } else if (BltOperation == EfiBltBufferToVideo) {
-    FrameOffset = FrameWidth * DestinationY + DestinationX;
-    BufferOffset = BufferWidth * SourceY + SourceX;
-    for (i = SourceY; i < SourceY + Height; i++) {
-      CopyMem (
-        FrameBuffer + FrameOffset,
-        BltBuffer + BufferOffset,
-        Width * PIXEL_BYTES
-      );
-      FrameOffset += FrameWidth;
-      BufferOffset += BufferWidth;
-    }
-  } else if (BltOperation == EfiBltVideoToVideo) {
-    FrameOffset = FrameWidth * DestinationY + DestinationX;
-    BufferOffset = FrameWidth * SourceY + SourceX;
-    for (i = SourceY; i < SourceY + Height; i++) {
-      CopyMem (
-        FrameBuffer + FrameOffset,
-        FrameBuffer + BufferOffset,
-        Width * PIXEL_BYTES
-      );
-      FrameOffset += FrameWidth;
-      BufferOffset += FrameWidth;
+  return iMXBlt (
+           &VidGopBltContext,
+           BltBuffer,
+           BltOperation,
+           SourceX,
+           SourceY,
+           DestinationX,
+           DestinationY,
+           Width,
+           Height,
+           Delta
+         );
+}
+
+EFI_STATUS
+EFIAPI
+VidGopPageFlipBlt (
+  IN IMX_DISPLAY_PAGE_FLIP_PROTOCOL     *This,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer, OPTIONAL
+  IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN UINTN                              SourceX,
+  IN UINTN                              SourceY,
+  IN UINTN                              DestinationX,
+  IN UINTN                              DestinationY,
+  IN UINTN                              Width,
+  IN UINTN                              Height,
+  IN UINTN                              Delta OPTIONAL
+  )
+{
+  // The last mode set had no room for a second surface
+  if (!VidGopPageFlipAvailable) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return iMXBlt (
+           &VidGopBackBltContext,
+           BltBuffer,
+           BltOperation,
+           SourceX,
+           SourceY,
+           DestinationX,
+           DestinationY,
+           Width,
+           Height,
+           Delta
+         );
+}
+
+EFI_STATUS
+EFIAPI
+VidGopPageFlipPresent (
+  IN IMX_DISPLAY_PAGE_FLIP_PROTOCOL   *This
+  )
+{
+  UINT32                      ActiveBuffer;
+  DISPLAY_INTERFACE_CONTEXT   *DisplayInterfaceContextPtr;
+  UINT32                      FrontBuffer;
+  UINT32                      NextBuffer;
+  EFI_STATUS                  Status;
+  UINT32                      Timeout;
+
+  if (!VidGopPageFlipAvailable) {
+    return EFI_UNSUPPORTED;
+  }
+
+  DisplayInterfaceContextPtr = &DisplayContextPtr->DiContext[DisplayDevice];
+
+  // Flush both surfaces, GraphicsOutput Blt then draws on the surface
+  // about to become visible
+  Status = iMXBltSwap (&VidGopBltContext, &VidGopBackBltContext);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  FrontBuffer = (UINT32)VidGopBltContext.FrameBuffer;
+
+  // Until the first flip the channel scans out of buffer 0 only
+  if (!VidGopDoubleBufferEnabled) {
+    SetCpmemFrameBufferAddress (
+      DisplayInterfaceContextPtr,
+      IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE,
+      (UINT32)VidGopBackBltContext.FrameBuffer
+    );
+    EnableIdmacDoubleBuffer (
+      DisplayInterfaceContextPtr,
+      IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE
+    );
+    VidGopDoubleBufferEnabled = TRUE;
+  }
+
+  // Queue the new surface in the idle slot, the IDMAC switches to it at the
+  // end of the current frame
+  ActiveBuffer = GetIdmacCurrentBuffer (
+                   DisplayInterfaceContextPtr,
+                   IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE
+                 );
+  NextBuffer = ActiveBuffer ^ 1;
+  SetCpmemBufferAddress (
+    DisplayInterfaceContextPtr,
+    IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE,
+    NextBuffer,
+    FrontBuffer
+  );
+  SelectIdmacBuffer (
+    DisplayInterfaceContextPtr,
+    IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE,
+    NextBuffer
+  );
+  VidGopMode.FrameBufferBase = (EFI_PHYSICAL_ADDRESS)FrontBuffer;
+
+  for (Timeout = 0; Timeout < VID_GOP_PAGE_FLIP_TIMEOUT_US;
+       Timeout += VID_GOP_PAGE_FLIP_POLL_US) {
+    if (GetIdmacCurrentBuffer (
+          DisplayInterfaceContextPtr,
+          IDMAC_CHANNEL_DP_PRIMARY_FLOW_MAIN_PLANE) == NextBuffer) {
+      return EFI_SUCCESS;
     }
-  } else {
-    DEBUG ((DEBUG_ERROR, "%a: Not implemented %d\n",
-      __FUNCTION__, BltOperation));
-    return EFI_INVALID_PARAMETER;
+    MicroSecondDelay (VID_GOP_PAGE_FLIP_POLL_US);
   }
 
-  return EFI_SUCCESS;
+  DEBUG ((DEBUG_ERROR, "%a: Buffer %d not picked up\n",
+    __FUNCTION__, NextBuffer));
+  return EFI_TIMEOUT;
 }
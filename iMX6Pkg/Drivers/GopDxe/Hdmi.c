@@ -289,7 +289,9 @@ InitHdmi (
   IN  DISPLAY_CONTEXT   *DisplayContextPtr
   )
 {
+  BOOLEAN                     EdidCached;
   DISPLAY_INTERFACE_CONTEXT   *pHdmiDisplayContext;
+  UINT32                      Index;
   EFI_STATUS                  Status;
 
   pHdmiDisplayContext = &DisplayContextPtr->DiContext[HdmiDisplay];
@@ -315,15 +317,19 @@ InitHdmi (
     0xFF
   );
 
-  Status = ReadEdid (
-             DisplayContextPtr,
-             HdmiDisplay,
-             pHdmiDisplayContext->EdidData,
-             &pHdmiDisplayContext->EdidDataSize
-           );
-  if (Status != EFI_SUCCESS) {
-    DEBUG ((DEBUG_WARN, "%a: Fail to read HDMI EDID data\n", __FUNCTION__));
-    Status = EFI_SUCCESS;
+  // Skip the full EDID read when the same display is still attached
+  EdidCached = (ReadCachedEdid (DisplayContextPtr, HdmiDisplay) == EFI_SUCCESS);
+  if (!EdidCached) {
+    Status = ReadEdid (
+               DisplayContextPtr,
+               HdmiDisplay,
+               pHdmiDisplayContext->EdidData,
+               &pHdmiDisplayContext->EdidDataSize
+             );
+    if (Status != EFI_SUCCESS) {
+      DEBUG ((DEBUG_WARN, "%a: Fail to read HDMI EDID data\n", __FUNCTION__));
+      Status = EFI_SUCCESS;
+    }
   }
 
   Status = GetPreferredTiming (
@@ -337,11 +343,19 @@ InitHdmi (
     goto Exit;
   }
 
-  if ((pHdmiDisplayContext->PreferredTiming.HActive == 1920) &&
-      (pHdmiDisplayContext->PreferredTiming.VActive == 1080))
-  {
-    pHdmiDisplayContext->PreferredTiming.HBlank -= 6;
+  if (!EdidCached && (pHdmiDisplayContext->EdidDataSize >= IMX_EDID_MIN_SIZE)) {
+    WriteEdidCache (DisplayContextPtr, HdmiDisplay);
+  }
+
+  GetDisplayModes (pHdmiDisplayContext);
+  for (Index = 0; Index < pHdmiDisplayContext->ModeCount; Index++) {
+    if ((pHdmiDisplayContext->ModeList[Index].HActive == 1920) &&
+        (pHdmiDisplayContext->ModeList[Index].VActive == 1080))
+    {
+      pHdmiDisplayContext->ModeList[Index].HBlank -= 6;
+    }
   }
+  pHdmiDisplayContext->PreferredTiming = pHdmiDisplayContext->ModeList[0];
 
 Exit:
   return Status;
@@ -664,26 +678,80 @@ SetDdcSpeed (
   MmioWrite8 ((UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_DIV, Mode);
 }
 
+// Wait for the current I2C master operation, polling once per byte time
+STATIC
+EFI_STATUS
+HdmiDdcWaitOperation (
+  IN  DISPLAY_INTERFACE_CONTEXT   *HdmiDisplayContextPtr,
+  IN  UINT32                      PollIntervalUs
+  )
+{
+  UINT32  ElapsedUs;
+  UINT8   I2cmIntStatus;
+
+  for (ElapsedUs = 0; ; ElapsedUs += PollIntervalUs) {
+    I2cmIntStatus = MmioRead8 (
+                      (UINT32)HdmiDisplayContextPtr->MmioBasePtr +
+                      HDMI_IH_I2CM_STAT0
+                    );
+    if (I2cmIntStatus != 0) {
+      break;
+    }
+
+    if (ElapsedUs >= HDMI_DDC_TIMEOUT_US) {
+      DEBUG ((DEBUG_ERROR, "%a: Timeout waiting for interrupt 0x%02x\n",
+        __FUNCTION__, I2cmIntStatus));
+      return EFI_DEVICE_ERROR;
+    }
+    gBS->Stall (PollIntervalUs);
+  }
+
+  MmioWrite8 (
+    (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_IH_I2CM_STAT0,
+    I2C_MASTER_ERROR | I2C_MASTER_DONE
+  );
+
+  if (!(I2cmIntStatus & I2C_MASTER_DONE) ||
+      (I2cmIntStatus & I2C_MASTER_ERROR))
+  {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to read with DDC 0x%02x\n",
+      __FUNCTION__, I2cmIntStatus));
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
 EFI_STATUS
 HdmiDdcRead (
   IN  DISPLAY_INTERFACE_CONTEXT   *HdmiDisplayContextPtr,
   IN  UINT8                       SlaveAddress,
+  IN  UINT8                       Segment,
   IN  UINT8                       RegisterAddress,
   IN  UINT32                      ReadSize,
   IN  DDC_MODE                    DDCMode,
   IN  UINT8                       *DataReadPtr
   )
 {
-  UINT8       *pCurrentDataRead;
-  UINT32      AddrCount;
-  UINT8       I2cmIntStatus;
-  UINT32      I2cRetryCount;
-  EFI_STATUS  Status;
+  UINT8           *pCurrentDataRead;
+  UINT32          AddrCount;
+  UINT32          BufferIndex;
+  UINT32          ChunkSize;
+  DDC_OPERATION   Operation;
+  UINT32          PollIntervalUs;
+  EFI_STATUS      Status;
 
   pCurrentDataRead = DataReadPtr;
   Status = EFI_SUCCESS;
 
-  // Setup EDID transaction and loop through all byte request
+  if (DDCMode == HDMI_DDC_FAST_MODE) {
+    PollIntervalUs = (HDMI_DDC_BYTE_CYCLES * 1000000) / HDMI_DDC_FAST_MODE_HZ;
+  } else {
+    PollIntervalUs = (HDMI_DDC_BYTE_CYCLES * 1000000) / HDMI_DDC_STANDARD_MODE_HZ;
+  }
+
+  // Setup EDID transaction, segment 0 is addressed without the segment
+  // pointer as not all sinks acknowledge it
   SetDdcSpeed (HdmiDisplayContextPtr, DDCMode);
   MmioWrite8 (
     (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_IH_I2CM_STAT0,
@@ -693,68 +761,57 @@ HdmiDdcRead (
     (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_SLAVE,
     SlaveAddress
   );
+  if (Segment != 0) {
+    MmioWrite8 (
+      (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_SEGADDR,
+      HDMI_DDC_SEGMENT_ADDRESS
+    );
+    MmioWrite8 (
+      (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_SEGPTR,
+      Segment
+    );
+  }
 
-  for (AddrCount = 0; AddrCount < ReadSize; ++AddrCount) {
+  // Read 8 bytes per operation and only fall back to single byte reads
+  // for the tail
+  for (AddrCount = 0; AddrCount < ReadSize; AddrCount += ChunkSize) {
+    if ((ReadSize - AddrCount) >= HDMI_I2CM_READ_BUFF_SIZE) {
+      ChunkSize = HDMI_I2CM_READ_BUFF_SIZE;
+      Operation = (Segment != 0) ? DDC_READ8_EXT_OPERATION : DDC_READ8_OPERATION;
+    } else {
+      ChunkSize = 1;
+      Operation = (Segment != 0) ? DDC_READ_EXT_OPERATION : DDC_READ_OPERATION;
+    }
 
     MmioWrite8 (
       (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_ADDRESS,
       (UINT8) ( RegisterAddress + AddrCount)
     );
-    MmioWrite8 (
-      (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_SEGADDR,
-      0x00
-    );
     MmioWrite8 (
       (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_I2CM_OPERATION,
-      DDC_READ_OPERATION
+      Operation
     );
 
-    // Poll for completion
-    I2cmIntStatus = MmioRead8 (
-                      (UINT32)HdmiDisplayContextPtr->MmioBasePtr +
-                      HDMI_IH_I2CM_STAT0
-                    );
-    for (I2cRetryCount = 10; I2cRetryCount > 0; I2cRetryCount--) {
-      I2cmIntStatus = MmioRead8 (
-                        (UINT32)HdmiDisplayContextPtr->MmioBasePtr +
-                        HDMI_IH_I2CM_STAT0
-                      );
-      if (I2cmIntStatus != 0) {
-        break;
-      }
-      gBS->Stall (2000);
-    }
-
-    if (I2cRetryCount == 0) {
-      Status = EFI_DEVICE_ERROR;
-      DEBUG ((DEBUG_ERROR, "%a: Timeout waiting for interrupt 0x%02x\n",
-        __FUNCTION__, I2cmIntStatus));
+    Status = HdmiDdcWaitOperation (HdmiDisplayContextPtr, PollIntervalUs);
+    if (Status != EFI_SUCCESS) {
       goto Exit;
     }
 
-    if ((I2cmIntStatus & I2C_MASTER_DONE) &&
-        !(I2cmIntStatus & I2C_MASTER_ERROR))
-    {
+    if (ChunkSize == HDMI_I2CM_READ_BUFF_SIZE) {
+      for (BufferIndex = 0; BufferIndex < ChunkSize; BufferIndex++) {
+        *pCurrentDataRead = MmioRead8 (
+                              (UINT32)HdmiDisplayContextPtr->MmioBasePtr +
+                              HDMI_I2CM_READ_BUFF0 + BufferIndex
+                            );
+        pCurrentDataRead++;
+      }
+    } else {
       *pCurrentDataRead = MmioRead8 (
                             (UINT32)HdmiDisplayContextPtr->MmioBasePtr +
                             HDMI_I2CM_DATAI
                           );
       pCurrentDataRead++;
-      MmioWrite8 (
-        (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_IH_I2CM_STAT0,
-        I2C_MASTER_ERROR | I2C_MASTER_DONE
-      );
-    } else {
-      Status = EFI_DEVICE_ERROR;
-      DEBUG ((DEBUG_ERROR, "%a: Failed to read with DDC 0x%02x\n",
-        __FUNCTION__, I2cmIntStatus));
-      goto Exit;
     }
-
-    MmioWrite8 (
-      (UINT32)HdmiDisplayContextPtr->MmioBasePtr + HDMI_IH_I2CM_STAT0,
-      I2C_MASTER_ERROR | I2C_MASTER_DONE
-    );
   }
 
 Exit:
@@ -339,6 +339,23 @@
 #define HDMI_I2CM_FS_SCL_HCNT_0_ADDR    0x7E10
 #define HDMI_I2CM_FS_SCL_LCNT_1_ADDR    0x7E11
 #define HDMI_I2CM_FS_SCL_LCNT_0_ADDR    0x7E12
+#define HDMI_I2CM_READ_BUFF0            0x7E20
+
+// Bytes returned by a sequential read operation in HDMI_I2CM_READ_BUFF0-7
+#define HDMI_I2CM_READ_BUFF_SIZE        8
+
+// E-DDC segment pointer slave address, refer to VESA E-DDC spec
+#define HDMI_DDC_SEGMENT_ADDRESS        0x30
+
+// SCL frequency of the DDC speed modes
+#define HDMI_DDC_STANDARD_MODE_HZ       100000
+#define HDMI_DDC_FAST_MODE_HZ           400000
+
+// SCL cycles to move one byte including its acknowledge
+#define HDMI_DDC_BYTE_CYCLES            9
+
+// Limit for a single DDC operation, sinks may stretch the clock
+#define HDMI_DDC_TIMEOUT_US             20000
 
 // DDC Interrupt status
 #define I2C_MASTER_ERROR                0x01
@@ -348,6 +365,8 @@
 typedef enum {
   DDC_READ_OPERATION = 0x01,
   DDC_READ_EXT_OPERATION = 0x02,
+  DDC_READ8_OPERATION = 0x04,
+  DDC_READ8_EXT_OPERATION = 0x08,
   DDC_WRITE_OPERATION = 0x10,
 } DDC_OPERATION;
 
@@ -520,6 +539,7 @@ EFI_STATUS
 HdmiDdcRead (
   IN  DISPLAY_INTERFACE_CONTEXT   *HdmiDisplayContextPtr,
   IN  UINT8                       SlaveAddress,
+  IN  UINT8                       Segment,
   IN  UINT8                       RegisterAddress,
   IN  UINT32                      ReadSize,
   IN  DDC_MODE                    DDCMode,
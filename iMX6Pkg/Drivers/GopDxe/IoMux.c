@@ -37,7 +37,10 @@ SetupDisplayMux (
   volatile IMX_IOMUXC_GPR_REGISTERS   *pIomuxcGprReg;
   UINT32                              DisplayInterfaceIndex;
   DISPLAY_MODE                        DisplayMode;
+  DISPLAY_INTERFACE_TYPE              DisplayType;
   UINT32                              Gpr3Reg;
+  UINT32                              OutputCount;
+  UINT32                              SourceIndex;
   UINT32                              SourceMask;
   UINT32                              SourceValue;
   EFI_STATUS                          Status;
@@ -52,24 +55,38 @@ SetupDisplayMux (
                LVDS0_MUX_CTL_MASK | LVDS1_MUX_CTL_MASK);
   MmioWrite32 ((UINT32)&pIomuxcGprReg->GPR3, Gpr3Reg);
 
-  for (DisplayInterfaceIndex = 0; DisplayInterfaceIndex < (UINT32)DisplayMode; ++DisplayInterfaceIndex) {
+  OutputCount = (UINT32)DisplayMode;
+  if (DisplayContextPtr->MirrorDisplay != NoDisplayType) {
+    OutputCount++;
+  }
+
+  for (DisplayInterfaceIndex = 0; DisplayInterfaceIndex < OutputCount; ++DisplayInterfaceIndex) {
+    // The mirror takes its pixels from the first DI
+    if (DisplayInterfaceIndex < (UINT32)DisplayMode) {
+      DisplayType = pDisplayInterfaceType[DisplayInterfaceIndex];
+      SourceIndex = DisplayInterfaceIndex;
+    } else {
+      DisplayType = DisplayContextPtr->MirrorDisplay;
+      SourceIndex = 0;
+    }
+
     Gpr3Reg = MmioRead32 ((UINT32)&pIomuxcGprReg->GPR3);
-    switch (pDisplayInterfaceType[DisplayInterfaceIndex]) {
+    switch (DisplayType) {
     case HdmiDisplay:
       SourceMask = HDMI_MUX_CTL_MASK;
-      SourceValue = DisplayInterfaceIndex << HDMI_MUX_CTL_OFFSET;
+      SourceValue = SourceIndex << HDMI_MUX_CTL_OFFSET;
       break;
     case MipiDisplay:
       SourceMask = MIPI_MUX_CTL_MASK;
-      SourceValue = DisplayInterfaceIndex << MIPI_MUX_CTL_OFFSET;
+      SourceValue = SourceIndex << MIPI_MUX_CTL_OFFSET;
       break;
     case Lvds0Display:
       SourceMask = LVDS0_MUX_CTL_MASK;
-      SourceValue = DisplayInterfaceIndex << LVDS0_MUX_CTL_OFFSET;
+      SourceValue = SourceIndex << LVDS0_MUX_CTL_OFFSET;
       break;
     case Lvds1Display:
       SourceMask = LVDS1_MUX_CTL_MASK;
-      SourceValue = DisplayInterfaceIndex << LVDS1_MUX_CTL_OFFSET;
+      SourceValue = SourceIndex << LVDS1_MUX_CTL_OFFSET;
       break;
     default:
       Status = EFI_UNSUPPORTED;
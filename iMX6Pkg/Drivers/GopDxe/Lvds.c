@@ -70,6 +70,8 @@ InitLvds (
     goto Exit;
   }
 
+  GetDisplayModes (pLvdsDisplayContext);
+
 Exit:
   return Status;
 }
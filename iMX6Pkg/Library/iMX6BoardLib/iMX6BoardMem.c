@@ -89,11 +89,20 @@ ArmPlatformGetVirtualMemoryMap (
   VirtualMemoryTable[Index].Attributes     = SOC_REGISTERS_ATTRIBUTES;
 #endif
 
-  // Framebuffer
-  VirtualMemoryTable[++Index].PhysicalBase = FixedPcdGet32 (PcdFrameBufferBase);
-  VirtualMemoryTable[Index].VirtualBase    = FixedPcdGet32 (PcdFrameBufferBase);
-  VirtualMemoryTable[Index].Length         = FixedPcdGet32 (PcdFrameBufferSize);
-  VirtualMemoryTable[Index].Attributes     = DDR_ATTRIBUTES_UNCACHED;
+  // Framebuffer. DDR_ATTRIBUTES_UNCACHED is normal non-cacheable memory, so
+  // stores are write-combined. The cacheable mapping relies on GopDxe
+  // cleaning what it draws. GopDxe maps the memory it allocates itself when
+  // PcdFrameBufferBase is 0.
+  if (FixedPcdGet32 (PcdFrameBufferBase) != 0) {
+    VirtualMemoryTable[++Index].PhysicalBase = FixedPcdGet32 (PcdFrameBufferBase);
+    VirtualMemoryTable[Index].VirtualBase    = FixedPcdGet32 (PcdFrameBufferBase);
+    VirtualMemoryTable[Index].Length         = FixedPcdGet32 (PcdFrameBufferSize);
+    if (FeaturePcdGet (PcdFrameBufferCacheable)) {
+      VirtualMemoryTable[Index].Attributes   = DDR_ATTRIBUTES_CACHED;
+    } else {
+      VirtualMemoryTable[Index].Attributes   = DDR_ATTRIBUTES_UNCACHED;
+    }
+  }
 
   // Boot (UEFI) DRAM region (kernel.img & boot working DRAM) (0x10800000 size 0x001D0000)
   VirtualMemoryTable[++Index].PhysicalBase   = BOOT_IMAGE_PHYSICAL_BASE;
@@ -100,7 +100,7 @@ IMX_I2C_CONTEXT i2c2EDIDConfig = {
 //
 // EDID read buffer
 //
-UINT8 edidBuffer[IMX_EDID_MIN_SIZE];
+UINT8 edidBuffer[IMX_EDID_MAX_SIZE];
 
 #define PCA955_REG_INPUT_PORT0      0x00
 #define PCA955_REG_INPUT_PORT1      0x01
@@ -114,64 +114,104 @@ UINT8 edidBuffer[IMX_EDID_MIN_SIZE];
 #define GPIO_DVI_EN_3V3             0x20 // 1.5
 #define GPIO_LCD_NTSBY_3V3          0x40 // 1.6
 
+//
+// SIL164 and PCA9555 share I2C4. Route their transfers through a single bus
+// owner so they are serialized and the controller stays configured between
+// the back to back register accesses.
+//
+IMX_I2C_BUS i2c4Bus;
+
+RETURN_STATUS LcdifBoardI2c4Transfer (
+    IMX_I2C_CONTEXT* Context,
+    IMX_I2C_REQUEST_TYPE Type,
+    UINT8 RegisterAddress,
+    UINT8* Data
+    )
+{
+    IMX_I2C_BATCH batch;
+    IMX_I2C_REQUEST request;
+    RETURN_STATUS status;
+
+    request.I2cContext = Context;
+    request.Type = Type;
+    request.RegisterAddress = RegisterAddress;
+    request.RegisterAddressSize = IMX_I2C_REGISTER_ADDRESS_8BIT;
+    request.Buffer = Data;
+    request.BufferSize = 1;
+
+    batch.RequestList = &request;
+    batch.RequestCount = 1;
+
+    //
+    // This driver is the only client of I2C4 and never submits from an event
+    // callback, so the bus is always idle here and the batch is performed
+    // before returning. A deferred batch would outlive this stack frame.
+    //
+    status = iMXI2cBusSubmit(&i2c4Bus, &batch);
+    ASSERT (status != RETURN_NOT_READY);
+    return status;
+}
+
 VOID LcdifBoardInitialize ()
 {
     UINT8 i2cData;
     RETURN_STATUS status;
 
+    iMXI2cBusInitialize(&i2c4Bus, i2c4SIL164Config.ControllerAddress);
+
     //
     // Dummy read since first read returns garbage
     //
-    iMXI2cRead(&i2c4SIL164Config, SIL164_REG_VND_IDL, &i2cData, 1);
+    LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_VND_IDL, &i2cData);
 
     //
     // Sanity check to make sure we are attached to a SIL164 chip.
     // Reading one byte at a time as SIL164 support only byte read and write.
     //
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_VND_IDL, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_VND_IDL, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     ASSERT (i2cData == 0x01);
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_VND_IDH, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_VND_IDH, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     ASSERT (i2cData == 0x00);
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_DEV_IDL, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_DEV_IDL, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     ASSERT (i2cData == 0x06);
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_DEV_IDH, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_DEV_IDH, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     ASSERT (i2cData == 0x00);
 
     //
     // Set lcd_nstby_3v3 and dvi_en_3v3 as output and high
     //
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_CFG_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_CFG_PORT1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     i2cData &= ~(GPIO_DVI_EN_3V3 | GPIO_LCD_NTSBY_3V3);
-    status = iMXI2cWrite(&i2c4PCA9555Config, PCA955_REG_CFG_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestWrite, PCA955_REG_CFG_PORT1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_OUTPUT_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_OUTPUT_PORT1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
     i2cData |= (GPIO_DVI_EN_3V3 | GPIO_LCD_NTSBY_3V3);
-    status = iMXI2cWrite(&i2c4PCA9555Config, PCA955_REG_OUTPUT_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestWrite, PCA955_REG_OUTPUT_PORT1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     DEBUG_CODE_BEGIN();
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_INPUT_PORT0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_INPUT_PORT0, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_INPUT_PORT0: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_INPUT_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_INPUT_PORT1, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_INPUT_PORT1: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_OUTPUT_PORT0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_OUTPUT_PORT0, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_OUTPUT_PORT0: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_OUTPUT_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_OUTPUT_PORT1, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_OUTPUT_PORT1: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_POL_INV_PORT0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_POL_INV_PORT0, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_POL_INV_PORT0: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_POL_INV_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_POL_INV_PORT1, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_POL_INV_PORT1: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_CFG_PORT0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_CFG_PORT0, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_CFG_PORT0: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4PCA9555Config, PCA955_REG_CFG_PORT1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4PCA9555Config, ImxI2cRequestRead, PCA955_REG_CFG_PORT1, &i2cData);
     DEBUG((DEBUG_INIT, "PCA955_REG_CFG_PORT1: 0x%04x\n", i2cData));
     DEBUG_CODE_END();
 
@@ -189,21 +229,21 @@ VOID LcdifBoardConfigureDisplay (
     // 24 bit and enable HSYNC and VSYNC
     //
     i2cData = SIL164_CONTROL0_INPUT_24BIT | SIL164_CONTROL0_HSYNC_ON | SIL164_CONTROL0_VSYNC_ON;
-    status = iMXI2cWrite(&i2c4SIL164Config, SIL164_REG_CONTROL0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestWrite, SIL164_REG_CONTROL0, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     //
     // Do we actually need to setup interrupts?
     //
     i2cData = 0x20 | 0x01;
-    status = iMXI2cWrite(&i2c4SIL164Config, SIL164_REG_CONTROL1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestWrite, SIL164_REG_CONTROL1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     //
     // DK = 100 - 5 step -> default (recommended setting)
     //
     i2cData = (0x04 << 5);
-    status = iMXI2cWrite(&i2c4SIL164Config, SIL164_REG_CONTROL1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestWrite, SIL164_REG_CONTROL1, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     //
@@ -212,31 +252,45 @@ VOID LcdifBoardConfigureDisplay (
     // SCNT - Enable
     //
     i2cData = SIL164_REG_CONTROL2_PFEN_ENABLE | 0x04 << 1 | SIL164_REG_CONTROL2_SCNT_ENABLE;
-    status = iMXI2cWrite(&i2c4SIL164Config, SIL164_REG_CONTROL2, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestWrite, SIL164_REG_CONTROL2, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     //
     // Power on the chip
     //
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_CONTROL0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_CONTROL0, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     i2cData |= SIL164_CONTROL0_POWER_ON;
 
-    status = iMXI2cWrite(&i2c4SIL164Config, SIL164_REG_CONTROL0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestWrite, SIL164_REG_CONTROL0, &i2cData);
     ASSERT (!RETURN_ERROR(status));
 
     DEBUG_CODE_BEGIN();
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_CONTROL0, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_CONTROL0, &i2cData);
     DEBUG((DEBUG_INIT, "SIL164_REG_CONTROL0: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_DETECT, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_DETECT, &i2cData);
     DEBUG((DEBUG_INIT, "SIL164_REG_DETECT: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_CONTROL1, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_CONTROL1, &i2cData);
     DEBUG((DEBUG_INIT, "SIL164_REG_CONTROL1: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_GPIO, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_GPIO, &i2cData);
     DEBUG((DEBUG_INIT, "SIL164_REG_GPIO: 0x%04x\n", i2cData));
-    status = iMXI2cRead(&i2c4SIL164Config, SIL164_REG_CONTROL2, &i2cData, 1);
+    status = LcdifBoardI2c4Transfer(&i2c4SIL164Config, ImxI2cRequestRead, SIL164_REG_CONTROL2, &i2cData);
     DEBUG((DEBUG_INIT, "SIL164_REG_CONTROL2: 0x%04x\n", i2cData));
+    {
+        IMX_I2C_BUS_STATISTICS i2cStatistics;
+
+        iMXI2cBusGetStatistics(&i2c4Bus, &i2cStatistics);
+        DEBUG((
+            DEBUG_INIT,
+            "I2C4 transactions %ld bytes %ld errors %ld setups %ld busy %ldns\n",
+            i2cStatistics.TransactionCount,
+            i2cStatistics.ByteCount,
+            i2cStatistics.ErrorCount,
+            i2cStatistics.ConfigureCount,
+            i2cStatistics.BusyTimeInNs));
+    }
+    iMXI2cBusDumpTrace(&i2c4Bus);
     DEBUG_CODE_END();
 }
 
@@ -268,6 +322,8 @@ RETURN_STATUS LcdifBoardQueryEdidTiming (
 {
     RETURN_STATUS status;
     UINT32 index;
+    UINT32 edidDataSize;
+    UINT32 modeCount;
     UINT8* edidDataReadPtr = &edidBuffer[0];
 
     ImxPadConfig(IMX_PAD_GPIO1_IO08, IMX_PAD_GPIO1_IO08_I2C3_SCL);
@@ -277,9 +333,36 @@ RETURN_STATUS LcdifBoardQueryEdidTiming (
         &i2c2EDIDConfig,
         0,
         (UINT8*)(edidDataReadPtr),
-        ARRAY_SIZE(edidBuffer));
+        IMX_EDID_BLOCK_SIZE);
     ASSERT(!RETURN_ERROR(status));
 
+    status = ImxValidateEdidData(edidDataReadPtr);
+    if (EFI_ERROR(status)) {
+        DEBUG((DEBUG_INIT, "EDID data not valid\n"));
+        goto End;
+    }
+
+    //
+    // The extension block is optional, a bad one only loses its timings
+    //
+    edidDataSize = IMX_EDID_BLOCK_SIZE;
+    if (ImxGetEdidSize(edidDataReadPtr) > IMX_EDID_BLOCK_SIZE) {
+        status = iMXI2cRead(
+            &i2c2EDIDConfig,
+            IMX_EDID_BLOCK_SIZE,
+            &edidDataReadPtr[IMX_EDID_BLOCK_SIZE],
+            IMX_EDID_BLOCK_SIZE);
+        if (!RETURN_ERROR(status)) {
+            status = ImxValidateEdidBlock(&edidDataReadPtr[IMX_EDID_BLOCK_SIZE]);
+        }
+
+        if (!RETURN_ERROR(status)) {
+            edidDataSize = ImxGetEdidSize(edidDataReadPtr);
+        } else {
+            DEBUG((DEBUG_INIT, "EDID extension block not valid\n"));
+        }
+    }
+
     DEBUG_CODE_BEGIN();
     ImxPadDumpConfig("IMX_PAD_GPIO1_IO08", IMX_PAD_GPIO1_IO08);
     ImxPadDumpConfig("IMX_PAD_GPIO1_IO09", IMX_PAD_GPIO1_IO09);
@@ -287,7 +370,7 @@ RETURN_STATUS LcdifBoardQueryEdidTiming (
     DEBUG((DEBUG_INIT, "EDID dump\n"));
     DEBUG((DEBUG_INIT, "=================================================\n"));
 
-    for (index = 0; index < IMX_EDID_MIN_SIZE; ++index) {
+    for (index = 0; index < edidDataSize; ++index) {
         DEBUG((
             DEBUG_INIT,
             "EDID 0x%02x: 0x%02x\n",
@@ -297,25 +380,25 @@ RETURN_STATUS LcdifBoardQueryEdidTiming (
     DEBUG((DEBUG_INIT, "=================================================\n"));
     DEBUG_CODE_END();
 
-    status = ImxValidateEdidData(edidDataReadPtr);
-    if (EFI_ERROR(status)) {
-        DEBUG((DEBUG_INIT, "EDID data not valid\n"));
+    //
+    // Use the best ranked timing, this also covers displays that only
+    // describe their native timing in the CEA-861 extension block
+    //
+    status = ImxGetEdidModes(
+        edidDataReadPtr,
+        edidDataSize,
+        PreferredTiming,
+        1,
+        &modeCount);
+    if (status != EFI_SUCCESS) {
+        DEBUG((DEBUG_ERROR, "Conversion to display timing failed\n"));
         goto End;
     }
 
-    {
-        IMX_DETAILED_TIMING_DESCRIPTOR* edidPreferredTiming;
-
-        edidPreferredTiming =
-            (IMX_DETAILED_TIMING_DESCRIPTOR*)&edidDataReadPtr[IMX_EDID_DTD_1_OFFSET];
-
-        status = ImxConvertDTDToDisplayTiming(
-            edidPreferredTiming,
-            PreferredTiming);
-        if (status != EFI_SUCCESS) {
-            DEBUG((DEBUG_ERROR, "Conversion to display timing failed\n"));
-            goto End;
-        }
+    if (modeCount == 0) {
+        DEBUG((DEBUG_ERROR, "EDID holds no usable timing\n"));
+        status = EFI_NOT_FOUND;
+        goto End;
     }
 
 End:
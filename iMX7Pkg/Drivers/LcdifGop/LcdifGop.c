@@ -26,12 +26,11 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/GraphicsOutput.h>
 
+#include <iMXBltLib.h>
 #include <iMXDisplay.h>
 
 #include "Lcdif.h"
 
-#define PIXEL_BYTES 4
-
 typedef struct _LCDIF_DISPLAY_CONTEXT {
 
     //
@@ -112,6 +111,7 @@ static VID_DEVICE_PATH LcdifVidDevicePath =
 static LCDIF_DISPLAY_CONTEXT LcdifDisplayContext;
 static EFI_GRAPHICS_OUTPUT_MODE_INFORMATION LcdifGopModeInfo;
 static EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE LcdifGopProtocolMode;
+static IMX_BLT_CONTEXT LcdifBltContext;
 
 static EFI_GRAPHICS_OUTPUT_PROTOCOL LcdifGopProtocol =
 {
@@ -193,6 +193,7 @@ LcdifGopInitialize (
     )
 {
     EFI_STATUS status;
+    UINT32 blackPixel = 0xFF000000;
 
     DEBUG ((DEBUG_INIT, "LcdIfGopInitialize\n"));
 
@@ -234,13 +235,33 @@ LcdifGopInitialize (
         }
         DEBUG((DEBUG_INIT, "Framebuffer address = %x\n", LcdifDisplayContext.FrameBuffer));
 
+        status = iMXBltInitialize(
+                    &LcdifBltContext,
+                    LcdifDisplayContext.FrameBuffer,
+                    LcdifDisplayContext.PreferedTiming.HActive,
+                    LcdifDisplayContext.PreferedTiming.VActive,
+                    LcdifDisplayContext.PreferedTiming.HActive,
+                    FeaturePcdGet(PcdFrameBufferShadow) ? IMX_BLT_FLAG_SHADOW : 0);
+        if (EFI_ERROR(status)) {
+            DEBUG((DEBUG_ERROR, "Blt initialization failed %r\n", status));
+            goto Exit;
+        }
+
         //
         // Initialize the frame buffer to black
         //
-        SetMem32(
-            LcdifDisplayContext.FrameBuffer,
-            fbSize,
-            0xFF000000);
+        iMXBlt(
+            &LcdifBltContext,
+            (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)&blackPixel,
+            EfiBltVideoFill,
+            0,
+            0,
+            0,
+            0,
+            LcdifDisplayContext.PreferedTiming.HActive,
+            LcdifDisplayContext.PreferedTiming.VActive,
+            0);
+        iMXBltFlush(&LcdifBltContext);
     }
 
     DEBUG ((DEBUG_INIT, "calling LcdIfConfigureDisplay\n"));
@@ -392,75 +413,17 @@ LcdifGopBlt (
     )
 {
     DEBUG ((DEBUG_VERBOSE, "entering LcdifGopBlt\n"));
-    UINT32 *frameBuffer;
-    UINT32 frameWidth;
-    UINT32 frameOffset;
-    UINT32 bufferOffset;
-    UINT32 bufferWidth;
-    UINT32 i;
-
-    frameBuffer = (UINT32 *) (UINTN) LcdifGopProtocolMode.FrameBufferBase;
-    frameWidth = LcdifGopModeInfo.HorizontalResolution;
-
-    if (Delta == 0) {
-        bufferWidth = Width;
-    } else {
-        bufferWidth = Delta / PIXEL_BYTES;
-    }
-
-    if (BltOperation == EfiBltVideoFill) {
-
-        frameOffset = frameWidth * DestinationY + DestinationX;
-        for (i = DestinationY; i < DestinationY + Height; i++) {
-            SetMem32(frameBuffer + frameOffset,
-                     Width * PIXEL_BYTES,
-                     *(UINT32 *)BltBuffer
-                     );
-            frameOffset += frameWidth;
-        }
-    } else if (BltOperation == EfiBltVideoToBltBuffer) {
-
-        frameOffset = frameWidth * SourceY + SourceX;
-        bufferOffset = bufferWidth * DestinationY + DestinationX;
-
-        for (i = SourceY; i < SourceY + Height; i++) {
-            CopyMem(BltBuffer + bufferOffset,
-                    frameBuffer + frameOffset,
-                    Width * PIXEL_BYTES);
-            frameOffset += frameWidth;
-            bufferOffset += bufferWidth;
-        }
-    } else if (BltOperation == EfiBltBufferToVideo) {
-
-        frameOffset = frameWidth * DestinationY + DestinationX;
-        bufferOffset = bufferWidth * SourceY + SourceX;
-
-        for (i = SourceY; i < SourceY + Height; i++) {
-            CopyMem(frameBuffer + frameOffset,
-                    BltBuffer + bufferOffset,
-                    Width * PIXEL_BYTES);
-            frameOffset += frameWidth;
-            bufferOffset += bufferWidth;
-        }
-
-    } else if (BltOperation == EfiBltVideoToVideo) {
-
-        frameOffset = frameWidth * DestinationY + DestinationX;
-        bufferOffset = frameWidth * SourceY + SourceX;
-
-        for (i = SourceY; i < SourceY + Height; i++) {
-            CopyMem(frameBuffer + frameOffset,
-                    frameBuffer + bufferOffset,
-                    Width * PIXEL_BYTES);
-            frameOffset += frameWidth;
-            bufferOffset += frameWidth;
-        }
-
-    } else {
-        DEBUG((EFI_D_ERROR, "LcdifGopBlt:LcdifGopBlt not implemented %d\n", BltOperation));
-        return EFI_INVALID_PARAMETER;
-    }
 
-    return EFI_SUCCESS;
+    return iMXBlt(
+        &LcdifBltContext,
+        BltBuffer,
+        BltOperation,
+        SourceX,
+        SourceY,
+        DestinationX,
+        DestinationY,
+        Width,
+        Height,
+        Delta);
 }
 
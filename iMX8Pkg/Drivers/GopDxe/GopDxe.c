@@ -0,0 +1,331 @@
+/** @file
+*
+*  Graphics output on the frame buffer set up by the boot loader.
+*
+*  The display controller is programmed before UEFI runs, LcdPlatformLib
+*  describes its modes and provides the display memory. Blt goes through
+*  iMXBltLib like on the other i.MX platforms.
+*
+*  Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/LcdPlatformLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <Protocol/DevicePath.h>
+#include <Protocol/GraphicsOutput.h>
+
+#include <iMXBltLib.h>
+
+typedef struct {
+  VENDOR_DEVICE_PATH Vendor;
+  EFI_DEVICE_PATH End;
+} VID_DEVICE_PATH;
+
+EFI_STATUS
+EFIAPI
+VidGopQueryMode (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL           *This,
+  IN UINT32                                 ModeNumber,
+  OUT UINTN                                 *SizeOfInfo,
+  OUT EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  **Info
+  );
+
+EFI_STATUS
+EFIAPI
+VidGopSetMode (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL   *This,
+  IN UINT32                         ModeNumber
+  );
+
+EFI_STATUS
+EFIAPI
+VidGopBlt (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL       *This,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer,
+  IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN UINTN                              SourceX,
+  IN UINTN                              SourceY,
+  IN UINTN                              DestinationX,
+  IN UINTN                              DestinationY,
+  IN UINTN                              Width,
+  IN UINTN                              Height,
+  IN UINTN                              Delta
+  );
+
+STATIC VID_DEVICE_PATH VidDevicePath = {
+  {
+    {
+      HARDWARE_DEVICE_PATH,
+      HW_VENDOR_DP,
+      {
+        (UINT8)sizeof (VENDOR_DEVICE_PATH),
+        (UINT8) ((sizeof (VENDOR_DEVICE_PATH)) >> 8),
+      }
+    },
+    {
+      0xe569dffc,
+      0x8e32,
+      0x45e3,
+      { 0xb1, 0x05, 0x29, 0x7f, 0x6e, 0x38, 0xb4, 0xdb }
+    }
+  },
+  {
+    END_DEVICE_PATH_TYPE,
+    END_ENTIRE_DEVICE_PATH_SUBTYPE,
+    {
+      sizeof (EFI_DEVICE_PATH_PROTOCOL),
+      0
+    }
+  }
+};
+
+STATIC EFI_GRAPHICS_OUTPUT_MODE_INFORMATION VidGopModeInfo;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE VidGopMode;
+
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL VidGop = {
+  VidGopQueryMode, // QueryMode
+  VidGopSetMode,   // SetMode
+  VidGopBlt,       // Blt
+  &VidGopMode      // Mode
+};
+
+STATIC EFI_PHYSICAL_ADDRESS VidGopVramBase;
+STATIC UINTN VidGopVramSize;
+
+STATIC IMX_BLT_CONTEXT VidGopBltContext;
+
+/**
+  Switch the display to a mode and set up its Blt context.
+
+  @param[in]  ModeNumber        LcdPlatformLib mode number.
+
+  @retval EFI_SUCCESS           The display shows the mode.
+  @retval EFI_UNSUPPORTED       The mode is not 32 bits per pixel BGR.
+  @retval EFI_BUFFER_TOO_SMALL  The mode does not fit the display memory.
+  @retval Others                The mode could not be set.
+
+**/
+STATIC
+EFI_STATUS
+VidGopApplyMode (
+  IN  UINT32  ModeNumber
+  )
+{
+  UINT32                                BlackPixel;
+  UINT32                                BltFlags;
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  ModeInfo;
+  UINTN                                 Size;
+  EFI_STATUS                            Status;
+
+  Status = LcdPlatformQueryMode (ModeNumber, &ModeInfo);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  // iMXBltLib draws EFI_GRAPHICS_OUTPUT_BLT_PIXEL as it is
+  if (ModeInfo.PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
+  Size = ModeInfo.PixelsPerScanLine * ModeInfo.VerticalResolution *
+         sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+  if (Size > VidGopVramSize) {
+    Status = EFI_BUFFER_TOO_SMALL;
+    goto Exit;
+  }
+
+  Status = LcdPlatformSetMode (ModeNumber);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  iMXBltFree (&VidGopBltContext);
+
+  // The display memory is mapped write-combining, nothing to clean
+  BltFlags = 0;
+  if (FeaturePcdGet (PcdFrameBufferShadow)) {
+    BltFlags |= IMX_BLT_FLAG_SHADOW;
+  }
+  Status = iMXBltInitialize (
+             &VidGopBltContext,
+             (VOID *)(UINTN)VidGopVramBase,
+             ModeInfo.HorizontalResolution,
+             ModeInfo.VerticalResolution,
+             ModeInfo.PixelsPerScanLine,
+             BltFlags
+           );
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  BlackPixel = 0xFF000000;
+  iMXBlt (
+    &VidGopBltContext,
+    (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)&BlackPixel,
+    EfiBltVideoFill,
+    0,
+    0,
+    0,
+    0,
+    ModeInfo.HorizontalResolution,
+    ModeInfo.VerticalResolution,
+    0
+  );
+  iMXBltFlush (&VidGopBltContext);
+
+  VidGopModeInfo = ModeInfo;
+  VidGopMode.Mode = ModeNumber;
+  VidGopMode.Info = &VidGopModeInfo;
+  VidGopMode.SizeOfInfo = sizeof (VidGopModeInfo);
+  VidGopMode.FrameBufferBase = VidGopVramBase;
+  VidGopMode.FrameBufferSize = Size;
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to set mode %d, Status=%r\n",
+      __FUNCTION__, ModeNumber, Status));
+  }
+  return Status;
+}
+
+EFI_STATUS
+EFIAPI
+GopDxeInitialize (
+  IN EFI_HANDLE         ImageHandle,
+  IN EFI_SYSTEM_TABLE   *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = LcdPlatformInitializeDisplay (ImageHandle);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to init display, Status=%r\n",
+      __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  Status = LcdPlatformGetVram (&VidGopVramBase, &VidGopVramSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to get display memory, Status=%r\n",
+      __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  VidGopMode.MaxMode = LcdPlatformGetMaxMode ();
+  Status = VidGopApplyMode (0);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &ImageHandle,
+                  &gEfiGraphicsOutputProtocolGuid,
+                  &VidGop,
+                  &gEfiDevicePathProtocolGuid,
+                  &VidDevicePath,
+                  NULL
+                );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to install protocol, Status=%r\n",
+      __FUNCTION__, Status));
+    iMXBltFree (&VidGopBltContext);
+  }
+
+Exit:
+  return Status;
+}
+
+EFI_STATUS
+EFIAPI
+VidGopQueryMode (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL *This,
+  IN  UINT32 ModeNumber,
+  OUT UINTN *SizeOfInfo,
+  OUT EFI_GRAPHICS_OUTPUT_MODE_INFORMATION **Info
+  )
+{
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  *OutputMode;
+  EFI_STATUS                            Status;
+
+  if ((SizeOfInfo == NULL) || (Info == NULL) ||
+      (ModeNumber >= VidGopMode.MaxMode)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OutputMode = AllocatePool (sizeof (EFI_GRAPHICS_OUTPUT_MODE_INFORMATION));
+  if (OutputMode == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = LcdPlatformQueryMode (ModeNumber, OutputMode);
+  if (EFI_ERROR (Status)) {
+    FreePool (OutputMode);
+    return Status;
+  }
+
+  *SizeOfInfo = sizeof (EFI_GRAPHICS_OUTPUT_MODE_INFORMATION);
+  *Info = OutputMode;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+VidGopSetMode (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL   *This,
+  IN UINT32                         ModeNumber
+  )
+{
+  if (ModeNumber >= VidGopMode.MaxMode) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (VidGopApplyMode (ModeNumber))) {
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+VidGopBlt (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL       *This,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer, OPTIONAL
+  IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN UINTN                              SourceX,
+  IN UINTN                              SourceY,
+  IN UINTN                              DestinationX,
+  IN UINTN                              DestinationY,
+  IN UINTN                              Width,
+  IN UINTN                              Height,
+  IN UINTN                              Delta OPTIONAL
+  )
+{
+  return iMXBlt (
+           &VidGopBltContext,
+           BltBuffer,
+           BltOperation,
+           SourceX,
+           SourceY,
+           DestinationX,
+           DestinationY,
+           Width,
+           Height,
+           Delta
+         );
+}
@@ -65,16 +65,30 @@ LcdPlatformGetVram (
   OUT UINTN                 * VramSize
   )
 {
-  EFI_STATUS      Status = EFI_SUCCESS;
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  ModeInfo;
+  UINT32                                ModeNumber;
+  UINTN                                 Size;
+  EFI_STATUS                            Status = EFI_SUCCESS;
 
   ASSERT (VramBaseAddress != NULL);
   ASSERT (VramSize != NULL);
 
-  // Set the VRAM size.
-  *VramSize = HD720_H_RES_PIXELS * HD720_V_RES_PIXELS * 4;
-  ASSERT (*VramSize <= FixedPcdGet64 (PcdArmLcdDdrFrameBufferSize));
+  // Set the VRAM size to the largest mode, 32 bits per pixel.
+  *VramSize = 0;
+  for (ModeNumber = 0; ModeNumber < LcdPlatformGetMaxMode (); ModeNumber++) {
+    Status = LcdPlatformQueryMode (ModeNumber, &ModeInfo);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    Size = ModeInfo.PixelsPerScanLine * ModeInfo.VerticalResolution * 4;
+    if (Size > *VramSize) {
+      *VramSize = Size;
+    }
+  }
 
-  // TODO: Pull frame buffer from global memory block
+  // The boot loader programs the display controller to scan out of the
+  // fixed frame buffer, LcdPlatformSetMode does not move it.
+  ASSERT (*VramSize <= FixedPcdGet64 (PcdArmLcdDdrFrameBufferSize));
   *VramBaseAddress =
      (EFI_PHYSICAL_ADDRESS)FixedPcdGet64 (PcdArmLcdDdrFrameBufferBase);
 
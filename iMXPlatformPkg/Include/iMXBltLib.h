@@ -0,0 +1,211 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _IMX_BLT_LIB_H_
+#define _IMX_BLT_LIB_H_
+
+#include <Protocol/GraphicsOutput.h>
+
+// Draw into a cached shadow copy of the frame buffer and copy the changed
+// rectangles to the frame buffer from a timer event
+#define IMX_BLT_FLAG_SHADOW                 0x00000001
+
+// The frame buffer is mapped cacheable, clean every rectangle written to it
+#define IMX_BLT_FLAG_CLEAN_FRAME_BUFFER     0x00000002
+
+// Number of separate dirty rectangles tracked before they are merged
+#define IMX_BLT_DIRTY_RECTANGLE_COUNT       8
+
+typedef struct {
+  UINTN X;
+  UINTN Y;
+  UINTN Width;
+  UINTN Height;
+} IMX_BLT_RECTANGLE;
+
+/**
+  Move the scanout of the display controller within the frame buffer.
+
+  @param[in]  Context   Context passed to iMXBltEnableScroll.
+  @param[in]  Offset    Offset of the first visible line from the start of
+                        the frame buffer in bytes.
+
+**/
+typedef
+VOID
+(EFIAPI *IMX_BLT_SET_SCANOUT) (
+  IN  VOID    *Context,
+  IN  UINTN   Offset
+  );
+
+//
+// State of a 32 bits per pixel frame buffer. Only accessed through the
+// functions below.
+//
+typedef struct {
+  UINT32              *FrameBuffer;
+  UINT32              *ShadowBuffer;
+  UINT32              Width;
+  UINT32              Height;
+  UINT32              PixelsPerScanLine;
+  UINT32              Flags;
+  BOOLEAN             ExitBootServices;
+  EFI_EVENT           FlushEvent;
+  EFI_EVENT           ExitBootServicesEvent;
+  UINT32              DirtyCount;
+  IMX_BLT_RECTANGLE   Dirty[IMX_BLT_DIRTY_RECTANGLE_COUNT];
+  UINT32              BufferHeight;
+  UINT32              ScanoutRow;
+  IMX_BLT_SET_SCANOUT SetScanout;
+  VOID                *SetScanoutContext;
+} IMX_BLT_CONTEXT;
+
+/**
+  Initialize a Blt context for a frame buffer.
+
+  If IMX_BLT_FLAG_SHADOW is requested but the shadow buffer can not be set
+  up, the context falls back to drawing into the frame buffer directly.
+
+  @param[out] Context             Blt context to initialize.
+  @param[in]  FrameBuffer         Base of the 32 bits per pixel frame buffer.
+  @param[in]  Width               Horizontal resolution in pixels.
+  @param[in]  Height              Vertical resolution in pixels.
+  @param[in]  PixelsPerScanLine   Pitch of the frame buffer in pixels.
+  @param[in]  Flags               IMX_BLT_FLAG_* options.
+
+  @retval EFI_SUCCESS             The context was initialized.
+  @retval EFI_INVALID_PARAMETER   The frame buffer geometry is invalid.
+
+**/
+EFI_STATUS
+iMXBltInitialize (
+  OUT IMX_BLT_CONTEXT   *Context,
+  IN  VOID              *FrameBuffer,
+  IN  UINT32            Width,
+  IN  UINT32            Height,
+  IN  UINT32            PixelsPerScanLine,
+  IN  UINT32            Flags
+  );
+
+/**
+  Scroll by moving the scanout address instead of copying the screen.
+
+  The frame buffer must hold more lines than the visible height. Full width
+  EfiBltVideoToVideo operations moving lines up then advance the visible
+  window through the frame buffer and only copy the lines outside of the
+  moved rectangle. When the window reaches the end of the frame buffer it
+  is copied back to the start. At ExitBootServices the window is moved back
+  to the start of the frame buffer.
+
+  While scrolled, the visible image does not start at the frame buffer base,
+  so nothing may write the frame buffer without going through iMXBlt.
+
+  @param[in]  Context             Initialized Blt context.
+  @param[in]  BufferHeight        Number of lines the frame buffer can hold.
+  @param[in]  SetScanout          Function moving the scanout address.
+  @param[in]  SetScanoutContext   Context passed to SetScanout.
+
+  @retval EFI_SUCCESS             Scrolling through the scanout address is on.
+  @retval EFI_BUFFER_TOO_SMALL    The frame buffer has no spare lines.
+  @retval Others                  The ExitBootServices event could not be
+                                  created.
+
+**/
+EFI_STATUS
+iMXBltEnableScroll (
+  IN  IMX_BLT_CONTEXT       *Context,
+  IN  UINT32                BufferHeight,
+  IN  IMX_BLT_SET_SCANOUT   SetScanout,
+  IN  VOID                  *SetScanoutContext
+  );
+
+/**
+  Perform an EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt operation on a Blt context.
+
+  The parameters follow EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt. Rectangles reaching
+  past the right or bottom edge of the frame are clipped to it.
+
+  @retval EFI_SUCCESS             The operation was performed.
+  @retval EFI_INVALID_PARAMETER   BltOperation is not valid, BltBuffer is
+                                  missing, the rectangle is empty, Delta is
+                                  smaller than a line of the rectangle or a
+                                  rectangle starts outside the frame.
+
+**/
+EFI_STATUS
+iMXBlt (
+  IN     IMX_BLT_CONTEXT                    *Context,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer, OPTIONAL
+  IN     EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN     UINTN                              SourceX,
+  IN     UINTN                              SourceY,
+  IN     UINTN                              DestinationX,
+  IN     UINTN                              DestinationY,
+  IN     UINTN                              Width,
+  IN     UINTN                              Height,
+  IN     UINTN                              Delta OPTIONAL
+  );
+
+/**
+  Exchange the frame buffers of two Blt contexts.
+
+  Both contexts are flushed, then swap their frame buffers together with
+  their shadow buffers, so each context keeps a shadow matching its new
+  frame buffer. Used to page flip between a visible and an off-screen
+  surface.
+
+  @param[in]  First               Blt context.
+  @param[in]  Second              Blt context of the same geometry and
+                                  shadow setting as First.
+
+  @retval EFI_SUCCESS             The frame buffers were exchanged.
+  @retval EFI_INVALID_PARAMETER   The contexts do not match.
+  @retval EFI_UNSUPPORTED         A context scrolls through the scanout
+                                  address or boot services were exited.
+
+**/
+EFI_STATUS
+iMXBltSwap (
+  IN  IMX_BLT_CONTEXT   *First,
+  IN  IMX_BLT_CONTEXT   *Second
+  );
+
+/**
+  Copy all pending changes from the shadow buffer to the frame buffer.
+
+  Does nothing for contexts without a shadow buffer.
+
+  @param[in]  Context             Blt context to flush.
+
+**/
+VOID
+iMXBltFlush (
+  IN  IMX_BLT_CONTEXT   *Context
+  );
+
+/**
+  Release the shadow buffer and events of a Blt context.
+
+  Pending changes are dropped, the frame buffer is left as it is. The
+  context can be initialized again afterwards, e.g. for a new mode.
+
+  @param[in]  Context             Blt context to release.
+
+**/
+VOID
+iMXBltFree (
+  IN  IMX_BLT_CONTEXT   *Context
+  );
+
+#endif // _IMX_BLT_LIB_H_
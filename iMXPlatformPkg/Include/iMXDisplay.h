@@ -18,6 +18,14 @@
 #define IMX_EDID_MIN_SIZE       128
 #define IMX_EDID_I2C_ADDRESS    0x50
 
+// Every EDID block has the size of the base block. Without a segment
+// pointer only the base block and the first extension block are addressable.
+#define IMX_EDID_BLOCK_SIZE     IMX_EDID_MIN_SIZE
+#define IMX_EDID_MAX_SIZE       (2 * IMX_EDID_BLOCK_SIZE)
+
+// Number of extension blocks following the base block
+#define IMX_EDID_EXTENSION_COUNT_OFFSET 0x7E
+
 // The first DTD is the preferred timing, refer to 3.1 VESA EDID spec.
 #define IMX_EDID_DTD_1_OFFSET   0x36
 #define IMX_EDID_DTD_2_OFFSET   0x48
@@ -113,4 +121,63 @@ ImxValidateEdidData (
   IN UINT8 *EdidDataPtr
   );
 
+/**
+  Check if an EDID extension block is valid
+
+  @param[in]    BlockPtr  Pointer to the extension block.
+
+  @retval   EFI_SUCCESS             The block checksum is valid.
+  @retval   EFI_INVALID_PARAMETER   The block checksum is invalid.
+
+**/
+EFI_STATUS
+ImxValidateEdidBlock (
+  IN UINT8 *BlockPtr
+  );
+
+/**
+  Get the size of an EDID including its extension blocks
+
+  @param[in]    EdidDataPtr  Pointer to a valid EDID base block.
+
+  @retval   Size of the base block and the extension blocks it announces,
+            limited to IMX_EDID_MAX_SIZE.
+
+**/
+UINT32
+ImxGetEdidSize (
+  IN UINT8 *EdidDataPtr
+  );
+
+/**
+  Collect the timings an EDID advertises, best first
+
+  Timings are ranked as follows:
+  1. The preferred timing, the first detailed timing of the base block.
+  2. CEA-861 short video descriptors marked as native.
+  3. The remaining detailed timings of the base and CEA-861 blocks.
+  4. The remaining CEA-861 short video descriptors, in EDID order.
+  5. Standard timings matching a 60Hz VESA DMT timing.
+  Short video descriptors and standard timings without a known timing are
+  skipped. Each resolution and pixel clock is only returned once.
+
+  @param[in]    EdidDataPtr     Pointer to EDID data.
+  @param[in]    EdidDataSize    Size of the EDID data.
+  @param[out]   ModeListPtr     Array receiving the timings.
+  @param[in]    MaxModeCount    Number of entries in ModeListPtr.
+  @param[out]   ModeCountPtr    Number of timings returned.
+
+  @retval   EFI_SUCCESS             The timings were collected.
+  @retval   EFI_INVALID_PARAMETER   EDID data is too small.
+
+**/
+EFI_STATUS
+ImxGetEdidModes (
+  IN UINT8                *EdidDataPtr,
+  IN UINT32               EdidDataSize,
+  OUT IMX_DISPLAY_TIMING  *ModeListPtr,
+  IN UINT32               MaxModeCount,
+  OUT UINT32              *ModeCountPtr
+  );
+
 #endif // __IMX_DISPLAY_H__
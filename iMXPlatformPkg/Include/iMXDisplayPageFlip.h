@@ -0,0 +1,78 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _IMX_DISPLAY_PAGE_FLIP_H_
+#define _IMX_DISPLAY_PAGE_FLIP_H_
+
+#include <Protocol/GraphicsOutput.h>
+
+//
+// Off-screen drawing for boot UI code. The protocol is installed on the
+// handle of the GraphicsOutput protocol it belongs to, under
+// giMXDisplayPageFlipProtocolGuid.
+//
+typedef struct _IMX_DISPLAY_PAGE_FLIP_PROTOCOL IMX_DISPLAY_PAGE_FLIP_PROTOCOL;
+
+/**
+  Draw into the back buffer.
+
+  The parameters follow EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt, with "video"
+  referring to the back buffer instead of the visible screen.
+
+  @retval EFI_SUCCESS             The operation was performed.
+  @retval EFI_INVALID_PARAMETER   BltOperation is not valid.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IMX_DISPLAY_PAGE_FLIP_BLT) (
+  IN     IMX_DISPLAY_PAGE_FLIP_PROTOCOL     *This,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer, OPTIONAL
+  IN     EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN     UINTN                              SourceX,
+  IN     UINTN                              SourceY,
+  IN     UINTN                              DestinationX,
+  IN     UINTN                              DestinationY,
+  IN     UINTN                              Width,
+  IN     UINTN                              Height,
+  IN     UINTN                              Delta OPTIONAL
+  );
+
+/**
+  Show the back buffer at the next vertical blank.
+
+  Returns once the display controller scans out the new frame. Afterwards
+  the back buffer holds the previously visible frame, and GraphicsOutput
+  Blt draws on the newly visible one.
+
+  @retval EFI_SUCCESS             The back buffer is visible.
+  @retval EFI_TIMEOUT             The display controller did not switch
+                                  buffers within a few frames.
+  @retval EFI_UNSUPPORTED         Boot services have been exited.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IMX_DISPLAY_PAGE_FLIP_PRESENT) (
+  IN  IMX_DISPLAY_PAGE_FLIP_PROTOCOL  *This
+  );
+
+struct _IMX_DISPLAY_PAGE_FLIP_PROTOCOL {
+  IMX_DISPLAY_PAGE_FLIP_BLT       Blt;
+  IMX_DISPLAY_PAGE_FLIP_PRESENT   Present;
+};
+
+extern EFI_GUID giMXDisplayPageFlipProtocolGuid;
+
+#endif // _IMX_DISPLAY_PAGE_FLIP_H_
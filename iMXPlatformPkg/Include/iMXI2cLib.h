@@ -42,6 +42,25 @@
 #define IMX_I2C_TX 0
 #define IMX_I2C_RX 1
 
+#define IMX_I2C_REGISTER_ADDRESS_8BIT   1
+#define IMX_I2C_REGISTER_ADDRESS_16BIT  2
+
+// Maximum number of data bytes in a SMBus block transfer
+#define IMX_I2C_SMBUS_BLOCK_MAX       32
+
+// Delay between address attempts while ACK polling an EEPROM write cycle
+#define IMX_I2C_ACK_POLL_INTERVAL_US  100
+
+// Number of most recent transfers kept in the trace ring of a controller
+#define IMX_I2C_TRACE_ENTRY_COUNT     32
+
+// Number of controllers that can be traced at the same time
+#define IMX_I2C_TRACE_CONTROLLER_COUNT  4
+
+// Latency histogram bucket N counts transfers that took less than 2^N us,
+// the last bucket also counts everything slower.
+#define IMX_I2C_LATENCY_BUCKET_COUNT  16
+
 typedef union {
   UINT16 Raw;
   struct {
@@ -131,6 +150,77 @@ typedef struct {
   UINT32 I2cClockRate;
 } IMX_I2C_DIVIDER;
 
+typedef enum {
+  ImxI2cRequestRead,
+  ImxI2cRequestWrite,
+} IMX_I2C_REQUEST_TYPE;
+
+typedef struct {
+  IMX_I2C_CONTEXT *I2cContext;
+  IMX_I2C_REQUEST_TYPE Type;
+  UINT16 RegisterAddress;
+  UINT32 RegisterAddressSize;
+  UINT8 *Buffer;
+  UINT32 BufferSize;
+  RETURN_STATUS Status;
+} IMX_I2C_REQUEST;
+
+typedef struct {
+  UINT64 DurationInNs;
+  RETURN_STATUS Status;
+  UINT32 Length;
+  UINT16 RegisterAddress;
+  UINT8 SlaveAddress;
+  UINT8 Type;
+} IMX_I2C_TRACE_ENTRY;
+
+typedef struct _IMX_I2C_BATCH IMX_I2C_BATCH;
+
+//
+// A batch of requests submitted to a shared bus. The bus owns the batch from
+// submission until Done is set. When the submission was deferred the batch is
+// performed later by the client that currently owns the bus, so its storage,
+// the request list and the buffers must stay valid until then.
+//
+struct _IMX_I2C_BATCH {
+  IMX_I2C_BATCH *Next;
+  IMX_I2C_REQUEST *RequestList;
+  UINT32 RequestCount;
+  RETURN_STATUS Status;
+  volatile BOOLEAN Done;
+};
+
+//
+// Per controller owner object. Batches are queued on the pending list and
+// performed one at a time by the client draining the bus, so transfers of
+// different clients are never interleaved. The controller setup is kept
+// between requests as long as the controller registers still match the
+// request, which also catches direct iMXI2cRead/iMXI2cWrite calls on the
+// same controller.
+//
+typedef struct {
+  UINT32 ControllerAddress;
+  BOOLEAN Draining;
+  BOOLEAN Warm;
+  IMX_I2C_BATCH *PendingHead;
+  IMX_I2C_BATCH *PendingTail;
+  UINT64 TransactionCount;
+  UINT64 ByteCount;
+  UINT64 ErrorCount;
+  UINT64 ContentionCount;
+  UINT64 ConfigureCount;
+  UINT64 BusyTicks;
+} IMX_I2C_BUS;
+
+typedef struct {
+  UINT64 TransactionCount;
+  UINT64 ByteCount;
+  UINT64 ErrorCount;
+  UINT64 ContentionCount;
+  UINT64 ConfigureCount;
+  UINT64 BusyTimeInNs;
+} IMX_I2C_BUS_STATISTICS;
+
 /**
   Perform I2C read operation.
 
@@ -182,4 +272,294 @@ iMXI2cWrite (
   IN UINT32           WriteBufferSize
   );
 
+/**
+  Perform I2C EEPROM write operation.
+
+  The iMXI2cEepromWrite splits the write into transfers that do not cross the
+  EEPROM page boundary. After each page transfer, the device is ACK polled to
+  wait for the internal write cycle to complete instead of using a fixed delay.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted EEPROM address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+  @param[in]    PageSize          EEPROM page size in bytes.
+
+  @retval   RETURN_SUCCESS            I2C EEPROM write operation succeeded.
+  @retval   RETURN_INVALID_PARAMETER  PageSize is 0 or the write extends past
+                                      the end of the 8-bit address space.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+  @retval   RETURN_TIMEOUT            The EEPROM write cycle did not complete.
+
+**/
+RETURN_STATUS
+iMXI2cEepromWrite (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT8            RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize,
+  IN UINT32           PageSize
+  );
+
+/**
+  Perform I2C read operation on a device with 16-bit register addressing.
+
+  The register address is sent most significant byte first, followed by a
+  repeated start and the read, all within a single controller setup.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start read.
+  @param[out]   ReadBufferPtr     Caller supplied buffer that would be written
+                                  into with data from the read operation.
+  @param[in]    ReadBufferSize    Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Read operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cRead16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  OUT UINT8           *ReadBufferPtr,
+  IN UINT32           ReadBufferSize
+  );
+
+/**
+  Perform I2C write operation on a device with 16-bit register addressing.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Write operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cWrite16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize
+  );
+
+/**
+  Perform I2C EEPROM write operation on a device with 16-bit addressing.
+
+  Same as iMXI2cEepromWrite for EEPROMs larger than 256 bytes.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted EEPROM address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+  @param[in]    PageSize          EEPROM page size in bytes.
+
+  @retval   RETURN_SUCCESS            I2C EEPROM write operation succeeded.
+  @retval   RETURN_INVALID_PARAMETER  PageSize is 0 or the write extends past
+                                      the end of the 16-bit address space.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+  @retval   RETURN_TIMEOUT            The EEPROM write cycle did not complete.
+
+**/
+RETURN_STATUS
+iMXI2cEepromWrite16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize,
+  IN UINT32           PageSize
+  );
+
+/**
+  Perform SMBus block read operation.
+
+  The command is written and the block is read back after a repeated start
+  within a single controller setup. The byte count returned by the device is
+  used to terminate the transfer. When PEC is enabled, the trailing PEC byte
+  is read and checked against the CRC-8 of the whole transaction.
+
+  @param[in]      I2cContext      Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]      Command         SMBus command code.
+  @param[out]     BlockBuffer     Caller supplied buffer receiving the block
+                                  data, without the byte count and PEC.
+  @param[in,out]  BlockSize       On input, size of BlockBuffer. On output,
+                                  number of bytes returned by the device.
+  @param[in]      PecEnable       TRUE to read and check the PEC byte.
+
+  @retval   RETURN_SUCCESS            SMBus block read succeeded.
+  @retval   RETURN_BUFFER_TOO_SMALL   The device returned an invalid byte count
+                                      or more data than BlockBuffer can hold.
+  @retval   RETURN_CRC_ERROR          PEC check failed.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cSmbusBlockRead (
+  IN      IMX_I2C_CONTEXT   *I2cContext,
+  IN      UINT8             Command,
+  OUT     UINT8             *BlockBuffer,
+  IN OUT  UINT32            *BlockSize,
+  IN      BOOLEAN           PecEnable
+  );
+
+/**
+  Perform SMBus block write operation.
+
+  The command, byte count, block data and optionally the PEC byte are sent
+  within a single controller setup.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    Command           SMBus command code.
+  @param[in]    BlockBuffer       Caller supplied block data.
+  @param[in]    BlockSize         Number of bytes in BlockBuffer, 1 to 32.
+  @param[in]    PecEnable         TRUE to append the PEC byte.
+
+  @retval   RETURN_SUCCESS            SMBus block write succeeded.
+  @retval   RETURN_INVALID_PARAMETER  BlockSize is out of range.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cSmbusBlockWrite (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT8             Command,
+  IN  UINT8             *BlockBuffer,
+  IN  UINT32            BlockSize,
+  IN  BOOLEAN           PecEnable
+  );
+
+/**
+  Initialize an I2C bus owner object.
+
+  All clients sharing the I2C controller at ControllerAddress should submit
+  their transfers through the same bus object, so transfers are serialized
+  and the controller configuration can be kept between transfers.
+
+  @param[out]   I2cBus              Pointer to the bus object to initialize.
+  @param[in]    ControllerAddress   Base address of the I2C controller owned
+                                    by this bus object.
+
+**/
+VOID
+iMXI2cBusInitialize (
+  OUT IMX_I2C_BUS   *I2cBus,
+  IN  UINT32        ControllerAddress
+  );
+
+/**
+  Submit a batch of I2C requests to a shared I2C bus.
+
+  The requests of a batch are performed in order, and batches are performed
+  one at a time in submission order, so transfers from different clients are
+  never interleaved. The controller is only reconfigured when its registers do
+  not match the clock and controller slave address of the request.
+
+  When the bus is idle, the batch and any batch queued meanwhile are performed
+  before returning. When the caller preempted the client currently owning the
+  bus, for example from a timer event callback, waiting would never end as
+  the owner cannot resume. The batch is then queued and RETURN_NOT_READY is
+  returned; the owner performs it before releasing the bus and sets Done. The
+  caller must keep the batch, its requests and their buffers valid until Done
+  is set, and read the result from the Status fields.
+
+  The bus is protected by disabling interrupts, which serializes the UEFI
+  boot services environment as it runs on a single processor.
+
+  @param[in]      I2cBus          Pointer to the bus object owning the
+                                  controller.
+  @param[in,out]  Batch           Batch of requests to perform. The Status
+                                  field of the batch and of each request is
+                                  updated and Done is set on completion.
+
+  @retval   RETURN_SUCCESS            All requests succeeded.
+  @retval   RETURN_INVALID_PARAMETER  A request targets another controller,
+                                      the batch was not queued.
+  @retval   RETURN_NOT_READY          The bus is owned by a preempted client,
+                                      the batch is queued.
+  @retval   RETURN_DEVICE_ERROR       A request failed, remaining requests of
+                                      the batch were not performed.
+
+**/
+RETURN_STATUS
+iMXI2cBusSubmit (
+  IN      IMX_I2C_BUS     *I2cBus,
+  IN OUT  IMX_I2C_BATCH   *Batch
+  );
+
+/**
+  Retrieve the utilization counters of a shared I2C bus.
+
+  @param[in]    I2cBus        Pointer to the bus object.
+  @param[out]   Statistics    Caller supplied buffer receiving the counters.
+
+**/
+VOID
+iMXI2cBusGetStatistics (
+  IN  IMX_I2C_BUS             *I2cBus,
+  OUT IMX_I2C_BUS_STATISTICS  *Statistics
+  );
+
+/**
+  Print the transfer trace and latency histogram of a shared I2C bus.
+
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]    I2cBus        Pointer to the bus object.
+
+**/
+VOID
+iMXI2cBusDumpTrace (
+  IN  IMX_I2C_BUS   *I2cBus
+  );
+
+/**
+  Retrieve the most recent transfers made on an I2C controller.
+
+  Every transfer is recorded, whether it was submitted through a bus object
+  or made directly with the iMXI2cRead/iMXI2cWrite family of functions.
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]      ControllerAddress   Base address of the I2C controller.
+  @param[out]     TraceBuffer         Caller supplied buffer receiving the
+                                      entries, oldest first.
+  @param[in,out]  EntryCount          On input the number of entries
+                                      TraceBuffer can hold. On output the
+                                      number of entries returned.
+
+  @retval   RETURN_SUCCESS        The entries were returned.
+  @retval   RETURN_UNSUPPORTED    Tracing is disabled.
+  @retval   RETURN_NOT_FOUND      No transfer was recorded for the controller.
+
+**/
+RETURN_STATUS
+iMXI2cGetTrace (
+  IN      UINT32                ControllerAddress,
+  OUT     IMX_I2C_TRACE_ENTRY   *TraceBuffer,
+  IN OUT  UINT32                *EntryCount
+  );
+
+/**
+  Print the transfer trace and latency histogram of an I2C controller.
+
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]    ControllerAddress   Base address of the I2C controller.
+
+**/
+VOID
+iMXI2cDumpTrace (
+  IN  UINT32    ControllerAddress
+  );
+
 #endif
@@ -0,0 +1,37 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _IMX_MEMORY_LOG_H_
+#define _IMX_MEMORY_LOG_H_
+
+#define IMX_MEMORY_LOG_SIGNATURE    SIGNATURE_32 ('I', 'M', 'L', 'G')
+
+//
+// Firmware debug log published as the giMXMemoryLogGuid configuration table.
+// The log is a ring of Size bytes of ASCII text following the header, placed
+// in EfiRuntimeServicesData so it is preserved for the OS. Head is the offset
+// of the next byte to be written. Once TotalLength exceeds Size the oldest
+// text has been overwritten and the log starts at Head.
+//
+typedef struct {
+  UINT32 Signature;
+  UINT32 Size;
+  UINT32 Head;
+  UINT32 Reserved;
+  UINT64 TotalLength;
+} IMX_MEMORY_LOG;
+
+#define IMX_MEMORY_LOG_DATA(Log)    ((CHAR8 *)((Log) + 1))
+
+#endif // _IMX_MEMORY_LOG_H_
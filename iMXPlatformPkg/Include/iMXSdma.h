@@ -0,0 +1,138 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _IMXSDMA_H_
+#define _IMXSDMA_H_
+
+// Number of SDMA channels and DMA request events
+enum {
+  IMX_SDMA_CHANNEL_COUNT = 32,
+  IMX_SDMA_EVENT_COUNT = 48
+};
+
+// SDMA Configuration Register bit definitions
+enum IMX_SDMA_CONFIG {
+  IMX_SDMA_CONFIG_CSM_STATIC =    (0 << 0),
+  IMX_SDMA_CONFIG_CSM_DYNAMIC =   (3 << 0),
+  IMX_SDMA_CONFIG_ACR =           (1 << 4),
+};
+
+// SDMA Channel 0 Boot Address Register bit definitions
+enum IMX_SDMA_CHN0ADDR {
+  IMX_SDMA_CHN0ADDR_BOOT =        (0x50 << 0),
+  IMX_SDMA_CHN0ADDR_SMSZ =        (1 << 14),
+};
+
+// Highest SDMA channel priority, a channel of priority 0 never runs
+enum {
+  IMX_SDMA_PRIORITY_MAX = 7
+};
+
+// Buffer descriptor status bit definitions
+enum IMX_SDMA_BD_STATUS {
+  IMX_SDMA_BD_DONE =              (1 << 0),
+  IMX_SDMA_BD_WRAP =              (1 << 1),
+  IMX_SDMA_BD_CONT =              (1 << 2),
+  IMX_SDMA_BD_INTR =              (1 << 3),
+  IMX_SDMA_BD_ERROR =             (1 << 4),
+  IMX_SDMA_BD_LAST =              (1 << 5),
+  IMX_SDMA_BD_EXTD =              (1 << 7),
+};
+
+// Buffer descriptor commands. Peripheral scripts take the transfer width,
+// channel 0 takes a command to the SDMA core.
+enum IMX_SDMA_BD_COMMAND {
+  IMX_SDMA_BD_COMMAND_WIDTH_32 =  0x00,
+  IMX_SDMA_BD_COMMAND_WIDTH_8 =   0x01,
+  IMX_SDMA_BD_COMMAND_WIDTH_16 =  0x02,
+  IMX_SDMA_BD_COMMAND_SETDM =     0x01,
+};
+
+// Channel contexts live in SDMA data memory, 32 words per channel once
+// CHN0ADDR.SMSZ is set
+#define IMX_SDMA_CONTEXT_ADDRESS(Channel)   (2048 + 32 * (Channel))
+
+typedef struct {
+  UINT16 Count;                // Bytes to transfer, bytes transferred once done
+  UINT8 Status;                // IMX_SDMA_BD_STATUS
+  UINT8 Command;               // IMX_SDMA_BD_COMMAND
+  UINT32 BufferAddress;
+  UINT32 ExtBufferAddress;
+} IMX_SDMA_BUFFER_DESCRIPTOR;
+
+//
+// Channel control block. MC0PTR points to an array of IMX_SDMA_CHANNEL_COUNT
+// blocks, the SDMA loads the buffer descriptor pointers of a channel from it
+// when the channel starts.
+//
+typedef struct {
+  UINT32 CurrentBdPointer;
+  UINT32 BaseBdPointer;
+  UINT32 Reserved[2];
+} IMX_SDMA_CHANNEL_CONTROL;
+
+//
+// Channel context loaded through channel 0. ChannelState[0] holds the program
+// counter in its low 14 bits. The ROM peripheral scripts take the event mask
+// of events 32 to 63 in GeneralRegister[0], of events 0 to 31 in
+// GeneralRegister[1], the peripheral FIFO address in GeneralRegister[2] and
+// the burst size in GeneralRegister[7].
+//
+typedef struct {
+  UINT32 ChannelState[2];
+  UINT32 GeneralRegister[8];
+  UINT32 Mda;
+  UINT32 Msa;
+  UINT32 Ms;
+  UINT32 Md;
+  UINT32 Pda;
+  UINT32 Psa;
+  UINT32 Ps;
+  UINT32 Pd;
+  UINT32 Ca;
+  UINT32 Cs;
+  UINT32 Dda;
+  UINT32 Dsa;
+  UINT32 Ds;
+  UINT32 Dd;
+  UINT32 Scratch[8];
+} IMX_SDMA_CONTEXT;
+
+#define IMX_SDMA_CONTEXT_PC_MASK      0x3FFF
+
+typedef struct _IMX_SDMA_REGISTERS {
+  UINT32 Mc0Ptr;               // 0x000: ARM platform Channel 0 Pointer
+  UINT32 Intr;                 // 0x004: Channel Interrupts, write 1 to clear
+  UINT32 StopStat;             // 0x008: Channel Stop/Channel Status
+  UINT32 HStart;               // 0x00C: Channel Start
+  UINT32 EvtOvr;               // 0x010: Channel Event Override
+  UINT32 DspOvr;               // 0x014: Channel BP Override
+  UINT32 HostOvr;              // 0x018: Channel ARM platform Override
+  UINT32 EvtPend;              // 0x01C: Channel Event Pending
+  UINT32 reserved1;
+  UINT32 Reset;                // 0x024: Reset Register
+  UINT32 EvtErr;               // 0x028: DMA Request Error Register
+  UINT32 IntrMask;             // 0x02C: Channel ARM platform Interrupt Mask
+  UINT32 Psw;                  // 0x030: Schedule Status
+  UINT32 EvtErrDbg;            // 0x034: DMA Request Error Register
+  UINT32 Config;               // 0x038: Configuration Register
+  UINT32 reserved2[8];
+  UINT32 Chn0Addr;             // 0x05C: Channel 0 Boot Address
+  UINT32 reserved3[40];
+  UINT32 ChnPri[IMX_SDMA_CHANNEL_COUNT];  // 0x100: Channel Priority Registers
+  UINT32 reserved4[32];
+  UINT32 ChnEnbl[IMX_SDMA_EVENT_COUNT];   // 0x200: Channel Enable RAM, one word per event
+} IMX_SDMA_REGISTERS;
+
+#endif // _IMXSDMA_H_
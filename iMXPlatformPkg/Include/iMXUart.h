@@ -182,6 +182,17 @@ enum {
   MX6UART_FIFO_COUNT = 32
 };
 
+// UFCR.TXTL values below 2 are reserved
+enum {
+  MX6UART_TX_WATERMARK_MIN = 2
+};
+
+// RX FIFO level at which CTS_B is deasserted under hardware flow control,
+// leaving room for characters the peer sends before it reacts
+enum {
+  MX6UART_CTS_TRIGGER_LEVEL = 16
+};
+
 typedef struct _MX6UART_REGISTERS {
   UINT32 Rxd;                  // 0x00: UART Receiver Register
   UINT32 reserved1[15];
@@ -204,4 +215,24 @@ typedef struct _MX6UART_REGISTERS {
   UINT32 Umcr;                 // 0xB8: UART RS-485 Mode Control Register
 } MX6UART_REGISTERS;
 
+#define IMX_UART_RX_RING_SIGNATURE    SIGNATURE_32 ('U', 'R', 'X', 'R')
+
+//
+// Receive ring published by the DXE SerialPortLib under
+// giMXSerialRxRingProtocolGuid and shared by all modules linking it. The
+// module that installs the ring owns the timer filling it, Serviced is
+// cleared once that timer stopped. OverrunCount counts receive FIFO
+// overruns, ErrorCount counts framing, parity and break conditions. The
+// ring data follows the header.
+//
+typedef struct {
+  UINT32 Signature;
+  UINT32 Size;
+  UINT32 Head;
+  UINT32 Tail;
+  UINT32 OverrunCount;
+  UINT32 ErrorCount;
+  BOOLEAN Serviced;
+} IMX_UART_RX_RING;
+
 #endif // _IMXUART_H_
@@ -0,0 +1,467 @@
+/** @file
+
+  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DebugPrintErrorLevelLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <iMXMemoryLog.h>
+
+// Maximum length of a single formatted debug message
+#define MAX_DEBUG_MESSAGE_LENGTH  0x100
+
+// VA_LIST can not initialize to NULL for all compilers, so use this global
+// variable as a placeholder when the BASE_LIST variant is used
+STATIC VA_LIST    mVaListNull;
+
+STATIC IMX_MEMORY_LOG   *mMemoryLog;
+STATIC EFI_EVENT        mExitBootServicesEvent;
+STATIC BOOLEAN          mExitBootServices;
+
+/**
+  Append a message to the memory log, overwriting the oldest text once the
+  log is full.
+
+  @param  Buffer    The message to append.
+  @param  Length    Length of the message in bytes.
+
+**/
+STATIC
+VOID
+MemoryLogAppend (
+  IN  CONST CHAR8   *Buffer,
+  IN  UINTN         Length
+  )
+{
+  UINTN     Count;
+  EFI_TPL   OldTpl;
+
+  if ((mMemoryLog == NULL) || (Length == 0)) {
+    return;
+  }
+
+  // Boot services can not be used once the OS has taken over
+  OldTpl = TPL_APPLICATION;
+  if (!mExitBootServices) {
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  }
+
+  mMemoryLog->TotalLength += Length;
+  if (Length > mMemoryLog->Size) {
+    Buffer += Length - mMemoryLog->Size;
+    Length = mMemoryLog->Size;
+  }
+
+  while (Length > 0) {
+    Count = MIN (Length, mMemoryLog->Size - mMemoryLog->Head);
+    CopyMem (IMX_MEMORY_LOG_DATA (mMemoryLog) + mMemoryLog->Head, Buffer, Count);
+    mMemoryLog->Head = (UINT32)((mMemoryLog->Head + Count) % mMemoryLog->Size);
+    Buffer += Count;
+    Length -= Count;
+  }
+
+  if (!mExitBootServices) {
+    gBS->RestoreTPL (OldTpl);
+  }
+}
+
+/**
+  Worker function that formats a debug message and sends it to the memory
+  log and, if the error level is enabled for it, to the serial port.
+
+  @param  ErrorLevel        The error level of the debug message.
+  @param  Format            Format string for the debug message to print.
+  @param  VaListMarker      VA_LIST marker for the variable argument list.
+  @param  BaseListMarker    BASE_LIST marker for the variable argument list.
+
+**/
+STATIC
+VOID
+DebugPrintMarker (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  IN  VA_LIST       VaListMarker,
+  IN  BASE_LIST     BaseListMarker
+  )
+{
+  CHAR8   Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN   Length;
+
+  ASSERT (Format != NULL);
+
+  // Everything enabled by PcdDebugPrintErrorLevel goes to the memory log
+  if ((ErrorLevel & GetDebugPrintErrorLevel ()) == 0) {
+    return;
+  }
+
+  if (BaseListMarker == NULL) {
+    Length = AsciiVSPrint (Buffer, sizeof (Buffer), Format, VaListMarker);
+  } else {
+    Length = AsciiBSPrint (Buffer, sizeof (Buffer), Format, BaseListMarker);
+  }
+
+  MemoryLogAppend (Buffer, Length);
+
+  // Only the levels selected for the UART pay for the serial output
+  if ((ErrorLevel & FixedPcdGet32 (PcdMemoryLogSerialErrorLevel)) != 0) {
+    SerialPortWrite ((UINT8 *)Buffer, Length);
+  }
+}
+
+/**
+  Prints a debug message to the debug output device if the specified error level is enabled.
+
+  If any bit in ErrorLevel is also set in DebugPrintErrorLevelLib function
+  GetDebugPrintErrorLevel (), then print the message specified by Format and the
+  associated variable argument list to the debug output device.
+
+  If Format is NULL, then ASSERT().
+
+  @param  ErrorLevel  The error level of the debug message.
+  @param  Format      Format string for the debug message to print.
+  @param  ...         Variable argument list whose contents are accessed
+                      based on the format string specified by Format.
+
+**/
+VOID
+EFIAPI
+DebugPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  ...
+  )
+{
+  VA_LIST   Marker;
+
+  VA_START (Marker, Format);
+  DebugVPrint (ErrorLevel, Format, Marker);
+  VA_END (Marker);
+}
+
+/**
+  Prints a debug message to the debug output device if the specified
+  error level is enabled.
+
+  @param  ErrorLevel    The error level of the debug message.
+  @param  Format        Format string for the debug message to print.
+  @param  VaListMarker  VA_LIST marker for the variable argument list.
+
+**/
+VOID
+EFIAPI
+DebugVPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  IN  VA_LIST       VaListMarker
+  )
+{
+  DebugPrintMarker (ErrorLevel, Format, VaListMarker, NULL);
+}
+
+/**
+  Prints a debug message to the debug output device if the specified
+  error level is enabled.
+
+  @param  ErrorLevel      The error level of the debug message.
+  @param  Format          Format string for the debug message to print.
+  @param  BaseListMarker  BASE_LIST marker for the variable argument list.
+
+**/
+VOID
+EFIAPI
+DebugBPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  IN  BASE_LIST     BaseListMarker
+  )
+{
+  DebugPrintMarker (ErrorLevel, Format, mVaListNull, BaseListMarker);
+}
+
+/**
+  Prints an assert message containing a filename, line number, and description.
+  This may be followed by a breakpoint or a dead loop.
+
+  The assert message always goes to both the memory log and the serial port.
+  It is written at TPL_HIGH_LEVEL so a buffered serial port sends it, and
+  any output queued before it, before the breakpoint or dead loop.
+
+  @param  FileName     The pointer to the name of the source file that generated the assert condition.
+  @param  LineNumber   The line number in the source file that generated the assert condition
+  @param  Description  The pointer to the description of the assert condition.
+
+**/
+VOID
+EFIAPI
+DebugAssert (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  )
+{
+  CHAR8     Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN     Length;
+  EFI_TPL   OldTpl;
+
+  Length = AsciiSPrint (Buffer,
+                        sizeof (Buffer),
+                        "ASSERT [%a] %a(%d): %a\n",
+                        gEfiCallerBaseName,
+                        FileName,
+                        LineNumber,
+                        Description);
+
+  MemoryLogAppend (Buffer, Length);
+
+  OldTpl = TPL_APPLICATION;
+  if (!mExitBootServices) {
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  }
+
+  SerialPortWrite ((UINT8 *)Buffer, Length);
+
+  if (!mExitBootServices) {
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if ((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_ASSERT_BREAKPOINT_ENABLED) != 0) {
+    CpuBreakpoint ();
+  } else if ((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_ASSERT_DEADLOOP_ENABLED) != 0) {
+    CpuDeadLoop ();
+  }
+}
+
+/**
+  Fills a target buffer with PcdDebugClearMemoryValue, and returns the target buffer.
+
+  If Buffer is NULL, then ASSERT().
+  If Length is greater than (MAX_ADDRESS - Buffer + 1), then ASSERT().
+
+  @param   Buffer  The pointer to the target buffer to be filled with PcdDebugClearMemoryValue.
+  @param   Length  The number of bytes in Buffer to fill with zeros PcdDebugClearMemoryValue.
+
+  @return  Buffer  The pointer to the target buffer filled with PcdDebugClearMemoryValue.
+
+**/
+VOID *
+EFIAPI
+DebugClearMemory (
+  OUT VOID  *Buffer,
+  IN  UINTN Length
+  )
+{
+  ASSERT (Buffer != NULL);
+
+  return SetMem (Buffer, Length, PcdGet8 (PcdDebugClearMemoryValue));
+}
+
+/**
+  Returns TRUE if ASSERT() macros are enabled.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED bit of PcdDebugProperyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED bit of PcdDebugProperyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugAssertEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG() macros are enabled.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_PRINT_ENABLED bit of PcdDebugProperyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_PRINT_ENABLED bit of PcdDebugProperyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugPrintEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_PRINT_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG_CODE() macros are enabled.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_CODE_ENABLED bit of PcdDebugProperyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_CODE_ENABLED bit of PcdDebugProperyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugCodeEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_CODE_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG_CLEAR_MEMORY() macro is enabled.
+
+  @retval  TRUE    The DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED bit of PcdDebugProperyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED bit of PcdDebugProperyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugClearMemoryEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if any one of the bit is set both in ErrorLevel and PcdFixedDebugPrintErrorLevel.
+
+  @param  ErrorLevel    The error level to check.
+
+  @retval  TRUE    Current ErrorLevel is supported.
+  @retval  FALSE   Current ErrorLevel is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+DebugPrintLevelEnabled (
+  IN  CONST UINTN   ErrorLevel
+  )
+{
+  return (BOOLEAN)((ErrorLevel & PcdGet32 (PcdFixedDebugPrintErrorLevel)) != 0);
+}
+
+STATIC
+VOID
+EFIAPI
+ExitBootServicesNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  // The log is runtime data and stays valid, only stop raising the TPL
+  mExitBootServices = TRUE;
+}
+
+/**
+  Locate the memory log published by a previously loaded module, or
+  allocate and publish it as a configuration table.
+
+  Failures are not fatal, messages then only go to the serial port.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The constructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeMemoryLogDebugLibConstructor (
+  IN  EFI_HANDLE          ImageHandle,
+  IN  EFI_SYSTEM_TABLE    *SystemTable
+  )
+{
+  EFI_PHYSICAL_ADDRESS    Address;
+  UINTN                   Index;
+  IMX_MEMORY_LOG          *Log;
+  EFI_STATUS              Status;
+
+  SerialPortInitialize ();
+
+  // UefiLib depends on DebugLib, so the table is looked up by hand
+  Log = NULL;
+  for (Index = 0; Index < SystemTable->NumberOfTableEntries; Index++) {
+    if (CompareGuid (&SystemTable->ConfigurationTable[Index].VendorGuid, &giMXMemoryLogGuid)) {
+      Log = SystemTable->ConfigurationTable[Index].VendorTable;
+      break;
+    }
+  }
+
+  if (Log == NULL) {
+    Status = gBS->AllocatePages (AllocateAnyPages,
+                                 EfiRuntimeServicesData,
+                                 EFI_SIZE_TO_PAGES (sizeof (*Log) + FixedPcdGet32 (PcdMemoryLogSize)),
+                                 &Address);
+    if (EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+
+    Log = (IMX_MEMORY_LOG *)(UINTN)Address;
+    ZeroMem (Log, sizeof (*Log));
+    Log->Signature = IMX_MEMORY_LOG_SIGNATURE;
+    Log->Size = FixedPcdGet32 (PcdMemoryLogSize);
+
+    Status = gBS->InstallConfigurationTable (&giMXMemoryLogGuid, Log);
+    if (EFI_ERROR (Status)) {
+      gBS->FreePages (Address, EFI_SIZE_TO_PAGES (sizeof (*Log) + FixedPcdGet32 (PcdMemoryLogSize)));
+      return EFI_SUCCESS;
+    }
+  } else if (Log->Signature != IMX_MEMORY_LOG_SIGNATURE) {
+    return EFI_SUCCESS;
+  }
+
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                             TPL_NOTIFY,
+                             ExitBootServicesNotify,
+                             NULL,
+                             &mExitBootServicesEvent);
+  if (EFI_ERROR (Status)) {
+    return EFI_SUCCESS;
+  }
+
+  mMemoryLog = Log;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stop logging to the memory log from this module.
+
+  The log itself stays published for the other modules and the OS.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeMemoryLogDebugLibDestructor (
+  IN  EFI_HANDLE          ImageHandle,
+  IN  EFI_SYSTEM_TABLE    *SystemTable
+  )
+{
+  if (mMemoryLog == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  if (!mExitBootServices) {
+    gBS->CloseEvent (mExitBootServicesEvent);
+  }
+
+  mMemoryLog = NULL;
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,384 @@
+/** @file
+
+  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <iMXUart.h>
+
+#include "UartSerialPortLib.h"
+
+// Period of the timer event filling the receive ring, in 100ns units. The
+// 32 byte RX FIFO holds about 2.7ms of data at 115200 baud.
+#define IMX_UART_RX_FILL_PERIOD       (1 * 1000 * 10)
+
+#define IMX_UART_RX_RING_DATA(Ring)   ((UINT8 *)((Ring) + 1))
+
+STATIC IMX_UART_RX_RING   *mRxRing;
+
+// Only created by the module owning the receive ring
+STATIC EFI_EVENT          mRxFillEvent;
+STATIC EFI_EVENT          mRxExitBootServicesEvent;
+
+// Set once this module set up the SDMA to empty the receive FIFO
+STATIC BOOLEAN            mRxDma;
+
+/**
+  Move pending bytes from the receive FIFO to the receive ring.
+
+  Must be called at TPL_HIGH_LEVEL. Once the ring is full the FIFO is left
+  alone, so characters are only lost on a FIFO overrun, which is counted.
+  While the SDMA empties the FIFO, only the module that set it up moves the
+  received data to the ring.
+
+**/
+STATIC
+VOID
+RxRingFill (
+  VOID
+  )
+{
+  UINTN     Count;
+  UINT32    Errors;
+  UINT32    Free;
+  UINTN     Received;
+
+  for (;;) {
+    // One slot is kept empty to tell a full ring from an empty one
+    Free = (mRxRing->Head + mRxRing->Size - mRxRing->Tail - 1) % mRxRing->Size;
+    if (Free == 0) {
+      break;
+    }
+
+    Count = MIN (Free, mRxRing->Size - mRxRing->Tail);
+    if (mRxDma) {
+      Received = UartSdmaRxRead (IMX_UART_RX_RING_DATA (mRxRing) + mRxRing->Tail,
+                                 Count,
+                                 &Errors);
+    } else if (!UartSdmaRxActive ()) {
+      Received = UartSerialPortReadFifo (IMX_UART_RX_RING_DATA (mRxRing) + mRxRing->Tail,
+                                         Count,
+                                         &Errors);
+    } else {
+      break;
+    }
+    mRxRing->Tail = (UINT32)((mRxRing->Tail + Received) % mRxRing->Size);
+
+    if ((Errors & MX6UART_RXD_OVRRUN) != 0) {
+      mRxRing->OverrunCount++;
+    }
+    if ((Errors & (MX6UART_RXD_FRMERR | MX6UART_RXD_BRK | MX6UART_RXD_PRERR)) != 0) {
+      mRxRing->ErrorCount++;
+    }
+
+    if (Received < Count) {
+      break;
+    }
+  }
+}
+
+/**
+  Copy bytes from the receive ring to a caller buffer.
+
+  Must be called at TPL_HIGH_LEVEL.
+
+  @param  Buffer           Pointer to the data buffer to store the data.
+  @param  NumberOfBytes    Maximum number of bytes to copy.
+
+  @retval                  The number of bytes copied.
+
+**/
+STATIC
+UINTN
+RxRingRead (
+  OUT UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  )
+{
+  UINTN   BytesRead;
+  UINTN   Count;
+
+  BytesRead = 0;
+  while ((BytesRead < NumberOfBytes) && (mRxRing->Head != mRxRing->Tail)) {
+    if (mRxRing->Tail > mRxRing->Head) {
+      Count = mRxRing->Tail - mRxRing->Head;
+    } else {
+      Count = mRxRing->Size - mRxRing->Head;
+    }
+
+    Count = MIN (Count, NumberOfBytes - BytesRead);
+    CopyMem (Buffer + BytesRead, IMX_UART_RX_RING_DATA (mRxRing) + mRxRing->Head, Count);
+    mRxRing->Head = (UINT32)((mRxRing->Head + Count) % mRxRing->Size);
+    BytesRead += Count;
+  }
+
+  return BytesRead;
+}
+
+STATIC
+VOID
+EFIAPI
+RxFillNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  EFI_TPL   OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  RxRingFill ();
+  gBS->RestoreTPL (OldTpl);
+}
+
+STATIC
+VOID
+EFIAPI
+RxExitBootServicesNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  // The ring lives in boot services memory and the fill timer stops with boot
+  // services. Whatever is still buffered is dropped, later reads of every
+  // module sharing the ring go to the FIFO directly.
+  mRxRing->Serviced = FALSE;
+  if (mRxDma) {
+    UartSdmaRxStop ();
+    mRxDma = FALSE;
+  }
+}
+
+/**
+  Read data from serial device and save the datas in buffer.
+
+  Reads NumberOfBytes data bytes from a serial device into the buffer
+  specified by Buffer. The number of bytes actually read is returned.
+  If the return value is less than NumberOfBytes, then the rest operation failed.
+  If Buffer is NULL, then ASSERT().
+  If NumberOfBytes is zero, then return 0.
+
+  Data is returned from the receive ring, which a timer event keeps filled
+  from the receive FIFO, followed by whatever is still in the FIFO. While the
+  SDMA empties the FIFO, data is only returned from the ring.
+
+  @param  Buffer            Pointer to the data buffer to store the data read
+                            from the serial device.
+  @param  NumberOfBytes     Number of bytes which will be read.
+
+  @retval 0                 Read data failed, No data is to be read.
+  @retval >0                Actual number of bytes read from serial device.
+
+**/
+UINTN
+EFIAPI
+SerialPortRead (
+  OUT UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  )
+{
+  UINTN     BytesRead;
+  EFI_TPL   OldTpl;
+
+  if ((mRxRing == NULL) || !mRxRing->Serviced) {
+    return UartSerialPortReadFifo (Buffer, NumberOfBytes, NULL);
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  RxRingFill ();
+  BytesRead = RxRingRead (Buffer, NumberOfBytes);
+  if ((BytesRead < NumberOfBytes) && !UartSdmaRxActive ()) {
+    // The ring is empty, take the rest straight from the FIFO
+    BytesRead += UartSerialPortReadFifo (Buffer + BytesRead, NumberOfBytes - BytesRead, NULL);
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  return BytesRead;
+}
+
+/**
+  Polls a serial device to see if there is any data waiting to be read.
+
+  Polls a serial device to see if there is any data waiting to be read.
+  If there is data waiting to be read from the serial device, then TRUE is
+  returned.
+  If there is no data waiting to be read from the serial device, then FALSE is
+  returned.
+
+  @retval TRUE          Data is waiting to be read from the serial device.
+  @retval FALSE         There is no data waiting to be read from the serial device.
+
+**/
+BOOLEAN
+EFIAPI
+SerialPortPoll (
+  VOID
+  )
+{
+  if ((mRxRing == NULL) || !mRxRing->Serviced) {
+    return UartSerialPortPollFifo ();
+  }
+
+  // Reading the ring indices is atomic, no need to raise the TPL
+  if (mRxRing->Head != mRxRing->Tail) {
+    return TRUE;
+  }
+
+  // Includes the receive buffers of the SDMA not moved to the ring yet
+  return UartSdmaRxPoll ();
+}
+
+/**
+  Set up the shared receive ring and the event filling it.
+
+  The first module linking this library installs the ring and fills it, the
+  other modules only read from the installed ring. Failures are not fatal,
+  SerialPortRead falls back to reading the FIFO.
+
+**/
+VOID
+DxeUartSerialPortReadInitialize (
+  VOID
+  )
+{
+  EFI_HANDLE          Handle;
+  IMX_UART_RX_RING    *Ring;
+  EFI_STATUS          Status;
+
+  Status = gBS->LocateProtocol (&giMXSerialRxRingProtocolGuid, NULL, (VOID **)&Ring);
+  if (!EFI_ERROR (Status)) {
+    // The module that installed the ring fills it
+    if (Ring->Signature == IMX_UART_RX_RING_SIGNATURE) {
+      mRxRing = Ring;
+    }
+    return;
+  }
+
+  Ring = AllocateZeroPool (sizeof (*Ring) + FixedPcdGet32 (PcdSerialRxRingSize));
+  if (Ring == NULL) {
+    return;
+  }
+
+  Ring->Signature = IMX_UART_RX_RING_SIGNATURE;
+  Ring->Size = FixedPcdGet32 (PcdSerialRxRingSize);
+
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                             TPL_NOTIFY,
+                             RxExitBootServicesNotify,
+                             NULL,
+                             &mRxExitBootServicesEvent);
+  if (EFI_ERROR (Status)) {
+    goto FreeRing;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                             TPL_NOTIFY,
+                             RxFillNotify,
+                             NULL,
+                             &mRxFillEvent);
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBootServicesEvent;
+  }
+
+  // The fill timer may fire as soon as it is set
+  mRxRing = Ring;
+  Status = gBS->SetTimer (mRxFillEvent, TimerPeriodic, IMX_UART_RX_FILL_PERIOD);
+  if (EFI_ERROR (Status)) {
+    goto CloseFillEvent;
+  }
+
+  Handle = NULL;
+  Status = gBS->InstallProtocolInterface (&Handle,
+                                          &giMXSerialRxRingProtocolGuid,
+                                          EFI_NATIVE_INTERFACE,
+                                          Ring);
+  if (EFI_ERROR (Status)) {
+    goto CloseFillEvent;
+  }
+
+  Ring->Serviced = TRUE;
+  return;
+
+CloseFillEvent:
+  gBS->CloseEvent (mRxFillEvent);
+  mRxFillEvent = NULL;
+  mRxRing = NULL;
+
+CloseExitBootServicesEvent:
+  gBS->CloseEvent (mRxExitBootServicesEvent);
+  mRxExitBootServicesEvent = NULL;
+
+FreeRing:
+  FreePool (Ring);
+}
+
+/**
+  Let the SDMA empty the receive FIFO.
+
+  Only used by the module filling the receive ring, once it set up the SDMA.
+  The fill timer then moves the data from the SDMA receive buffers to the
+  ring.
+
+**/
+VOID
+DxeUartSerialPortReadStartDma (
+  VOID
+  )
+{
+  EFI_TPL   OldTpl;
+
+  if ((mRxFillEvent == NULL) || (mRxRing == NULL) || !mRxRing->Serviced) {
+    return;
+  }
+
+  // Keep the fill timer off the FIFO while the SDMA takes it over
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (!RETURN_ERROR (UartSdmaRxStart ())) {
+    mRxDma = TRUE;
+  }
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Close the events filling the receive ring from this module.
+
+  The ring itself is left installed for the other modules sharing it. When
+  this module fills the ring, the other modules read the FIFO directly from
+  now on.
+
+**/
+VOID
+DxeUartSerialPortReadUninitialize (
+  VOID
+  )
+{
+  if (mRxRing == NULL) {
+    return;
+  }
+
+  if ((mRxFillEvent != NULL) && mRxRing->Serviced) {
+    mRxRing->Serviced = FALSE;
+    if (mRxDma) {
+      UartSdmaRxStop ();
+      mRxDma = FALSE;
+    }
+    gBS->CloseEvent (mRxFillEvent);
+    gBS->CloseEvent (mRxExitBootServicesEvent);
+  }
+
+  mRxRing = NULL;
+}
@@ -0,0 +1,753 @@
+/** @file
+
+  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
+#include <iMXSdma.h>
+#include <iMXUart.h>
+
+#include "UartSerialPortLib.h"
+
+// SDMA channels of the console UART. Their channel control blocks are in
+// different cache lines, see IMX_UART_SDMA_DESCRIPTORS.
+#define IMX_UART_SDMA_TX_CHANNEL      1
+#define IMX_UART_SDMA_RX_CHANNEL      4
+
+#define IMX_UART_SDMA_PRIORITY        4
+
+// Bytes moved per DMA request. The transmit request is raised once the TX
+// FIFO drained to MX6UART_TX_WATERMARK_MIN, the receive request once the RX
+// FIFO holds one more character than the burst, which leaves the aging timer
+// to flush the characters below the trigger level.
+#define IMX_UART_SDMA_BURST           8
+#define IMX_UART_SDMA_RX_TRIGGER      (IMX_UART_SDMA_BURST + 1)
+
+// Receive buffers the SDMA fills in turn, each of PcdSerialDmaThreshold bytes
+#define IMX_UART_SDMA_RX_BD_COUNT     4
+
+// Largest data cache line of the supported cores
+#define IMX_UART_SDMA_CACHE_LINE      64
+
+// Time allowed for channel 0 to load a channel context, in microseconds
+#define IMX_UART_SDMA_TIMEOUT         1000
+
+//
+// Descriptor page shared with the SDMA. The SDMA is not cache coherent: what
+// the CPU writes is cleaned to memory before the SDMA is started on it, and
+// what the SDMA writes is invalidated before the CPU reads it. Cleaning a
+// cache line writes all of it back, so data written by the SDMA must never
+// share a cache line with data the CPU is writing at the same time. Each
+// group below starts on its own cache line, and the receive descriptors are
+// only rewritten once the SDMA completed all of them.
+//
+typedef struct {
+  IMX_SDMA_CHANNEL_CONTROL    Ccb[IMX_SDMA_CHANNEL_COUNT];
+  IMX_SDMA_CONTEXT            Context;
+  IMX_SDMA_BUFFER_DESCRIPTOR  Channel0Bd;
+  UINT8                       Reserved0[IMX_UART_SDMA_CACHE_LINE - sizeof (IMX_SDMA_BUFFER_DESCRIPTOR)];
+  IMX_SDMA_BUFFER_DESCRIPTOR  TxBd;
+  UINT8                       Reserved1[IMX_UART_SDMA_CACHE_LINE - sizeof (IMX_SDMA_BUFFER_DESCRIPTOR)];
+  IMX_SDMA_BUFFER_DESCRIPTOR  RxBd[IMX_UART_SDMA_RX_BD_COUNT];
+} IMX_UART_SDMA_DESCRIPTORS;
+
+//
+// SDMA state of the module that set up the SDMA. Other modules sharing the
+// rings only complete transmit transfers, which needs no memory state.
+//
+typedef struct {
+  IMX_UART_SDMA_DESCRIPTORS   *Descriptors;
+  UINT8                       *RxBuffer;
+  UINT32                      RxBufferSize;
+  UINT32                      RxNext;
+  UINT32                      RxOffset;
+  UINT32                      RxTriggerLevel;
+  BOOLEAN                     RxRunning;
+  BOOLEAN                     Running;
+} IMX_UART_SDMA;
+
+STATIC IMX_UART_SDMA    mSdma;
+
+STATIC
+UINT32
+SdmaAddress (
+  IN  VOID    *Buffer
+  )
+{
+  // Callers check that the SDMA can address the buffer
+  ASSERT ((UINTN)Buffer <= MAX_UINT32);
+  return (UINT32)(UINTN)Buffer;
+}
+
+/**
+  Run channel 0 on its buffer descriptor and wait for it to finish.
+
+  @retval RETURN_SUCCESS        The command completed.
+  @retval RETURN_TIMEOUT        Channel 0 did not finish in time.
+  @retval RETURN_DEVICE_ERROR   The SDMA reported an error for the command.
+
+**/
+STATIC
+RETURN_STATUS
+SdmaRunChannel0 (
+  VOID
+  )
+{
+  UINT32                Counter;
+  IMX_SDMA_REGISTERS    *SdmaBase;
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+
+  MmioWrite32 ((UINTN)&SdmaBase->HStart, BIT0);
+  Counter = IMX_UART_SDMA_TIMEOUT;
+  while ((MmioRead32 ((UINTN)&SdmaBase->StopStat) & BIT0) != 0) {
+    if (Counter == 0) {
+      MmioWrite32 ((UINTN)&SdmaBase->StopStat, BIT0);
+      return RETURN_TIMEOUT;
+    }
+    MicroSecondDelay (1);
+    --Counter;
+  }
+  MmioWrite32 ((UINTN)&SdmaBase->Intr, BIT0);
+
+  InvalidateDataCacheRange (&mSdma.Descriptors->Channel0Bd,
+                            sizeof (mSdma.Descriptors->Channel0Bd));
+  if ((mSdma.Descriptors->Channel0Bd.Status & IMX_SDMA_BD_ERROR) != 0) {
+    return RETURN_DEVICE_ERROR;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Load the context of a UART channel through channel 0 and hand the channel
+  its DMA request event.
+
+  @param  Channel           SDMA channel to set up.
+  @param  Script            ROM address of the script the channel runs.
+  @param  Event             SDMA event of the UART DMA request.
+  @param  FifoAddress       Address of the UART data register.
+
+  @retval RETURN_SUCCESS    The channel is ready to be started.
+  @retval Others            Channel 0 failed to load the context.
+
+**/
+STATIC
+RETURN_STATUS
+SdmaSetupChannel (
+  IN  UINT32  Channel,
+  IN  UINT32  Script,
+  IN  UINT32  Event,
+  IN  UINT32  FifoAddress
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR    *Bd;
+  IMX_SDMA_CONTEXT              *Context;
+  IMX_SDMA_REGISTERS            *SdmaBase;
+  RETURN_STATUS                 Status;
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  Context = &mSdma.Descriptors->Context;
+  Bd = &mSdma.Descriptors->Channel0Bd;
+
+  ZeroMem (Context, sizeof (*Context));
+  Context->ChannelState[0] = Script & IMX_SDMA_CONTEXT_PC_MASK;
+  if (Event >= 32) {
+    Context->GeneralRegister[0] = 1U << (Event - 32);
+  } else {
+    Context->GeneralRegister[1] = 1U << Event;
+  }
+  Context->GeneralRegister[2] = FifoAddress;
+  Context->GeneralRegister[7] = IMX_UART_SDMA_BURST;
+  WriteBackDataCacheRange (Context, sizeof (*Context));
+
+  Bd->Count = sizeof (*Context) / sizeof (UINT32);
+  Bd->Command = IMX_SDMA_BD_COMMAND_SETDM;
+  Bd->BufferAddress = SdmaAddress (Context);
+  Bd->ExtBufferAddress = IMX_SDMA_CONTEXT_ADDRESS (Channel);
+  Bd->Status = IMX_SDMA_BD_DONE | IMX_SDMA_BD_WRAP | IMX_SDMA_BD_EXTD;
+  WriteBackDataCacheRange (Bd, sizeof (*Bd));
+
+  Status = SdmaRunChannel0 ();
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  // The channel is started by the ARM core and triggered by its event
+  MmioAnd32 ((UINTN)&SdmaBase->EvtOvr, ~(1U << Channel));
+  MmioAnd32 ((UINTN)&SdmaBase->HostOvr, ~(1U << Channel));
+  MmioOr32 ((UINTN)&SdmaBase->DspOvr, 1U << Channel);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnPri[Channel], IMX_UART_SDMA_PRIORITY);
+  MmioOr32 ((UINTN)&SdmaBase->ChnEnbl[Event], 1U << Channel);
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Hand all receive buffers back to the SDMA.
+
+  Must only be called while the SDMA owns none of them.
+
+**/
+STATIC
+VOID
+SdmaRxArm (
+  VOID
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR    *Bd;
+  UINT32                        Index;
+
+  for (Index = 0; Index < IMX_UART_SDMA_RX_BD_COUNT; ++Index) {
+    Bd = &mSdma.Descriptors->RxBd[Index];
+    Bd->Count = (UINT16)mSdma.RxBufferSize;
+    Bd->Command = IMX_SDMA_BD_COMMAND_WIDTH_8;
+    Bd->BufferAddress = SdmaAddress (mSdma.RxBuffer + Index * mSdma.RxBufferSize);
+    Bd->ExtBufferAddress = 0;
+    Bd->Status = IMX_SDMA_BD_DONE | IMX_SDMA_BD_CONT | IMX_SDMA_BD_EXTD;
+  }
+  Bd->Status |= IMX_SDMA_BD_WRAP;
+
+  WriteBackDataCacheRange (mSdma.Descriptors->RxBd, sizeof (mSdma.Descriptors->RxBd));
+  mSdma.RxNext = 0;
+  mSdma.RxOffset = 0;
+}
+
+/**
+  Set up the SDMA to move data between memory and the console UART.
+
+  The SDMA is only used when PcdSdmaBase and PcdSerialDmaThreshold are set,
+  and no other agent already set it up. Channel 0 loads the contexts of the
+  transmit and receive channels, which run the mcu_2_app and uart_2_mcu ROM
+  scripts.
+
+  @retval RETURN_SUCCESS            The SDMA is ready, or was already set up by
+                                    this module.
+  @retval RETURN_UNSUPPORTED        The SDMA is disabled or in use.
+  @retval RETURN_OUT_OF_RESOURCES   The descriptors could not be allocated.
+  @retval Others                    Channel 0 failed to load a context.
+
+**/
+RETURN_STATUS
+UartSdmaInitialize (
+  VOID
+  )
+{
+  IMX_UART_SDMA_DESCRIPTORS   *Descriptors;
+  UINT32                      Index;
+  IMX_SDMA_REGISTERS          *SdmaBase;
+  RETURN_STATUS               Status;
+  UINTN                       UartBase;
+
+  if (mSdma.Running) {
+    return RETURN_SUCCESS;
+  }
+
+  if ((FixedPcdGet32 (PcdSdmaBase) == 0) || (FixedPcdGet32 (PcdSerialDmaThreshold) == 0)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((FixedPcdGet32 (PcdSerialSdmaTxEvent) >= IMX_SDMA_EVENT_COUNT) ||
+      (FixedPcdGet32 (PcdSerialSdmaRxEvent) >= IMX_SDMA_EVENT_COUNT) ||
+      (FixedPcdGet32 (PcdSerialDmaThreshold) > MAX_UINT16)) {
+    ASSERT (FALSE);
+    return RETURN_UNSUPPORTED;
+  }
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+  // A channel 0 pointer means another agent owns the SDMA
+  if (MmioRead32 ((UINTN)&SdmaBase->Mc0Ptr) != 0) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  ASSERT (sizeof (*Descriptors) <= EFI_PAGE_SIZE);
+  Descriptors = AllocatePages (1);
+  if (Descriptors == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  // Whole cache lines, so the CPU never writes back into a receive buffer
+  mSdma.RxBufferSize = ALIGN_VALUE (FixedPcdGet32 (PcdSerialDmaThreshold),
+                                    IMX_UART_SDMA_CACHE_LINE);
+  if (mSdma.RxBufferSize > MAX_UINT16) {
+    mSdma.RxBufferSize -= IMX_UART_SDMA_CACHE_LINE;
+  }
+  mSdma.RxBuffer = AllocatePages (EFI_SIZE_TO_PAGES (IMX_UART_SDMA_RX_BD_COUNT * mSdma.RxBufferSize));
+  if (mSdma.RxBuffer == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto FreeDescriptors;
+  }
+  if (((UINTN)Descriptors + EFI_PAGE_SIZE - 1 > MAX_UINT32) ||
+      ((UINTN)mSdma.RxBuffer + IMX_UART_SDMA_RX_BD_COUNT * mSdma.RxBufferSize - 1 > MAX_UINT32)) {
+    Status = RETURN_UNSUPPORTED;
+    goto FreeRxBuffer;
+  }
+  InvalidateDataCacheRange (mSdma.RxBuffer, IMX_UART_SDMA_RX_BD_COUNT * mSdma.RxBufferSize);
+
+  ZeroMem (Descriptors, sizeof (*Descriptors));
+  mSdma.Descriptors = Descriptors;
+  Descriptors->Ccb[0].BaseBdPointer = SdmaAddress (&Descriptors->Channel0Bd);
+  Descriptors->Ccb[0].CurrentBdPointer = SdmaAddress (&Descriptors->Channel0Bd);
+  Descriptors->Ccb[IMX_UART_SDMA_TX_CHANNEL].BaseBdPointer = SdmaAddress (&Descriptors->TxBd);
+  Descriptors->Ccb[IMX_UART_SDMA_TX_CHANNEL].CurrentBdPointer = SdmaAddress (&Descriptors->TxBd);
+  Descriptors->Ccb[IMX_UART_SDMA_RX_CHANNEL].BaseBdPointer = SdmaAddress (Descriptors->RxBd);
+  Descriptors->Ccb[IMX_UART_SDMA_RX_CHANNEL].CurrentBdPointer = SdmaAddress (Descriptors->RxBd);
+  WriteBackDataCacheRange (Descriptors, sizeof (*Descriptors));
+
+  for (Index = 0; Index < IMX_SDMA_EVENT_COUNT; ++Index) {
+    MmioWrite32 ((UINTN)&SdmaBase->ChnEnbl[Index], 0);
+  }
+  for (Index = 0; Index < IMX_SDMA_CHANNEL_COUNT; ++Index) {
+    MmioWrite32 ((UINTN)&SdmaBase->ChnPri[Index], 0);
+  }
+
+  // Channel 0 is started by the ARM core only and loads 32 word contexts
+  MmioWrite32 ((UINTN)&SdmaBase->Config, IMX_SDMA_CONFIG_CSM_STATIC);
+  MmioWrite32 ((UINTN)&SdmaBase->Chn0Addr, IMX_SDMA_CHN0ADDR_SMSZ | IMX_SDMA_CHN0ADDR_BOOT);
+  MmioOr32 ((UINTN)&SdmaBase->EvtOvr, BIT0);
+  MmioAnd32 ((UINTN)&SdmaBase->HostOvr, ~BIT0);
+  MmioOr32 ((UINTN)&SdmaBase->DspOvr, BIT0);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnPri[0], IMX_SDMA_PRIORITY_MAX);
+  MmioWrite32 ((UINTN)&SdmaBase->Mc0Ptr, SdmaAddress (Descriptors->Ccb));
+
+  Status = SdmaSetupChannel (IMX_UART_SDMA_TX_CHANNEL,
+                             FixedPcdGet32 (PcdSdmaMcuToAppScript),
+                             FixedPcdGet32 (PcdSerialSdmaTxEvent),
+                             (UINT32)(UartBase + OFFSET_OF (MX6UART_REGISTERS, Txd)));
+  if (RETURN_ERROR (Status)) {
+    goto ReleaseSdma;
+  }
+
+  Status = SdmaSetupChannel (IMX_UART_SDMA_RX_CHANNEL,
+                             FixedPcdGet32 (PcdSdmaUartToMcuScript),
+                             FixedPcdGet32 (PcdSerialSdmaRxEvent),
+                             (UINT32)(UartBase + OFFSET_OF (MX6UART_REGISTERS, Rxd)));
+  if (RETURN_ERROR (Status)) {
+    goto ReleaseSdma;
+  }
+
+  mSdma.Running = TRUE;
+  return RETURN_SUCCESS;
+
+ReleaseSdma:
+  DEBUG ((DEBUG_ERROR, "%a: SDMA channel setup failed %r\n", __FUNCTION__, Status));
+  for (Index = 0; Index < IMX_SDMA_EVENT_COUNT; ++Index) {
+    MmioWrite32 ((UINTN)&SdmaBase->ChnEnbl[Index], 0);
+  }
+  MmioWrite32 ((UINTN)&SdmaBase->Mc0Ptr, 0);
+
+FreeRxBuffer:
+  FreePages (mSdma.RxBuffer, EFI_SIZE_TO_PAGES (IMX_UART_SDMA_RX_BD_COUNT * mSdma.RxBufferSize));
+
+FreeDescriptors:
+  FreePages (Descriptors, 1);
+  ZeroMem (&mSdma, sizeof (mSdma));
+  return Status;
+}
+
+/**
+  Stop the UART channels and give the SDMA back.
+
+  A transmit transfer in flight is cut short, callers wait for it to complete
+  first. The descriptors stay allocated, so this can be called at
+  ExitBootServices.
+
+**/
+VOID
+UartSdmaStop (
+  VOID
+  )
+{
+  IMX_SDMA_REGISTERS    *SdmaBase;
+  UINTN                 UartBase;
+
+  if (!mSdma.Running) {
+    return;
+  }
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+  UartSdmaRxStop ();
+
+  MmioAnd32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1), ~MX6UART_UCR1_TXDMAEN);
+  MmioWrite32 ((UINTN)&SdmaBase->StopStat, 1U << IMX_UART_SDMA_TX_CHANNEL);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnEnbl[FixedPcdGet32 (PcdSerialSdmaTxEvent)], 0);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnEnbl[FixedPcdGet32 (PcdSerialSdmaRxEvent)], 0);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnPri[IMX_UART_SDMA_TX_CHANNEL], 0);
+  MmioWrite32 ((UINTN)&SdmaBase->ChnPri[IMX_UART_SDMA_RX_CHANNEL], 0);
+  MmioWrite32 ((UINTN)&SdmaBase->Intr,
+               (1U << IMX_UART_SDMA_TX_CHANNEL) | (1U << IMX_UART_SDMA_RX_CHANNEL));
+  MmioWrite32 ((UINTN)&SdmaBase->Mc0Ptr, 0);
+
+  mSdma.Running = FALSE;
+}
+
+/**
+  Stop the SDMA and free its descriptors and receive buffers.
+
+**/
+VOID
+UartSdmaUninitialize (
+  VOID
+  )
+{
+  UartSdmaStop ();
+
+  if (mSdma.Descriptors != NULL) {
+    FreePages (mSdma.RxBuffer, EFI_SIZE_TO_PAGES (IMX_UART_SDMA_RX_BD_COUNT * mSdma.RxBufferSize));
+    FreePages (mSdma.Descriptors, 1);
+  }
+
+  ZeroMem (&mSdma, sizeof (mSdma));
+}
+
+/**
+  Start sending a buffer through the SDMA.
+
+  The buffer must stay untouched until UartSdmaTxDone returns TRUE. Only the
+  module that set up the SDMA can start transfers.
+
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written to the serial device.
+
+  @retval                  The number of bytes handed to the SDMA, 0 if the
+                           caller has to write the FIFO itself.
+
+**/
+UINTN
+UartSdmaTxStart (
+  IN  UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR    *Bd;
+  IMX_SDMA_CHANNEL_CONTROL      *Ccb;
+  IMX_SDMA_REGISTERS            *SdmaBase;
+  UINTN                         UartBase;
+
+  if (!mSdma.Running || (NumberOfBytes == 0)) {
+    return 0;
+  }
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+  Bd = &mSdma.Descriptors->TxBd;
+  Ccb = &mSdma.Descriptors->Ccb[IMX_UART_SDMA_TX_CHANNEL];
+
+  // The SDMA only addresses the low 4GB
+  NumberOfBytes = MIN (NumberOfBytes, MAX_UINT16);
+  if ((UINTN)Buffer + NumberOfBytes - 1 > MAX_UINT32) {
+    return 0;
+  }
+
+  WriteBackDataCacheRange (Buffer, NumberOfBytes);
+
+  Bd->Count = (UINT16)NumberOfBytes;
+  Bd->Command = IMX_SDMA_BD_COMMAND_WIDTH_8;
+  Bd->BufferAddress = SdmaAddress (Buffer);
+  Bd->ExtBufferAddress = 0;
+  Bd->Status = IMX_SDMA_BD_DONE | IMX_SDMA_BD_WRAP | IMX_SDMA_BD_INTR |
+               IMX_SDMA_BD_LAST | IMX_SDMA_BD_EXTD;
+  WriteBackDataCacheRange (Bd, sizeof (*Bd));
+
+  Ccb->BaseBdPointer = SdmaAddress (Bd);
+  Ccb->CurrentBdPointer = SdmaAddress (Bd);
+  WriteBackDataCacheRange (Ccb, sizeof (*Ccb));
+
+  MmioOr32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1), MX6UART_UCR1_TXDMAEN);
+  MmioWrite32 ((UINTN)&SdmaBase->HStart, 1U << IMX_UART_SDMA_TX_CHANNEL);
+
+  return NumberOfBytes;
+}
+
+/**
+  Check for the completion of the transfer started by UartSdmaTxStart.
+
+  Only reads registers, so any module sharing the transmit ring can complete
+  a transfer started by the module that set up the SDMA. Must only be called
+  while a transfer is in flight.
+
+  @retval TRUE          The SDMA wrote the whole buffer to the FIFO.
+  @retval FALSE         The transfer is still in flight.
+
+**/
+BOOLEAN
+UartSdmaTxDone (
+  VOID
+  )
+{
+  IMX_SDMA_REGISTERS    *SdmaBase;
+  UINTN                 UartBase;
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+  if ((MmioRead32 ((UINTN)&SdmaBase->Intr) & (1U << IMX_UART_SDMA_TX_CHANNEL)) == 0) {
+    return FALSE;
+  }
+
+  MmioWrite32 ((UINTN)&SdmaBase->Intr, 1U << IMX_UART_SDMA_TX_CHANNEL);
+  MmioAnd32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1), ~MX6UART_UCR1_TXDMAEN);
+  return TRUE;
+}
+
+/**
+  Let the SDMA empty the receive FIFO into the receive buffers.
+
+  @retval RETURN_SUCCESS        Reception runs through the SDMA.
+  @retval RETURN_UNSUPPORTED    This module did not set up the SDMA.
+
+**/
+RETURN_STATUS
+UartSdmaRxStart (
+  VOID
+  )
+{
+  IMX_SDMA_REGISTERS    *SdmaBase;
+  UINTN                 UartBase;
+  UINT32                Ufcr;
+
+  if (!mSdma.Running) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if (mSdma.RxRunning) {
+    return RETURN_SUCCESS;
+  }
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+  SdmaRxArm ();
+
+  // The burst is only safe above the trigger level, restored on stop
+  Ufcr = MmioRead32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ufcr));
+  mSdma.RxTriggerLevel = Ufcr & MX6UART_UFCR_RXTL_MASK;
+  MmioWrite32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ufcr),
+               (Ufcr & ~MX6UART_UFCR_RXTL_MASK) |
+               (IMX_UART_SDMA_RX_TRIGGER << MX6UART_UFCR_RXTL_SHIFT));
+
+  MmioOr32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1),
+            MX6UART_UCR1_RXDMAEN | MX6UART_UCR1_ATDMAEN);
+  MmioWrite32 ((UINTN)&SdmaBase->HStart, 1U << IMX_UART_SDMA_RX_CHANNEL);
+
+  mSdma.RxRunning = TRUE;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Give the receive FIFO back to the CPU.
+
+  Data the SDMA received but UartSdmaRxRead did not return yet is dropped.
+
+**/
+VOID
+UartSdmaRxStop (
+  VOID
+  )
+{
+  IMX_SDMA_REGISTERS    *SdmaBase;
+  UINTN                 UartBase;
+
+  if (!mSdma.RxRunning) {
+    return;
+  }
+
+  SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+  MmioAnd32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1),
+             ~(MX6UART_UCR1_RXDMAEN | MX6UART_UCR1_ATDMAEN));
+  MmioWrite32 ((UINTN)&SdmaBase->StopStat, 1U << IMX_UART_SDMA_RX_CHANNEL);
+  MmioAndThenOr32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ufcr),
+                   ~MX6UART_UFCR_RXTL_MASK,
+                   mSdma.RxTriggerLevel);
+
+  mSdma.RxRunning = FALSE;
+}
+
+/**
+  Read the MX6UART_RXD error bits of a receive buffer the SDMA flagged.
+
+  The SDMA only reports that a character had an error, the cause is left in
+  the UART status registers.
+
+**/
+STATIC
+UINT32
+SdmaRxErrors (
+  IN  UINTN   UartBase
+  )
+{
+  UINT32  Errors;
+  UINT32  Usr1;
+  UINT32  Usr2;
+
+  Errors = MX6UART_RXD_ERR;
+  Usr1 = MmioRead32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr1)) &
+         (MX6UART_USR1_FRAMERR | MX6UART_USR1_PARITYERR);
+  Usr2 = MmioRead32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr2)) & MX6UART_USR2_BRCD;
+
+  if ((Usr1 & MX6UART_USR1_FRAMERR) != 0) {
+    Errors |= MX6UART_RXD_FRMERR;
+  }
+  if ((Usr1 & MX6UART_USR1_PARITYERR) != 0) {
+    Errors |= MX6UART_RXD_PRERR;
+  }
+  if (Usr2 != 0) {
+    Errors |= MX6UART_RXD_BRK;
+  }
+
+  // Write one to clear
+  MmioWrite32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr1), Usr1);
+  MmioWrite32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr2), Usr2);
+  return Errors;
+}
+
+/**
+  Read data the SDMA received.
+
+  Must be called at TPL_HIGH_LEVEL. Buffers are returned in the order the
+  SDMA completed them. Once all of them have been read they are handed back
+  to the SDMA together. While no buffer is available to the SDMA the
+  characters wait in the receive FIFO.
+
+  @param  Buffer           Pointer to the data buffer to store the data.
+  @param  NumberOfBytes    Maximum number of bytes to read.
+  @param  ErrorStatus      Optional pointer to return the MX6UART_RXD error
+                           bits seen since the last call.
+
+  @retval                  The number of bytes read.
+
+**/
+UINTN
+UartSdmaRxRead (
+  OUT UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  OUT UINT32    *ErrorStatus OPTIONAL
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR    *Bd;
+  UINTN                         BytesRead;
+  UINTN                         Count;
+  UINT8                         *Data;
+  UINT32                        Errors;
+  IMX_SDMA_REGISTERS            *SdmaBase;
+  UINTN                         UartBase;
+
+  BytesRead = 0;
+  Errors = 0;
+
+  if (mSdma.RxRunning) {
+    SdmaBase = (IMX_SDMA_REGISTERS *)FixedPcdGet32 (PcdSdmaBase);
+    UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+
+    // ORE is write one to clear
+    if ((MmioRead32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr2)) & MX6UART_USR2_ORE) != 0) {
+      MmioWrite32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Usr2), MX6UART_USR2_ORE);
+      Errors |= MX6UART_RXD_ERR | MX6UART_RXD_OVRRUN;
+    }
+
+    while (BytesRead < NumberOfBytes) {
+      Bd = &mSdma.Descriptors->RxBd[mSdma.RxNext];
+      InvalidateDataCacheRange (Bd, sizeof (*Bd));
+      if ((Bd->Status & IMX_SDMA_BD_DONE) != 0) {
+        // Still owned by the SDMA
+        break;
+      }
+
+      if ((mSdma.RxOffset == 0) && ((Bd->Status & IMX_SDMA_BD_ERROR) != 0)) {
+        Errors |= SdmaRxErrors (UartBase);
+      }
+
+      Count = MIN (Bd->Count - mSdma.RxOffset, NumberOfBytes - BytesRead);
+      Data = mSdma.RxBuffer + mSdma.RxNext * mSdma.RxBufferSize + mSdma.RxOffset;
+      InvalidateDataCacheRange (Data, Count);
+      CopyMem (Buffer + BytesRead, Data, Count);
+      BytesRead += Count;
+      mSdma.RxOffset += (UINT32)Count;
+
+      if (mSdma.RxOffset == Bd->Count) {
+        mSdma.RxOffset = 0;
+        mSdma.RxNext++;
+        if (mSdma.RxNext == IMX_UART_SDMA_RX_BD_COUNT) {
+          // The SDMA completed every buffer and stops at the next request.
+          // Restarting a running channel has no effect.
+          SdmaRxArm ();
+          MmioWrite32 ((UINTN)&SdmaBase->HStart, 1U << IMX_UART_SDMA_RX_CHANNEL);
+        }
+      }
+    }
+  }
+
+  if (ErrorStatus != NULL) {
+    *ErrorStatus = Errors;
+  }
+
+  return BytesRead;
+}
+
+/**
+  Check whether received data is waiting in the receive FIFO or, when this
+  module runs the receive channel, in a completed receive buffer.
+
+**/
+BOOLEAN
+UartSdmaRxPoll (
+  VOID
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR    *Bd;
+
+  if (mSdma.RxRunning) {
+    Bd = &mSdma.Descriptors->RxBd[mSdma.RxNext];
+    InvalidateDataCacheRange (Bd, sizeof (*Bd));
+    if (((Bd->Status & IMX_SDMA_BD_DONE) == 0) && (Bd->Count > mSdma.RxOffset)) {
+      return TRUE;
+    }
+  }
+
+  return UartSerialPortPollFifo ();
+}
+
+/**
+  Check whether the SDMA of any module empties the receive FIFO.
+
+  @retval TRUE          The receive FIFO must not be read by the CPU.
+  @retval FALSE         The CPU reads the receive FIFO.
+
+**/
+BOOLEAN
+UartSdmaRxActive (
+  VOID
+  )
+{
+  UINTN   UartBase;
+
+  if ((FixedPcdGet32 (PcdSdmaBase) == 0) || (FixedPcdGet32 (PcdSerialDmaThreshold) == 0)) {
+    return FALSE;
+  }
+
+  UartBase = FixedPcdGet32 (PcdSerialRegisterBase);
+  return (MmioRead32 (UartBase + OFFSET_OF (MX6UART_REGISTERS, Ucr1)) & MX6UART_UCR1_RXDMAEN) != 0;
+}
@@ -0,0 +1,362 @@
+/** @file
+
+  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "UartSerialPortLib.h"
+
+#define IMX_UART_TX_RING_SIGNATURE    SIGNATURE_32 ('U', 'T', 'X', 'R')
+
+// Period of the timer event draining the transmit ring, in 100ns units
+#define IMX_UART_TX_DRAIN_PERIOD      (10 * 1000 * 10)
+
+// TPL of the drain timer event. Writes at or above this TPL cannot rely on
+// the timer to drain the ring and are sent synchronously.
+#define IMX_UART_TX_DRAIN_TPL         TPL_NOTIFY
+
+//
+// Transmit ring shared by all DXE modules linking this library, so output
+// from different modules is sent in the order it was written. The module
+// that installs the ring owns the drain timer and the ExitBootServices flush,
+// the other modules only queue to it. Serviced is cleared once the owner no
+// longer drains the ring, further writes are then sent synchronously.
+// DmaCount bytes at Head are being sent by the SDMA, any module draining the
+// ring completes the transfer. The ring data follows the header.
+//
+typedef struct {
+  UINT32  Signature;
+  UINT32  Size;
+  UINT32  Head;
+  UINT32  Tail;
+  UINT32  DmaCount;
+  BOOLEAN Serviced;
+} IMX_UART_TX_RING;
+
+#define IMX_UART_TX_RING_DATA(Ring)   ((UINT8 *)((Ring) + 1))
+
+STATIC IMX_UART_TX_RING   *mTxRing;
+
+// Only created by the module owning the transmit ring
+STATIC EFI_EVENT          mTxDrainEvent;
+STATIC EFI_EVENT          mExitBootServicesEvent;
+
+/**
+  Send pending bytes of the transmit ring to the UART.
+
+  Must be called at TPL_HIGH_LEVEL. Segments of at least PcdSerialDmaThreshold
+  bytes are handed to the SDMA when the module owning the ring set it up.
+
+  @param  Wait    TRUE to send all pending bytes, FALSE to only send what fits
+                  in the transmit FIFO or start an SDMA transfer.
+
+**/
+STATIC
+VOID
+TxRingDrain (
+  IN  BOOLEAN   Wait
+  )
+{
+  UINTN   Count;
+  UINTN   Sent;
+
+  while (mTxRing->Head != mTxRing->Tail) {
+    if (mTxRing->DmaCount != 0) {
+      if (UartSdmaTxDone ()) {
+        mTxRing->Head = (mTxRing->Head + mTxRing->DmaCount) % mTxRing->Size;
+        mTxRing->DmaCount = 0;
+      } else if (!Wait) {
+        break;
+      }
+      continue;
+    }
+
+    if (mTxRing->Tail > mTxRing->Head) {
+      Count = mTxRing->Tail - mTxRing->Head;
+    } else {
+      Count = mTxRing->Size - mTxRing->Head;
+    }
+
+    if ((FixedPcdGet32 (PcdSerialDmaThreshold) != 0) &&
+        (Count >= FixedPcdGet32 (PcdSerialDmaThreshold))) {
+      mTxRing->DmaCount = (UINT32)UartSdmaTxStart (IMX_UART_TX_RING_DATA (mTxRing) + mTxRing->Head,
+                                                   Count);
+      if (mTxRing->DmaCount != 0) {
+        continue;
+      }
+    }
+
+    Sent = UartSerialPortWriteFifo (IMX_UART_TX_RING_DATA (mTxRing) + mTxRing->Head, Count, Wait);
+    mTxRing->Head = (UINT32)((mTxRing->Head + Sent) % mTxRing->Size);
+    if (Sent < Count) {
+      break;
+    }
+  }
+}
+
+STATIC
+VOID
+EFIAPI
+TxDrainNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  EFI_TPL   OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  TxRingDrain (FALSE);
+  gBS->RestoreTPL (OldTpl);
+}
+
+STATIC
+VOID
+EFIAPI
+ExitBootServicesNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  // Flush everything before the OS takes over the UART. The drain timer
+  // stops with boot services, so further writes of every module sharing the
+  // ring are synchronous and the SDMA is left to the OS.
+  TxRingDrain (TRUE);
+  mTxRing->Serviced = FALSE;
+  UartSdmaStop ();
+}
+
+/**
+  Write data from buffer to serial device.
+
+  Writes NumberOfBytes data bytes from Buffer to the serial device.
+  The number of bytes actually written to the serial device is returned.
+  If the return value is less than NumberOfBytes, then the write operation failed.
+  If Buffer is NULL, then ASSERT().
+  If NumberOfBytes is zero, then return 0.
+
+  The data is copied to the transmit ring and sent in the background by a
+  timer event. Writes made at or above the drain TPL flush the ring and are
+  sent synchronously. Output that must reach the wire before the caller
+  stops, like an ASSERT message followed by a dead loop, has to be written
+  at or above the drain TPL.
+
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written to the serial device.
+
+  @retval 0                NumberOfBytes is 0.
+  @retval >0               The number of bytes written to the serial device.
+                           If this value is less than NumberOfBytes, then the
+                           read operation failed.
+
+**/
+UINTN
+EFIAPI
+SerialPortWrite (
+  IN  UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  )
+{
+  UINTN     BytesQueued;
+  UINTN     Count;
+  UINT32    Free;
+  EFI_TPL   OldTpl;
+
+  if ((mTxRing == NULL) || !mTxRing->Serviced) {
+    return UartSerialPortWriteFifo (Buffer, NumberOfBytes, TRUE);
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (OldTpl >= IMX_UART_TX_DRAIN_TPL) {
+    TxRingDrain (TRUE);
+    UartSerialPortWriteFifo (Buffer, NumberOfBytes, TRUE);
+    gBS->RestoreTPL (OldTpl);
+    return NumberOfBytes;
+  }
+
+  BytesQueued = 0;
+  while (BytesQueued < NumberOfBytes) {
+    // One slot is kept empty to tell a full ring from an empty one
+    Free = (mTxRing->Head + mTxRing->Size - mTxRing->Tail - 1) % mTxRing->Size;
+    if (Free == 0) {
+      // Ring is full, fall back to waiting on the wire
+      TxRingDrain (TRUE);
+      continue;
+    }
+
+    Count = MIN (NumberOfBytes - BytesQueued, Free);
+    Count = MIN (Count, mTxRing->Size - mTxRing->Tail);
+    CopyMem (IMX_UART_TX_RING_DATA (mTxRing) + mTxRing->Tail, Buffer + BytesQueued, Count);
+    mTxRing->Tail = (UINT32)((mTxRing->Tail + Count) % mTxRing->Size);
+    BytesQueued += Count;
+  }
+
+  // Top up the FIFO without waiting, the timer event sends the rest
+  TxRingDrain (FALSE);
+  gBS->RestoreTPL (OldTpl);
+
+  return NumberOfBytes;
+}
+
+/**
+  Set up the shared transmit and receive rings and the events servicing them.
+
+  The first module linking this library installs the rings and services
+  them, the other modules only queue to the installed rings. Failures are not
+  fatal, SerialPortWrite and SerialPortRead fall back to accessing the FIFOs
+  directly.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The constructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeUartSerialPortLibConstructor (
+  IN  EFI_HANDLE          ImageHandle,
+  IN  EFI_SYSTEM_TABLE    *SystemTable
+  )
+{
+  EFI_HANDLE          Handle;
+  IMX_UART_TX_RING    *Ring;
+  EFI_STATUS          Status;
+
+  DxeUartSerialPortReadInitialize ();
+
+  Status = gBS->LocateProtocol (&giMXSerialTxRingProtocolGuid, NULL, (VOID **)&Ring);
+  if (!EFI_ERROR (Status)) {
+    // The module that installed the ring drains it
+    if (Ring->Signature == IMX_UART_TX_RING_SIGNATURE) {
+      mTxRing = Ring;
+    }
+    return EFI_SUCCESS;
+  }
+
+  Ring = AllocatePool (sizeof (*Ring) + FixedPcdGet32 (PcdSerialTxRingSize));
+  if (Ring == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Ring->Signature = IMX_UART_TX_RING_SIGNATURE;
+  Ring->Size = FixedPcdGet32 (PcdSerialTxRingSize);
+  Ring->Head = 0;
+  Ring->Tail = 0;
+  Ring->DmaCount = 0;
+  Ring->Serviced = FALSE;
+
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                             TPL_NOTIFY,
+                             ExitBootServicesNotify,
+                             NULL,
+                             &mExitBootServicesEvent);
+  if (EFI_ERROR (Status)) {
+    goto FreeRing;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                             IMX_UART_TX_DRAIN_TPL,
+                             TxDrainNotify,
+                             NULL,
+                             &mTxDrainEvent);
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBootServicesEvent;
+  }
+
+  // The drain timer may fire as soon as it is set
+  mTxRing = Ring;
+  Status = gBS->SetTimer (mTxDrainEvent, TimerPeriodic, IMX_UART_TX_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    goto CloseDrainEvent;
+  }
+
+  Handle = NULL;
+  Status = gBS->InstallProtocolInterface (&Handle,
+                                          &giMXSerialTxRingProtocolGuid,
+                                          EFI_NATIVE_INTERFACE,
+                                          Ring);
+  if (EFI_ERROR (Status)) {
+    goto CloseDrainEvent;
+  }
+
+  Ring->Serviced = TRUE;
+
+  // Large transfers go through the SDMA when the platform enabled it
+  if (!RETURN_ERROR (UartSdmaInitialize ())) {
+    DxeUartSerialPortReadStartDma ();
+  }
+
+  return EFI_SUCCESS;
+
+CloseDrainEvent:
+  gBS->CloseEvent (mTxDrainEvent);
+  mTxDrainEvent = NULL;
+  mTxRing = NULL;
+
+CloseExitBootServicesEvent:
+  gBS->CloseEvent (mExitBootServicesEvent);
+  mExitBootServicesEvent = NULL;
+
+FreeRing:
+  FreePool (Ring);
+  return EFI_SUCCESS;
+}
+
+/**
+  Flush the transmit ring and close the events of this module.
+
+  The rings themselves are left installed for the other modules sharing them.
+  When this module services the rings, the other modules write synchronously
+  from now on.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeUartSerialPortLibDestructor (
+  IN  EFI_HANDLE          ImageHandle,
+  IN  EFI_SYSTEM_TABLE    *SystemTable
+  )
+{
+  EFI_TPL   OldTpl;
+
+  DxeUartSerialPortReadUninitialize ();
+
+  if (mTxRing == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  // Queued output of this module is left to the owner of the ring
+  if ((mTxDrainEvent != NULL) && mTxRing->Serviced) {
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    TxRingDrain (TRUE);
+    mTxRing->Serviced = FALSE;
+    gBS->RestoreTPL (OldTpl);
+    UartSdmaUninitialize ();
+    gBS->CloseEvent (mTxDrainEvent);
+    gBS->CloseEvent (mExitBootServicesEvent);
+  }
+
+  mTxRing = NULL;
+  return EFI_SUCCESS;
+}
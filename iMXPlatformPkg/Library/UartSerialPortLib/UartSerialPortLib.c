@@ -16,8 +16,44 @@
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
 #include <Library/SerialPortLib.h>
+#include <Library/TimerLib.h>
 #include <iMXUart.h>
 
+#include "UartSerialPortLib.h"
+
+/**
+  Enable or disable RTS/CTS hardware flow control.
+
+  When enabled, the receiver deasserts CTS_B once the RX FIFO reaches
+  MX6UART_CTS_TRIGGER_LEVEL characters, and the transmitter only sends while
+  the RTS_B input is asserted.
+
+  @param UartBase       Base address of the UART registers.
+  @param Enable         TRUE to enable hardware flow control, FALSE to let
+                        software drive CTS_B and ignore RTS_B.
+
+**/
+STATIC
+VOID
+UartSetHardwareFlowControl (
+  IN  MX6UART_REGISTERS   *UartBase,
+  IN  BOOLEAN             Enable
+  )
+{
+  if (Enable) {
+    MmioAndThenOr32 ((UINTN)&UartBase->Ucr4,
+                     ~MX6UART_UCR4_CTSTL_MASK,
+                     MX6UART_CTS_TRIGGER_LEVEL << MX6UART_UCR4_CTSTL_SHIFT);
+    MmioAndThenOr32 ((UINTN)&UartBase->Ucr2,
+                     ~MX6UART_UCR2_IRTS,
+                     MX6UART_UCR2_CTSC);
+  } else {
+    MmioAndThenOr32 ((UINTN)&UartBase->Ucr2,
+                     ~MX6UART_UCR2_CTSC,
+                     MX6UART_UCR2_IRTS);
+  }
+}
+
 /**
   Initialize the serial device hardware.
 
@@ -45,108 +81,152 @@ SerialPortInitialize (
     return RETURN_DEVICE_ERROR;
   }
 
+  // Use the lowest TX watermark to get the largest write burst
+  MmioAndThenOr32 ((UINTN)&UartBase->Ufcr,
+                   ~MX6UART_UFCR_TXTL_MASK,
+                   MX6UART_TX_WATERMARK_MIN << MX6UART_UFCR_TXTL_SHIFT);
+
+  if (FeaturePcdGet (PcdSerialUseHardwareFlowControl)) {
+    UartSetHardwareFlowControl (UartBase, TRUE);
+  }
+
   return RETURN_SUCCESS;
 }
 
 /**
-  Write data from buffer to serial device.
-
-  Writes NumberOfBytes data bytes from Buffer to the serial device.
-  The number of bytes actually written to the serial device is returned.
-  If the return value is less than NumberOfBytes, then the write operation failed.
-  If Buffer is NULL, then ASSERT().
-  If NumberOfBytes is zero, then return 0.
+  Write data from buffer to the UART transmit FIFO.
 
   @param  Buffer           Pointer to the data buffer to be written.
   @param  NumberOfBytes    Number of bytes to written to the serial device.
+  @param  Wait             TRUE to wait for FIFO space until all bytes are
+                           written, FALSE to stop as soon as the FIFO is full.
 
-  @retval 0                NumberOfBytes is 0.
-  @retval >0               The number of bytes written to the serial device.
-                           If this value is less than NumberOfBytes, then the
-                           read operation failed.
+  @retval                  The number of bytes written to the FIFO.
 
 **/
 UINTN
-EFIAPI
-SerialPortWrite (
-  IN  UINT8   *Buffer,
-  IN  UINTN   NumberOfBytes
+UartSerialPortWriteFifo (
+  IN  UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  IN  BOOLEAN   Wait
   )
 {
-  MX6UART_REGISTERS   *UartBase;
+  UINTN               BurstSize;
   UINTN               BytesSent;
+  UINT32              Threshold;
+  MX6UART_REGISTERS   *UartBase;
 
   UartBase = (MX6UART_REGISTERS*)FixedPcdGet32 (PcdSerialRegisterBase);
   BytesSent = 0;
+
+  // TRDY is set once the TX FIFO holds no more than TXTL characters, so a
+  // burst of (FIFO size - TXTL) characters can be written without checking
+  // TXFULL again.
+  Threshold = (MmioRead32 ((UINTN)&UartBase->Ufcr) & MX6UART_UFCR_TXTL_MASK) >>
+              MX6UART_UFCR_TXTL_SHIFT;
+  if ((Threshold < MX6UART_TX_WATERMARK_MIN) || (Threshold >= MX6UART_FIFO_COUNT)) {
+    // Reserved or unusable watermark, fall back to checking TXFULL per byte
+    while (BytesSent < NumberOfBytes) {
+      if ((MmioRead32 ((UINTN)&UartBase->Uts) & MX6UART_UTS_TXFULL) != 0) {
+        if (!Wait) {
+          break;
+        }
+        continue;
+      }
+      MmioWrite32 ((UINTN)&UartBase->Txd, Buffer[BytesSent]);
+      BytesSent++;
+    }
+
+    return BytesSent;
+  }
+
   while (BytesSent < NumberOfBytes) {
-    // Check if FIFO is full and wait if it is.
-    while ((MmioRead32 ((UINTN)&UartBase->Uts) & MX6UART_UTS_TXFULL) != 0);
-    MmioWrite32 ((UINTN)&UartBase->Txd, Buffer[BytesSent]);
-    BytesSent++;
+    // Wait for the FIFO to drain below the watermark
+    if ((MmioRead32 ((UINTN)&UartBase->Usr1) & MX6UART_USR1_TRDY) == 0) {
+      if (!Wait) {
+        break;
+      }
+      continue;
+    }
+
+    BurstSize = MIN (NumberOfBytes - BytesSent, MX6UART_FIFO_COUNT - Threshold);
+    while (BurstSize > 0) {
+      MmioWrite32 ((UINTN)&UartBase->Txd, Buffer[BytesSent]);
+      BytesSent++;
+      BurstSize--;
+    }
   }
 
   return BytesSent;
 }
 
 /**
-  Read data from serial device and save the datas in buffer.
+  Read data from the UART receive FIFO.
 
-  Reads NumberOfBytes data bytes from a serial device into the buffer
-  specified by Buffer. The number of bytes actually read is returned.
-  If the return value is less than NumberOfBytes, then the rest operation failed.
-  If Buffer is NULL, then ASSERT().
-  If NumberOfBytes is zero, then return 0.
+  Reads until the FIFO is empty or NumberOfBytes bytes have been read. A
+  receiver overrun flagged in USR2.ORE is cleared and reported through
+  ErrorStatus.
 
-  @param  Buffer            Pointer to the data buffer to store the data read
-                            from the serial device.
-  @param  NumberOfBytes     Number of bytes which will be read.
+  @param  Buffer           Pointer to the data buffer to store the data read
+                           from the receive FIFO.
+  @param  NumberOfBytes    Maximum number of bytes to read.
+  @param  ErrorStatus      Optional pointer to return the MX6UART_RXD error
+                           bits seen while reading. MX6UART_RXD_OVRRUN is set
+                           if characters were lost since the last call.
 
-  @retval 0                 Read data failed, No data is to be read.
-  @retval >0                Actual number of bytes read from serial device.
+  @retval                  The number of bytes read from the FIFO.
 
 **/
 UINTN
-EFIAPI
-SerialPortRead (
-  OUT UINT8   *Buffer,
-  IN  UINTN   NumberOfBytes
+UartSerialPortReadFifo (
+  OUT UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  OUT UINT32    *ErrorStatus OPTIONAL
   )
 {
-  MX6UART_REGISTERS   *UartBase;
   UINTN               BytesRead;
   UINT32              Data;
+  UINT32              Errors;
+  MX6UART_REGISTERS   *UartBase;
 
   UartBase = (MX6UART_REGISTERS*)FixedPcdGet32 (PcdSerialRegisterBase);
   BytesRead = 0;
+  Errors = 0;
+
+  // ORE is write one to clear
+  if ((MmioRead32 ((UINTN)&UartBase->Usr2) & MX6UART_USR2_ORE) != 0) {
+    MmioWrite32 ((UINTN)&UartBase->Usr2, MX6UART_USR2_ORE);
+    Errors |= MX6UART_RXD_ERR | MX6UART_RXD_OVRRUN;
+  }
+
   while (BytesRead < NumberOfBytes) {
     Data = MmioRead32 ((UINTN)&UartBase->Rxd);
     if ((Data & MX6UART_RXD_CHARRDY) == 0) {
       break;
     }
 
+    Errors |= Data & (MX6UART_RXD_ERR | MX6UART_RXD_OVRRUN | MX6UART_RXD_FRMERR |
+                      MX6UART_RXD_BRK | MX6UART_RXD_PRERR);
     Buffer[BytesRead] = (UINT8) (Data & MX6UART_RXD_RX_DATA_MASK);
     BytesRead++;
   }
 
+  if (ErrorStatus != NULL) {
+    *ErrorStatus = Errors;
+  }
+
   return BytesRead;
 }
 
 /**
-  Polls a serial device to see if there is any data waiting to be read.
-
-  Polls a serial device to see if there is any data waiting to be read.
-  If there is data waiting to be read from the serial device, then TRUE is
-  returned.
-  If there is no data waiting to be read from the serial device, then FALSE is
-  returned.
+  Check whether the UART receive FIFO holds data.
 
-  @retval TRUE          Data is waiting to be read from the serial device.
-  @retval FALSE         There is no data waiting to be read from the serial device.
+  @retval TRUE          At least one character is waiting in the receive FIFO.
+  @retval FALSE         The receive FIFO is empty.
 
 **/
 BOOLEAN
-EFIAPI
-SerialPortPoll (
+UartSerialPortPollFifo (
   VOID
   )
 {
@@ -164,6 +244,7 @@ SerialPortPoll (
 
   @param Control                Sets the bits of Control that are settable.
 
+  @retval RETURN_SUCCESS        The new control bits were set on the serial device.
   @retval RETURN_UNSUPPORTED    The serial device does not support this operation.
 
 **/
@@ -173,7 +254,34 @@ SerialPortSetControl (
   IN UINT32   Control
   )
 {
-  return RETURN_UNSUPPORTED;
+  MX6UART_REGISTERS   *UartBase;
+
+  if ((Control & ~(EFI_SERIAL_REQUEST_TO_SEND |
+                   EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE |
+                   EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE)) != 0) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  UartBase = (MX6UART_REGISTERS*)FixedPcdGet32 (PcdSerialRegisterBase);
+
+  UartSetHardwareFlowControl (UartBase,
+                              (Control & EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE) != 0);
+
+  // UCR2.CTS drives the CTS_B output, which is the RTS signal of the peer.
+  // It is ignored while the receiver controls CTS_B.
+  if ((Control & EFI_SERIAL_REQUEST_TO_SEND) != 0) {
+    MmioOr32 ((UINTN)&UartBase->Ucr2, MX6UART_UCR2_CTS);
+  } else {
+    MmioAnd32 ((UINTN)&UartBase->Ucr2, ~MX6UART_UCR2_CTS);
+  }
+
+  if ((Control & EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE) != 0) {
+    MmioOr32 ((UINTN)&UartBase->Uts, MX6UART_UTS_LOOP);
+  } else {
+    MmioAnd32 ((UINTN)&UartBase->Uts, ~MX6UART_UTS_LOOP);
+  }
+
+  return RETURN_SUCCESS;
 }
 
 /**
@@ -182,7 +290,7 @@ SerialPortSetControl (
   @param Control                A pointer to return the current control signals
                                 from the serial device.
 
-  @retval RETURN_UNSUPPORTED    The serial device does not support this operation.
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
 
 **/
 RETURN_STATUS
@@ -191,7 +299,139 @@ SerialPortGetControl (
   OUT UINT32  *Control
   )
 {
-  return RETURN_UNSUPPORTED;
+  MX6UART_REGISTERS   *UartBase;
+  UINT32              Ucr2;
+  UINT32              Usr1;
+  UINT32              Usr2;
+
+  UartBase = (MX6UART_REGISTERS*)FixedPcdGet32 (PcdSerialRegisterBase);
+  Usr1 = MmioRead32 ((UINTN)&UartBase->Usr1);
+  Usr2 = MmioRead32 ((UINTN)&UartBase->Usr2);
+
+  *Control = 0;
+
+  // USR1.RTSS reflects the RTS_B input, which is the CTS signal of the peer
+  if ((Usr1 & MX6UART_USR1_RTSS) != 0) {
+    *Control |= EFI_SERIAL_CLEAR_TO_SEND;
+  }
+
+  Ucr2 = MmioRead32 ((UINTN)&UartBase->Ucr2);
+  if ((Ucr2 & MX6UART_UCR2_CTS) != 0) {
+    *Control |= EFI_SERIAL_REQUEST_TO_SEND;
+  }
+
+  if (((Ucr2 & MX6UART_UCR2_CTSC) != 0) && ((Ucr2 & MX6UART_UCR2_IRTS) == 0)) {
+    *Control |= EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE;
+  }
+
+  // Data may already have been moved from the FIFO to a receive ring
+  if (!SerialPortPoll ()) {
+    *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  }
+
+  if ((Usr2 & MX6UART_USR2_TXDC) != 0) {
+    *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+
+  if ((MmioRead32 ((UINTN)&UartBase->Uts) & MX6UART_UTS_LOOP) != 0) {
+    *Control |= EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Compute the RFDIV, UBIR and UBMR values for a baud rate.
+
+  The baud rate is given by RefFreq / (16 * (UBMR + 1) / (UBIR + 1)), where
+  RefFreq is the UART module clock divided by RFDIV.
+
+  @param BaudRate           The requested baud rate. On output, the value
+                            actually achieved.
+  @param Ufcr               On output, the UFCR.RFDIV field value.
+  @param Ubir               On output, the UBIR register value.
+  @param Ubmr               On output, the UBMR register value.
+  @param ReferenceFrequency On output, the divided reference frequency.
+
+  @retval RETURN_SUCCESS            The divider values were computed.
+  @retval RETURN_INVALID_PARAMETER  The baud rate can not be reached from the
+                                    UART module clock.
+
+**/
+STATIC
+RETURN_STATUS
+UartCalculateBaudDivisor (
+  IN OUT UINT64   *BaudRate,
+  OUT    UINT32   *Ufcr,
+  OUT    UINT32   *Ubir,
+  OUT    UINT32   *Ubmr,
+  OUT    UINT32   *ReferenceFrequency
+  )
+{
+  UINT64  Denominator;
+  UINT32  Divider;
+  UINT64  Numerator;
+  UINT64  Remainder;
+  UINT64  Value0;
+  UINT64  Value1;
+
+  // RFDIV encoding of the module clock dividers 1 to 7
+  STATIC CONST UINT32 RfDivEncoding[] = {
+    MX6UART_UFCR_RFDIV_1,
+    MX6UART_UFCR_RFDIV_2,
+    MX6UART_UFCR_RFDIV_3,
+    MX6UART_UFCR_RFDIV_4,
+    MX6UART_UFCR_RFDIV_5,
+    MX6UART_UFCR_RFDIV_6,
+    MX6UART_UFCR_RFDIV_7,
+  };
+
+  if ((*BaudRate == 0) ||
+      (MultU64x32 (*BaudRate, 16) > FixedPcdGet32 (PcdSerialClockFrequency))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  // Divide the module clock as much as possible while keeping the reference
+  // clock above 16 times the baud rate, to keep UBIR/UBMR small.
+  Divider = (UINT32)DivU64x64Remainder (FixedPcdGet32 (PcdSerialClockFrequency),
+                                        MultU64x32 (*BaudRate, 16),
+                                        NULL);
+  Divider = MAX (1, MIN (Divider, ARRAY_SIZE (RfDivEncoding)));
+  *ReferenceFrequency = FixedPcdGet32 (PcdSerialClockFrequency) / Divider;
+  *Ufcr = RfDivEncoding[Divider - 1];
+
+  // Reduce (16 * BaudRate) / ReferenceFrequency to the 16-bit UBIR/UBMR
+  // registers, first by the greatest common divisor, then by picking the
+  // largest numerator that keeps the rounded denominator in range. The
+  // reference clock is at least 16 times the baud rate, so the numerator is
+  // never the larger of the two.
+  Numerator = MultU64x32 (*BaudRate, 16);
+  Denominator = *ReferenceFrequency;
+  Value0 = Numerator;
+  Value1 = Denominator;
+  while (Value1 != 0) {
+    DivU64x64Remainder (Value0, Value1, &Remainder);
+    Value0 = Value1;
+    Value1 = Remainder;
+  }
+  Numerator = DivU64x64Remainder (Numerator, Value0, NULL);
+  Denominator = DivU64x64Remainder (Denominator, Value0, NULL);
+  if (Denominator > 0x10000) {
+    Value0 = MAX (1, DivU64x64Remainder (MultU64x32 (Numerator, 0x10000), Denominator, NULL));
+    Denominator = DivU64x64Remainder (MultU64x32 (Denominator, (UINT32)Value0 * 2) + Numerator,
+                                      MultU64x32 (Numerator, 2),
+                                      NULL);
+    Denominator = MIN (Denominator, 0x10000);
+    Numerator = Value0;
+  }
+
+  *Ubir = (UINT32)Numerator - 1;
+  *Ubmr = (UINT32)Denominator - 1;
+  *BaudRate = DivU64x64Remainder (MultU64x32 (Numerator, *ReferenceFrequency),
+                                  MultU64x32 (Denominator, 16),
+                                  NULL);
+
+  return RETURN_SUCCESS;
 }
 
 /**
@@ -224,7 +464,11 @@ SerialPortGetControl (
                             device's default number of stop bits.
                             On output, the value actually set.
 
-  @retval RETURN_UNSUPPORTED        The serial device does not support this operation.
+  @retval RETURN_SUCCESS            The new attributes were set on the serial device.
+  @retval RETURN_INVALID_PARAMETER  One or more of the attributes has an
+                                    unsupported value.
+  @retval RETURN_TIMEOUT            The pending characters could not be sent
+                                    with the old settings, nothing was changed.
 
 **/
 RETURN_STATUS
@@ -238,5 +482,136 @@ SerialPortSetAttributes (
   IN OUT EFI_STOP_BITS_TYPE *StopBits
   )
 {
-  return RETURN_UNSUPPORTED;
+  UINT64              ActualBaudRate;
+  UINT8               ActualDataBits;
+  EFI_PARITY_TYPE     ActualParity;
+  UINT32              ActualReceiveFifoDepth;
+  EFI_STOP_BITS_TYPE  ActualStopBits;
+  UINT32              ActualTimeout;
+  UINT64              Counter;
+  UINT32              ReferenceFrequency;
+  RETURN_STATUS       Status;
+  UINT32              Ubir;
+  UINT32              Ubmr;
+  UINT32              Ucr2;
+  UINT32              Ufcr;
+  MX6UART_REGISTERS   *UartBase;
+
+  UartBase = (MX6UART_REGISTERS*)FixedPcdGet32 (PcdSerialRegisterBase);
+
+  // Validate everything before touching the hardware or the caller values,
+  // they are only updated once the new settings are in effect.
+  ActualBaudRate = *BaudRate;
+  if (ActualBaudRate == 0) {
+    ActualBaudRate = FixedPcdGet64 (PcdUartDefaultBaudRate);
+  }
+
+  Status = UartCalculateBaudDivisor (&ActualBaudRate,
+                                     &Ufcr,
+                                     &Ubir,
+                                     &Ubmr,
+                                     &ReferenceFrequency);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Ucr2 = 0;
+
+  ActualDataBits = *DataBits;
+  if (ActualDataBits == 0) {
+    ActualDataBits = FixedPcdGet8 (PcdUartDefaultDataBits);
+  }
+  switch (ActualDataBits) {
+  case 7:
+    break;
+  case 8:
+    Ucr2 |= MX6UART_UCR2_WS;
+    break;
+  default:
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  ActualParity = *Parity;
+  if (ActualParity == DefaultParity) {
+    ActualParity = (EFI_PARITY_TYPE)FixedPcdGet8 (PcdUartDefaultParity);
+  }
+  switch (ActualParity) {
+  case NoParity:
+    break;
+  case EvenParity:
+    Ucr2 |= MX6UART_UCR2_PREN;
+    break;
+  case OddParity:
+    Ucr2 |= MX6UART_UCR2_PREN | MX6UART_UCR2_PROE;
+    break;
+  default:
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  ActualStopBits = *StopBits;
+  if (ActualStopBits == DefaultStopBits) {
+    ActualStopBits = (EFI_STOP_BITS_TYPE)FixedPcdGet8 (PcdUartDefaultStopBits);
+  }
+  switch (ActualStopBits) {
+  case OneStopBit:
+    break;
+  case TwoStopBits:
+    Ucr2 |= MX6UART_UCR2_STPB;
+    break;
+  default:
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  // The FIFO size is fixed, the requested depth sets the RX trigger level.
+  // While the SDMA empties the FIFO its burst size depends on the trigger
+  // level, which is then kept.
+  ActualReceiveFifoDepth = *ReceiveFifoDepth;
+  if (ActualReceiveFifoDepth > MX6UART_FIFO_COUNT) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  if ((ActualReceiveFifoDepth != 0) &&
+      ((MmioRead32 ((UINTN)&UartBase->Ucr1) & MX6UART_UCR1_RXDMAEN) == 0)) {
+    Ufcr |= ActualReceiveFifoDepth << MX6UART_UFCR_RXTL_SHIFT;
+  } else {
+    Ufcr |= MmioRead32 ((UINTN)&UartBase->Ufcr) & MX6UART_UFCR_RXTL_MASK;
+    ActualReceiveFifoDepth = MX6UART_FIFO_COUNT;
+  }
+
+  // Character timeouts are not used by this polled driver
+  ActualTimeout = *Timeout;
+  if (ActualTimeout == 0) {
+    ActualTimeout = FixedPcdGet32 (PcdUartDefaultTimeout);
+  }
+
+  // Let pending characters go out with the old settings. With hardware flow
+  // control the peer may hold them back forever, so allow a character
+  // timeout for each character of the FIFO and the shift register.
+  Counter = MultU64x32 (MX6UART_FIFO_COUNT + 1, ActualTimeout);
+  while ((MmioRead32 ((UINTN)&UartBase->Usr2) & MX6UART_USR2_TXDC) == 0) {
+    if (Counter == 0) {
+      return RETURN_TIMEOUT;
+    }
+    MicroSecondDelay (1);
+    --Counter;
+  }
+
+  Ufcr |= MmioRead32 ((UINTN)&UartBase->Ufcr) &
+          (MX6UART_UFCR_DCEDTE | MX6UART_UFCR_TXTL_MASK);
+  MmioWrite32 ((UINTN)&UartBase->Ufcr, Ufcr);
+  MmioAndThenOr32 ((UINTN)&UartBase->Ucr2,
+                   ~(MX6UART_UCR2_WS | MX6UART_UCR2_STPB | MX6UART_UCR2_PREN | MX6UART_UCR2_PROE),
+                   Ucr2);
+
+  // UBIR must be written before UBMR, writing UBMR updates the divider
+  MmioWrite32 ((UINTN)&UartBase->Ubir, Ubir);
+  MmioWrite32 ((UINTN)&UartBase->Ubmr, Ubmr);
+  MmioWrite32 ((UINTN)&UartBase->Onems, ReferenceFrequency / 1000);
+
+  *BaudRate = ActualBaudRate;
+  *ReceiveFifoDepth = ActualReceiveFifoDepth;
+  *Timeout = ActualTimeout;
+  *Parity = ActualParity;
+  *DataBits = ActualDataBits;
+  *StopBits = ActualStopBits;
+  return RETURN_SUCCESS;
 }
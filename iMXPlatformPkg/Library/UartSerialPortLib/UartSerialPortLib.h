@@ -0,0 +1,222 @@
+/** @file
+
+  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef _UART_SERIAL_PORT_LIB_H_
+#define _UART_SERIAL_PORT_LIB_H_
+
+/**
+  Write data from buffer to the UART transmit FIFO.
+
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written to the serial device.
+  @param  Wait             TRUE to wait for FIFO space until all bytes are
+                           written, FALSE to stop as soon as the FIFO is full.
+
+  @retval                  The number of bytes written to the FIFO.
+
+**/
+UINTN
+UartSerialPortWriteFifo (
+  IN  UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  IN  BOOLEAN   Wait
+  );
+
+/**
+  Read data from the UART receive FIFO.
+
+  Reads until the FIFO is empty or NumberOfBytes bytes have been read. A
+  receiver overrun flagged in USR2.ORE is cleared and reported through
+  ErrorStatus.
+
+  @param  Buffer           Pointer to the data buffer to store the data read
+                           from the receive FIFO.
+  @param  NumberOfBytes    Maximum number of bytes to read.
+  @param  ErrorStatus      Optional pointer to return the MX6UART_RXD error
+                           bits seen while reading. MX6UART_RXD_OVRRUN is set
+                           if characters were lost since the last call.
+
+  @retval                  The number of bytes read from the FIFO.
+
+**/
+UINTN
+UartSerialPortReadFifo (
+  OUT UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  OUT UINT32    *ErrorStatus OPTIONAL
+  );
+
+/**
+  Check whether the UART receive FIFO holds data.
+
+  @retval TRUE          At least one character is waiting in the receive FIFO.
+  @retval FALSE         The receive FIFO is empty.
+
+**/
+BOOLEAN
+UartSerialPortPollFifo (
+  VOID
+  );
+
+/**
+  Set up the shared receive ring of the DXE instance.
+
+**/
+VOID
+DxeUartSerialPortReadInitialize (
+  VOID
+  );
+
+/**
+  Stop filling the receive ring from the calling module.
+
+**/
+VOID
+DxeUartSerialPortReadUninitialize (
+  VOID
+  );
+
+/**
+  Let the SDMA empty the receive FIFO once this module set it up.
+
+**/
+VOID
+DxeUartSerialPortReadStartDma (
+  VOID
+  );
+
+/**
+  Set up the SDMA to move data between memory and the console UART.
+
+  @retval RETURN_SUCCESS            The SDMA is ready.
+  @retval RETURN_UNSUPPORTED        The SDMA is disabled or in use.
+  @retval Others                    The SDMA could not be set up.
+
+**/
+RETURN_STATUS
+UartSdmaInitialize (
+  VOID
+  );
+
+/**
+  Stop the UART channels and give the SDMA back, keeping the descriptors.
+
+**/
+VOID
+UartSdmaStop (
+  VOID
+  );
+
+/**
+  Stop the SDMA and free its descriptors and receive buffers.
+
+**/
+VOID
+UartSdmaUninitialize (
+  VOID
+  );
+
+/**
+  Start sending a buffer through the SDMA.
+
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written to the serial device.
+
+  @retval                  The number of bytes handed to the SDMA, 0 if the
+                           caller has to write the FIFO itself.
+
+**/
+UINTN
+UartSdmaTxStart (
+  IN  UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  );
+
+/**
+  Check for the completion of the transfer started by UartSdmaTxStart.
+
+  @retval TRUE          The SDMA wrote the whole buffer to the FIFO.
+  @retval FALSE         The transfer is still in flight.
+
+**/
+BOOLEAN
+UartSdmaTxDone (
+  VOID
+  );
+
+/**
+  Let the SDMA empty the receive FIFO into the receive buffers.
+
+  @retval RETURN_SUCCESS        Reception runs through the SDMA.
+  @retval RETURN_UNSUPPORTED    This module did not set up the SDMA.
+
+**/
+RETURN_STATUS
+UartSdmaRxStart (
+  VOID
+  );
+
+/**
+  Give the receive FIFO back to the CPU.
+
+**/
+VOID
+UartSdmaRxStop (
+  VOID
+  );
+
+/**
+  Read data the SDMA received.
+
+  @param  Buffer           Pointer to the data buffer to store the data.
+  @param  NumberOfBytes    Maximum number of bytes to read.
+  @param  ErrorStatus      Optional pointer to return the MX6UART_RXD error
+                           bits seen since the last call.
+
+  @retval                  The number of bytes read.
+
+**/
+UINTN
+UartSdmaRxRead (
+  OUT UINT8     *Buffer,
+  IN  UINTN     NumberOfBytes,
+  OUT UINT32    *ErrorStatus OPTIONAL
+  );
+
+/**
+  Check whether received data is waiting in the receive FIFO or in a receive
+  buffer of the SDMA.
+
+  @retval TRUE          Data is waiting to be read.
+  @retval FALSE         No data is waiting.
+
+**/
+BOOLEAN
+UartSdmaRxPoll (
+  VOID
+  );
+
+/**
+  Check whether the SDMA of any module empties the receive FIFO.
+
+  @retval TRUE          The receive FIFO must not be read by the CPU.
+  @retval FALSE         The CPU reads the receive FIFO.
+
+**/
+BOOLEAN
+UartSdmaRxActive (
+  VOID
+  );
+
+#endif // _UART_SERIAL_PORT_LIB_H_
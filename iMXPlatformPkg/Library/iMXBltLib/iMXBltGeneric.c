@@ -0,0 +1,38 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+
+#include "iMXBltLibInternal.h"
+
+VOID
+iMXBltFill (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Pixel
+  )
+{
+  SetMem32 (Destination, Count * sizeof (UINT32), Pixel);
+}
+
+VOID
+iMXBltCopyForward (
+  OUT UINT32        *Destination,
+  IN  CONST UINT32  *Source,
+  IN  UINTN         Count
+  )
+{
+  CopyMem (Destination, Source, Count * sizeof (UINT32));
+}
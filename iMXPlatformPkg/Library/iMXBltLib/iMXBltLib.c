@@ -0,0 +1,1023 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <iMXBltLib.h>
+
+#include "iMXBltLibInternal.h"
+
+#define PIXEL_BYTES 4
+
+// Period of the timer event copying dirty rectangles to the frame buffer,
+// in 100ns units
+#define IMX_BLT_FLUSH_PERIOD    (16 * 1000 * 10)
+
+// Blt may be called up to TPL_NOTIFY, the flush event runs at that level
+#define IMX_BLT_TPL             TPL_NOTIFY
+
+/**
+  Return the first visible line of the frame buffer.
+
+**/
+STATIC
+UINT32 *
+iMXBltScreen (
+  IN  IMX_BLT_CONTEXT   *Context
+  )
+{
+  return Context->FrameBuffer +
+         (Context->ScanoutRow * Context->PixelsPerScanLine);
+}
+
+/**
+  Return the length of a rectangle of the frame as one run of pixels.
+
+  A rectangle starting at the left edge and spanning the whole width covers
+  every line from its first to its last pixel, apart from the padding at the
+  end of each line. Nothing is visible in the padding, so such a rectangle
+  can be filled or copied as one run that includes it.
+
+  @retval 0       The rectangle does not span whole lines.
+  @retval Others  Number of pixels from the first to the last pixel of the
+                  rectangle.
+
+**/
+STATIC
+UINTN
+iMXBltRunLength (
+  IN  IMX_BLT_CONTEXT   *Context,
+  IN  UINTN             X,
+  IN  UINTN             Width,
+  IN  UINTN             Height
+  )
+{
+  if ((X != 0) || (Width != Context->Width)) {
+    return 0;
+  }
+
+  return (Context->PixelsPerScanLine * (Height - 1)) + Width;
+}
+
+/**
+  Clip a span of pixels or lines to a frame dimension.
+
+  @param[in]      Limit     Frame width or height.
+  @param[in]      Start     First pixel or line of the span.
+  @param[in, out] Length    Length of the span, shortened to end at Limit.
+
+  @retval TRUE              Some of the span lies inside the frame.
+  @retval FALSE             The span starts outside the frame.
+
+**/
+STATIC
+BOOLEAN
+iMXBltClip (
+  IN      UINTN   Limit,
+  IN      UINTN   Start,
+  IN OUT  UINTN   *Length
+  )
+{
+  if (Start >= Limit) {
+    return FALSE;
+  }
+
+  // Compare against the room left so Start + Length can not overflow
+  if (*Length > Limit - Start) {
+    *Length = Limit - Start;
+  }
+  return TRUE;
+}
+
+/**
+  Copy a run of pixels, which may overlap.
+
+  Uses the forward kernel whenever it can not overwrite pixels before
+  reading them, falling back to CopyMem otherwise.
+
+**/
+STATIC
+VOID
+iMXBltMove (
+  OUT UINT32        *Destination,
+  IN  CONST UINT32  *Source,
+  IN  UINTN         Count
+  )
+{
+  if ((Destination <= Source) || (Destination >= Source + Count)) {
+    iMXBltCopyForward (Destination, Source, Count);
+  } else {
+    CopyMem (Destination, Source, Count * PIXEL_BYTES);
+  }
+}
+
+/**
+  Write a rectangle of the frame buffer back from the data cache.
+
+  Each line is cleaned on its own so small rectangles, such as glyphs, do
+  not clean whole lines of the screen.
+
+**/
+STATIC
+VOID
+iMXBltCleanRectangle (
+  IN  IMX_BLT_CONTEXT           *Context,
+  IN  CONST IMX_BLT_RECTANGLE   *Rectangle
+  )
+{
+  UINT32  *Screen;
+  UINTN   FrameOffset;
+  UINTN   i;
+  UINTN   Run;
+
+  if ((Context->Flags & IMX_BLT_FLAG_CLEAN_FRAME_BUFFER) == 0) {
+    return;
+  }
+
+  Screen = iMXBltScreen (Context);
+  FrameOffset = Context->PixelsPerScanLine * Rectangle->Y + Rectangle->X;
+  Run = iMXBltRunLength (Context, Rectangle->X, Rectangle->Width, Rectangle->Height);
+  if (Run != 0) {
+    WriteBackDataCacheRange (Screen + FrameOffset, Run * PIXEL_BYTES);
+    return;
+  }
+
+  for (i = 0; i < Rectangle->Height; i++) {
+    WriteBackDataCacheRange (
+      Screen + FrameOffset,
+      Rectangle->Width * PIXEL_BYTES
+    );
+    FrameOffset += Context->PixelsPerScanLine;
+  }
+}
+
+/**
+  Copy a rectangle from the shadow buffer to the frame buffer.
+
+**/
+STATIC
+VOID
+iMXBltCopyRectangle (
+  IN  IMX_BLT_CONTEXT           *Context,
+  IN  CONST IMX_BLT_RECTANGLE   *Rectangle
+  )
+{
+  UINT32  *Screen;
+  UINTN   FrameOffset;
+  UINTN   i;
+  UINTN   Run;
+
+  Screen = iMXBltScreen (Context);
+  FrameOffset = Context->PixelsPerScanLine * Rectangle->Y + Rectangle->X;
+  Run = iMXBltRunLength (Context, Rectangle->X, Rectangle->Width, Rectangle->Height);
+  if (Run != 0) {
+    iMXBltCopyForward (Screen + FrameOffset, Context->ShadowBuffer + FrameOffset, Run);
+  } else {
+    for (i = 0; i < Rectangle->Height; i++) {
+      iMXBltCopyForward (
+        Screen + FrameOffset,
+        Context->ShadowBuffer + FrameOffset,
+        Rectangle->Width
+      );
+      FrameOffset += Context->PixelsPerScanLine;
+    }
+  }
+
+  iMXBltCleanRectangle (Context, Rectangle);
+}
+
+/**
+  Check whether two rectangles overlap or share an edge.
+
+**/
+STATIC
+BOOLEAN
+iMXBltRectanglesTouch (
+  IN  CONST IMX_BLT_RECTANGLE   *First,
+  IN  CONST IMX_BLT_RECTANGLE   *Second
+  )
+{
+  return (First->X <= Second->X + Second->Width) &&
+         (Second->X <= First->X + First->Width) &&
+         (First->Y <= Second->Y + Second->Height) &&
+         (Second->Y <= First->Y + First->Height);
+}
+
+/**
+  Grow a rectangle to the bounding box of itself and another rectangle.
+
+**/
+STATIC
+VOID
+iMXBltRectangleUnion (
+  IN OUT  IMX_BLT_RECTANGLE         *Rectangle,
+  IN      CONST IMX_BLT_RECTANGLE   *Other
+  )
+{
+  UINTN   Right;
+  UINTN   Bottom;
+
+  Right = MAX (Rectangle->X + Rectangle->Width, Other->X + Other->Width);
+  Bottom = MAX (Rectangle->Y + Rectangle->Height, Other->Y + Other->Height);
+  Rectangle->X = MIN (Rectangle->X, Other->X);
+  Rectangle->Y = MIN (Rectangle->Y, Other->Y);
+  Rectangle->Width = Right - Rectangle->X;
+  Rectangle->Height = Bottom - Rectangle->Y;
+}
+
+/**
+  Record a changed rectangle of the shadow buffer.
+
+  Rectangles that overlap or touch are merged into their bounding box, so a
+  line of text or a scrolled region is copied as one rectangle. Once the
+  list is full, the new rectangle is merged with the entry whose bounding
+  box grows the least.
+
+  Must be called at IMX_BLT_TPL.
+
+**/
+STATIC
+VOID
+iMXBltAddDirtyRectangle (
+  IN  IMX_BLT_CONTEXT   *Context,
+  IN  UINTN             X,
+  IN  UINTN             Y,
+  IN  UINTN             Width,
+  IN  UINTN             Height
+  )
+{
+  UINTN               BestGrowth;
+  UINT32              BestIndex;
+  UINTN               Growth;
+  UINT32              Index;
+  IMX_BLT_RECTANGLE   Merged;
+  IMX_BLT_RECTANGLE   Rectangle;
+
+  if ((Width == 0) || (Height == 0)) {
+    return;
+  }
+
+  Rectangle.X = X;
+  Rectangle.Y = Y;
+  Rectangle.Width = Width;
+  Rectangle.Height = Height;
+
+  // A merged rectangle may touch entries it did not touch before, so
+  // restart the scan after every merge
+  Index = 0;
+  while (Index < Context->DirtyCount) {
+    if (iMXBltRectanglesTouch (&Rectangle, &Context->Dirty[Index])) {
+      iMXBltRectangleUnion (&Rectangle, &Context->Dirty[Index]);
+      Context->DirtyCount--;
+      Context->Dirty[Index] = Context->Dirty[Context->DirtyCount];
+      Index = 0;
+      continue;
+    }
+    Index++;
+  }
+
+  if (Context->DirtyCount == IMX_BLT_DIRTY_RECTANGLE_COUNT) {
+    BestIndex = 0;
+    BestGrowth = MAX_UINTN;
+    for (Index = 0; Index < Context->DirtyCount; Index++) {
+      Merged = Context->Dirty[Index];
+      iMXBltRectangleUnion (&Merged, &Rectangle);
+      Growth = (Merged.Width * Merged.Height) -
+               (Context->Dirty[Index].Width * Context->Dirty[Index].Height);
+      if (Growth < BestGrowth) {
+        BestGrowth = Growth;
+        BestIndex = Index;
+      }
+    }
+
+    iMXBltRectangleUnion (&Context->Dirty[BestIndex], &Rectangle);
+    return;
+  }
+
+  Context->Dirty[Context->DirtyCount] = Rectangle;
+  Context->DirtyCount++;
+}
+
+/**
+  Copy all dirty rectangles to the frame buffer.
+
+  Must be called at IMX_BLT_TPL.
+
+**/
+STATIC
+VOID
+iMXBltFlushDirtyRectangles (
+  IN  IMX_BLT_CONTEXT   *Context
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Context->DirtyCount; Index++) {
+    iMXBltCopyRectangle (Context, &Context->Dirty[Index]);
+  }
+
+  Context->DirtyCount = 0;
+}
+
+/**
+  Copy whole lines within the frame buffer, cleaning them if needed.
+
+  Lines are counted from the start of the frame buffer, not from the first
+  visible line. The ranges may overlap.
+
+**/
+STATIC
+VOID
+iMXBltMoveRows (
+  IN  IMX_BLT_CONTEXT   *Context,
+  IN  UINTN             DestinationRow,
+  IN  UINTN             SourceRow,
+  IN  UINTN             Count
+  )
+{
+  UINT32  *Destination;
+  UINTN   Size;
+
+  if ((Count == 0) || (DestinationRow == SourceRow)) {
+    return;
+  }
+
+  Destination = Context->FrameBuffer + (DestinationRow * Context->PixelsPerScanLine);
+  Size = Count * Context->PixelsPerScanLine * PIXEL_BYTES;
+  iMXBltMove (
+    Destination,
+    Context->FrameBuffer + (SourceRow * Context->PixelsPerScanLine),
+    Count * Context->PixelsPerScanLine
+  );
+
+  if ((Context->Flags & IMX_BLT_FLAG_CLEAN_FRAME_BUFFER) != 0) {
+    WriteBackDataCacheRange (Destination, Size);
+  }
+}
+
+/**
+  Check whether an EfiBltVideoToVideo operation can be done by moving the
+  scanout address.
+
+  Only full width operations moving lines up qualify. The lines outside of
+  the moved rectangle are still copied, so the rectangle must cover more
+  than half of the screen for this to be a win.
+
+**/
+STATIC
+BOOLEAN
+iMXBltIsScroll (
+  IN  IMX_BLT_CONTEXT   *Context,
+  IN  UINTN             SourceX,
+  IN  UINTN             SourceY,
+  IN  UINTN             DestinationX,
+  IN  UINTN             DestinationY,
+  IN  UINTN             Width,
+  IN  UINTN             Height
+  )
+{
+  return (Context->SetScanout != NULL) &&
+         !Context->ExitBootServices &&
+         (SourceX == 0) &&
+         (DestinationX == 0) &&
+         (Width == Context->Width) &&
+         (SourceY > DestinationY) &&
+         (SourceY + Height <= Context->Height) &&
+         (Height > Context->Height / 2);
+}
+
+/**
+  Scroll lines up by moving the visible window through the frame buffer.
+
+  The moved rectangle stays where it is in memory and the window advances by
+  the scroll distance. Only the lines above and below the rectangle are
+  copied to their new place. Once the window would run past the end of the
+  frame buffer the whole screen is copied back to the start.
+
+  With a shadow buffer, the shadow must already hold the scrolled image and
+  have no dirty rectangles left; the lines are then copied from it.
+
+  Must be called at IMX_BLT_TPL.
+
+**/
+STATIC
+VOID
+iMXBltScroll (
+  IN  IMX_BLT_CONTEXT   *Context,
+  IN  UINTN             SourceY,
+  IN  UINTN             DestinationY,
+  IN  UINTN             Height
+  )
+{
+  UINTN               Bottom;
+  UINTN               Lines;
+  UINTN               NewRow;
+  UINTN               OldRow;
+  IMX_BLT_RECTANGLE   Rectangle;
+
+  Bottom = DestinationY + Height;
+  Lines = SourceY - DestinationY;
+  OldRow = Context->ScanoutRow;
+  if (OldRow + Lines + Context->Height <= Context->BufferHeight) {
+    NewRow = OldRow + Lines;
+  } else {
+    NewRow = 0;
+  }
+
+  if ((Context->Flags & IMX_BLT_FLAG_SHADOW) != 0) {
+    Context->ScanoutRow = NewRow;
+    Rectangle.X = 0;
+    Rectangle.Width = Context->Width;
+    if (NewRow == 0) {
+      Rectangle.Y = 0;
+      Rectangle.Height = Context->Height;
+      iMXBltCopyRectangle (Context, &Rectangle);
+    } else {
+      Rectangle.Y = 0;
+      Rectangle.Height = DestinationY;
+      if (Rectangle.Height != 0) {
+        iMXBltCopyRectangle (Context, &Rectangle);
+      }
+      Rectangle.Y = Bottom;
+      Rectangle.Height = Context->Height - Bottom;
+      if (Rectangle.Height != 0) {
+        iMXBltCopyRectangle (Context, &Rectangle);
+      }
+    }
+  } else if (NewRow == 0) {
+    // Every source line is at or below its destination, so copying from
+    // the top down never reads a line already overwritten
+    iMXBltMoveRows (Context, 0, OldRow, DestinationY);
+    iMXBltMoveRows (Context, DestinationY, OldRow + SourceY, Height);
+    iMXBltMoveRows (Context, Bottom, OldRow + Bottom, Context->Height - Bottom);
+    Context->ScanoutRow = 0;
+  } else {
+    iMXBltMoveRows (Context, NewRow, OldRow, DestinationY);
+    iMXBltMoveRows (
+      Context,
+      NewRow + Bottom,
+      OldRow + Bottom,
+      Context->Height - Bottom
+    );
+    Context->ScanoutRow = NewRow;
+  }
+
+  Context->SetScanout (
+             Context->SetScanoutContext,
+             NewRow * Context->PixelsPerScanLine * PIXEL_BYTES
+           );
+}
+
+STATIC
+VOID
+EFIAPI
+iMXBltFlushNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  iMXBltFlushDirtyRectangles ((IMX_BLT_CONTEXT *)Context);
+}
+
+STATIC
+VOID
+EFIAPI
+iMXBltExitBootServicesNotify (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  )
+{
+  IMX_BLT_CONTEXT   *BltContext;
+
+  // Hand the OS a frame buffer with everything drawn so far, starting at
+  // the frame buffer base
+  BltContext = (IMX_BLT_CONTEXT *)Context;
+  iMXBltFlushDirtyRectangles (BltContext);
+  if (BltContext->ScanoutRow != 0) {
+    iMXBltMoveRows (BltContext, 0, BltContext->ScanoutRow, BltContext->Height);
+    BltContext->ScanoutRow = 0;
+    BltContext->SetScanout (BltContext->SetScanoutContext, 0);
+  }
+  BltContext->ExitBootServices = TRUE;
+}
+
+/**
+  Set up the shadow buffer of a Blt context and the events flushing it.
+
+  @retval EFI_SUCCESS             The shadow buffer is in use.
+  @retval EFI_OUT_OF_RESOURCES    The shadow buffer could not be allocated.
+
+**/
+STATIC
+EFI_STATUS
+iMXBltInitializeShadow (
+  IN  IMX_BLT_CONTEXT   *Context
+  )
+{
+  UINTN       Size;
+  EFI_STATUS  Status;
+
+  Size = Context->PixelsPerScanLine * Context->Height * PIXEL_BYTES;
+  Context->ShadowBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Size));
+  if (Context->ShadowBuffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  // Start from what is already on screen
+  CopyMem (Context->ShadowBuffer, Context->FrameBuffer, Size);
+
+  Status = gBS->CreateEvent (
+                  EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                  IMX_BLT_TPL,
+                  iMXBltExitBootServicesNotify,
+                  Context,
+                  &Context->ExitBootServicesEvent
+                );
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  IMX_BLT_TPL,
+                  iMXBltFlushNotify,
+                  Context,
+                  &Context->FlushEvent
+                );
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->SetTimer (Context->FlushEvent, TimerPeriodic, IMX_BLT_FLUSH_PERIOD);
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Shadow buffer not used, Status=%r\n",
+      __FUNCTION__, Status));
+    if (Context->FlushEvent != NULL) {
+      gBS->CloseEvent (Context->FlushEvent);
+      Context->FlushEvent = NULL;
+    }
+    if (Context->ExitBootServicesEvent != NULL) {
+      gBS->CloseEvent (Context->ExitBootServicesEvent);
+      Context->ExitBootServicesEvent = NULL;
+    }
+    if (Context->ShadowBuffer != NULL) {
+      FreePages (Context->ShadowBuffer, EFI_SIZE_TO_PAGES (Size));
+      Context->ShadowBuffer = NULL;
+    }
+  }
+  return Status;
+}
+
+/**
+  Initialize a Blt context for a frame buffer.
+
+  If IMX_BLT_FLAG_SHADOW is requested but the shadow buffer can not be set
+  up, the context falls back to drawing into the frame buffer directly.
+
+  @param[out] Context             Blt context to initialize.
+  @param[in]  FrameBuffer         Base of the 32 bits per pixel frame buffer.
+  @param[in]  Width               Horizontal resolution in pixels.
+  @param[in]  Height              Vertical resolution in pixels.
+  @param[in]  PixelsPerScanLine   Pitch of the frame buffer in pixels.
+  @param[in]  Flags               IMX_BLT_FLAG_* options.
+
+  @retval EFI_SUCCESS             The context was initialized.
+  @retval EFI_INVALID_PARAMETER   The frame buffer geometry is invalid.
+
+**/
+EFI_STATUS
+iMXBltInitialize (
+  OUT IMX_BLT_CONTEXT   *Context,
+  IN  VOID              *FrameBuffer,
+  IN  UINT32            Width,
+  IN  UINT32            Height,
+  IN  UINT32            PixelsPerScanLine,
+  IN  UINT32            Flags
+  )
+{
+  if ((FrameBuffer == NULL) || (Width == 0) || (Height == 0) ||
+      (PixelsPerScanLine < Width)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Context, sizeof (*Context));
+  Context->FrameBuffer = FrameBuffer;
+  Context->Width = Width;
+  Context->Height = Height;
+  Context->PixelsPerScanLine = PixelsPerScanLine;
+  Context->Flags = Flags;
+
+  if ((Flags & IMX_BLT_FLAG_SHADOW) != 0) {
+    if (EFI_ERROR (iMXBltInitializeShadow (Context))) {
+      Context->Flags &= ~IMX_BLT_FLAG_SHADOW;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Scroll by moving the scanout address instead of copying the screen.
+
+  @param[in]  Context             Initialized Blt context.
+  @param[in]  BufferHeight        Number of lines the frame buffer can hold.
+  @param[in]  SetScanout          Function moving the scanout address.
+  @param[in]  SetScanoutContext   Context passed to SetScanout.
+
+  @retval EFI_SUCCESS             Scrolling through the scanout address is on.
+  @retval EFI_BUFFER_TOO_SMALL    The frame buffer has no spare lines.
+  @retval Others                  The ExitBootServices event could not be
+                                  created.
+
+**/
+EFI_STATUS
+iMXBltEnableScroll (
+  IN  IMX_BLT_CONTEXT       *Context,
+  IN  UINT32                BufferHeight,
+  IN  IMX_BLT_SET_SCANOUT   SetScanout,
+  IN  VOID                  *SetScanoutContext
+  )
+{
+  EFI_STATUS  Status;
+
+  if (BufferHeight <= Context->Height) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  // The shadow buffer already registered for ExitBootServices
+  if (Context->ExitBootServicesEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                    IMX_BLT_TPL,
+                    iMXBltExitBootServicesNotify,
+                    Context,
+                    &Context->ExitBootServicesEvent
+                  );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Context->BufferHeight = BufferHeight;
+  Context->ScanoutRow = 0;
+  Context->SetScanout = SetScanout;
+  Context->SetScanoutContext = SetScanoutContext;
+  return EFI_SUCCESS;
+}
+
+/**
+  Perform an EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt operation on a Blt context.
+
+  The parameters follow EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt. Rectangles reaching
+  past the right or bottom edge of the frame are clipped to it.
+
+  @retval EFI_SUCCESS             The operation was performed.
+  @retval EFI_INVALID_PARAMETER   BltOperation is not valid, BltBuffer is
+                                  missing, the rectangle is empty, Delta is
+                                  smaller than a line of the rectangle or a
+                                  rectangle starts outside the frame.
+
+**/
+EFI_STATUS
+iMXBlt (
+  IN     IMX_BLT_CONTEXT                    *Context,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer, OPTIONAL
+  IN     EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN     UINTN                              SourceX,
+  IN     UINTN                              SourceY,
+  IN     UINTN                              DestinationX,
+  IN     UINTN                              DestinationY,
+  IN     UINTN                              Width,
+  IN     UINTN                              Height,
+  IN     UINTN                              Delta OPTIONAL
+  )
+{
+  UINTN               BufferOffset;
+  UINTN               BufferWidth;
+  UINT32              *FrameBuffer;
+  UINTN               FrameOffset;
+  UINTN               FrameWidth;
+  UINTN               i;
+  EFI_TPL             OldTpl;
+  IMX_BLT_RECTANGLE   Rectangle;
+  UINTN               Run;
+  BOOLEAN             Scroll;
+  BOOLEAN             UseShadow;
+
+  if ((UINT32)BltOperation >= (UINT32)EfiGraphicsOutputBltOperationMax) {
+    DEBUG ((DEBUG_ERROR, "%a: Not implemented %d\n",
+      __FUNCTION__, BltOperation));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((BltBuffer == NULL) && (BltOperation != EfiBltVideoToVideo)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Width == 0) || (Height == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // The Blt buffer keeps the caller's stride even if the rectangle is
+  // clipped below
+  if (Delta == 0) {
+    BufferWidth = Width;
+  } else {
+    BufferWidth = Delta / PIXEL_BYTES;
+    if (BufferWidth < Width) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  // Clip once up front so the line loops can not leave the frame. Both
+  // ends of a move only ever lose pixels from the right and bottom.
+  if ((BltOperation == EfiBltVideoToBltBuffer) ||
+      (BltOperation == EfiBltVideoToVideo)) {
+    if (!iMXBltClip (Context->Width, SourceX, &Width) ||
+        !iMXBltClip (Context->Height, SourceY, &Height)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+  if (BltOperation != EfiBltVideoToBltBuffer) {
+    if (!iMXBltClip (Context->Width, DestinationX, &Width) ||
+        !iMXBltClip (Context->Height, DestinationY, &Height)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (IMX_BLT_TPL);
+
+  UseShadow = ((Context->Flags & IMX_BLT_FLAG_SHADOW) != 0) &&
+              !Context->ExitBootServices;
+  if (UseShadow) {
+    FrameBuffer = Context->ShadowBuffer;
+  } else {
+    FrameBuffer = iMXBltScreen (Context);
+  }
+  Scroll = FALSE;
+  FrameWidth = Context->PixelsPerScanLine;
+
+  if (BltOperation == EfiBltVideoFill) {
+    FrameOffset = FrameWidth * DestinationY + DestinationX;
+    Run = iMXBltRunLength (Context, DestinationX, Width, Height);
+    if (Run != 0) {
+      iMXBltFill (FrameBuffer + FrameOffset, Run, *(UINT32 *)BltBuffer);
+    } else {
+      for (i = 0; i < Height; i++) {
+        iMXBltFill (FrameBuffer + FrameOffset, Width, *(UINT32 *)BltBuffer);
+        FrameOffset += FrameWidth;
+      }
+    }
+  } else if (BltOperation == EfiBltVideoToBltBuffer) {
+    FrameOffset = FrameWidth * SourceY + SourceX;
+    BufferOffset = BufferWidth * DestinationY + DestinationX;
+    // The padding of the run would land in the caller's buffer, so only
+    // unpadded lines qualify
+    if ((Width == FrameWidth) && (BufferWidth == Width)) {
+      iMXBltCopyForward (
+        (UINT32 *)(BltBuffer + BufferOffset),
+        FrameBuffer + FrameOffset,
+        Width * Height
+      );
+    } else {
+      for (i = 0; i < Height; i++) {
+        iMXBltCopyForward (
+          (UINT32 *)(BltBuffer + BufferOffset),
+          FrameBuffer + FrameOffset,
+          Width
+        );
+        FrameOffset += FrameWidth;
+        BufferOffset += BufferWidth;
+      }
+    }
+  } else if (BltOperation == EfiBltBufferToVideo) {
+    FrameOffset = FrameWidth * DestinationY + DestinationX;
+    BufferOffset = BufferWidth * SourceY + SourceX;
+    // A Blt buffer with the pitch of the frame lines up with the run,
+    // whatever it holds past Width only lands in the padding
+    Run = 0;
+    if (BufferWidth == FrameWidth) {
+      Run = iMXBltRunLength (Context, DestinationX, Width, Height);
+    }
+    if (Run != 0) {
+      iMXBltCopyForward (
+        FrameBuffer + FrameOffset,
+        (UINT32 *)(BltBuffer + BufferOffset),
+        Run
+      );
+    } else {
+      for (i = 0; i < Height; i++) {
+        iMXBltCopyForward (
+          FrameBuffer + FrameOffset,
+          (UINT32 *)(BltBuffer + BufferOffset),
+          Width
+        );
+        FrameOffset += FrameWidth;
+        BufferOffset += BufferWidth;
+      }
+    }
+  } else {
+    Scroll = iMXBltIsScroll (
+               Context,
+               SourceX,
+               SourceY,
+               DestinationX,
+               DestinationY,
+               Width,
+               Height
+             );
+    if (Scroll && UseShadow) {
+      // Bring the frame buffer up to date so only the lines around the
+      // moved rectangle need copying from the scrolled shadow
+      iMXBltFlushDirtyRectangles (Context);
+    }
+
+    // Clipping leaves a full width rectangle only when both ends start at
+    // the left edge
+    Run = iMXBltRunLength (Context, DestinationX, Width, Height);
+    if (Scroll && !UseShadow) {
+      // The moved lines stay in place, only the visible window moves
+    } else if (Run != 0) {
+      iMXBltMove (
+        FrameBuffer + FrameWidth * DestinationY,
+        FrameBuffer + FrameWidth * SourceY,
+        Run
+      );
+    } else if (DestinationY > SourceY) {
+      // Copy bottom up so overlapping lines are read before they are written
+      FrameOffset = FrameWidth * (DestinationY + Height - 1) + DestinationX;
+      BufferOffset = FrameWidth * (SourceY + Height - 1) + SourceX;
+      for (i = 0; i < Height; i++) {
+        iMXBltCopyForward (
+          FrameBuffer + FrameOffset,
+          FrameBuffer + BufferOffset,
+          Width
+        );
+        FrameOffset -= FrameWidth;
+        BufferOffset -= FrameWidth;
+      }
+    } else {
+      // Lines may overlap themselves when moving sideways
+      FrameOffset = FrameWidth * DestinationY + DestinationX;
+      BufferOffset = FrameWidth * SourceY + SourceX;
+      for (i = 0; i < Height; i++) {
+        iMXBltMove (
+          FrameBuffer + FrameOffset,
+          FrameBuffer + BufferOffset,
+          Width
+        );
+        FrameOffset += FrameWidth;
+        BufferOffset += FrameWidth;
+      }
+    }
+
+    if (Scroll) {
+      iMXBltScroll (Context, SourceY, DestinationY, Height);
+    }
+  }
+
+  // A scroll already updated the frame buffer
+  if ((BltOperation != EfiBltVideoToBltBuffer) && !Scroll) {
+    if (UseShadow) {
+      iMXBltAddDirtyRectangle (Context, DestinationX, DestinationY, Width, Height);
+    } else {
+      Rectangle.X = DestinationX;
+      Rectangle.Y = DestinationY;
+      Rectangle.Width = Width;
+      Rectangle.Height = Height;
+      iMXBltCleanRectangle (Context, &Rectangle);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Copy all pending changes from the shadow buffer to the frame buffer.
+
+  Does nothing for contexts without a shadow buffer.
+
+  @param[in]  Context             Blt context to flush.
+
+**/
+VOID
+iMXBltFlush (
+  IN  IMX_BLT_CONTEXT   *Context
+  )
+{
+  EFI_TPL   OldTpl;
+
+  if ((Context->Flags & IMX_BLT_FLAG_SHADOW) == 0) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (IMX_BLT_TPL);
+  iMXBltFlushDirtyRectangles (Context);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Exchange the frame buffers of two Blt contexts.
+
+  @param[in]  First               Blt context.
+  @param[in]  Second              Blt context of the same geometry and
+                                  shadow setting as First.
+
+  @retval EFI_SUCCESS             The frame buffers were exchanged.
+  @retval EFI_INVALID_PARAMETER   The contexts do not match.
+  @retval EFI_UNSUPPORTED         A context scrolls through the scanout
+                                  address or boot services were exited.
+
+**/
+EFI_STATUS
+iMXBltSwap (
+  IN  IMX_BLT_CONTEXT   *First,
+  IN  IMX_BLT_CONTEXT   *Second
+  )
+{
+  UINT32      *FrameBuffer;
+  EFI_TPL     OldTpl;
+  UINT32      *ShadowBuffer;
+  EFI_STATUS  Status;
+
+  if ((First->Width != Second->Width) ||
+      (First->Height != Second->Height) ||
+      (First->PixelsPerScanLine != Second->PixelsPerScanLine) ||
+      ((First->Flags & IMX_BLT_FLAG_SHADOW) !=
+       (Second->Flags & IMX_BLT_FLAG_SHADOW))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (IMX_BLT_TPL);
+
+  if ((First->SetScanout != NULL) || (Second->SetScanout != NULL) ||
+      First->ExitBootServices || Second->ExitBootServices) {
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
+  iMXBltFlushDirtyRectangles (First);
+  iMXBltFlushDirtyRectangles (Second);
+
+  FrameBuffer = First->FrameBuffer;
+  ShadowBuffer = First->ShadowBuffer;
+  First->FrameBuffer = Second->FrameBuffer;
+  First->ShadowBuffer = Second->ShadowBuffer;
+  Second->FrameBuffer = FrameBuffer;
+  Second->ShadowBuffer = ShadowBuffer;
+  Status = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Release the shadow buffer and events of a Blt context.
+
+  Pending changes are dropped, the frame buffer is left as it is. The
+  context can be initialized again afterwards, e.g. for a new mode.
+
+  @param[in]  Context             Blt context to release.
+
+**/
+VOID
+iMXBltFree (
+  IN  IMX_BLT_CONTEXT   *Context
+  )
+{
+  UINTN   Size;
+
+  if (Context->FlushEvent != NULL) {
+    gBS->CloseEvent (Context->FlushEvent);
+  }
+  if (Context->ExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (Context->ExitBootServicesEvent);
+  }
+  if (Context->ShadowBuffer != NULL) {
+    Size = Context->PixelsPerScanLine * Context->Height * PIXEL_BYTES;
+    FreePages (Context->ShadowBuffer, EFI_SIZE_TO_PAGES (Size));
+  }
+
+  ZeroMem (Context, sizeof (*Context));
+}
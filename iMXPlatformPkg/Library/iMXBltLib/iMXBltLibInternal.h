@@ -0,0 +1,53 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _IMX_BLT_LIB_INTERNAL_H_
+#define _IMX_BLT_LIB_INTERNAL_H_
+
+/**
+  Fill a run of 32 bits per pixel pixels.
+
+  On ARM the run is written with 32 byte NEON stores once the destination is
+  16 byte aligned, so uncached write-combining frame buffers see full bursts.
+
+  @param[out] Destination   First pixel to write, 4 byte aligned.
+  @param[in]  Count         Number of pixels.
+  @param[in]  Pixel         Pixel value.
+
+**/
+VOID
+iMXBltFill (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Pixel
+  );
+
+/**
+  Copy a run of 32 bits per pixel pixels from low to high addresses.
+
+  Safe for overlapping runs only when Destination is not above Source.
+
+  @param[out] Destination   First pixel to write, 4 byte aligned.
+  @param[in]  Source        First pixel to read, 4 byte aligned.
+  @param[in]  Count         Number of pixels.
+
+**/
+VOID
+iMXBltCopyForward (
+  OUT UINT32        *Destination,
+  IN  CONST UINT32  *Source,
+  IN  UINTN         Count
+  );
+
+#endif // _IMX_BLT_LIB_INTERNAL_H_
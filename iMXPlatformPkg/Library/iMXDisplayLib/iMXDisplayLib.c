@@ -18,6 +18,106 @@
 
 #include <iMXDisplay.h>
 
+// Size of a detailed timing descriptor
+#define EDID_DTD_SIZE                 18
+
+// Flags byte of a detailed timing descriptor
+#define EDID_DTD_FLAGS_OFFSET         17
+#define EDID_DTD_FLAGS_INTERLACED     0x80
+
+// Standard timings, refer to 3.9 VESA EDID spec
+#define EDID_STANDARD_TIMING_OFFSET   0x26
+#define EDID_STANDARD_TIMING_COUNT    8
+#define EDID_STANDARD_TIMING_UNUSED   0x0101
+
+// CEA-861 extension block, refer to 7.5 CEA-861-F spec
+#define CEA_EXTENSION_TAG             0x02
+#define CEA_REVISION_OFFSET           0x01
+#define CEA_DTD_OFFSET                0x02
+#define CEA_DATA_BLOCK_OFFSET         0x04
+#define CEA_DATA_BLOCK_REVISION       0x03
+#define CEA_DATA_BLOCK_TAG_VIDEO      0x02
+
+// Digital separate sync with the H/V sync polarity bits of a DTD
+#define EDID_FLAGS_SEPARATE_SYNC      0x18
+#define EDID_FLAGS_VSYNC_POSITIVE     0x04
+#define EDID_FLAGS_HSYNC_POSITIVE     0x02
+#define EDID_FLAGS_SYNC_POSITIVE      (EDID_FLAGS_SEPARATE_SYNC | \
+                                       EDID_FLAGS_VSYNC_POSITIVE | \
+                                       EDID_FLAGS_HSYNC_POSITIVE)
+
+typedef struct {
+  UINT8               Vic;
+  IMX_DISPLAY_TIMING  Timing;
+} CEA_VIDEO_FORMAT;
+
+typedef struct {
+  IMX_DISPLAY_TIMING  *ModeListPtr;
+  UINT32              MaxModeCount;
+  UINT32              ModeCount;
+} EDID_MODE_LIST;
+
+// Standard timings only carry resolution and refresh rate. Those the
+// display advertises at 60Hz are looked up in the VESA DMT timings.
+STATIC IMX_DISPLAY_TIMING CONST DmtTimings[] = {
+  // PixelClock, HActive, HBlank, VActive, VBlank, HSync, VSync, HSyncOffset,
+  // VSyncOffset, HImageSize, VImageSize, HBorder, VBorder, EdidFlags, Flags,
+  // PixelRepetition, Bpp, PixelFormat
+  { 25175000, 640, 160, 480, 45, 96, 2, 16, 10, 0, 0, 0, 0,
+    EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 40000000, 800, 256, 600, 28, 128, 4, 40, 1, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 65000000, 1024, 320, 768, 38, 136, 6, 24, 3, 0, 0, 0, 0,
+    EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 74250000, 1280, 370, 720, 30, 40, 5, 110, 5, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 83500000, 1280, 400, 800, 31, 128, 6, 72, 3, 0, 0, 0, 0,
+    EDID_FLAGS_SEPARATE_SYNC | EDID_FLAGS_VSYNC_POSITIVE,
+    0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 108000000, 1280, 520, 960, 40, 112, 3, 96, 1, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 108000000, 1280, 408, 1024, 42, 112, 3, 48, 1, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 106500000, 1440, 464, 900, 34, 152, 6, 80, 3, 0, 0, 0, 0,
+    EDID_FLAGS_SEPARATE_SYNC | EDID_FLAGS_VSYNC_POSITIVE,
+    0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 108000000, 1600, 200, 900, 100, 80, 3, 24, 1, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 146250000, 1680, 560, 1050, 39, 176, 6, 104, 3, 0, 0, 0, 0,
+    EDID_FLAGS_SEPARATE_SYNC | EDID_FLAGS_VSYNC_POSITIVE,
+    0, 1, 32, PIXEL_FORMAT_BGRA32 },
+  { 148500000, 1920, 280, 1080, 45, 44, 5, 88, 4, 0, 0, 0, 0,
+    EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 },
+};
+
+// Progressive CEA-861 video formats a short video descriptor can refer to
+STATIC CEA_VIDEO_FORMAT CONST CeaVideoFormats[] = {
+  { 1, { 25175000, 640, 160, 480, 45, 96, 2, 16, 10, 0, 0, 0, 0,
+         EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 2, { 27000000, 720, 138, 480, 45, 62, 6, 16, 9, 0, 0, 0, 0,
+         EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 3, { 27000000, 720, 138, 480, 45, 62, 6, 16, 9, 0, 0, 0, 0,
+         EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 4, { 74250000, 1280, 370, 720, 30, 40, 5, 110, 5, 0, 0, 0, 0,
+         EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 16, { 148500000, 1920, 280, 1080, 45, 44, 5, 88, 4, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 17, { 27000000, 720, 144, 576, 49, 64, 5, 12, 5, 0, 0, 0, 0,
+          EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 18, { 27000000, 720, 144, 576, 49, 64, 5, 12, 5, 0, 0, 0, 0,
+          EDID_FLAGS_SEPARATE_SYNC, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 19, { 74250000, 1280, 700, 720, 30, 40, 5, 440, 5, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 31, { 148500000, 1920, 720, 1080, 45, 44, 5, 528, 4, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 32, { 74250000, 1920, 830, 1080, 45, 44, 5, 638, 4, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 33, { 74250000, 1920, 720, 1080, 45, 44, 5, 528, 4, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+  { 34, { 74250000, 1920, 280, 1080, 45, 44, 5, 88, 4, 0, 0, 0, 0,
+          EDID_FLAGS_SYNC_POSITIVE, 0, 1, 32, PIXEL_FORMAT_BGRA32 } },
+};
+
 /**
   Convert detailed timing descriptor to display timing format
 
@@ -150,3 +250,376 @@ ImxValidateEdidData (
   DEBUG ((DEBUG_INFO, "%a: Success\r\n", __FUNCTION__));
   return EFI_SUCCESS;
 }
+
+/**
+  Check if an EDID extension block is valid
+
+  @param[in]    BlockPtr  Pointer to the extension block.
+
+  @retval   EFI_SUCCESS             The block checksum is valid.
+  @retval   EFI_INVALID_PARAMETER   The block checksum is invalid.
+
+**/
+EFI_STATUS
+ImxValidateEdidBlock (
+  IN UINT8 *BlockPtr
+  )
+{
+  UINT8   Checksum;
+  UINT32  Index;
+
+  Checksum = 0;
+  for (Index = 0; Index < IMX_EDID_BLOCK_SIZE; Index++) {
+    Checksum += BlockPtr[Index];
+  }
+
+  if (Checksum != 0) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid EDID block checksum\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the size of an EDID including its extension blocks
+
+  @param[in]    EdidDataPtr  Pointer to a valid EDID base block.
+
+  @retval   Size of the base block and the extension blocks it announces,
+            limited to IMX_EDID_MAX_SIZE.
+
+**/
+UINT32
+ImxGetEdidSize (
+  IN UINT8 *EdidDataPtr
+  )
+{
+  UINT32  Size;
+
+  Size = (EdidDataPtr[IMX_EDID_EXTENSION_COUNT_OFFSET] + 1) * IMX_EDID_BLOCK_SIZE;
+  if (Size > IMX_EDID_MAX_SIZE) {
+    Size = IMX_EDID_MAX_SIZE;
+  }
+
+  return Size;
+}
+
+/**
+  Append a timing to a mode list unless it is full or already holds the
+  same resolution at the same pixel clock.
+
+  @param[in, out] ModeListPtr   Mode list.
+  @param[in]      TimingPtr     Timing to add.
+
+**/
+STATIC
+VOID
+AddEdidMode (
+  IN OUT  EDID_MODE_LIST            *ModeListPtr,
+  IN      CONST IMX_DISPLAY_TIMING  *TimingPtr
+  )
+{
+  IMX_DISPLAY_TIMING  *pMode;
+  UINT32              Index;
+
+  if (ModeListPtr->ModeCount >= ModeListPtr->MaxModeCount) {
+    return;
+  }
+
+  for (Index = 0; Index < ModeListPtr->ModeCount; Index++) {
+    pMode = &ModeListPtr->ModeListPtr[Index];
+    if ((pMode->HActive == TimingPtr->HActive) &&
+        (pMode->VActive == TimingPtr->VActive) &&
+        (pMode->PixelClock == TimingPtr->PixelClock)) {
+      return;
+    }
+  }
+
+  ModeListPtr->ModeListPtr[ModeListPtr->ModeCount] = *TimingPtr;
+  ModeListPtr->ModeCount++;
+}
+
+/**
+  Append a detailed timing descriptor to a mode list.
+
+  Descriptors with a zero pixel clock hold monitor data and are skipped,
+  interlaced timings are skipped as the display controllers scan out
+  progressive frames only.
+
+  @param[in, out] ModeListPtr   Mode list.
+  @param[in]      DtdPtr        Detailed timing descriptor.
+
+**/
+STATIC
+VOID
+AddEdidDtd (
+  IN OUT  EDID_MODE_LIST  *ModeListPtr,
+  IN      UINT8           *DtdPtr
+  )
+{
+  IMX_DISPLAY_TIMING  Timing;
+
+  if ((DtdPtr[0] == 0) && (DtdPtr[1] == 0)) {
+    return;
+  }
+
+  if ((DtdPtr[EDID_DTD_FLAGS_OFFSET] & EDID_DTD_FLAGS_INTERLACED) != 0) {
+    return;
+  }
+
+  ImxConvertDTDToDisplayTiming ((IMX_DETAILED_TIMING_DESCRIPTOR *)DtdPtr, &Timing);
+  Timing.PixelRepetition = 1;
+  Timing.Bpp = 32;
+  Timing.PixelFormat = PIXEL_FORMAT_BGRA32;
+  AddEdidMode (ModeListPtr, &Timing);
+}
+
+/**
+  Append the detailed timing descriptors of a CEA-861 block to a mode list.
+
+  @param[in, out] ModeListPtr   Mode list.
+  @param[in]      BlockPtr      CEA-861 extension block.
+
+**/
+STATIC
+VOID
+AddCeaDtds (
+  IN OUT  EDID_MODE_LIST  *ModeListPtr,
+  IN      UINT8           *BlockPtr
+  )
+{
+  UINT32  Offset;
+
+  // An offset of 0 means the block has no detailed timings
+  Offset = BlockPtr[CEA_DTD_OFFSET];
+  if (Offset < CEA_DATA_BLOCK_OFFSET) {
+    return;
+  }
+
+  // The last byte of the block is the checksum
+  for (; Offset + EDID_DTD_SIZE < IMX_EDID_BLOCK_SIZE; Offset += EDID_DTD_SIZE) {
+    if ((BlockPtr[Offset] == 0) && (BlockPtr[Offset + 1] == 0)) {
+      break;
+    }
+    AddEdidDtd (ModeListPtr, &BlockPtr[Offset]);
+  }
+}
+
+/**
+  Append the short video descriptors of a CEA-861 block to a mode list.
+
+  Data blocks were introduced with revision 3, the bytes before the
+  detailed timings of older blocks are reserved.
+
+  @param[in, out] ModeListPtr   Mode list.
+  @param[in]      BlockPtr      CEA-861 extension block.
+  @param[in]      Native        Append only the native formats if TRUE, only
+                                the other formats if FALSE.
+
+**/
+STATIC
+VOID
+AddCeaSvds (
+  IN OUT  EDID_MODE_LIST  *ModeListPtr,
+  IN      UINT8           *BlockPtr,
+  IN      BOOLEAN         Native
+  )
+{
+  UINT32    DataBlockEnd;
+  UINT32    Format;
+  UINT32    Length;
+  UINT32    Offset;
+  UINT32    Svd;
+  BOOLEAN   SvdNative;
+  UINT8     Vic;
+
+  if (BlockPtr[CEA_REVISION_OFFSET] < CEA_DATA_BLOCK_REVISION) {
+    return;
+  }
+
+  DataBlockEnd = BlockPtr[CEA_DTD_OFFSET];
+  if (DataBlockEnd > IMX_EDID_BLOCK_SIZE - 1) {
+    return;
+  }
+
+  Offset = CEA_DATA_BLOCK_OFFSET;
+  while (Offset < DataBlockEnd) {
+    Length = BlockPtr[Offset] & 0x1F;
+    if (Offset + 1 + Length > DataBlockEnd) {
+      break;
+    }
+
+    if ((BlockPtr[Offset] >> 5) == CEA_DATA_BLOCK_TAG_VIDEO) {
+      for (Svd = Offset + 1; Svd <= Offset + Length; Svd++) {
+        // Bit 7 flags a native format for VICs 1-64 only
+        if ((BlockPtr[Svd] >= 129) && (BlockPtr[Svd] <= 192)) {
+          Vic = BlockPtr[Svd] & 0x7F;
+          SvdNative = TRUE;
+        } else {
+          Vic = BlockPtr[Svd];
+          SvdNative = FALSE;
+        }
+        if (SvdNative != Native) {
+          continue;
+        }
+
+        for (Format = 0; Format < ARRAY_SIZE (CeaVideoFormats); Format++) {
+          if (CeaVideoFormats[Format].Vic == Vic) {
+            AddEdidMode (ModeListPtr, &CeaVideoFormats[Format].Timing);
+            break;
+          }
+        }
+      }
+    }
+
+    Offset += 1 + Length;
+  }
+}
+
+/**
+  Append the standard timings of the EDID base block to a mode list.
+
+  @param[in, out] ModeListPtr   Mode list.
+  @param[in]      EdidDataPtr   EDID base block.
+
+**/
+STATIC
+VOID
+AddStandardTimings (
+  IN OUT  EDID_MODE_LIST  *ModeListPtr,
+  IN      UINT8           *EdidDataPtr
+  )
+{
+  UINT32  HActive;
+  UINT32  Index;
+  UINT32  Format;
+  UINT8   *StandardTiming;
+  UINT32  VActive;
+
+  for (Index = 0; Index < EDID_STANDARD_TIMING_COUNT; Index++) {
+    StandardTiming = &EdidDataPtr[EDID_STANDARD_TIMING_OFFSET + (Index * 2)];
+    if ((StandardTiming[0] | (StandardTiming[1] << 8)) ==
+        EDID_STANDARD_TIMING_UNUSED) {
+      continue;
+    }
+
+    // Only 60Hz timings are looked up
+    if ((StandardTiming[1] & 0x3F) + 60 != 60) {
+      continue;
+    }
+
+    HActive = (StandardTiming[0] + 31) * 8;
+    switch (StandardTiming[1] >> 6) {
+    case 0:
+      VActive = (HActive * 10) / 16;
+      break;
+    case 1:
+      VActive = (HActive * 3) / 4;
+      break;
+    case 2:
+      VActive = (HActive * 4) / 5;
+      break;
+    default:
+      VActive = (HActive * 9) / 16;
+      break;
+    }
+
+    for (Format = 0; Format < ARRAY_SIZE (DmtTimings); Format++) {
+      if ((DmtTimings[Format].HActive == HActive) &&
+          (DmtTimings[Format].VActive == VActive)) {
+        AddEdidMode (ModeListPtr, &DmtTimings[Format]);
+        break;
+      }
+    }
+  }
+}
+
+/**
+  Collect the timings an EDID advertises, best first
+
+  Timings are ranked as follows:
+  1. The preferred timing, the first detailed timing of the base block.
+  2. CEA-861 short video descriptors marked as native.
+  3. The remaining detailed timings of the base and CEA-861 blocks.
+  4. The remaining CEA-861 short video descriptors, in EDID order.
+  5. Standard timings matching a 60Hz VESA DMT timing.
+  Short video descriptors and standard timings without a known timing are
+  skipped. Each resolution and pixel clock is only returned once.
+
+  @param[in]    EdidDataPtr     Pointer to EDID data.
+  @param[in]    EdidDataSize    Size of the EDID data.
+  @param[out]   ModeListPtr     Array receiving the timings.
+  @param[in]    MaxModeCount    Number of entries in ModeListPtr.
+  @param[out]   ModeCountPtr    Number of timings returned.
+
+  @retval   EFI_SUCCESS             The timings were collected.
+  @retval   EFI_INVALID_PARAMETER   EDID data is too small.
+
+**/
+EFI_STATUS
+ImxGetEdidModes (
+  IN UINT8                *EdidDataPtr,
+  IN UINT32               EdidDataSize,
+  OUT IMX_DISPLAY_TIMING  *ModeListPtr,
+  IN UINT32               MaxModeCount,
+  OUT UINT32              *ModeCountPtr
+  )
+{
+  UINT8           *BlockPtr;
+  UINT8           *CeaBlockPtr[(IMX_EDID_MAX_SIZE / IMX_EDID_BLOCK_SIZE) - 1];
+  UINT32          CeaBlockCount;
+  UINT32          Index;
+  EDID_MODE_LIST  ModeList;
+  UINT32          Offset;
+
+  *ModeCountPtr = 0;
+  if (EdidDataSize < IMX_EDID_MIN_SIZE) {
+    DEBUG ((DEBUG_WARN, "%a: Insufficient EDID data\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ModeList.ModeListPtr = ModeListPtr;
+  ModeList.MaxModeCount = MaxModeCount;
+  ModeList.ModeCount = 0;
+
+  // Only use extension blocks that are present and intact
+  if (EdidDataSize > ImxGetEdidSize (EdidDataPtr)) {
+    EdidDataSize = ImxGetEdidSize (EdidDataPtr);
+  }
+  CeaBlockCount = 0;
+  for (Offset = IMX_EDID_BLOCK_SIZE;
+       (Offset + IMX_EDID_BLOCK_SIZE <= EdidDataSize) &&
+       (CeaBlockCount < ARRAY_SIZE (CeaBlockPtr));
+       Offset += IMX_EDID_BLOCK_SIZE) {
+    BlockPtr = &EdidDataPtr[Offset];
+    if ((BlockPtr[0] == CEA_EXTENSION_TAG) &&
+        (ImxValidateEdidBlock (BlockPtr) == EFI_SUCCESS)) {
+      CeaBlockPtr[CeaBlockCount] = BlockPtr;
+      CeaBlockCount++;
+    }
+  }
+
+  AddEdidDtd (&ModeList, &EdidDataPtr[IMX_EDID_DTD_1_OFFSET]);
+
+  for (Index = 0; Index < CeaBlockCount; Index++) {
+    AddCeaSvds (&ModeList, CeaBlockPtr[Index], TRUE);
+  }
+
+  AddEdidDtd (&ModeList, &EdidDataPtr[IMX_EDID_DTD_2_OFFSET]);
+  AddEdidDtd (&ModeList, &EdidDataPtr[IMX_EDID_DTD_3_OFFSET]);
+  AddEdidDtd (&ModeList, &EdidDataPtr[IMX_EDID_DTD_4_OFFSET]);
+  for (Index = 0; Index < CeaBlockCount; Index++) {
+    AddCeaDtds (&ModeList, CeaBlockPtr[Index]);
+  }
+
+  for (Index = 0; Index < CeaBlockCount; Index++) {
+    AddCeaSvds (&ModeList, CeaBlockPtr[Index], FALSE);
+  }
+
+  AddStandardTimings (&ModeList, EdidDataPtr);
+
+  *ModeCountPtr = ModeList.ModeCount;
+  DEBUG ((DEBUG_INFO, "%a: %d modes\n", __FUNCTION__, ModeList.ModeCount));
+  return EFI_SUCCESS;
+}
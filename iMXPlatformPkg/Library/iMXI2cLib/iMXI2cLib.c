@@ -19,6 +19,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
+#include <Library/PcdLib.h>
 #include <Library/TimerLib.h>
 
 #include <iMXI2cLib.h>
@@ -80,6 +81,21 @@ static IMX_I2C_DIVIDER mDividerValue[] = {
   {3840, 0x1F},
 };
 
+//
+// Transfer trace of a controller. Traces are kept per controller rather than
+// per bus object so direct transfers are recorded as well. A slot is claimed
+// by the first transfer made on a controller and never released.
+//
+typedef struct {
+  UINT32 ControllerAddress;
+  UINT32 TraceIndex;
+  UINT32 TraceCount;
+  IMX_I2C_TRACE_ENTRY Trace[IMX_I2C_TRACE_ENTRY_COUNT];
+  UINT32 LatencyHistogram[IMX_I2C_LATENCY_BUCKET_COUNT];
+} IMX_I2C_TRACE;
+
+static IMX_I2C_TRACE mTrace[IMX_I2C_TRACE_CONTROLLER_COUNT];
+
 BOOLEAN
 iMXI2cWaitStatusSet (
   IN  IMX_I2C_CONTEXT   *I2cContext,
@@ -164,16 +180,35 @@ iMXI2cSendByte (
   return FALSE;
 }
 
-RETURN_STATUS
-iMXI2cSetupController (
+UINT16
+iMXI2cGetClockRate (
+  IN  IMX_I2C_CONTEXT   *I2cContext
+  )
+{
+  UINT32                  Divider;
+  UINT32                  DividerCount;
+  IMX_I2C_IFDR_REGISTER   DividerData;
+
+  DividerData.Raw = 0;
+  Divider = I2cContext->ReferenceFrequency / I2cContext->TargetFrequency;
+  for (DividerCount = 0; DividerCount < ARRAY_SIZE(mDividerValue); ++DividerCount) {
+    if (mDividerValue[DividerCount].Divider >= Divider) {
+      DividerData.IC = mDividerValue[DividerCount].I2cClockRate;
+      break;
+    }
+  }
+
+  return DividerData.Raw;
+}
+
+VOID
+iMXI2cConfigureController (
   IN  IMX_I2C_CONTEXT   *I2cContext
   )
 {
   IMX_I2C_REGISTERS       *BaseAddress;
   IMX_I2C_IADR_REGISTER   AddressData;
   IMX_I2C_I2CR_REGISTER   ControlData;
-  UINT32                  Divider;
-  UINT32                  DividerCount;
   IMX_I2C_IFDR_REGISTER   DividerData;
 
   BaseAddress = (IMX_I2C_REGISTERS *)I2cContext->ControllerAddress;
@@ -187,19 +222,8 @@ iMXI2cSetupController (
   // If no reference frequency is provided, fall through and use value setup
   // by first boot loader
   if (I2cContext->ReferenceFrequency != 0) {
-    DividerData.Raw = 0;
-    Divider = I2cContext->ReferenceFrequency / I2cContext->TargetFrequency;
-    for (DividerCount = 0; DividerCount < ARRAY_SIZE(mDividerValue); ++DividerCount) {
-      if (mDividerValue[DividerCount].Divider >= Divider) {
-        DEBUG ((DEBUG_INFO,
-                "%a: Divider %d I2cClockRate 0x%02x\n",
-                __FUNCTION__,
-                mDividerValue[DividerCount].Divider,
-                mDividerValue[DividerCount].I2cClockRate));
-        DividerData.IC = mDividerValue[DividerCount].I2cClockRate;
-        break;
-      }
-    }
+    DividerData.Raw = iMXI2cGetClockRate (I2cContext);
+    DEBUG ((DEBUG_INFO, "%a: I2cClockRate 0x%02x\n", __FUNCTION__, DividerData.IC));
     MmioWrite16 ((UINTN)&BaseAddress->IFDR, DividerData.Raw);
   }
 
@@ -213,6 +237,51 @@ iMXI2cSetupController (
   ControlData.IEN = IMX_I2C_I2CR_IEN_INTERRUPT_ENABLED;
   MmioWrite16 ((UINTN)&BaseAddress->I2CR, ControlData.Raw);
   MicroSecondDelay (100);
+}
+
+BOOLEAN
+iMXI2cIsConfigured (
+  IN  IMX_I2C_CONTEXT   *I2cContext
+  )
+{
+  IMX_I2C_IADR_REGISTER   AddressData;
+  IMX_I2C_REGISTERS       *BaseAddress;
+  IMX_I2C_I2CR_REGISTER   ControlData;
+  IMX_I2C_IFDR_REGISTER   DividerData;
+
+  BaseAddress = (IMX_I2C_REGISTERS *)I2cContext->ControllerAddress;
+
+  // The registers are checked rather than remembering the last setup, as
+  // anyone calling iMXI2cConfigureController on the controller changes them.
+  ControlData = (IMX_I2C_I2CR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2CR);
+  if (ControlData.IEN != IMX_I2C_I2CR_IEN_INTERRUPT_ENABLED) {
+    return FALSE;
+  }
+
+  AddressData = (IMX_I2C_IADR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->IADR);
+  if (AddressData.ADR != I2cContext->ControllerSlaveAddress) {
+    return FALSE;
+  }
+
+  if (I2cContext->ReferenceFrequency != 0) {
+    DividerData = (IMX_I2C_IFDR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->IFDR);
+    if (DividerData.Raw != iMXI2cGetClockRate (I2cContext)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+RETURN_STATUS
+iMXI2cStartController (
+  IN  IMX_I2C_CONTEXT   *I2cContext
+  )
+{
+  IMX_I2C_REGISTERS       *BaseAddress;
+  IMX_I2C_I2CR_REGISTER   ControlData;
+
+  BaseAddress = (IMX_I2C_REGISTERS *)I2cContext->ControllerAddress;
 
   // Clear pending interrupt status bits
   MmioWrite16 ((UINTN)&BaseAddress->I2SR, 0);
@@ -225,6 +294,8 @@ iMXI2cSetupController (
 
   // Select master mode and transmit mode.
   // Note: STOP must have been called prior to this (i.e. MTX = 0)
+  ControlData = (IMX_I2C_I2CR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2CR);
+  ControlData.TXAK = IMX_I2C_I2CR_TXAK_SEND_TRANSMIT_ACK;
   ControlData.MTX = IMX_I2C_I2CR_MTX_TRANSMIT_MODE;
   ControlData.MSTA = IMX_I2C_I2CR_MSTA_MASTER_MODE;
   MmioWrite16 ((UINTN)&BaseAddress->I2CR, ControlData.Raw);
@@ -249,6 +320,8 @@ iMXI2cSendDeviceAddress (
   IMX_I2C_DEVICE_ADDRESS_PACKET   Data;
   BOOLEAN                         Result;
 
+  BaseAddress = (IMX_I2C_REGISTERS*)I2cContext->ControllerAddress;
+
   if ((DeviceAddress < 0) || (DeviceAddress > 0x7F)) {
     return RETURN_DEVICE_ERROR;
   }
@@ -328,29 +401,29 @@ iMXI2cGenerateStop (
   return RETURN_SUCCESS;
 }
 
-/**
-  Perform I2C read operation.
-
-  The iMXI2cRead perform I2C read operation by programming the I2C controller.
-  The caller is responsible to provide I2C controller configuration.
-
-  @param[in]    I2cContext        Pointer to structure containing the targeted
-                                  I2C controller to be used for I2C operation.
-  @param[in]    RegisterAddress   Targeted device register address to start read.
-  @param[out]   ReadBufferPtr     Caller supplied buffer that would be written
-                                  into with data from the read operation.
-  @param[in]    ReadBufferSize    Size of caller supplied buffer.
+BOOLEAN
+iMXI2cSendRegisterAddress (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT16            RegisterAddress,
+  IN  UINT32            RegisterAddressSize
+  )
+{
+  // Multi-byte register addresses are sent most significant byte first
+  if (RegisterAddressSize == IMX_I2C_REGISTER_ADDRESS_16BIT) {
+    if (iMXI2cSendByte (I2cContext, (UINT8)(RegisterAddress >> 8)) == FALSE) {
+      return FALSE;
+    }
+  }
 
-  @retval   RETURN_SUCCESS        I2C Read operation succeeded.
-  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+  return iMXI2cSendByte (I2cContext, (UINT8)RegisterAddress);
+}
 
-**/
 RETURN_STATUS
-iMXI2cRead (
-  IN IMX_I2C_CONTEXT  *I2cContext,
-  IN UINT8            RegisterAddress,
-  OUT UINT8           *ReadBufferPtr,
-IN UINT32             ReadBufferSize
+iMXI2cStartRead (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT16            RegisterAddress,
+  IN  UINT32            RegisterAddressSize,
+  IN  BOOLEAN           ConfigureController
   )
 {
   IMX_I2C_REGISTERS       *BaseAddress;
@@ -360,8 +433,12 @@ IN UINT32             ReadBufferSize
 
   BaseAddress = (IMX_I2C_REGISTERS*)I2cContext->ControllerAddress;
 
-  // Initialize controller
-  Status = iMXI2cSetupController (I2cContext);
+  // Initialize controller, the divider and slave address programming can be
+  // skipped when the controller is already configured for this context.
+  if (ConfigureController) {
+    iMXI2cConfigureController (I2cContext);
+  }
+  Status = iMXI2cStartController (I2cContext);
   if (RETURN_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: Fail to setup controller %r\n", __FUNCTION__, Status));
     return Status;
@@ -371,33 +448,80 @@ IN UINT32             ReadBufferSize
   Status = iMXI2cGenerateStart (I2cContext, IMX_I2C_TX);
   if (RETURN_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: iMXI2cGenerateStart failed %r\n", __FUNCTION__, Status));
-    goto Exit;
+    return Status;
   }
 
   // Send target register address
-  Result = iMXI2cSendByte (I2cContext, RegisterAddress);
+  Result = iMXI2cSendRegisterAddress (I2cContext, RegisterAddress, RegisterAddressSize);
   if (Result == FALSE) {
     DEBUG ((DEBUG_ERROR,
             "%a: Slave register address transfer fail 0x%04x\n",
             __FUNCTION__,
             MmioRead16 ((UINTN)&BaseAddress->I2SR)));
-    Status = RETURN_DEVICE_ERROR;
-    goto Exit;
+    return RETURN_DEVICE_ERROR;
   }
 
   // Configure Repeated Start in order to indicate read
-  Status = iMXI2cConfigureRepeatStart(I2cContext);
+  iMXI2cConfigureRepeatStart (I2cContext);
 
   // Generate Start condition for the read
   Status = iMXI2cGenerateStart (I2cContext, IMX_I2C_RX);
   if (RETURN_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: iMXI2cGenerateStart failed %r\n", __FUNCTION__, Status));
-    goto Exit;
+    return Status;
   }
 
   // Change controller to Master Receive Mode
   Data = (IMX_I2C_I2CR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2CR);
   Data.MTX = IMX_I2C_I2CR_MTX_RECEIVE_MODE;
+  Data.RSTA = IMX_I2C_I2CR_RSTA_REPEAT_START_DISABLE;
+  MmioWrite16 ((UINTN)&BaseAddress->I2CR, Data.Raw);
+
+  return RETURN_SUCCESS;
+}
+
+RETURN_STATUS
+iMXI2cReceiveBytes (
+  IN      IMX_I2C_CONTEXT   *I2cContext,
+  OUT     UINT8             *ReadBufferPtr,
+  IN OUT  UINT32            *ReadBufferSize,
+  IN      BOOLEAN           SmbusBlockRead,
+  IN      UINT32            TrailerSize
+  )
+{
+  IMX_I2C_REGISTERS       *BaseAddress;
+  UINT8                   Byte;
+  RETURN_STATUS           CountStatus;
+  IMX_I2C_I2CR_REGISTER   Data;
+  UINT32                  Received;
+  UINT32                  Remaining;
+  RETURN_STATUS           Status;
+
+  BaseAddress = (IMX_I2C_REGISTERS*)I2cContext->ControllerAddress;
+  // An invalid SMBus byte count is kept apart from Status so completing the
+  // transfer with a Stop signal cannot clear it.
+  CountStatus = RETURN_SUCCESS;
+  Status = RETURN_SUCCESS;
+  Received = 0;
+
+  // For a SMBus block read the transfer length is only known once the byte
+  // count has been received. Until then, keep acknowledging.
+  if (SmbusBlockRead) {
+    Remaining = MAX_UINT32;
+  } else {
+    Remaining = *ReadBufferSize;
+  }
+
+  // For a single byte read the slave must be NAKed on the first byte, so set
+  // TXAK before the transfer is kicked off. I2CR is only modified by this
+  // routine from here on, so keep a local copy instead of re-reading it for
+  // every byte.
+  Data = (IMX_I2C_I2CR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2CR);
+  if (Remaining == 1) {
+    Data.TXAK = IMX_I2C_I2CR_TXAK_NO_TRANSMIT_ACK;
+  } else {
+    Data.TXAK = IMX_I2C_I2CR_TXAK_SEND_TRANSMIT_ACK;
+  }
   MmioWrite16 ((UINTN)&BaseAddress->I2CR, Data.Raw);
 
   // Clear controller status bits
@@ -406,32 +530,25 @@ IN UINT32             ReadBufferSize
   MmioRead16 ((UINTN)&BaseAddress->I2DR);
 
   do {
-    // Wait for read transfer to complete
-    if (iMXI2cWaitStatusSet (I2cContext, IMX_I2C_I2SR_IIF) == FALSE) {
-      DEBUG ((DEBUG_ERROR, "%a: waiting for read fail\n", __FUNCTION__));
-      Status = RETURN_DEVICE_ERROR;
-      goto Exit;
-    }
-
-    if (iMXI2cWaitStatusSet (I2cContext, IMX_I2C_I2SR_ICF) == FALSE) {
+    // Wait for the byte transfer to complete and the interrupt to be raised
+    // with a single status poll.
+    if (iMXI2cWaitStatusSet (I2cContext, IMX_I2C_I2SR_IIF | IMX_I2C_I2SR_ICF) == FALSE) {
       DEBUG ((DEBUG_ERROR, "%a: waiting for read fail\n", __FUNCTION__));
-      Status = RETURN_DEVICE_ERROR;
-      goto Exit;
+      return RETURN_DEVICE_ERROR;
     }
 
-    // Before the last byte is read, a Stop signal must be generated
-    if (ReadBufferSize == 1) {
+    if (Remaining == 1) {
+      // Before the last byte is read, a Stop signal must be generated. Reading
+      // I2DR afterwards will not start another transfer.
       Status = iMXI2cGenerateStop (I2cContext);
       if (RETURN_ERROR (Status)) {
         DEBUG ((DEBUG_ERROR, "%a: iMXI2cGenerateStop fail %r\n", __FUNCTION__, Status));
-        goto Exit;
+        return Status;
       }
-    }
-
-    // For second to last byte to read, inform controller to not send transmit ack.
-    // This will inform the slave to stop sending more data after the next byte.
-    if (ReadBufferSize == 2) {
-      Data = (IMX_I2C_I2CR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2CR);
+    } else if (Remaining == 2) {
+      // For second to last byte to read, inform controller to not send
+      // transmit ack. Reading I2DR below starts the last byte transfer, which
+      // the slave will then see NAKed.
       Data.TXAK = IMX_I2C_I2CR_TXAK_NO_TRANSMIT_ACK;
       MmioWrite16 ((UINTN)&BaseAddress->I2CR, Data.Raw);
     }
@@ -439,58 +556,221 @@ IN UINT32             ReadBufferSize
     // Clear controller status bits
     MmioWrite16 ((UINTN)&BaseAddress->I2SR, 0);
 
-    *ReadBufferPtr = MmioRead8 ((UINTN)&BaseAddress->I2DR);
-    ++ReadBufferPtr;
-    --ReadBufferSize;
-  } while (ReadBufferSize > 0);
+    Byte = MmioRead8 ((UINTN)&BaseAddress->I2DR);
+    --Remaining;
 
-  // Generate Stop signal and idle controller
-  Status = iMXI2cGenerateStop (I2cContext);
-  if (RETURN_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: Final iMXI2cGenerateStop fail %r\n", __FUNCTION__, Status));
-  }
+    // Once the byte count was rejected the bytes are only drained from the
+    // bus, never stored.
+    if (!RETURN_ERROR (CountStatus) && (Received < *ReadBufferSize)) {
+      ReadBufferPtr[Received] = Byte;
+      ++Received;
+    }
 
-Exit:
+    if (SmbusBlockRead && (Received == 1) && !RETURN_ERROR (CountStatus)) {
+      // Reading the byte count has already started the next byte transfer.
+      // Any ACK/NAK change is still in time as it is only sampled at the end
+      // of that byte.
+      if ((Byte == 0) ||
+          (Byte > IMX_I2C_SMBUS_BLOCK_MAX) ||
+          (1 + Byte + TrailerSize > *ReadBufferSize)) {
+        DEBUG ((DEBUG_ERROR, "%a: Invalid block count %d\n", __FUNCTION__, Byte));
+        CountStatus = RETURN_BUFFER_TOO_SMALL;
+        Remaining = 1;
+      } else {
+        Remaining = Byte + TrailerSize;
+      }
+
+      if (Remaining == 1) {
+        Data.TXAK = IMX_I2C_I2CR_TXAK_NO_TRANSMIT_ACK;
+        MmioWrite16 ((UINTN)&BaseAddress->I2CR, Data.Raw);
+      }
+    }
+  } while (Remaining > 0);
+
+  // Stop signal has already been generated before the last byte was read
+  *ReadBufferSize = Received;
+  if (RETURN_ERROR (CountStatus)) {
+    return CountStatus;
+  }
   return Status;
 }
 
-/**
-  Perform I2C write operation.
+UINT64
+iMXI2cElapsedTicks (
+  IN  UINT64  BeginTicks,
+  IN  UINT64  EndTicks
+  )
+{
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterEnd < CounterStart) {
+    // Performance counter counts down
+    if (BeginTicks >= EndTicks) {
+      return BeginTicks - EndTicks;
+    }
+    return (BeginTicks - CounterEnd) + (CounterStart - EndTicks);
+  }
 
-  The iMXI2cWrite perform I2C write operation by programming the I2C
-  controller. The caller is responsible to provide I2C controller
-  configuration.
+  if (EndTicks >= BeginTicks) {
+    return EndTicks - BeginTicks;
+  }
+  return (CounterEnd - BeginTicks) + (EndTicks - CounterStart);
+}
 
-  @param[in]    I2cContext        Pointer to structure containing the targeted
-                                  I2C controller to be used for I2C operation.
-  @param[in]    RegisterAddress   Targeted device register address to start write.
-  @param[out]   WriteBufferPtr    Caller supplied buffer that contained data that
-                                  would be read from for I2C write operation.
-  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+IMX_I2C_TRACE *
+iMXI2cFindTrace (
+  IN  UINT32    ControllerAddress
+  )
+{
+  UINT32  Index;
 
-  @retval   RETURN_SUCCESS        I2C Write operation succeeded.
-  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+  // Slots are claimed in order, the first free slot ends the search
+  for (Index = 0; Index < IMX_I2C_TRACE_CONTROLLER_COUNT; ++Index) {
+    if (mTrace[Index].ControllerAddress == ControllerAddress) {
+      return &mTrace[Index];
+    }
+
+    if (mTrace[Index].ControllerAddress == 0) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+VOID
+iMXI2cRecordTrace (
+  IN  IMX_I2C_CONTEXT       *I2cContext,
+  IN  IMX_I2C_REQUEST_TYPE  Type,
+  IN  UINT16                RegisterAddress,
+  IN  UINT32                Length,
+  IN  RETURN_STATUS         Status,
+  IN  UINT64                BeginTicks
+  )
+{
+  UINT32                Bucket;
+  UINT64                DurationInNs;
+  UINT64                DurationInUs;
+  IMX_I2C_TRACE_ENTRY   *Entry;
+  UINT32                Index;
+  BOOLEAN               InterruptState;
+  IMX_I2C_TRACE         *Trace;
+
+  DurationInNs = GetTimeInNanoSecond (iMXI2cElapsedTicks (BeginTicks, GetPerformanceCounter ()));
+  DurationInUs = DivU64x32 (DurationInNs, 1000);
+  if (DurationInUs == 0) {
+    Bucket = 0;
+  } else {
+    Bucket = (UINT32)HighBitSet64 (DurationInUs) + 1;
+    if (Bucket >= IMX_I2C_LATENCY_BUCKET_COUNT) {
+      Bucket = IMX_I2C_LATENCY_BUCKET_COUNT - 1;
+    }
+  }
+
+  // A transfer made from an event callback may preempt the recording of
+  // another transfer on the same controller.
+  InterruptState = SaveAndDisableInterrupts ();
+  Trace = iMXI2cFindTrace (I2cContext->ControllerAddress);
+  if (Trace == NULL) {
+    for (Index = 0; Index < IMX_I2C_TRACE_CONTROLLER_COUNT; ++Index) {
+      if (mTrace[Index].ControllerAddress == 0) {
+        Trace = &mTrace[Index];
+        Trace->ControllerAddress = I2cContext->ControllerAddress;
+        break;
+      }
+    }
+  }
+
+  if (Trace != NULL) {
+    Entry = &Trace->Trace[Trace->TraceIndex];
+    Entry->DurationInNs = DurationInNs;
+    Entry->Status = Status;
+    Entry->Length = Length;
+    Entry->SlaveAddress = (UINT8)I2cContext->SlaveAddress;
+    Entry->RegisterAddress = RegisterAddress;
+    Entry->Type = (UINT8)Type;
+    Trace->TraceIndex = (Trace->TraceIndex + 1) % IMX_I2C_TRACE_ENTRY_COUNT;
+    if (Trace->TraceCount < IMX_I2C_TRACE_ENTRY_COUNT) {
+      ++Trace->TraceCount;
+    }
+    ++Trace->LatencyHistogram[Bucket];
+  }
+  SetInterruptState (InterruptState);
+}
 
-**/
 RETURN_STATUS
-iMXI2cWrite (
-  IN IMX_I2C_CONTEXT  *I2cContext,
-  IN UINT8            RegisterAddress,
-  IN UINT8            *WriteBufferPtr,
-  IN UINT32           WriteBufferSize
+iMXI2cReadInternal (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT16            RegisterAddress,
+  IN  UINT32            RegisterAddressSize,
+  OUT UINT8             *ReadBufferPtr,
+  IN  UINT32            ReadBufferSize,
+  IN  BOOLEAN           ConfigureController
+  )
+{
+  UINT64          BeginTicks;
+  RETURN_STATUS   Status;
+
+  if (ReadBufferSize == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  BeginTicks = 0;
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    BeginTicks = GetPerformanceCounter ();
+  }
+
+  Status = iMXI2cStartRead (I2cContext, RegisterAddress, RegisterAddressSize, ConfigureController);
+  if (!RETURN_ERROR (Status)) {
+    Status = iMXI2cReceiveBytes (I2cContext, ReadBufferPtr, &ReadBufferSize, FALSE, 0);
+  }
+
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    iMXI2cRecordTrace (I2cContext,
+                       ImxI2cRequestRead,
+                       RegisterAddress,
+                       ReadBufferSize,
+                       Status,
+                       BeginTicks);
+  }
+
+  return Status;
+}
+
+RETURN_STATUS
+iMXI2cWriteInternal (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT16            RegisterAddress,
+  IN  UINT32            RegisterAddressSize,
+  IN  UINT8             *WriteBufferPtr,
+  IN  UINT32            WriteBufferSize,
+  IN  BOOLEAN           ConfigureController
   )
 {
   IMX_I2C_REGISTERS     *BaseAddress;
+  UINT64                BeginTicks;
+  UINT32                Length;
   BOOLEAN               Result;
   RETURN_STATUS         Status;
 
   BaseAddress = (IMX_I2C_REGISTERS*)I2cContext->ControllerAddress;
+  Length = WriteBufferSize;
+  BeginTicks = 0;
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    BeginTicks = GetPerformanceCounter ();
+  }
 
-  // Initialize controller
-  Status = iMXI2cSetupController (I2cContext);
+  // Initialize controller, the divider and slave address programming can be
+  // skipped when the controller is already configured for this context.
+  if (ConfigureController) {
+    iMXI2cConfigureController (I2cContext);
+  }
+  Status = iMXI2cStartController (I2cContext);
   if (RETURN_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: Fail to setup controller %r\n", __FUNCTION__, Status));
-    return Status;
+    goto Exit;
   }
 
   // Generate Start signal and send slave device address
@@ -501,7 +781,7 @@ iMXI2cWrite (
   }
 
   // Send target register address to indicate where to start write
-  Result = iMXI2cSendByte (I2cContext, RegisterAddress);
+  Result = iMXI2cSendRegisterAddress (I2cContext, RegisterAddress, RegisterAddressSize);
   if (Result == FALSE) {
     DEBUG ((DEBUG_ERROR,
             "%a: Slave register address transfer fail 0x%04x\n",
@@ -534,5 +814,886 @@ iMXI2cWrite (
   }
 
 Exit:
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    iMXI2cRecordTrace (I2cContext,
+                       ImxI2cRequestWrite,
+                       RegisterAddress,
+                       Length,
+                       Status,
+                       BeginTicks);
+  }
+
   return Status;
 }
+
+/**
+  Perform I2C read operation.
+
+  The iMXI2cRead perform I2C read operation by programming the I2C controller.
+  The caller is responsible to provide I2C controller configuration.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start read.
+  @param[out]   ReadBufferPtr     Caller supplied buffer that would be written
+                                  into with data from the read operation.
+  @param[in]    ReadBufferSize    Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Read operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cRead (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT8            RegisterAddress,
+  OUT UINT8           *ReadBufferPtr,
+  IN UINT32           ReadBufferSize
+  )
+{
+  return iMXI2cReadInternal (I2cContext,
+                             RegisterAddress,
+                             IMX_I2C_REGISTER_ADDRESS_8BIT,
+                             ReadBufferPtr,
+                             ReadBufferSize,
+                             TRUE);
+}
+
+/**
+  Perform I2C write operation.
+
+  The iMXI2cWrite perform I2C write operation by programming the I2C
+  controller. The caller is responsible to provide I2C controller
+  configuration.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start write.
+  @param[out]   WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Write operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cWrite (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT8            RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize
+  )
+{
+  return iMXI2cWriteInternal (I2cContext,
+                              RegisterAddress,
+                              IMX_I2C_REGISTER_ADDRESS_8BIT,
+                              WriteBufferPtr,
+                              WriteBufferSize,
+                              TRUE);
+}
+
+RETURN_STATUS
+iMXI2cAckPoll (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  BOOLEAN           ConfigureController
+  )
+{
+  BOOLEAN                 Acked;
+  IMX_I2C_REGISTERS       *BaseAddress;
+  UINT64                  BeginTicks;
+  UINT64                  ElapsedInUs;
+  RETURN_STATUS           Status;
+  IMX_I2C_I2SR_REGISTER   StatusData;
+
+  BaseAddress = (IMX_I2C_REGISTERS*)I2cContext->ControllerAddress;
+
+  // The divider and slave address do not change between attempts, so the
+  // controller is configured at most once for the whole poll.
+  if (ConfigureController) {
+    iMXI2cConfigureController (I2cContext);
+  }
+
+  // An EEPROM does not acknowledge its address while the internal write cycle
+  // is in progress. Keep addressing the device until it ACKs or timeout. Each
+  // attempt spends a full address byte on the bus, so the elapsed time is
+  // measured instead of counting the poll interval only.
+  BeginTicks = GetPerformanceCounter ();
+  for (;;) {
+    Status = iMXI2cStartController (I2cContext);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    Acked = FALSE;
+    Status = iMXI2cGenerateStart (I2cContext, IMX_I2C_TX);
+    if (!RETURN_ERROR (Status)) {
+      StatusData = (IMX_I2C_I2SR_REGISTER)MmioRead16 ((UINTN)&BaseAddress->I2SR);
+      Acked = (StatusData.RXAK == 0);
+    }
+
+    Status = iMXI2cGenerateStop (I2cContext);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Acked) {
+      return RETURN_SUCCESS;
+    }
+
+    ElapsedInUs = DivU64x32 (
+                    GetTimeInNanoSecond (iMXI2cElapsedTicks (BeginTicks, GetPerformanceCounter ())),
+                    1000);
+    if (ElapsedInUs >= I2cContext->TimeoutInUs) {
+      break;
+    }
+
+    MicroSecondDelay (IMX_I2C_ACK_POLL_INTERVAL_US);
+  }
+
+  DEBUG ((DEBUG_ERROR, "%a: Device 0x%02x did not ACK\n", __FUNCTION__, I2cContext->SlaveAddress));
+  return RETURN_TIMEOUT;
+}
+
+RETURN_STATUS
+iMXI2cEepromWriteInternal (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT32            RegisterAddress,
+  IN  UINT32            RegisterAddressSize,
+  IN  UINT8             *WriteBufferPtr,
+  IN  UINT32            WriteBufferSize,
+  IN  UINT32            PageSize
+  )
+{
+  UINT32          Address;
+  UINT32          ChunkSize;
+  BOOLEAN         ConfigureController;
+  UINT32          Limit;
+  RETURN_STATUS   Status;
+
+  if ((PageSize == 0) ||
+      ((RegisterAddressSize != IMX_I2C_REGISTER_ADDRESS_8BIT) &&
+       (RegisterAddressSize != IMX_I2C_REGISTER_ADDRESS_16BIT))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  // The write must not run past the end of the register address space
+  Limit = 1U << (8 * RegisterAddressSize);
+  if ((RegisterAddress >= Limit) ||
+      (WriteBufferSize > Limit - RegisterAddress)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  // Only the first page needs the controller configured, later pages and the
+  // ACK polling in between reuse the same setup.
+  Address = RegisterAddress;
+  ConfigureController = TRUE;
+  while (WriteBufferSize > 0) {
+    // Bytes past the page boundary would wrap around to the start of the page
+    ChunkSize = PageSize - (Address % PageSize);
+    if (ChunkSize > WriteBufferSize) {
+      ChunkSize = WriteBufferSize;
+    }
+
+    Status = iMXI2cWriteInternal (I2cContext,
+                                  (UINT16)Address,
+                                  RegisterAddressSize,
+                                  WriteBufferPtr,
+                                  ChunkSize,
+                                  ConfigureController);
+    if (RETURN_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Page write at 0x%04x fail %r\n", __FUNCTION__, Address, Status));
+      return Status;
+    }
+
+    ConfigureController = FALSE;
+    Status = iMXI2cAckPoll (I2cContext, ConfigureController);
+    if (RETURN_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Write cycle at 0x%04x fail %r\n", __FUNCTION__, Address, Status));
+      return Status;
+    }
+
+    Address += ChunkSize;
+    WriteBufferPtr += ChunkSize;
+    WriteBufferSize -= ChunkSize;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Perform I2C EEPROM write operation.
+
+  The iMXI2cEepromWrite splits the write into transfers that do not cross the
+  EEPROM page boundary. After each page transfer, the device is ACK polled to
+  wait for the internal write cycle to complete instead of using a fixed delay.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted EEPROM address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+  @param[in]    PageSize          EEPROM page size in bytes.
+
+  @retval   RETURN_SUCCESS            I2C EEPROM write operation succeeded.
+  @retval   RETURN_INVALID_PARAMETER  PageSize is 0 or the write extends past
+                                      the end of the 8-bit address space.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+  @retval   RETURN_TIMEOUT            The EEPROM write cycle did not complete.
+
+**/
+RETURN_STATUS
+iMXI2cEepromWrite (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT8            RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize,
+  IN UINT32           PageSize
+  )
+{
+  return iMXI2cEepromWriteInternal (I2cContext,
+                                    RegisterAddress,
+                                    IMX_I2C_REGISTER_ADDRESS_8BIT,
+                                    WriteBufferPtr,
+                                    WriteBufferSize,
+                                    PageSize);
+}
+
+/**
+  Perform I2C read operation on a device with 16-bit register addressing.
+
+  The register address is sent most significant byte first, followed by a
+  repeated start and the read, all within a single controller setup.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start read.
+  @param[out]   ReadBufferPtr     Caller supplied buffer that would be written
+                                  into with data from the read operation.
+  @param[in]    ReadBufferSize    Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Read operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cRead16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  OUT UINT8           *ReadBufferPtr,
+  IN UINT32           ReadBufferSize
+  )
+{
+  return iMXI2cReadInternal (I2cContext,
+                             RegisterAddress,
+                             IMX_I2C_REGISTER_ADDRESS_16BIT,
+                             ReadBufferPtr,
+                             ReadBufferSize,
+                             TRUE);
+}
+
+/**
+  Perform I2C write operation on a device with 16-bit register addressing.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted device register address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+
+  @retval   RETURN_SUCCESS        I2C Write operation succeeded.
+  @retval   RETURN_DEVICE_ERROR   The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cWrite16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize
+  )
+{
+  return iMXI2cWriteInternal (I2cContext,
+                              RegisterAddress,
+                              IMX_I2C_REGISTER_ADDRESS_16BIT,
+                              WriteBufferPtr,
+                              WriteBufferSize,
+                              TRUE);
+}
+
+/**
+  Perform I2C EEPROM write operation on a device with 16-bit addressing.
+
+  Same as iMXI2cEepromWrite for EEPROMs larger than 256 bytes.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    RegisterAddress   Targeted EEPROM address to start write.
+  @param[in]    WriteBufferPtr    Caller supplied buffer that contained data that
+                                  would be read from for I2C write operation.
+  @param[in]    WriteBufferSize   Size of caller supplied buffer.
+  @param[in]    PageSize          EEPROM page size in bytes.
+
+  @retval   RETURN_SUCCESS            I2C EEPROM write operation succeeded.
+  @retval   RETURN_INVALID_PARAMETER  PageSize is 0 or the write extends past
+                                      the end of the 16-bit address space.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+  @retval   RETURN_TIMEOUT            The EEPROM write cycle did not complete.
+
+**/
+RETURN_STATUS
+iMXI2cEepromWrite16 (
+  IN IMX_I2C_CONTEXT  *I2cContext,
+  IN UINT16           RegisterAddress,
+  IN UINT8            *WriteBufferPtr,
+  IN UINT32           WriteBufferSize,
+  IN UINT32           PageSize
+  )
+{
+  return iMXI2cEepromWriteInternal (I2cContext,
+                                    RegisterAddress,
+                                    IMX_I2C_REGISTER_ADDRESS_16BIT,
+                                    WriteBufferPtr,
+                                    WriteBufferSize,
+                                    PageSize);
+}
+
+UINT8
+iMXI2cCalculatePec (
+  IN  UINT8   Crc,
+  IN  UINT8   *Buffer,
+  IN  UINT32  BufferSize
+  )
+{
+  UINT32  Bit;
+
+  // SMBus PEC is a CRC-8 with polynomial x^8 + x^2 + x + 1
+  while (BufferSize > 0) {
+    Crc ^= *Buffer;
+    for (Bit = 0; Bit < 8; ++Bit) {
+      if ((Crc & 0x80) != 0) {
+        Crc = (UINT8)((Crc << 1) ^ 0x07);
+      } else {
+        Crc = (UINT8)(Crc << 1);
+      }
+    }
+
+    ++Buffer;
+    --BufferSize;
+  }
+
+  return Crc;
+}
+
+/**
+  Perform SMBus block read operation.
+
+  The command is written and the block is read back after a repeated start
+  within a single controller setup. The byte count returned by the device is
+  used to terminate the transfer. When PEC is enabled, the trailing PEC byte
+  is read and checked against the CRC-8 of the whole transaction.
+
+  @param[in]      I2cContext      Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]      Command         SMBus command code.
+  @param[out]     BlockBuffer     Caller supplied buffer receiving the block
+                                  data, without the byte count and PEC.
+  @param[in,out]  BlockSize       On input, size of BlockBuffer. On output,
+                                  number of bytes returned by the device.
+  @param[in]      PecEnable       TRUE to read and check the PEC byte.
+
+  @retval   RETURN_SUCCESS            SMBus block read succeeded.
+  @retval   RETURN_BUFFER_TOO_SMALL   The device returned an invalid byte count
+                                      or more data than BlockBuffer can hold.
+  @retval   RETURN_CRC_ERROR          PEC check failed.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cSmbusBlockRead (
+  IN      IMX_I2C_CONTEXT   *I2cContext,
+  IN      UINT8             Command,
+  OUT     UINT8             *BlockBuffer,
+  IN OUT  UINT32            *BlockSize,
+  IN      BOOLEAN           PecEnable
+  )
+{
+  UINT64          BeginTicks;
+  UINT8           Crc;
+  UINT8           Header[3];
+  UINT8           Packet[1 + IMX_I2C_SMBUS_BLOCK_MAX + 1];
+  UINT32          PacketSize;
+  UINT32          TrailerSize;
+  RETURN_STATUS   Status;
+
+  TrailerSize = PecEnable ? 1 : 0;
+  PacketSize = 1 + MIN (*BlockSize, IMX_I2C_SMBUS_BLOCK_MAX) + TrailerSize;
+  BeginTicks = 0;
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    BeginTicks = GetPerformanceCounter ();
+  }
+
+  Status = iMXI2cStartRead (I2cContext, Command, IMX_I2C_REGISTER_ADDRESS_8BIT, TRUE);
+  if (!RETURN_ERROR (Status)) {
+    Status = iMXI2cReceiveBytes (I2cContext, Packet, &PacketSize, TRUE, TrailerSize);
+  }
+
+  if (FeaturePcdGet (PcdI2cTraceEnable)) {
+    iMXI2cRecordTrace (I2cContext,
+                       ImxI2cRequestRead,
+                       Command,
+                       PacketSize,
+                       Status,
+                       BeginTicks);
+  }
+
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  if (PecEnable) {
+    Header[0] = (UINT8)(I2cContext->SlaveAddress << 1) | IMX_I2C_TX;
+    Header[1] = Command;
+    Header[2] = (UINT8)(I2cContext->SlaveAddress << 1) | IMX_I2C_RX;
+    Crc = iMXI2cCalculatePec (0, Header, sizeof (Header));
+    Crc = iMXI2cCalculatePec (Crc, Packet, PacketSize - 1);
+    if (Crc != Packet[PacketSize - 1]) {
+      DEBUG ((DEBUG_ERROR,
+              "%a: PEC mismatch 0x%02x expected 0x%02x\n",
+              __FUNCTION__,
+              Packet[PacketSize - 1],
+              Crc));
+      return RETURN_CRC_ERROR;
+    }
+  }
+
+  // Never trust the byte count further than the bytes actually received
+  if ((Packet[0] == 0) ||
+      (Packet[0] > IMX_I2C_SMBUS_BLOCK_MAX) ||
+      (Packet[0] > *BlockSize) ||
+      (1 + Packet[0] + TrailerSize != PacketSize)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid block count %d\n", __FUNCTION__, Packet[0]));
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+
+  *BlockSize = Packet[0];
+  CopyMem (BlockBuffer, &Packet[1], Packet[0]);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Perform SMBus block write operation.
+
+  The command, byte count, block data and optionally the PEC byte are sent
+  within a single controller setup.
+
+  @param[in]    I2cContext        Pointer to structure containing the targeted
+                                  I2C controller to be used for I2C operation.
+  @param[in]    Command           SMBus command code.
+  @param[in]    BlockBuffer       Caller supplied block data.
+  @param[in]    BlockSize         Number of bytes in BlockBuffer, 1 to 32.
+  @param[in]    PecEnable         TRUE to append the PEC byte.
+
+  @retval   RETURN_SUCCESS            SMBus block write succeeded.
+  @retval   RETURN_INVALID_PARAMETER  BlockSize is out of range.
+  @retval   RETURN_DEVICE_ERROR       The I2C device is not functioning correctly.
+
+**/
+RETURN_STATUS
+iMXI2cSmbusBlockWrite (
+  IN  IMX_I2C_CONTEXT   *I2cContext,
+  IN  UINT8             Command,
+  IN  UINT8             *BlockBuffer,
+  IN  UINT32            BlockSize,
+  IN  BOOLEAN           PecEnable
+  )
+{
+  UINT8     Crc;
+  UINT8     Header[2];
+  UINT8     Packet[1 + IMX_I2C_SMBUS_BLOCK_MAX + 1];
+  UINT32    PacketSize;
+
+  if ((BlockSize == 0) || (BlockSize > IMX_I2C_SMBUS_BLOCK_MAX)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Packet[0] = (UINT8)BlockSize;
+  CopyMem (&Packet[1], BlockBuffer, BlockSize);
+  PacketSize = 1 + BlockSize;
+
+  if (PecEnable) {
+    Header[0] = (UINT8)(I2cContext->SlaveAddress << 1) | IMX_I2C_TX;
+    Header[1] = Command;
+    Crc = iMXI2cCalculatePec (0, Header, sizeof (Header));
+    Packet[PacketSize] = iMXI2cCalculatePec (Crc, Packet, PacketSize);
+    ++PacketSize;
+  }
+
+  return iMXI2cWriteInternal (I2cContext,
+                              Command,
+                              IMX_I2C_REGISTER_ADDRESS_8BIT,
+                              Packet,
+                              PacketSize,
+                              TRUE);
+}
+
+BOOLEAN
+iMXI2cBusIsWarm (
+  IN  IMX_I2C_BUS       *I2cBus,
+  IN  IMX_I2C_CONTEXT   *I2cContext
+  )
+{
+  // Warm is cleared after a failed transfer, the controller state is unknown
+  // even if its registers still match.
+  if (!I2cBus->Warm) {
+    return FALSE;
+  }
+
+  return iMXI2cIsConfigured (I2cContext);
+}
+
+/**
+  Initialize an I2C bus owner object.
+
+  All clients sharing the I2C controller at ControllerAddress should submit
+  their transfers through the same bus object, so transfers are serialized
+  and the controller configuration can be kept between transfers.
+
+  @param[out]   I2cBus              Pointer to the bus object to initialize.
+  @param[in]    ControllerAddress   Base address of the I2C controller owned
+                                    by this bus object.
+
+**/
+VOID
+iMXI2cBusInitialize (
+  OUT IMX_I2C_BUS   *I2cBus,
+  IN  UINT32        ControllerAddress
+  )
+{
+  ZeroMem (I2cBus, sizeof (*I2cBus));
+  I2cBus->ControllerAddress = ControllerAddress;
+  I2cBus->Draining = FALSE;
+  I2cBus->Warm = FALSE;
+  I2cBus->PendingHead = NULL;
+  I2cBus->PendingTail = NULL;
+}
+
+VOID
+iMXI2cBusPerform (
+  IN      IMX_I2C_BUS     *I2cBus,
+  IN OUT  IMX_I2C_BATCH   *Batch
+  )
+{
+  UINT64            BeginTicks;
+  BOOLEAN           ConfigureController;
+  UINT32            Index;
+  IMX_I2C_REQUEST   *Request;
+
+  // Only the client draining the bus gets here, so the counters need no
+  // further protection.
+  Batch->Status = RETURN_SUCCESS;
+  BeginTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < Batch->RequestCount; ++Index) {
+    Request = &Batch->RequestList[Index];
+    ConfigureController = !iMXI2cBusIsWarm (I2cBus, Request->I2cContext);
+    if (ConfigureController) {
+      ++I2cBus->ConfigureCount;
+    }
+
+    if (Request->Type == ImxI2cRequestRead) {
+      Request->Status = iMXI2cReadInternal (Request->I2cContext,
+                                            Request->RegisterAddress,
+                                            Request->RegisterAddressSize,
+                                            Request->Buffer,
+                                            Request->BufferSize,
+                                            ConfigureController);
+    } else {
+      Request->Status = iMXI2cWriteInternal (Request->I2cContext,
+                                             Request->RegisterAddress,
+                                             Request->RegisterAddressSize,
+                                             Request->Buffer,
+                                             Request->BufferSize,
+                                             ConfigureController);
+    }
+
+    ++I2cBus->TransactionCount;
+
+    if (RETURN_ERROR (Request->Status)) {
+      // Controller state is unknown after a failed transfer, force the next
+      // request to go through a full controller setup.
+      ++I2cBus->ErrorCount;
+      I2cBus->Warm = FALSE;
+      Batch->Status = Request->Status;
+      break;
+    }
+
+    I2cBus->ByteCount += Request->BufferSize;
+    I2cBus->Warm = TRUE;
+  }
+
+  I2cBus->BusyTicks += iMXI2cElapsedTicks (BeginTicks, GetPerformanceCounter ());
+}
+
+/**
+  Submit a batch of I2C requests to a shared I2C bus.
+
+  The requests of a batch are performed in order, and batches are performed
+  one at a time in submission order, so transfers from different clients are
+  never interleaved. The controller is only reconfigured when its registers do
+  not match the clock and controller slave address of the request.
+
+  When the bus is idle, the batch and any batch queued meanwhile are performed
+  before returning. When the caller preempted the client currently owning the
+  bus, for example from a timer event callback, waiting would never end as
+  the owner cannot resume. The batch is then queued and RETURN_NOT_READY is
+  returned; the owner performs it before releasing the bus and sets Done. The
+  caller must keep the batch, its requests and their buffers valid until Done
+  is set, and read the result from the Status fields.
+
+  The bus is protected by disabling interrupts, which serializes the UEFI
+  boot services environment as it runs on a single processor.
+
+  @param[in]      I2cBus          Pointer to the bus object owning the
+                                  controller.
+  @param[in,out]  Batch           Batch of requests to perform. The Status
+                                  field of the batch and of each request is
+                                  updated and Done is set on completion.
+
+  @retval   RETURN_SUCCESS            All requests succeeded.
+  @retval   RETURN_INVALID_PARAMETER  A request targets another controller,
+                                      the batch was not queued.
+  @retval   RETURN_NOT_READY          The bus is owned by a preempted client,
+                                      the batch is queued.
+  @retval   RETURN_DEVICE_ERROR       A request failed, remaining requests of
+                                      the batch were not performed.
+
+**/
+RETURN_STATUS
+iMXI2cBusSubmit (
+  IN      IMX_I2C_BUS     *I2cBus,
+  IN OUT  IMX_I2C_BATCH   *Batch
+  )
+{
+  IMX_I2C_BATCH   *Current;
+  UINT32          Index;
+  BOOLEAN         InterruptState;
+
+  for (Index = 0; Index < Batch->RequestCount; ++Index) {
+    Batch->RequestList[Index].Status = RETURN_NOT_READY;
+    if ((Batch->RequestList[Index].I2cContext->ControllerAddress != I2cBus->ControllerAddress) ||
+        ((Batch->RequestList[Index].RegisterAddressSize != IMX_I2C_REGISTER_ADDRESS_8BIT) &&
+         (Batch->RequestList[Index].RegisterAddressSize != IMX_I2C_REGISTER_ADDRESS_16BIT))) {
+      Batch->Status = RETURN_INVALID_PARAMETER;
+      Batch->Done = TRUE;
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  Batch->Next = NULL;
+  Batch->Status = RETURN_NOT_READY;
+  Batch->Done = FALSE;
+
+  InterruptState = SaveAndDisableInterrupts ();
+  if (I2cBus->PendingTail == NULL) {
+    I2cBus->PendingHead = Batch;
+  } else {
+    I2cBus->PendingTail->Next = Batch;
+  }
+  I2cBus->PendingTail = Batch;
+
+  if (I2cBus->Draining) {
+    // The client draining the bus was preempted by this caller and picks the
+    // batch up once it resumes.
+    ++I2cBus->ContentionCount;
+    SetInterruptState (InterruptState);
+    return RETURN_NOT_READY;
+  }
+  I2cBus->Draining = TRUE;
+  SetInterruptState (InterruptState);
+
+  // Keep draining until the pending list is empty, including batches queued
+  // by callers that preempted this one.
+  for (;;) {
+    InterruptState = SaveAndDisableInterrupts ();
+    Current = I2cBus->PendingHead;
+    if (Current == NULL) {
+      I2cBus->Draining = FALSE;
+      SetInterruptState (InterruptState);
+      break;
+    }
+
+    I2cBus->PendingHead = Current->Next;
+    if (I2cBus->PendingHead == NULL) {
+      I2cBus->PendingTail = NULL;
+    }
+    SetInterruptState (InterruptState);
+
+    iMXI2cBusPerform (I2cBus, Current);
+    // The owner of a deferred batch may release it as soon as Done is set
+    Current->Done = TRUE;
+  }
+
+  return Batch->Status;
+}
+
+/**
+  Retrieve the utilization counters of a shared I2C bus.
+
+  @param[in]    I2cBus        Pointer to the bus object.
+  @param[out]   Statistics    Caller supplied buffer receiving the counters.
+
+**/
+VOID
+iMXI2cBusGetStatistics (
+  IN  IMX_I2C_BUS             *I2cBus,
+  OUT IMX_I2C_BUS_STATISTICS  *Statistics
+  )
+{
+  BOOLEAN   InterruptState;
+
+  InterruptState = SaveAndDisableInterrupts ();
+  Statistics->TransactionCount = I2cBus->TransactionCount;
+  Statistics->ByteCount = I2cBus->ByteCount;
+  Statistics->ErrorCount = I2cBus->ErrorCount;
+  Statistics->ContentionCount = I2cBus->ContentionCount;
+  Statistics->ConfigureCount = I2cBus->ConfigureCount;
+  Statistics->BusyTimeInNs = GetTimeInNanoSecond (I2cBus->BusyTicks);
+  SetInterruptState (InterruptState);
+}
+
+/**
+  Print the transfer trace and latency histogram of a shared I2C bus.
+
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]    I2cBus        Pointer to the bus object.
+
+**/
+VOID
+iMXI2cBusDumpTrace (
+  IN  IMX_I2C_BUS   *I2cBus
+  )
+{
+  iMXI2cDumpTrace (I2cBus->ControllerAddress);
+}
+
+/**
+  Retrieve the most recent transfers made on an I2C controller.
+
+  Every transfer is recorded, whether it was submitted through a bus object
+  or made directly with the iMXI2cRead/iMXI2cWrite family of functions.
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]      ControllerAddress   Base address of the I2C controller.
+  @param[out]     TraceBuffer         Caller supplied buffer receiving the
+                                      entries, oldest first.
+  @param[in,out]  EntryCount          On input the number of entries
+                                      TraceBuffer can hold. On output the
+                                      number of entries returned.
+
+  @retval   RETURN_SUCCESS        The entries were returned.
+  @retval   RETURN_UNSUPPORTED    Tracing is disabled.
+  @retval   RETURN_NOT_FOUND      No transfer was recorded for the controller.
+
+**/
+RETURN_STATUS
+iMXI2cGetTrace (
+  IN      UINT32                ControllerAddress,
+  OUT     IMX_I2C_TRACE_ENTRY   *TraceBuffer,
+  IN OUT  UINT32                *EntryCount
+  )
+{
+  UINT32          Count;
+  UINT32          Index;
+  BOOLEAN         InterruptState;
+  IMX_I2C_TRACE   *Trace;
+  UINT32          TraceIndex;
+
+  if (!FeaturePcdGet (PcdI2cTraceEnable)) {
+    *EntryCount = 0;
+    return RETURN_UNSUPPORTED;
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+  Trace = iMXI2cFindTrace (ControllerAddress);
+  if (Trace == NULL) {
+    SetInterruptState (InterruptState);
+    *EntryCount = 0;
+    return RETURN_NOT_FOUND;
+  }
+
+  // Return the most recent entries that fit, oldest first
+  Count = MIN (*EntryCount, Trace->TraceCount);
+  TraceIndex = (Trace->TraceIndex + IMX_I2C_TRACE_ENTRY_COUNT - Count) %
+               IMX_I2C_TRACE_ENTRY_COUNT;
+  for (Index = 0; Index < Count; ++Index) {
+    CopyMem (&TraceBuffer[Index], &Trace->Trace[TraceIndex], sizeof (*TraceBuffer));
+    TraceIndex = (TraceIndex + 1) % IMX_I2C_TRACE_ENTRY_COUNT;
+  }
+  SetInterruptState (InterruptState);
+
+  *EntryCount = Count;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Print the transfer trace and latency histogram of an I2C controller.
+
+  Transfers are only recorded when PcdI2cTraceEnable is set.
+
+  @param[in]    ControllerAddress   Base address of the I2C controller.
+
+**/
+VOID
+iMXI2cDumpTrace (
+  IN  UINT32    ControllerAddress
+  )
+{
+  UINT32                Bucket;
+  IMX_I2C_TRACE_ENTRY   *Entry;
+  UINT32                Index;
+  IMX_I2C_TRACE         *Trace;
+  UINT32                TraceIndex;
+
+  if (!FeaturePcdGet (PcdI2cTraceEnable)) {
+    DEBUG ((DEBUG_INFO, "%a: I2C tracing is disabled\n", __FUNCTION__));
+    return;
+  }
+
+  Trace = iMXI2cFindTrace (ControllerAddress);
+  if (Trace == NULL) {
+    DEBUG ((DEBUG_INFO, "%a: No transfer on I2C 0x%08x\n", __FUNCTION__, ControllerAddress));
+    return;
+  }
+
+  DEBUG ((DEBUG_INFO, "I2C 0x%08x trace, oldest first\n", ControllerAddress));
+  TraceIndex = (Trace->TraceIndex + IMX_I2C_TRACE_ENTRY_COUNT - Trace->TraceCount) %
+               IMX_I2C_TRACE_ENTRY_COUNT;
+  for (Index = 0; Index < Trace->TraceCount; ++Index) {
+    Entry = &Trace->Trace[TraceIndex];
+    DEBUG ((DEBUG_INFO,
+            "  %a Slave 0x%02x Reg 0x%04x Len %d %ldus %r\n",
+            (Entry->Type == ImxI2cRequestRead) ? "RD" : "WR",
+            Entry->SlaveAddress,
+            Entry->RegisterAddress,
+            Entry->Length,
+            DivU64x32 (Entry->DurationInNs, 1000),
+            Entry->Status));
+    TraceIndex = (TraceIndex + 1) % IMX_I2C_TRACE_ENTRY_COUNT;
+  }
+
+  DEBUG ((DEBUG_INFO, "I2C 0x%08x latency histogram\n", ControllerAddress));
+  for (Bucket = 0; Bucket < IMX_I2C_LATENCY_BUCKET_COUNT; ++Bucket) {
+    if (Trace->LatencyHistogram[Bucket] == 0) {
+      continue;
+    }
+
+    if (Bucket == IMX_I2C_LATENCY_BUCKET_COUNT - 1) {
+      DEBUG ((DEBUG_INFO, "  >= %6dus: %d\n", 1 << (Bucket - 1), Trace->LatencyHistogram[Bucket]));
+    } else {
+      DEBUG ((DEBUG_INFO, "  <  %6dus: %d\n", 1 << Bucket, Trace->LatencyHistogram[Bucket]));
+    }
+  }
+}
@@ -0,0 +1,52 @@
+/** @file
+*
+*  Pixel kernels for the host tests that copy strictly from low to high
+*  addresses, one pixel at a time.
+*
+*  iMXBltGeneric.c copies with CopyMem, which handles any overlap, so a run
+*  handed to iMXBltCopyForward the wrong way round goes unnoticed with it.
+*  The NEON kernels only honor the documented contract, and so do these.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Uefi.h>
+
+#include "iMXBltLibInternal.h"
+
+VOID
+iMXBltFill (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Pixel
+  )
+{
+  volatile UINT32   *Cursor;
+
+  for (Cursor = Destination; Count > 0; --Count) {
+    *Cursor++ = Pixel;
+  }
+}
+
+VOID
+iMXBltCopyForward (
+  OUT UINT32        *Destination,
+  IN  CONST UINT32  *Source,
+  IN  UINTN         Count
+  )
+{
+  volatile UINT32   *Cursor;
+
+  for (Cursor = Destination; Count > 0; --Count) {
+    *Cursor++ = *Source++;
+  }
+}
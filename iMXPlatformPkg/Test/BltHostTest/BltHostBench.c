@@ -0,0 +1,242 @@
+/** @file
+*
+*  Host benchmark of iMXBltLib against the scalar reference.
+*
+*  Runs the common console and boot logo operations on a 1024x768 frame, with
+*  and without padding at the end of the lines. The shadow buffer runs include
+*  the flush to the frame buffer. Only the host time is measured, it compares
+*  the line handling of the library against per pixel loops but says nothing
+*  about the cost of an uncached frame buffer on the target.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXBltLib.h>
+
+#include "BltReference.h"
+
+#define BENCH_WIDTH             1024
+#define BENCH_HEIGHT            768
+#define BENCH_GLYPH_WIDTH       8
+#define BENCH_GLYPH_HEIGHT      19
+#define BENCH_MIN_TIME_NS       50000000ULL
+
+typedef enum {
+  BenchReference,
+  BenchDirect,
+  BenchShadow,
+  BenchModeMax
+} BENCH_MODE;
+
+typedef struct {
+  BENCH_MODE            Mode;
+  IMX_BLT_CONTEXT       Context;
+  BLT_REFERENCE_FRAME   Reference;
+} BENCH_TARGET;
+
+typedef
+UINTN
+(*BENCH_FUNCTION) (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  );
+
+STATIC CONST CHAR8  *mModeName[BenchModeMax] = { "reference", "direct", "shadow" };
+
+STATIC
+VOID
+BenchBlt (
+  IN  BENCH_TARGET                        *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL       *BltBuffer,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_OPERATION   BltOperation,
+  IN  UINTN                               SourceX,
+  IN  UINTN                               SourceY,
+  IN  UINTN                               DestinationX,
+  IN  UINTN                               DestinationY,
+  IN  UINTN                               Width,
+  IN  UINTN                               Height
+  )
+{
+  if (Target->Mode == BenchReference) {
+    BltReference (&Target->Reference, BltBuffer, BltOperation, SourceX, SourceY,
+                  DestinationX, DestinationY, Width, Height, 0);
+  } else {
+    iMXBlt (&Target->Context, BltBuffer, BltOperation, SourceX, SourceY,
+            DestinationX, DestinationY, Width, Height, 0);
+  }
+}
+
+STATIC
+UINTN
+BenchFillScreen (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  )
+{
+  BenchBlt (Target, Buffer, EfiBltVideoFill, 0, 0, 0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+  return BENCH_WIDTH * BENCH_HEIGHT;
+}
+
+STATIC
+UINTN
+BenchBufferToScreen (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  )
+{
+  BenchBlt (Target, Buffer, EfiBltBufferToVideo, 0, 0, 0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+  return BENCH_WIDTH * BENCH_HEIGHT;
+}
+
+STATIC
+UINTN
+BenchScreenToBuffer (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  )
+{
+  BenchBlt (Target, Buffer, EfiBltVideoToBltBuffer, 0, 0, 0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+  return BENCH_WIDTH * BENCH_HEIGHT;
+}
+
+//
+// A console scrolling up by one text line and clearing the last one
+//
+STATIC
+UINTN
+BenchScroll (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  )
+{
+  BenchBlt (Target, NULL, EfiBltVideoToVideo, 0, BENCH_GLYPH_HEIGHT, 0, 0,
+            BENCH_WIDTH, BENCH_HEIGHT - BENCH_GLYPH_HEIGHT);
+  BenchBlt (Target, Buffer, EfiBltVideoFill, 0, 0, 0, BENCH_HEIGHT - BENCH_GLYPH_HEIGHT,
+            BENCH_WIDTH, BENCH_GLYPH_HEIGHT);
+  return BENCH_WIDTH * BENCH_HEIGHT;
+}
+
+//
+// A line of text drawn one glyph at a time
+//
+STATIC
+UINTN
+BenchGlyphs (
+  IN  BENCH_TARGET                    *Target,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer
+  )
+{
+  UINTN   X;
+
+  for (X = 0; X < BENCH_WIDTH; X += BENCH_GLYPH_WIDTH) {
+    BenchBlt (Target, Buffer, EfiBltBufferToVideo, 0, 0, X, BENCH_HEIGHT / 2,
+              BENCH_GLYPH_WIDTH, BENCH_GLYPH_HEIGHT);
+  }
+  return BENCH_WIDTH * BENCH_GLYPH_HEIGHT;
+}
+
+STATIC
+VOID
+BenchRun (
+  IN  CONST CHAR8     *Name,
+  IN  BENCH_FUNCTION  Function,
+  IN  UINT32          PixelsPerScanLine
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  UINT32                          *FrameBuffer;
+  UINT64                          HostInNs;
+  UINT32                          Index;
+  UINT32                          Iterations;
+  BENCH_MODE                      Mode;
+  UINTN                           Pixels;
+  UINT64                          ReferenceInNs;
+  struct timespec                 Start;
+  struct timespec                 Stop;
+  BENCH_TARGET                    Target;
+
+  Buffer = malloc (BENCH_WIDTH * BENCH_HEIGHT * sizeof (*Buffer));
+  FrameBuffer = malloc ((UINTN)PixelsPerScanLine * BENCH_HEIGHT * sizeof (UINT32));
+  SetMem (Buffer, BENCH_WIDTH * BENCH_HEIGHT * sizeof (*Buffer), 0x5A);
+  SetMem (FrameBuffer, (UINTN)PixelsPerScanLine * BENCH_HEIGHT * sizeof (UINT32), 0);
+  Pixels = 0;
+  ReferenceInNs = 0;
+
+  for (Mode = BenchReference; Mode < BenchModeMax; ++Mode) {
+    HostReset ();
+    Target.Mode = Mode;
+    Target.Reference.Pixels = FrameBuffer;
+    Target.Reference.Width = BENCH_WIDTH;
+    Target.Reference.Height = BENCH_HEIGHT;
+    Target.Reference.PixelsPerScanLine = PixelsPerScanLine;
+    iMXBltInitialize (&Target.Context, FrameBuffer, BENCH_WIDTH, BENCH_HEIGHT,
+                      PixelsPerScanLine, (Mode == BenchShadow) ? IMX_BLT_FLAG_SHADOW : 0);
+
+    // Double the iterations until the run is long enough to time
+    Iterations = 1;
+    do {
+      Iterations *= 2;
+      clock_gettime (CLOCK_MONOTONIC, &Start);
+      for (Index = 0; Index < Iterations; ++Index) {
+        Pixels = Function (&Target, Buffer);
+        iMXBltFlush (&Target.Context);
+      }
+      clock_gettime (CLOCK_MONOTONIC, &Stop);
+      HostInNs = (Stop.tv_sec - Start.tv_sec) * 1000000000ULL + Stop.tv_nsec - Start.tv_nsec;
+    } while (HostInNs < BENCH_MIN_TIME_NS);
+    HostInNs /= Iterations;
+    if (Mode == BenchReference) {
+      ReferenceInNs = HostInNs;
+    }
+
+    printf ("%-16s pitch %4u %-9s %9.1f us  %8.1f Mpixel/s  %5.2fx\n",
+            Name,
+            PixelsPerScanLine,
+            mModeName[Mode],
+            HostInNs / 1000.0,
+            Pixels * 1000.0 / HostInNs,
+            (double)ReferenceInNs / HostInNs);
+    iMXBltFree (&Target.Context);
+  }
+
+  free (FrameBuffer);
+  free (Buffer);
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  STATIC CONST UINT32 Pitches[] = { BENCH_WIDTH, BENCH_WIDTH + 16 };
+  UINT32              Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Pitches); ++Index) {
+    BenchRun ("FillScreen", BenchFillScreen, Pitches[Index]);
+    BenchRun ("BufferToScreen", BenchBufferToScreen, Pitches[Index]);
+    BenchRun ("ScreenToBuffer", BenchScreenToBuffer, Pitches[Index]);
+    BenchRun ("ScrollLine", BenchScroll, Pitches[Index]);
+    BenchRun ("GlyphLine", BenchGlyphs, Pitches[Index]);
+  }
+  return 0;
+}
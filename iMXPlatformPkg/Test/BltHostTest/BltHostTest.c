@@ -0,0 +1,886 @@
+/** @file
+*
+*  Host functional tests of iMXBltLib against the scalar reference.
+*
+*  Every operation is run on the frame and on a reference copy of the visible
+*  image, the frames are compared after each step. The frame buffer sits
+*  between guard pixels and Blt buffers are allocated to their exact size, so
+*  anything written outside of the frame or the buffer is caught. The fuzz
+*  tests draw their parameters from a fixed seed, so a failure reproduces.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <stdlib.h>
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXBltLib.h>
+
+#include "BltReference.h"
+#include "iMXBltLibInternal.h"
+
+// The same tests are built once per kernel
+#ifndef TEST_NAME
+#define TEST_NAME           "BltHostTest"
+#endif
+
+#define TEST_GUARD_PIXELS   64
+#define TEST_GUARD_PIXEL    0xDEADBEEF
+
+#define TEST_TIMER_EVENT    (EVT_TIMER | EVT_NOTIFY_SIGNAL)
+
+#define TEST_FUZZ_SEED              0x9E3779B97F4A7C15ULL
+#define TEST_FUZZ_KERNEL_COUNT      20000
+#define TEST_FUZZ_KERNEL_PIXELS     300
+#define TEST_FUZZ_FRAME_COUNT       200
+#define TEST_FUZZ_BLT_COUNT         100
+
+typedef struct {
+  UINT32                *Memory;
+  UINT32                *FrameBuffer;
+  UINT32                Width;
+  UINT32                Height;
+  UINT32                PixelsPerScanLine;
+  UINT32                BufferHeight;
+  UINTN                 ScanoutOffset;
+  UINT32                SetScanoutCount;
+  IMX_BLT_CONTEXT       Context;
+  BLT_REFERENCE_FRAME   Reference;
+} TEST_FRAME;
+
+STATIC UINT64  mRandomState;
+
+STATIC
+UINTN
+TestRandom (
+  IN  UINTN   Limit
+  )
+{
+  // xorshift64*
+  mRandomState ^= mRandomState >> 12;
+  mRandomState ^= mRandomState << 25;
+  mRandomState ^= mRandomState >> 27;
+  return (UINTN)((mRandomState * 0x2545F4914F6CDD1DULL) >> 32) % Limit;
+}
+
+STATIC
+VOID
+EFIAPI
+TestSetScanout (
+  IN  VOID    *Context,
+  IN  UINTN   Offset
+  )
+{
+  TEST_FRAME  *Frame;
+
+  Frame = Context;
+  Frame->ScanoutOffset = Offset;
+  ++Frame->SetScanoutCount;
+}
+
+STATIC
+UINT32
+TestPixel (
+  IN  UINTN   Index,
+  IN  UINT32  Seed
+  )
+{
+  return (UINT32)((Index + Seed) * 2654435761u);
+}
+
+/**
+  Set up a frame filled with a pattern and the matching reference image.
+
+  A BufferHeight above Height enables scrolling through the scanout address.
+
+**/
+STATIC
+VOID
+TestFrameCreate (
+  OUT TEST_FRAME  *Frame,
+  IN  UINT32      Width,
+  IN  UINT32      Height,
+  IN  UINT32      PixelsPerScanLine,
+  IN  UINT32      BufferHeight,
+  IN  UINT32      Flags
+  )
+{
+  UINTN   Count;
+  UINTN   Index;
+  UINTN   Y;
+
+  ZeroMem (Frame, sizeof (*Frame));
+  Frame->Width = Width;
+  Frame->Height = Height;
+  Frame->PixelsPerScanLine = PixelsPerScanLine;
+  Frame->BufferHeight = BufferHeight;
+
+  Count = (UINTN)PixelsPerScanLine * BufferHeight;
+  Frame->Memory = malloc ((Count + 2 * TEST_GUARD_PIXELS) * sizeof (UINT32));
+  for (Index = 0; Index < Count + 2 * TEST_GUARD_PIXELS; ++Index) {
+    Frame->Memory[Index] = TEST_GUARD_PIXEL;
+  }
+  Frame->FrameBuffer = Frame->Memory + TEST_GUARD_PIXELS;
+  for (Index = 0; Index < Count; ++Index) {
+    Frame->FrameBuffer[Index] = TestPixel (Index, 0);
+  }
+
+  Frame->Reference.Pixels = malloc ((UINTN)Width * Height * sizeof (UINT32));
+  Frame->Reference.Width = Width;
+  Frame->Reference.Height = Height;
+  Frame->Reference.PixelsPerScanLine = Width;
+  for (Y = 0; Y < Height; ++Y) {
+    CopyMem (
+      Frame->Reference.Pixels + Y * Width,
+      Frame->FrameBuffer + Y * PixelsPerScanLine,
+      Width * sizeof (UINT32)
+    );
+  }
+
+  HOST_CHECK (iMXBltInitialize (
+                &Frame->Context,
+                Frame->FrameBuffer,
+                Width,
+                Height,
+                PixelsPerScanLine,
+                Flags
+              ) == EFI_SUCCESS);
+  if (BufferHeight > Height) {
+    HOST_CHECK (iMXBltEnableScroll (
+                  &Frame->Context,
+                  BufferHeight,
+                  TestSetScanout,
+                  Frame
+                ) == EFI_SUCCESS);
+  }
+}
+
+STATIC
+VOID
+TestFrameDestroy (
+  IN  TEST_FRAME  *Frame
+  )
+{
+  iMXBltFree (&Frame->Context);
+  free (Frame->Memory);
+  free (Frame->Reference.Pixels);
+}
+
+/**
+  Check that the visible frame matches the reference and the guard pixels
+  around the frame buffer are intact.
+
+**/
+STATIC
+BOOLEAN
+TestFrameMatches (
+  IN  TEST_FRAME  *Frame
+  )
+{
+  UINTN   Count;
+  UINTN   Index;
+  UINT32  *Screen;
+  UINTN   Y;
+
+  Count = (UINTN)Frame->PixelsPerScanLine * Frame->BufferHeight;
+  for (Index = 0; Index < TEST_GUARD_PIXELS; ++Index) {
+    if ((Frame->Memory[Index] != TEST_GUARD_PIXEL) ||
+        (Frame->FrameBuffer[Count + Index] != TEST_GUARD_PIXEL)) {
+      return FALSE;
+    }
+  }
+
+  Screen = Frame->FrameBuffer + Frame->ScanoutOffset / sizeof (UINT32);
+  for (Y = 0; Y < Frame->Height; ++Y) {
+    if (CompareMem (
+          Screen + Y * Frame->PixelsPerScanLine,
+          Frame->Reference.Pixels + Y * Frame->Width,
+          Frame->Width * sizeof (UINT32)
+        ) != 0) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+  Run a Blt operation on the frame and on the reference.
+
+  The caller's Blt buffer of BufferCount pixels is copied to an allocation of
+  exactly that size for each side, the results must be identical down to the
+  pixels the operation should not touch.
+
+  @return The status returned by iMXBlt.
+
+**/
+STATIC
+EFI_STATUS
+TestBlt (
+  IN      TEST_FRAME                          *Frame,
+  IN OUT  EFI_GRAPHICS_OUTPUT_BLT_PIXEL       *BltBuffer,
+  IN      UINTN                               BufferCount,
+  IN      EFI_GRAPHICS_OUTPUT_BLT_OPERATION   BltOperation,
+  IN      UINTN                               SourceX,
+  IN      UINTN                               SourceY,
+  IN      UINTN                               DestinationX,
+  IN      UINTN                               DestinationY,
+  IN      UINTN                               Width,
+  IN      UINTN                               Height,
+  IN      UINTN                               Delta
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *ReferenceBuffer;
+  EFI_STATUS                      ReferenceStatus;
+  EFI_STATUS                      Status;
+
+  Buffer = NULL;
+  ReferenceBuffer = NULL;
+  if (BltBuffer != NULL) {
+    Buffer = malloc (BufferCount * sizeof (*Buffer));
+    ReferenceBuffer = malloc (BufferCount * sizeof (*Buffer));
+    CopyMem (Buffer, BltBuffer, BufferCount * sizeof (*Buffer));
+    CopyMem (ReferenceBuffer, BltBuffer, BufferCount * sizeof (*Buffer));
+  }
+
+  Status = iMXBlt (
+             &Frame->Context,
+             Buffer,
+             BltOperation,
+             SourceX,
+             SourceY,
+             DestinationX,
+             DestinationY,
+             Width,
+             Height,
+             Delta
+           );
+  ReferenceStatus = BltReference (
+                      &Frame->Reference,
+                      ReferenceBuffer,
+                      BltOperation,
+                      SourceX,
+                      SourceY,
+                      DestinationX,
+                      DestinationY,
+                      Width,
+                      Height,
+                      Delta
+                    );
+  HOST_CHECK (Status == ReferenceStatus);
+
+  if (BltBuffer != NULL) {
+    HOST_CHECK (CompareMem (Buffer, ReferenceBuffer, BufferCount * sizeof (*Buffer)) == 0);
+    CopyMem (BltBuffer, Buffer, BufferCount * sizeof (*Buffer));
+    free (Buffer);
+    free (ReferenceBuffer);
+  }
+  return Status;
+}
+
+/**
+  Fill a Blt buffer with a pattern.
+
+**/
+STATIC
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *
+TestBuffer (
+  IN  UINTN   Count,
+  IN  UINT32  Seed
+  )
+{
+  UINT32  *Buffer;
+  UINTN   Index;
+
+  Buffer = malloc (Count * sizeof (UINT32));
+  for (Index = 0; Index < Count; ++Index) {
+    Buffer[Index] = TestPixel (Index, Seed);
+  }
+  return (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)Buffer;
+}
+
+STATIC
+VOID
+TestInitialize (
+  VOID
+  )
+{
+  IMX_BLT_CONTEXT   Context;
+  TEST_FRAME        Frame;
+  UINT32            Pixel;
+
+  HostReset ();
+  Pixel = 0;
+  HOST_CHECK (iMXBltInitialize (&Context, NULL, 64, 48, 64, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (iMXBltInitialize (&Context, &Pixel, 0, 48, 64, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (iMXBltInitialize (&Context, &Pixel, 64, 0, 64, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (iMXBltInitialize (&Context, &Pixel, 64, 48, 63, 0) == EFI_INVALID_PARAMETER);
+
+  // The shadow buffer starts from what is on screen and owns two events,
+  // which are gone after iMXBltFree
+  TestFrameCreate (&Frame, 64, 48, 80, 48, IMX_BLT_FLAG_SHADOW);
+  HOST_CHECK ((Frame.Context.Flags & IMX_BLT_FLAG_SHADOW) != 0);
+  HOST_CHECK (HostOpenEventCount () == 2);
+  HOST_CHECK (CompareMem (
+                Frame.Context.ShadowBuffer,
+                Frame.FrameBuffer,
+                80 * 48 * sizeof (UINT32)
+              ) == 0);
+  HOST_CHECK (iMXBltEnableScroll (&Frame.Context, 48, TestSetScanout, &Frame) ==
+              EFI_BUFFER_TOO_SMALL);
+  HOST_CHECK (iMXBltEnableScroll (&Frame.Context, 96, TestSetScanout, &Frame) ==
+              EFI_SUCCESS);
+  HOST_CHECK (HostOpenEventCount () == 2);
+  TestFrameDestroy (&Frame);
+  HOST_CHECK (HostOpenEventCount () == 0);
+  HOST_CHECK (gHostDebugErrorCount == 0);
+}
+
+STATIC
+VOID
+TestParameters (
+  VOID
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  TEST_FRAME                      Frame;
+
+  HostReset ();
+  TestFrameCreate (&Frame, 64, 48, 64, 48, 0);
+  Buffer = TestBuffer (128 * 96, 1);
+
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiGraphicsOutputBltOperationMax,
+                       0, 0, 0, 0, 1, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoFill,
+                       0, 0, 0, 0, 1, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 0, 0, 0, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 0, 0, 1, 0, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 128 * 96, EfiBltBufferToVideo,
+                       0, 0, 0, 0, 16, 16, 15 * sizeof (UINT32)) == EFI_INVALID_PARAMETER);
+
+  // Rectangles must start inside the frame, even when huge
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 64, 0, 1, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 0, 48, 1, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                       MAX_UINTN, 0, 0, 0, 1, 1, 0) == EFI_INVALID_PARAMETER);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 128 * 96, EfiBltVideoToBltBuffer,
+                       0, MAX_UINTN, 0, 0, 1, 1, 0) == EFI_INVALID_PARAMETER);
+
+  // and are clipped at the right and bottom edge, without overflowing
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 60, 40, MAX_UINTN, MAX_UINTN, 0) == EFI_SUCCESS);
+  HOST_CHECK (TestBlt (&Frame, Buffer, 128 * 96, EfiBltBufferToVideo,
+                       3, 5, 50, 30, 128, 96, 128 * sizeof (UINT32)) == EFI_SUCCESS);
+  HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                       50, 10, 10, 40, 100, 100, 0) == EFI_SUCCESS);
+  HOST_CHECK (TestFrameMatches (&Frame));
+
+  // The Blt buffer keeps its stride when the rectangle is clipped
+  HOST_CHECK (TestBlt (&Frame, Buffer, 128 * 96, EfiBltVideoToBltBuffer,
+                       40, 20, 7, 9, 100, 100, 100 * sizeof (UINT32)) == EFI_SUCCESS);
+
+  free (Buffer);
+  TestFrameDestroy (&Frame);
+  HOST_CHECK (gHostDebugErrorCount == 1);
+}
+
+/**
+  Full width rectangles are done as one run through the padding of the frame
+  lines. The visible result must not depend on the padding, and the padding
+  of the Blt buffer must not be written.
+
+**/
+STATIC
+VOID
+TestRuns (
+  VOID
+  )
+{
+  STATIC CONST UINT32             Pitches[] = { 64, 65, 80 };
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  UINTN                           CleanCount;
+  TEST_FRAME                      Frame;
+  UINT32                          Index;
+  UINT32                          Pitch;
+
+  for (Index = 0; Index < ARRAY_SIZE (Pitches); ++Index) {
+    Pitch = Pitches[Index];
+    HostReset ();
+    TestFrameCreate (&Frame, 64, 48, Pitch, 48, IMX_BLT_FLAG_CLEAN_FRAME_BUFFER);
+    Buffer = TestBuffer (Pitch * 48, Index);
+
+    CleanCount = gHostCounters.CacheCleanCount;
+    HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                         0, 0, 0, 4, 64, 40, 0) == EFI_SUCCESS);
+    HOST_CHECK (gHostCounters.CacheCleanCount == CleanCount + 1);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    // A Blt buffer with the pitch of the frame is copied as one run
+    CleanCount = gHostCounters.CacheCleanCount;
+    HOST_CHECK (TestBlt (&Frame, Buffer, Pitch * 48, EfiBltBufferToVideo,
+                         0, 1, 0, 2, 64, 40, Pitch * sizeof (UINT32)) == EFI_SUCCESS);
+    HOST_CHECK (gHostCounters.CacheCleanCount == CleanCount + 1);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    HOST_CHECK (TestBlt (&Frame, Buffer, 64 * 48, EfiBltBufferToVideo,
+                         0, 0, 0, 0, 64, 48, 0) == EFI_SUCCESS);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    // Overlapping full width moves in both directions
+    HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                         0, 3, 0, 0, 64, 45, 0) == EFI_SUCCESS);
+    HOST_CHECK (TestFrameMatches (&Frame));
+    HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                         0, 0, 0, 5, 64, 48, 0) == EFI_SUCCESS);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    HOST_CHECK (TestBlt (&Frame, Buffer, Pitch * 48, EfiBltVideoToBltBuffer,
+                         0, 0, 0, 0, 64, 48, Pitch * sizeof (UINT32)) == EFI_SUCCESS);
+    HOST_CHECK (TestBlt (&Frame, Buffer, 64 * 48, EfiBltVideoToBltBuffer,
+                         0, 0, 0, 0, 64, 48, 0) == EFI_SUCCESS);
+
+    free (Buffer);
+    TestFrameDestroy (&Frame);
+  }
+}
+
+STATIC
+VOID
+TestShadow (
+  VOID
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  UINT32                          *Before;
+  UINTN                           Count;
+  TEST_FRAME                      Frame;
+  UINT32                          Index;
+
+  HostReset ();
+  TestFrameCreate (&Frame, 64, 48, 80, 48, IMX_BLT_FLAG_SHADOW);
+  Buffer = TestBuffer (8 * 8, 2);
+  Count = 80 * 48;
+  Before = malloc (Count * sizeof (UINT32));
+  CopyMem (Before, Frame.FrameBuffer, Count * sizeof (UINT32));
+
+  // Scattered glyphs overflow the dirty rectangle list and get merged
+  for (Index = 0; Index < 3 * IMX_BLT_DIRTY_RECTANGLE_COUNT; ++Index) {
+    HOST_CHECK (TestBlt (&Frame, Buffer, 8 * 8, EfiBltBufferToVideo,
+                         0, 0, (Index * 23) % 57, (Index * 11) % 41, 8, 8, 0) == EFI_SUCCESS);
+  }
+  HOST_CHECK (Frame.Context.DirtyCount <= IMX_BLT_DIRTY_RECTANGLE_COUNT);
+  HOST_CHECK (CompareMem (Before, Frame.FrameBuffer, Count * sizeof (UINT32)) == 0);
+
+  // The Blt buffer reads back the shadow, not the stale frame buffer
+  HOST_CHECK (TestBlt (&Frame, Buffer, 8 * 8, EfiBltVideoToBltBuffer,
+                       20, 20, 0, 0, 8, 8, 0) == EFI_SUCCESS);
+
+  HostSignalEvents (TEST_TIMER_EVENT);
+  HOST_CHECK (Frame.Context.DirtyCount == 0);
+  HOST_CHECK (TestFrameMatches (&Frame));
+
+  HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                       3, 4, 5, 2, 30, 30, 0) == EFI_SUCCESS);
+  iMXBltFlush (&Frame.Context);
+  HOST_CHECK (TestFrameMatches (&Frame));
+
+  // ExitBootServices flushes, later operations go to the frame buffer
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 10, 10, 20, 20, 0) == EFI_SUCCESS);
+  HostSignalEvents (EVT_SIGNAL_EXIT_BOOT_SERVICES);
+  HOST_CHECK (TestFrameMatches (&Frame));
+  HOST_CHECK (TestBlt (&Frame, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 30, 30, 20, 20, 0) == EFI_SUCCESS);
+  HOST_CHECK (TestFrameMatches (&Frame));
+
+  free (Before);
+  free (Buffer);
+  TestFrameDestroy (&Frame);
+}
+
+/**
+  Scroll the whole screen up a line at a time until the scanout wraps around
+  the frame buffer a few times.
+
+**/
+STATIC
+VOID
+TestScroll (
+  VOID
+  )
+{
+  STATIC CONST UINT32             Flags[] = { 0, IMX_BLT_FLAG_SHADOW };
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  TEST_FRAME                      Frame;
+  UINT32                          Index;
+  UINT32                          Line;
+  UINT32                          Wraps;
+
+  for (Index = 0; Index < ARRAY_SIZE (Flags); ++Index) {
+    HostReset ();
+    TestFrameCreate (&Frame, 64, 48, 72, 64, Flags[Index]);
+    Buffer = TestBuffer (64 * 8, Index);
+
+    Wraps = 0;
+    for (Line = 0; Line < 40; ++Line) {
+      // A console scrolls everything but the header up by a text line and
+      // draws the next one. Every third step moves a single pixel line and
+      // leaves the bottom line alone, so the window also ends exactly at the
+      // end of the frame buffer.
+      if ((Line % 3) == 0) {
+        HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                             0, 3, 0, 2, 64, 45, 0) == EFI_SUCCESS);
+      } else {
+        HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                             0, 10, 0, 2, 64, 38, 0) == EFI_SUCCESS);
+        HOST_CHECK (TestBlt (&Frame, Buffer, 64 * 8, EfiBltBufferToVideo,
+                             0, 0, 0, 40, 64, 8, 0) == EFI_SUCCESS);
+      }
+      iMXBltFlush (&Frame.Context);
+      HOST_CHECK (TestFrameMatches (&Frame));
+      HOST_CHECK (Frame.ScanoutOffset ==
+                  Frame.Context.ScanoutRow * 72 * sizeof (UINT32));
+      if (Frame.Context.ScanoutRow == 0) {
+        ++Wraps;
+      }
+    }
+    HOST_CHECK (Frame.SetScanoutCount == 40);
+    HOST_CHECK (Wraps > 2);
+
+    // Not more than half the screen, copied in place
+    HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                         0, 30, 0, 0, 64, 18, 0) == EFI_SUCCESS);
+    HOST_CHECK (Frame.SetScanoutCount == 40);
+    iMXBltFlush (&Frame.Context);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    // The OS gets the screen at the start of the frame buffer
+    HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                         0, 10, 0, 2, 64, 38, 0) == EFI_SUCCESS);
+    HOST_CHECK (Frame.Context.ScanoutRow != 0);
+    HostSignalEvents (EVT_SIGNAL_EXIT_BOOT_SERVICES);
+    HOST_CHECK (Frame.ScanoutOffset == 0);
+    HOST_CHECK (TestFrameMatches (&Frame));
+    HOST_CHECK (TestBlt (&Frame, NULL, 0, EfiBltVideoToVideo,
+                         0, 10, 0, 2, 64, 38, 0) == EFI_SUCCESS);
+    HOST_CHECK (Frame.ScanoutOffset == 0);
+    HOST_CHECK (TestFrameMatches (&Frame));
+
+    free (Buffer);
+    TestFrameDestroy (&Frame);
+  }
+}
+
+STATIC
+VOID
+TestSwap (
+  VOID
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *Buffer;
+  TEST_FRAME                      Back;
+  TEST_FRAME                      Front;
+  TEST_FRAME                      Other;
+  UINT32                          *FrameBuffer;
+
+  HostReset ();
+  TestFrameCreate (&Front, 64, 48, 64, 48, IMX_BLT_FLAG_SHADOW);
+  TestFrameCreate (&Back, 64, 48, 64, 48, IMX_BLT_FLAG_SHADOW);
+  TestFrameCreate (&Other, 64, 48, 64, 48, 0);
+  Buffer = TestBuffer (1, 3);
+
+  HOST_CHECK (iMXBltSwap (&Front.Context, &Other.Context) == EFI_INVALID_PARAMETER);
+
+  // Pending changes land in the frame buffer they were drawn for
+  HOST_CHECK (TestBlt (&Back, Buffer, 1, EfiBltVideoFill,
+                       0, 0, 8, 8, 16, 16, 0) == EFI_SUCCESS);
+  FrameBuffer = Front.Context.FrameBuffer;
+  HOST_CHECK (iMXBltSwap (&Front.Context, &Back.Context) == EFI_SUCCESS);
+  HOST_CHECK (Back.Context.FrameBuffer == FrameBuffer);
+  HOST_CHECK (Back.Context.DirtyCount == 0);
+  HOST_CHECK (iMXBltSwap (&Front.Context, &Back.Context) == EFI_SUCCESS);
+  HOST_CHECK (TestFrameMatches (&Back));
+  HOST_CHECK (TestFrameMatches (&Front));
+
+  free (Buffer);
+  TestFrameDestroy (&Front);
+  TestFrameDestroy (&Back);
+  TestFrameDestroy (&Other);
+}
+
+/**
+  Run the pixel kernels on runs of random length and alignment, between
+  guard pixels, against plain loops. Copies also overlap forward, the one
+  overlap the kernel has to handle.
+
+**/
+STATIC
+VOID
+TestFuzzKernels (
+  VOID
+  )
+{
+  UINT32  Destination[TEST_FUZZ_KERNEL_PIXELS + 2 * TEST_GUARD_PIXELS];
+  UINT32  Expected[TEST_FUZZ_KERNEL_PIXELS + 2 * TEST_GUARD_PIXELS];
+  UINT32  Source[TEST_FUZZ_KERNEL_PIXELS + 2 * TEST_GUARD_PIXELS];
+  UINTN   Count;
+  UINTN   DestinationIndex;
+  UINT32  Failures;
+  UINTN   Index;
+  UINT32  Iteration;
+  UINT32  Pixel;
+  UINTN   SourceIndex;
+
+  HostReset ();
+  mRandomState = TEST_FUZZ_SEED;
+  Failures = 0;
+  for (Iteration = 0; Iteration < TEST_FUZZ_KERNEL_COUNT; ++Iteration) {
+    for (Index = 0; Index < ARRAY_SIZE (Destination); ++Index) {
+      Destination[Index] = TEST_GUARD_PIXEL;
+      Source[Index] = TestPixel (Index, Iteration);
+    }
+
+    // Short runs are the interesting ones, they never reach the bursts
+    Count = TestRandom (2) ? TestRandom (40) : TestRandom (TEST_FUZZ_KERNEL_PIXELS - 8);
+    DestinationIndex = TEST_GUARD_PIXELS + TestRandom (8);
+    SourceIndex = TEST_GUARD_PIXELS + TestRandom (8);
+
+    switch (TestRandom (3)) {
+    case 0:
+      Pixel = TestPixel (Iteration, 1);
+      CopyMem (Expected, Destination, sizeof (Expected));
+      for (Index = 0; Index < Count; ++Index) {
+        Expected[DestinationIndex + Index] = Pixel;
+      }
+      iMXBltFill (Destination + DestinationIndex, Count, Pixel);
+      break;
+
+    case 1:
+      CopyMem (Expected, Destination, sizeof (Expected));
+      for (Index = 0; Index < Count; ++Index) {
+        Expected[DestinationIndex + Index] = Source[SourceIndex + Index];
+      }
+      iMXBltCopyForward (Destination + DestinationIndex, Source + SourceIndex, Count);
+      break;
+
+    default:
+      // Within one buffer, the destination at or below the source
+      CopyMem (Destination, Source, sizeof (Destination));
+      DestinationIndex = MIN (DestinationIndex, SourceIndex);
+      CopyMem (Expected, Destination, sizeof (Expected));
+      for (Index = 0; Index < Count; ++Index) {
+        Expected[DestinationIndex + Index] = Expected[SourceIndex + Index];
+      }
+      iMXBltCopyForward (Destination + DestinationIndex, Destination + SourceIndex, Count);
+      break;
+    }
+
+    if (CompareMem (Destination, Expected, sizeof (Destination)) != 0) {
+      ++Failures;
+    }
+  }
+  HOST_CHECK (Failures == 0);
+}
+
+/**
+  Pick a coordinate or length around the interesting values of a frame
+  dimension, including ones that overflow when added up.
+
+**/
+STATIC
+UINTN
+TestFuzzValue (
+  IN  UINTN   Limit
+  )
+{
+  switch (TestRandom (8)) {
+  case 0:
+    return 0;
+  case 1:
+    return Limit - 1;
+  case 2:
+    return Limit;
+  case 3:
+    return MAX_UINTN - TestRandom (Limit + 1);
+  case 4:
+    return Limit + TestRandom (Limit);
+  default:
+    return TestRandom (Limit);
+  }
+}
+
+/**
+  Run random operations with random, often invalid, rectangles on frames of
+  random geometry in every mode and compare against the reference after each
+  of them.
+
+**/
+STATIC
+VOID
+TestFuzzBlt (
+  VOID
+  )
+{
+  STATIC CONST UINT32               Flags[] = {
+                                      0,
+                                      IMX_BLT_FLAG_CLEAN_FRAME_BUFFER,
+                                      IMX_BLT_FLAG_SHADOW,
+                                      IMX_BLT_FLAG_SHADOW | IMX_BLT_FLAG_CLEAN_FRAME_BUFFER
+                                    };
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *Buffer;
+  UINTN                             BufferCount;
+  UINTN                             BufferWidth;
+  UINTN                             BufferX;
+  UINTN                             BufferY;
+  UINT32                            BufferHeight;
+  UINTN                             Delta;
+  UINTN                             DestinationX;
+  UINTN                             DestinationY;
+  UINT32                            ExitIndex;
+  UINT32                            Failures;
+  TEST_FRAME                        Frame;
+  UINT32                            FrameIndex;
+  UINT32                            Height;
+  UINTN                             Index;
+  EFI_GRAPHICS_OUTPUT_BLT_OPERATION Operation;
+  UINTN                             RectangleHeight;
+  UINTN                             RectangleWidth;
+  UINTN                             SourceX;
+  UINTN                             SourceY;
+  UINT32                            Width;
+
+  mRandomState = TEST_FUZZ_SEED;
+  Failures = 0;
+  for (FrameIndex = 0; FrameIndex < TEST_FUZZ_FRAME_COUNT; ++FrameIndex) {
+    HostReset ();
+    Width = 1 + (UINT32)TestRandom (97);
+    Height = 1 + (UINT32)TestRandom (61);
+    BufferHeight = Height;
+    if (TestRandom (2) == 0) {
+      BufferHeight += 1 + (UINT32)TestRandom (2 * Height);
+    }
+    TestFrameCreate (
+      &Frame,
+      Width,
+      Height,
+      Width + (UINT32)(TestRandom (2) ? 0 : TestRandom (18)),
+      BufferHeight,
+      Flags[FrameIndex % ARRAY_SIZE (Flags)]
+    );
+    ExitIndex = (UINT32)TestRandom (2 * TEST_FUZZ_BLT_COUNT);
+
+    for (Index = 0; Index < TEST_FUZZ_BLT_COUNT; ++Index) {
+      Operation = (EFI_GRAPHICS_OUTPUT_BLT_OPERATION)TestRandom (EfiGraphicsOutputBltOperationMax);
+      SourceX = TestFuzzValue (Width);
+      SourceY = TestFuzzValue (Height);
+      DestinationX = TestFuzzValue (Width);
+      DestinationY = TestFuzzValue (Height);
+      RectangleWidth = TestFuzzValue (Width);
+      RectangleHeight = TestFuzzValue (Height);
+      Delta = 0;
+      BufferCount = 1;
+
+      if ((Operation == EfiBltVideoToVideo) && (TestRandom (2) == 0)) {
+        // Full width moves up by a few lines, the console scrolls that may
+        // move the scanout
+        SourceX = 0;
+        DestinationX = 0;
+        RectangleWidth = TestRandom (2) ? Width : TestFuzzValue (Width);
+        SourceY = 1 + TestRandom (MAX (Height / 4, 1));
+        DestinationY = TestRandom (SourceY);
+      } else if ((Operation == EfiBltBufferToVideo) || (Operation == EfiBltVideoToBltBuffer)) {
+        // The Blt buffer has to exist, so its side of the rectangle stays
+        // within a buffer of some lines of up to twice the frame width
+        BufferWidth = 1 + TestRandom (2 * Width);
+        RectangleWidth = TestRandom (BufferWidth + 1);
+        BufferX = TestRandom (BufferWidth - RectangleWidth + 1);
+        BufferY = TestRandom (4);
+        if ((RectangleWidth != BufferWidth) || TestRandom (2)) {
+          // Bytes beyond whole pixels are ignored, too few are invalid
+          Delta = BufferWidth * sizeof (UINT32) + TestRandom (sizeof (UINT32));
+          if ((RectangleWidth != 0) && (TestRandom (16) == 0)) {
+            Delta = RectangleWidth * sizeof (UINT32) - 1;
+          }
+        }
+        BufferCount = (BufferY + Height) * BufferWidth;
+        if (Operation == EfiBltBufferToVideo) {
+          SourceX = BufferX;
+          SourceY = BufferY;
+        } else {
+          DestinationX = BufferX;
+          DestinationY = BufferY;
+        }
+      }
+      // Now and then the buffer is missing, which only VideoToVideo accepts
+      Buffer = NULL;
+      if (TestRandom (16) != 0) {
+        Buffer = TestBuffer (BufferCount, (UINT32)Index);
+      }
+
+      TestBlt (&Frame, Buffer, BufferCount, Operation, SourceX, SourceY,
+               DestinationX, DestinationY, RectangleWidth, RectangleHeight, Delta);
+      free (Buffer);
+
+      switch (TestRandom (4)) {
+      case 0:
+        HostSignalEvents (TEST_TIMER_EVENT);
+        break;
+      case 1:
+        iMXBltFlush (&Frame.Context);
+        break;
+      default:
+        break;
+      }
+      if (Index == ExitIndex) {
+        HostSignalEvents (EVT_SIGNAL_EXIT_BOOT_SERVICES);
+        if (Frame.ScanoutOffset != 0) {
+          ++Failures;
+        }
+      }
+
+      iMXBltFlush (&Frame.Context);
+      if (!TestFrameMatches (&Frame)) {
+        ++Failures;
+      }
+    }
+
+    TestFrameDestroy (&Frame);
+  }
+  HOST_CHECK (Failures == 0);
+  HOST_CHECK (HostOpenEventCount () == 0);
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  TestInitialize ();
+  TestParameters ();
+  TestRuns ();
+  TestShadow ();
+  TestScroll ();
+  TestSwap ();
+  TestFuzzKernels ();
+  TestFuzzBlt ();
+  return (int)HostSummary (TEST_NAME);
+}
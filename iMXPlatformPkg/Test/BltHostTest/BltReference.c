@@ -0,0 +1,150 @@
+/** @file
+*
+*  Scalar reference of the EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt operations.
+*
+*  Written for obviousness rather than speed, it is the oracle of the Blt
+*  tests and the baseline of the Blt benchmark.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include "BltReference.h"
+
+// Keep the compiler from turning the pixel loops into vector code or memset
+// and memcpy calls, so the benchmark compares against plain scalar loops
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC optimize ("no-tree-vectorize", "no-tree-loop-distribute-patterns")
+#endif
+
+STATIC
+BOOLEAN
+BltReferenceClip (
+  IN      UINTN   Limit,
+  IN      UINTN   Start,
+  IN OUT  UINTN   *Length
+  )
+{
+  if (Start >= Limit) {
+    return FALSE;
+  }
+  if (*Length > Limit - Start) {
+    *Length = Limit - Start;
+  }
+  return TRUE;
+}
+
+EFI_STATUS
+BltReference (
+  IN     BLT_REFERENCE_FRAME                *Frame,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer, OPTIONAL
+  IN     EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN     UINTN                              SourceX,
+  IN     UINTN                              SourceY,
+  IN     UINTN                              DestinationX,
+  IN     UINTN                              DestinationY,
+  IN     UINTN                              Width,
+  IN     UINTN                              Height,
+  IN     UINTN                              Delta OPTIONAL
+  )
+{
+  UINT32  *Buffer;
+  UINTN   BufferWidth;
+  UINT32  *Pixels;
+  UINTN   Pitch;
+  UINTN   Step;
+  UINTN   X;
+  UINTN   Y;
+
+  if ((UINT32)BltOperation >= (UINT32)EfiGraphicsOutputBltOperationMax) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((BltBuffer == NULL) && (BltOperation != EfiBltVideoToVideo)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((Width == 0) || (Height == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  BufferWidth = (Delta == 0) ? Width : Delta / sizeof (UINT32);
+  if (BufferWidth < Width) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((BltOperation == EfiBltVideoToBltBuffer) ||
+      (BltOperation == EfiBltVideoToVideo)) {
+    if (!BltReferenceClip (Frame->Width, SourceX, &Width) ||
+        !BltReferenceClip (Frame->Height, SourceY, &Height)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+  if (BltOperation != EfiBltVideoToBltBuffer) {
+    if (!BltReferenceClip (Frame->Width, DestinationX, &Width) ||
+        !BltReferenceClip (Frame->Height, DestinationY, &Height)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Buffer = (UINT32 *)BltBuffer;
+  Pixels = Frame->Pixels;
+  Pitch = Frame->PixelsPerScanLine;
+
+  switch (BltOperation) {
+  case EfiBltVideoFill:
+    for (Y = 0; Y < Height; Y++) {
+      for (X = 0; X < Width; X++) {
+        Pixels[(DestinationY + Y) * Pitch + DestinationX + X] = Buffer[0];
+      }
+    }
+    break;
+
+  case EfiBltVideoToBltBuffer:
+    for (Y = 0; Y < Height; Y++) {
+      for (X = 0; X < Width; X++) {
+        Buffer[(DestinationY + Y) * BufferWidth + DestinationX + X] =
+          Pixels[(SourceY + Y) * Pitch + SourceX + X];
+      }
+    }
+    break;
+
+  case EfiBltBufferToVideo:
+    for (Y = 0; Y < Height; Y++) {
+      for (X = 0; X < Width; X++) {
+        Pixels[(DestinationY + Y) * Pitch + DestinationX + X] =
+          Buffer[(SourceY + Y) * BufferWidth + SourceX + X];
+      }
+    }
+    break;
+
+  default:
+    // Walk away from the destination so overlapping pixels are read before
+    // they are written
+    if ((DestinationY > SourceY) ||
+        ((DestinationY == SourceY) && (DestinationX > SourceX))) {
+      for (Step = Width * Height; Step-- > 0;) {
+        Y = Step / Width;
+        X = Step % Width;
+        Pixels[(DestinationY + Y) * Pitch + DestinationX + X] =
+          Pixels[(SourceY + Y) * Pitch + SourceX + X];
+      }
+    } else {
+      for (Step = 0; Step < Width * Height; Step++) {
+        Y = Step / Width;
+        X = Step % Width;
+        Pixels[(DestinationY + Y) * Pitch + DestinationX + X] =
+          Pixels[(SourceY + Y) * Pitch + SourceX + X];
+      }
+    }
+    break;
+  }
+
+  return EFI_SUCCESS;
+}
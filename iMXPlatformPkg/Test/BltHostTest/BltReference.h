@@ -0,0 +1,54 @@
+/** @file
+*
+*  Scalar reference of the EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt operations.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _BLT_REFERENCE_H_
+#define _BLT_REFERENCE_H_
+
+#include <Uefi.h>
+
+#include <Protocol/GraphicsOutput.h>
+
+typedef struct {
+  UINT32  *Pixels;
+  UINTN   Width;
+  UINTN   Height;
+  UINTN   PixelsPerScanLine;
+} BLT_REFERENCE_FRAME;
+
+/**
+  Perform a Blt operation one pixel at a time.
+
+  Takes the same parameters and returns the same status as iMXBlt, including
+  its clipping at the right and bottom edge of the frame. Pixels outside of
+  the clipped rectangle, including the padding of the frame lines, are never
+  touched.
+
+**/
+EFI_STATUS
+BltReference (
+  IN     BLT_REFERENCE_FRAME                *Frame,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer, OPTIONAL
+  IN     EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN     UINTN                              SourceX,
+  IN     UINTN                              SourceY,
+  IN     UINTN                              DestinationX,
+  IN     UINTN                              DestinationY,
+  IN     UINTN                              Width,
+  IN     UINTN                              Height,
+  IN     UINTN                              Delta OPTIONAL
+  );
+
+#endif
@@ -0,0 +1,25 @@
+/** @file
+*
+*  PCDs and GUIDs of the code under test, the host counterpart of the
+*  AutoGen.h generated by the EDK2 build.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _I2C_HOST_TEST_AUTOGEN_H_
+#define _I2C_HOST_TEST_AUTOGEN_H_
+
+#include <Base.h>
+
+extern BOOLEAN  gHostPcd_PcdI2cTraceEnable;
+
+#endif
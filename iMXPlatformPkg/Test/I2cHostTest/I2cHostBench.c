@@ -0,0 +1,178 @@
+/** @file
+*
+*  Host benchmark of iMXI2cLib against the I2C controller model.
+*
+*  The simulated time is what the transfer would take on the target: bus time
+*  at the configured SCL frequency, register access time and every delay the
+*  driver spins in. The host time only measures the cost of the model and is
+*  reported to spot accidental regressions of the harness itself.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <stdio.h>
+#include <time.h>
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXI2cLib.h>
+
+#include "I2cModel.h"
+
+#define BENCH_I2C_BASE          0x021A0000
+#define BENCH_EDID_ADDRESS      0x50
+#define BENCH_EEPROM_ADDRESS    0x54
+#define BENCH_ITERATIONS        64
+
+BOOLEAN gHostPcd_PcdI2cTraceEnable = FALSE;
+
+STATIC I2C_MODEL          mModel;
+STATIC I2C_MODEL_SLAVE    mEdid;
+STATIC I2C_MODEL_SLAVE    mEeprom;
+STATIC IMX_I2C_CONTEXT    mContext;
+STATIC IMX_I2C_BUS        mBus;
+STATIC UINT8              mBuffer[256];
+
+typedef
+RETURN_STATUS
+(*BENCH_FUNCTION) (
+  VOID
+  );
+
+STATIC
+RETURN_STATUS
+BenchEdidRead (
+  VOID
+  )
+{
+  mContext.SlaveAddress = BENCH_EDID_ADDRESS;
+  return iMXI2cRead (&mContext, 0, mBuffer, 128);
+}
+
+STATIC
+RETURN_STATUS
+BenchRegisterWrite (
+  VOID
+  )
+{
+  mContext.SlaveAddress = BENCH_EDID_ADDRESS;
+  return iMXI2cWrite (&mContext, 0x10, mBuffer, 1);
+}
+
+STATIC
+RETURN_STATUS
+BenchEepromWrite (
+  VOID
+  )
+{
+  mContext.SlaveAddress = BENCH_EEPROM_ADDRESS;
+  return iMXI2cEepromWrite16 (&mContext, 0x100, mBuffer, 256, 32);
+}
+
+STATIC
+RETURN_STATUS
+BenchBusBatch (
+  VOID
+  )
+{
+  IMX_I2C_BATCH     Batch;
+  IMX_I2C_REQUEST   Request[8];
+  UINT32            Index;
+
+  mContext.SlaveAddress = BENCH_EDID_ADDRESS;
+  ZeroMem (Request, sizeof (Request));
+  for (Index = 0; Index < ARRAY_SIZE (Request); ++Index) {
+    Request[Index].I2cContext = &mContext;
+    Request[Index].Type = ImxI2cRequestWrite;
+    Request[Index].RegisterAddress = (UINT16)Index;
+    Request[Index].RegisterAddressSize = IMX_I2C_REGISTER_ADDRESS_8BIT;
+    Request[Index].Buffer = &mBuffer[Index];
+    Request[Index].BufferSize = 1;
+  }
+
+  Batch.RequestList = Request;
+  Batch.RequestCount = ARRAY_SIZE (Request);
+  return iMXI2cBusSubmit (&mBus, &Batch);
+}
+
+STATIC
+VOID
+BenchRun (
+  IN  CONST CHAR8     *Name,
+  IN  BENCH_FUNCTION  Function,
+  IN  UINT32          PayloadBytes
+  )
+{
+  UINT64            BusTimeInNs;
+  UINT64            Bytes;
+  UINT64            HostInNs;
+  UINT32            Index;
+  UINT64            SimulatedInNs;
+  struct timespec   Start;
+  struct timespec   Stop;
+
+  HostReset ();
+  I2cModelInitialize (&mModel, BENCH_I2C_BASE, 400000);
+  I2cModelAddSlave (&mModel, &mEdid, BENCH_EDID_ADDRESS, 1, 256, 0, 0);
+  I2cModelAddSlave (&mModel, &mEeprom, BENCH_EEPROM_ADDRESS, 2, 4096, 32, 5000000);
+  iMXI2cBusInitialize (&mBus, BENCH_I2C_BASE);
+
+  clock_gettime (CLOCK_MONOTONIC, &Start);
+  for (Index = 0; Index < BENCH_ITERATIONS; ++Index) {
+    if (RETURN_ERROR (Function ())) {
+      printf ("%-16s failed\n", Name);
+      return;
+    }
+  }
+  clock_gettime (CLOCK_MONOTONIC, &Stop);
+
+  HostInNs = (Stop.tv_sec - Start.tv_sec) * 1000000000ULL + Stop.tv_nsec - Start.tv_nsec;
+  SimulatedInNs = HostNow ();
+  BusTimeInNs = mModel.BusTimeInNs;
+  Bytes = (UINT64)PayloadBytes * BENCH_ITERATIONS;
+
+  printf ("%-16s %9.1f us/op %7.1f us/byte  bus %5.1f%%  mmio %6.1f/byte  delay %7.1f us/byte  enable %u  host %6.1f us/op\n",
+          Name,
+          SimulatedInNs / 1000.0 / BENCH_ITERATIONS,
+          SimulatedInNs / 1000.0 / Bytes,
+          100.0 * BusTimeInNs / SimulatedInNs,
+          (double)(gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount) / Bytes,
+          (double)gHostCounters.DelayInUs / Bytes,
+          mModel.EnableCount,
+          HostInNs / 1000.0 / BENCH_ITERATIONS);
+  if (mModel.ProtocolErrorCount != 0) {
+    printf ("%-16s %u protocol errors\n", Name, mModel.ProtocolErrorCount);
+  }
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  ZeroMem (&mContext, sizeof (mContext));
+  mContext.ControllerAddress = BENCH_I2C_BASE;
+  mContext.ReferenceFrequency = 66000000;
+  mContext.TargetFrequency = 400000;
+  mContext.TimeoutInUs = 100000;
+
+  BenchRun ("EdidRead128", BenchEdidRead, 128);
+  BenchRun ("RegisterWrite1", BenchRegisterWrite, 1);
+  BenchRun ("EepromWrite256", BenchEepromWrite, 256);
+  BenchRun ("BusBatch8x1", BenchBusBatch, 8);
+  return 0;
+}
@@ -0,0 +1,594 @@
+/** @file
+*
+*  Host functional tests of iMXI2cLib against the I2C controller model.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/TimerLib.h>
+
+#include <HostLib.h>
+#include <iMXI2cLib.h>
+
+#include "I2cModel.h"
+
+#define TEST_I2C_BASE           0x021A0000
+#define TEST_RTC_ADDRESS        0x51
+#define TEST_EEPROM_ADDRESS     0x50
+#define TEST_EEPROM16_ADDRESS   0x54
+#define TEST_SMBUS_ADDRESS      0x0B
+#define TEST_EEPROM_CYCLE_NS    5000000ULL
+
+BOOLEAN gHostPcd_PcdI2cTraceEnable = TRUE;
+
+STATIC I2C_MODEL          mModel;
+STATIC I2C_MODEL_SLAVE    mRtc;
+STATIC I2C_MODEL_SLAVE    mEeprom;
+STATIC I2C_MODEL_SLAVE    mEeprom16;
+STATIC I2C_MODEL_SLAVE    mSmbus;
+
+STATIC
+VOID
+TestSetup (
+  OUT IMX_I2C_CONTEXT   *Context,
+  IN  UINT8             SlaveAddress
+  )
+{
+  UINT32  Index;
+
+  HostReset ();
+  I2cModelInitialize (&mModel, TEST_I2C_BASE, 400000);
+  I2cModelAddSlave (&mModel, &mRtc, TEST_RTC_ADDRESS, 1, 16, 0, 0);
+  I2cModelAddSlave (&mModel, &mEeprom, TEST_EEPROM_ADDRESS, 1, 256, 16, TEST_EEPROM_CYCLE_NS);
+  I2cModelAddSlave (&mModel, &mEeprom16, TEST_EEPROM16_ADDRESS, 2, 4096, 32, TEST_EEPROM_CYCLE_NS);
+  I2cModelAddSlave (&mModel, &mSmbus, TEST_SMBUS_ADDRESS, 1, 256, 0, 0);
+  for (Index = 0; Index < 256; ++Index) {
+    mRtc.Memory[Index % 16] = (UINT8)(0xA0 + Index % 16);
+    mEeprom.Memory[Index] = (UINT8)(Index ^ 0x5A);
+  }
+
+  ZeroMem (Context, sizeof (*Context));
+  Context->ControllerAddress = TEST_I2C_BASE;
+  Context->ReferenceFrequency = 66000000;
+  Context->TargetFrequency = 400000;
+  Context->SlaveAddress = SlaveAddress;
+  Context->TimeoutInUs = 100000;
+}
+
+STATIC
+UINT8
+TestPec (
+  IN  UINT8   Crc,
+  IN  UINT8   *Buffer,
+  IN  UINT32  Size
+  )
+{
+  UINT32  Bit;
+
+  while (Size-- > 0) {
+    Crc ^= *Buffer++;
+    for (Bit = 0; Bit < 8; ++Bit) {
+      Crc = (UINT8)(((Crc & 0x80) != 0) ? ((Crc << 1) ^ 0x07) : (Crc << 1));
+    }
+  }
+  return Crc;
+}
+
+STATIC
+VOID
+TestRegisterRead (
+  VOID
+  )
+{
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Buffer[17];
+  UINT32            Length;
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  for (Length = 1; Length <= 16; ++Length) {
+    SetMem (Buffer, sizeof (Buffer), 0xEE);
+    Status = iMXI2cRead (&Context, 0, Buffer, Length);
+    HOST_CHECK (Status == RETURN_SUCCESS);
+    HOST_CHECK (CompareMem (Buffer, mRtc.Memory, Length) == 0);
+    HOST_CHECK (Buffer[Length] == 0xEE);
+  }
+
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+  HOST_CHECK (gHostCounters.UnmappedCount == 0);
+  HOST_CHECK ((mModel.I2sr & IMX_I2C_I2SR_IBB) == 0);
+}
+
+STATIC
+VOID
+TestRegisterWrite (
+  VOID
+  )
+{
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Data[4];
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  Data[0] = 0x11;
+  Data[1] = 0x22;
+  Data[2] = 0x33;
+  Data[3] = 0x44;
+  Status = iMXI2cWrite (&Context, 0x05, Data, sizeof (Data));
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (&mRtc.Memory[5], Data, sizeof (Data)) == 0);
+  HOST_CHECK (mRtc.Memory[4] == 0xA4);
+  HOST_CHECK (mRtc.Memory[9] == 0xA9);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestRegister16 (
+  VOID
+  )
+{
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Data[8];
+  UINT8             ReadBack[8];
+  UINT32            Index;
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_EEPROM16_ADDRESS);
+  for (Index = 0; Index < sizeof (Data); ++Index) {
+    Data[Index] = (UINT8)(0x30 + Index);
+  }
+
+  Status = iMXI2cWrite16 (&Context, 0x0123, Data, sizeof (Data));
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (&mEeprom16.Memory[0x0123], Data, sizeof (Data)) == 0);
+
+  // Wait out the write cycle before reading back
+  MicroSecondDelay (TEST_EEPROM_CYCLE_NS / 1000);
+  Status = iMXI2cRead16 (&Context, 0x0123, ReadBack, sizeof (ReadBack));
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (ReadBack, Data, sizeof (Data)) == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestEepromWrite (
+  VOID
+  )
+{
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Data[200];
+  UINT32            Index;
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_EEPROM_ADDRESS);
+  for (Index = 0; Index < sizeof (Data); ++Index) {
+    Data[Index] = (UINT8)(Index * 7);
+  }
+
+  // Start in the middle of a page so the first and last chunks are partial
+  Status = iMXI2cEepromWrite (&Context, 0x2B, Data, sizeof (Data), 16);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (&mEeprom.Memory[0x2B], Data, sizeof (Data)) == 0);
+  HOST_CHECK (mEeprom.Memory[0x2A] == (0x2A ^ 0x5A));
+  HOST_CHECK (mEeprom.Memory[0x2B + sizeof (Data)] == ((0x2B + sizeof (Data)) ^ 0x5A));
+  // Every page write must have been followed by ACK polling, all on a single
+  // controller setup
+  HOST_CHECK (mEeprom.NakCount != 0);
+  HOST_CHECK (mModel.EnableCount == 1);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+
+  // The write must not wrap around the end of the address space
+  Status = iMXI2cEepromWrite (&Context, 0xF0, Data, 0x20, 16);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+  Status = iMXI2cEepromWrite (&Context, 0x20, Data, MAX_UINT32 - 0x0F, 16);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+  Status = iMXI2cEepromWrite16 (&Context, 0x0020, Data, MAX_UINT32 - 0x0F, 16);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+  Status = iMXI2cEepromWrite (&Context, 0, Data, 16, 0);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+}
+
+STATIC
+VOID
+TestEepromAckPollTimeout (
+  VOID
+  )
+{
+  UINT64            Begin;
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Data[4];
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_EEPROM_ADDRESS);
+  ZeroMem (Data, sizeof (Data));
+
+  // A write cycle longer than the timeout must fail with RETURN_TIMEOUT, and
+  // give up once the timeout has really elapsed, not after the sum of the
+  // poll intervals.
+  mEeprom.WriteCycleInNs = 1000000000ULL;
+  Context.TimeoutInUs = 10000;
+  Begin = HostNow ();
+  Status = iMXI2cEepromWrite (&Context, 0, Data, sizeof (Data), 16);
+  HOST_CHECK (Status == RETURN_TIMEOUT);
+  HOST_CHECK (HostNow () - Begin >= Context.TimeoutInUs * 1000ULL);
+  HOST_CHECK (HostNow () - Begin < (Context.TimeoutInUs + 1000) * 1000ULL);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestSmbusBlock (
+  VOID
+  )
+{
+  UINT8             Block[IMX_I2C_SMBUS_BLOCK_MAX];
+  UINT32            BlockSize;
+  IMX_I2C_CONTEXT   Context;
+  UINT8             Guarded[IMX_I2C_SMBUS_BLOCK_MAX];
+  UINT8             Header[3];
+  UINT32            Index;
+  UINT8             Pec;
+  RETURN_STATUS     Status;
+
+  TestSetup (&Context, TEST_SMBUS_ADDRESS);
+
+  // Block read of 5 bytes, with and without PEC
+  mSmbus.Memory[0x20] = 5;
+  for (Index = 0; Index < 5; ++Index) {
+    mSmbus.Memory[0x21 + Index] = (UINT8)(0xC0 + Index);
+  }
+  Header[0] = TEST_SMBUS_ADDRESS << 1;
+  Header[1] = 0x20;
+  Header[2] = (TEST_SMBUS_ADDRESS << 1) | 1;
+  Pec = TestPec (0, Header, sizeof (Header));
+  mSmbus.Memory[0x26] = TestPec (Pec, &mSmbus.Memory[0x20], 6);
+
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x20, Block, &BlockSize, FALSE);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (BlockSize == 5);
+  HOST_CHECK (CompareMem (Block, &mSmbus.Memory[0x21], 5) == 0);
+
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x20, Block, &BlockSize, TRUE);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (BlockSize == 5);
+
+  mSmbus.Memory[0x26] ^= 1;
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x20, Block, &BlockSize, TRUE);
+  HOST_CHECK (Status == RETURN_CRC_ERROR);
+
+  // Invalid byte counts must fail without touching the caller buffer, and
+  // the transfer must still end with a NAK and a Stop.
+  mSmbus.Memory[0x30] = 0xFF;
+  mSmbus.Memory[0x50] = 0;
+  mSmbus.Memory[0x60] = 8;
+  SetMem (Guarded, sizeof (Guarded), 0xEE);
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x30, Guarded, &BlockSize, FALSE);
+  HOST_CHECK (Status == RETURN_BUFFER_TOO_SMALL);
+  HOST_CHECK (BlockSize == sizeof (Block));
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x50, Guarded, &BlockSize, TRUE);
+  HOST_CHECK (Status == RETURN_BUFFER_TOO_SMALL);
+  BlockSize = 4;
+  Status = iMXI2cSmbusBlockRead (&Context, 0x60, Guarded, &BlockSize, FALSE);
+  HOST_CHECK (Status == RETURN_BUFFER_TOO_SMALL);
+  HOST_CHECK (BlockSize == 4);
+  for (Index = 0; Index < sizeof (Guarded); ++Index) {
+    HOST_CHECK (Guarded[Index] == 0xEE);
+  }
+  HOST_CHECK ((mModel.I2sr & IMX_I2C_I2SR_IBB) == 0);
+
+  // The bus is still usable afterwards
+  BlockSize = sizeof (Block);
+  Status = iMXI2cSmbusBlockRead (&Context, 0x20, Block, &BlockSize, FALSE);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (BlockSize == 5);
+
+  // Block write with PEC
+  for (Index = 0; Index < 3; ++Index) {
+    Block[Index] = (UINT8)(0x70 + Index);
+  }
+  Status = iMXI2cSmbusBlockWrite (&Context, 0x40, Block, 3, TRUE);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (mSmbus.Memory[0x40] == 3);
+  HOST_CHECK (CompareMem (&mSmbus.Memory[0x41], Block, 3) == 0);
+  Header[1] = 0x40;
+  Pec = TestPec (0, Header, 2);
+  HOST_CHECK (mSmbus.Memory[0x44] == TestPec (Pec, &mSmbus.Memory[0x40], 4));
+
+  Status = iMXI2cSmbusBlockWrite (&Context, 0x40, Block, 0, FALSE);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestBuildRequest (
+  OUT IMX_I2C_REQUEST       *Request,
+  IN  IMX_I2C_CONTEXT       *Context,
+  IN  IMX_I2C_REQUEST_TYPE  Type,
+  IN  UINT8                 RegisterAddress,
+  IN  UINT8                 *Buffer,
+  IN  UINT32                BufferSize
+  )
+{
+  ZeroMem (Request, sizeof (*Request));
+  Request->I2cContext = Context;
+  Request->Type = Type;
+  Request->RegisterAddress = RegisterAddress;
+  Request->RegisterAddressSize = IMX_I2C_REGISTER_ADDRESS_8BIT;
+  Request->Buffer = Buffer;
+  Request->BufferSize = BufferSize;
+}
+
+STATIC
+VOID
+TestBusSubmit (
+  VOID
+  )
+{
+  IMX_I2C_BATCH           Batch;
+  IMX_I2C_BUS             Bus;
+  IMX_I2C_CONTEXT         Context;
+  UINT8                   Data[2];
+  UINT8                   ReadBack[2];
+  IMX_I2C_REQUEST         Request[2];
+  IMX_I2C_BUS_STATISTICS  Statistics;
+  RETURN_STATUS           Status;
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  iMXI2cBusInitialize (&Bus, TEST_I2C_BASE);
+
+  Data[0] = 0x12;
+  Data[1] = 0x34;
+  TestBuildRequest (&Request[0], &Context, ImxI2cRequestWrite, 2, Data, sizeof (Data));
+  TestBuildRequest (&Request[1], &Context, ImxI2cRequestRead, 2, ReadBack, sizeof (ReadBack));
+  Batch.RequestList = Request;
+  Batch.RequestCount = 2;
+
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (Batch.Done);
+  HOST_CHECK (Batch.Status == RETURN_SUCCESS);
+  HOST_CHECK (Request[0].Status == RETURN_SUCCESS);
+  HOST_CHECK (Request[1].Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (ReadBack, Data, sizeof (Data)) == 0);
+
+  // The controller is only configured for the first request
+  iMXI2cBusGetStatistics (&Bus, &Statistics);
+  HOST_CHECK (Statistics.TransactionCount == 2);
+  HOST_CHECK (Statistics.ByteCount == 4);
+  HOST_CHECK (Statistics.ConfigureCount == 1);
+  HOST_CHECK (Statistics.ErrorCount == 0);
+  HOST_CHECK (mModel.EnableCount == 1);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+
+  // A request for another controller is rejected without touching the bus
+  Context.ControllerAddress = TEST_I2C_BASE + 0x4000;
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+  HOST_CHECK (Bus.PendingHead == NULL);
+}
+
+//
+// Client preempting the bus owner, as a timer event callback would
+//
+typedef struct {
+  IMX_I2C_BUS       *Bus;
+  IMX_I2C_BATCH     Batch;
+  IMX_I2C_REQUEST   Request;
+  UINT8             Data;
+  RETURN_STATUS     SubmitStatus;
+} TEST_PREEMPT;
+
+STATIC
+VOID
+TestPreempt (
+  IN  VOID    *Context
+  )
+{
+  TEST_PREEMPT  *Preempt;
+
+  Preempt = Context;
+  Preempt->SubmitStatus = iMXI2cBusSubmit (Preempt->Bus, &Preempt->Batch);
+}
+
+STATIC
+VOID
+TestBusPreempt (
+  VOID
+  )
+{
+  IMX_I2C_BATCH           Batch;
+  IMX_I2C_BUS             Bus;
+  IMX_I2C_CONTEXT         Context;
+  IMX_I2C_CONTEXT         EepromContext;
+  UINT8                   Data[8];
+  STATIC TEST_PREEMPT     Preempt;
+  IMX_I2C_REQUEST         Request;
+  IMX_I2C_BUS_STATISTICS  Statistics;
+  RETURN_STATUS           Status;
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  EepromContext = Context;
+  EepromContext.SlaveAddress = TEST_EEPROM_ADDRESS;
+  iMXI2cBusInitialize (&Bus, TEST_I2C_BASE);
+
+  SetMem (Data, sizeof (Data), 0x99);
+  TestBuildRequest (&Request, &Context, ImxI2cRequestWrite, 0, Data, sizeof (Data));
+  Batch.RequestList = &Request;
+  Batch.RequestCount = 1;
+
+  ZeroMem (&Preempt, sizeof (Preempt));
+  Preempt.Bus = &Bus;
+  Preempt.Data = 0x77;
+  TestBuildRequest (&Preempt.Request, &EepromContext, ImxI2cRequestWrite, 0x80, &Preempt.Data, 1);
+  Preempt.Batch.RequestList = &Preempt.Request;
+  Preempt.Batch.RequestCount = 1;
+
+  // Preempt the owner in the middle of its data bytes. The preempting batch
+  // must be queued, then performed by the owner once its own batch is done,
+  // without interleaving the two transfers on the bus.
+  HostSetInterrupt (TestPreempt, &Preempt, 60);
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (Preempt.SubmitStatus == RETURN_NOT_READY);
+  HOST_CHECK (Preempt.Batch.Done);
+  HOST_CHECK (Preempt.Batch.Status == RETURN_SUCCESS);
+  HOST_CHECK (Preempt.Request.Status == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (mRtc.Memory, Data, sizeof (Data)) == 0);
+  HOST_CHECK (mEeprom.Memory[0x80] == 0x77);
+  HOST_CHECK (!Bus.Draining);
+  HOST_CHECK (Bus.PendingHead == NULL);
+
+  iMXI2cBusGetStatistics (&Bus, &Statistics);
+  HOST_CHECK (Statistics.ContentionCount == 1);
+  HOST_CHECK (Statistics.TransactionCount == 2);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestBusWarm (
+  VOID
+  )
+{
+  IMX_I2C_BATCH           Batch;
+  IMX_I2C_BUS             Bus;
+  IMX_I2C_CONTEXT         Context;
+  UINT8                   Data;
+  UINT16                  Ifdr;
+  IMX_I2C_CONTEXT         SlowContext;
+  IMX_I2C_REQUEST         Request;
+  IMX_I2C_BUS_STATISTICS  Statistics;
+  RETURN_STATUS           Status;
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  SlowContext = Context;
+  SlowContext.TargetFrequency = 100000;
+  iMXI2cBusInitialize (&Bus, TEST_I2C_BASE);
+
+  TestBuildRequest (&Request, &Context, ImxI2cRequestRead, 0, &Data, 1);
+  Batch.RequestList = &Request;
+  Batch.RequestCount = 1;
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  iMXI2cBusGetStatistics (&Bus, &Statistics);
+  HOST_CHECK (Statistics.ConfigureCount == 1);
+  Ifdr = mModel.Ifdr;
+
+  // A direct transfer on the same controller with another clock must force
+  // the next bus request through a full setup.
+  Status = iMXI2cRead (&SlowContext, 0, &Data, 1);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  iMXI2cBusGetStatistics (&Bus, &Statistics);
+  HOST_CHECK (Statistics.ConfigureCount == 2);
+  HOST_CHECK (mModel.Ifdr == Ifdr);
+
+  // Same for a request with another controller slave address
+  SlowContext = Context;
+  SlowContext.ControllerSlaveAddress = 0x10;
+  Status = iMXI2cRead (&SlowContext, 0, &Data, 1);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  iMXI2cBusGetStatistics (&Bus, &Statistics);
+  HOST_CHECK (Statistics.ConfigureCount == 3);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestTrace (
+  VOID
+  )
+{
+  IMX_I2C_BATCH           Batch;
+  IMX_I2C_BUS             Bus;
+  IMX_I2C_CONTEXT         Context;
+  UINT8                   Data[4];
+  UINT32                  EntryCount;
+  IMX_I2C_REQUEST         Request;
+  RETURN_STATUS           Status;
+  IMX_I2C_TRACE_ENTRY     Trace[4];
+
+  TestSetup (&Context, TEST_RTC_ADDRESS);
+  iMXI2cBusInitialize (&Bus, TEST_I2C_BASE);
+
+  // Direct transfers are recorded like bus transfers
+  Status = iMXI2cRead (&Context, 0x03, Data, 4);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  Status = iMXI2cWrite (&Context, 0x07, Data, 2);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  EntryCount = 2;
+  Status = iMXI2cGetTrace (TEST_I2C_BASE, Trace, &EntryCount);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (EntryCount == 2);
+  HOST_CHECK (Trace[0].Type == ImxI2cRequestRead);
+  HOST_CHECK (Trace[0].SlaveAddress == TEST_RTC_ADDRESS);
+  HOST_CHECK (Trace[0].RegisterAddress == 0x03);
+  HOST_CHECK (Trace[0].Length == 4);
+  HOST_CHECK (Trace[0].DurationInNs > 0);
+  HOST_CHECK (Trace[1].Type == ImxI2cRequestWrite);
+  HOST_CHECK (Trace[1].RegisterAddress == 0x07);
+  HOST_CHECK (Trace[1].Length == 2);
+
+  // A bus request is recorded once
+  TestBuildRequest (&Request, &Context, ImxI2cRequestRead, 0x0A, Data, 1);
+  Batch.RequestList = &Request;
+  Batch.RequestCount = 1;
+  Status = iMXI2cBusSubmit (&Bus, &Batch);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  EntryCount = 2;
+  Status = iMXI2cGetTrace (TEST_I2C_BASE, Trace, &EntryCount);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (Trace[0].RegisterAddress == 0x07);
+  HOST_CHECK (Trace[1].RegisterAddress == 0x0A);
+
+  EntryCount = ARRAY_SIZE (Trace);
+  Status = iMXI2cGetTrace (TEST_I2C_BASE + 0x4000, Trace, &EntryCount);
+  HOST_CHECK (Status == RETURN_NOT_FOUND);
+  HOST_CHECK (EntryCount == 0);
+  iMXI2cBusDumpTrace (&Bus);
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  TestRegisterRead ();
+  TestRegisterWrite ();
+  TestRegister16 ();
+  TestEepromWrite ();
+  TestEepromAckPollTimeout ();
+  TestSmbusBlock ();
+  TestBusSubmit ();
+  TestBusPreempt ();
+  TestBusWarm ();
+  TestTrace ();
+  return (int)HostSummary ("I2cHostTest");
+}
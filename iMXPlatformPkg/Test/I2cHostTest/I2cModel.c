@@ -0,0 +1,397 @@
+/** @file
+*
+*  Behavioral model of the i.MX I2C controller and of simple I2C slaves.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXI2cLib.h>
+
+#include "I2cModel.h"
+
+#define I2C_MODEL_IADR      0x00
+#define I2C_MODEL_IFDR      0x04
+#define I2C_MODEL_I2CR      0x08
+#define I2C_MODEL_I2SR      0x0C
+#define I2C_MODEL_I2DR      0x10
+#define I2C_MODEL_WINDOW    0x4000
+
+#define I2C_MODEL_I2CR_RSTA   BIT2
+#define I2C_MODEL_I2CR_TXAK   BIT3
+#define I2C_MODEL_I2CR_MTX    BIT4
+#define I2C_MODEL_I2CR_MSTA   BIT5
+#define I2C_MODEL_I2CR_IEN    BIT7
+
+STATIC
+VOID
+I2cModelError (
+  IN  I2C_MODEL     *Model,
+  IN  CONST CHAR8   *Description
+  )
+{
+  ++Model->ProtocolErrorCount;
+  ++gHostFailCount;
+  HostReportFailure (__FILE__, __LINE__, Description);
+}
+
+STATIC
+VOID
+I2cModelSlaveStop (
+  IN  I2C_MODEL   *Model
+  )
+{
+  I2C_MODEL_SLAVE   *Slave;
+
+  Slave = Model->Selected;
+  if (Slave == NULL) {
+    return;
+  }
+
+  // An EEPROM only starts its write cycle on STOP after data was written
+  if (Slave->Written && (Slave->WriteCycleInNs != 0)) {
+    Slave->BusyUntilInNs = HostNow () + Slave->WriteCycleInNs;
+  }
+  Slave->Written = FALSE;
+  Model->Selected = NULL;
+}
+
+STATIC
+VOID
+I2cModelCheckEndOfRead (
+  IN  I2C_MODEL   *Model
+  )
+{
+  if (Model->ByteInFlight) {
+    I2cModelError (Model, "START/STOP while a byte is in flight");
+  }
+
+  // The master must NAK the last byte it reads, otherwise the slave keeps
+  // driving the next data bit and may hold SDA low across the STOP.
+  if ((Model->Phase == I2cModelPhaseReceive) &&
+      (Model->Selected != NULL) &&
+      Model->LastReadAcked) {
+    I2cModelError (Model, "Last byte of a read was ACKed");
+  }
+}
+
+STATIC
+UINT8
+I2cModelSlaveRead (
+  IN  I2C_MODEL_SLAVE   *Slave
+  )
+{
+  UINT8   Data;
+
+  Data = Slave->Memory[Slave->Pointer % Slave->Size];
+  Slave->Pointer = (Slave->Pointer + 1) % Slave->Size;
+  return Data;
+}
+
+STATIC
+VOID
+I2cModelSlaveWrite (
+  IN  I2C_MODEL_SLAVE   *Slave,
+  IN  UINT8             Data
+  )
+{
+  UINT32  PageBase;
+
+  if (Slave->AddressBytesReceived < Slave->AddressBytes) {
+    if (Slave->AddressBytesReceived == 0) {
+      Slave->Pointer = 0;
+    }
+    Slave->Pointer = ((Slave->Pointer << 8) | Data) % Slave->Size;
+    ++Slave->AddressBytesReceived;
+    return;
+  }
+
+  Slave->Memory[Slave->Pointer] = Data;
+  Slave->Written = TRUE;
+
+  // EEPROM pages wrap around, a register file simply increments
+  if (Slave->PageSize != 0) {
+    PageBase = Slave->Pointer - (Slave->Pointer % Slave->PageSize);
+    Slave->Pointer = PageBase + ((Slave->Pointer + 1) % Slave->PageSize);
+  } else {
+    Slave->Pointer = (Slave->Pointer + 1) % Slave->Size;
+  }
+}
+
+STATIC
+VOID
+I2cModelCompleteByte (
+  IN  I2C_MODEL   *Model
+  )
+{
+  BOOLEAN           Ack;
+  UINT32            Index;
+  I2C_MODEL_SLAVE   *Slave;
+
+  Ack = FALSE;
+  if (Model->ByteIsReceive) {
+    Model->RxData = (Model->Selected != NULL) ? I2cModelSlaveRead (Model->Selected) : 0xFF;
+    // TXAK is sampled at the end of the byte
+    Model->LastReadAcked = ((Model->I2cr & I2C_MODEL_I2CR_TXAK) == 0);
+    Model->ReadNaked = !Model->LastReadAcked;
+  } else if (Model->Phase == I2cModelPhaseAddress) {
+    Model->Selected = NULL;
+    for (Index = 0; Index < Model->SlaveCount; ++Index) {
+      Slave = Model->Slave[Index];
+      if (Slave->Address != (Model->TxData >> 1)) {
+        continue;
+      }
+      if (HostNow () < Slave->BusyUntilInNs) {
+        ++Slave->NakCount;
+        break;
+      }
+      Model->Selected = Slave;
+      Slave->AddressBytesReceived = 0;
+      Ack = TRUE;
+      break;
+    }
+
+    Model->SlaveNaked = !Ack;
+    Model->LastReadAcked = FALSE;
+    Model->ReadNaked = FALSE;
+    if ((Model->TxData & 1) != 0) {
+      Model->Phase = I2cModelPhaseReceive;
+    } else {
+      Model->Phase = I2cModelPhaseTransmit;
+    }
+  } else if (Model->Phase == I2cModelPhaseTransmit) {
+    if (Model->Selected != NULL) {
+      I2cModelSlaveWrite (Model->Selected, Model->TxData);
+      Ack = TRUE;
+    }
+  }
+
+  if (!Model->ByteIsReceive) {
+    if (Ack) {
+      Model->I2sr &= ~IMX_I2C_I2SR_RXAK;
+    } else {
+      Model->I2sr |= IMX_I2C_I2SR_RXAK;
+    }
+  }
+
+  Model->I2sr |= IMX_I2C_I2SR_ICF | IMX_I2C_I2SR_IIF;
+  Model->ByteInFlight = FALSE;
+  ++Model->ByteCount;
+  Model->BusTimeInNs += 9 * Model->BitTimeInNs;
+}
+
+STATIC
+VOID
+I2cModelStartByte (
+  IN  I2C_MODEL   *Model,
+  IN  BOOLEAN     Receive
+  )
+{
+  Model->ByteInFlight = TRUE;
+  Model->ByteIsReceive = Receive;
+  Model->ByteDoneInNs = HostNow () + 9 * Model->BitTimeInNs;
+  Model->I2sr &= ~IMX_I2C_I2SR_ICF;
+}
+
+STATIC
+VOID
+I2cModelTick (
+  IN  VOID    *Context,
+  IN  UINT64  NowInNs
+  )
+{
+  I2C_MODEL   *Model;
+
+  Model = Context;
+  if (Model->ByteInFlight && (NowInNs >= Model->ByteDoneInNs)) {
+    I2cModelCompleteByte (Model);
+  }
+}
+
+STATIC
+VOID
+I2cModelWriteI2cr (
+  IN  I2C_MODEL   *Model,
+  IN  UINT16      Value
+  )
+{
+  UINT16  Old;
+
+  Old = Model->I2cr;
+  // RSTA is write only and always reads as zero
+  Model->I2cr = Value & ~I2C_MODEL_I2CR_RSTA;
+
+  if ((Value & I2C_MODEL_I2CR_IEN) == 0) {
+    if (Model->ByteInFlight) {
+      I2cModelError (Model, "Controller disabled while a byte is in flight");
+    }
+    I2cModelSlaveStop (Model);
+    Model->I2sr = 0;
+    Model->Phase = I2cModelPhaseIdle;
+    Model->ByteInFlight = FALSE;
+    return;
+  }
+
+  if ((Old & I2C_MODEL_I2CR_IEN) == 0) {
+    ++Model->EnableCount;
+    if ((Value & I2C_MODEL_I2CR_MSTA) != 0) {
+      I2cModelError (Model, "MSTA set together with IEN");
+    }
+    return;
+  }
+
+  if (((Old & I2C_MODEL_I2CR_MSTA) == 0) && ((Value & I2C_MODEL_I2CR_MSTA) != 0)) {
+    if ((Model->I2sr & IMX_I2C_I2SR_IBB) != 0) {
+      I2cModelError (Model, "START while the bus is busy");
+    }
+    ++Model->StartCount;
+    Model->I2sr |= IMX_I2C_I2SR_IBB;
+    Model->Phase = I2cModelPhaseAddress;
+  } else if (((Old & I2C_MODEL_I2CR_MSTA) != 0) && ((Value & I2C_MODEL_I2CR_MSTA) == 0)) {
+    I2cModelCheckEndOfRead (Model);
+    I2cModelSlaveStop (Model);
+    Model->I2sr &= ~IMX_I2C_I2SR_IBB;
+    Model->Phase = I2cModelPhaseIdle;
+  } else if (((Value & I2C_MODEL_I2CR_MSTA) != 0) && ((Value & I2C_MODEL_I2CR_RSTA) != 0)) {
+    I2cModelCheckEndOfRead (Model);
+    ++Model->StartCount;
+    Model->Phase = I2cModelPhaseAddress;
+  }
+}
+
+STATIC
+UINT32
+I2cModelRead (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width
+  )
+{
+  I2C_MODEL   *Model;
+
+  Model = Context;
+  switch (Offset) {
+  case I2C_MODEL_IADR:
+    return Model->Iadr;
+  case I2C_MODEL_IFDR:
+    return Model->Ifdr;
+  case I2C_MODEL_I2CR:
+    return Model->I2cr;
+  case I2C_MODEL_I2SR:
+    return Model->I2sr;
+  case I2C_MODEL_I2DR:
+    // In master receive mode, reading the data register starts the next byte
+    if (((Model->I2cr & I2C_MODEL_I2CR_MSTA) != 0) &&
+        ((Model->I2cr & I2C_MODEL_I2CR_MTX) == 0)) {
+      if (Model->ByteInFlight) {
+        I2cModelError (Model, "I2DR read while a byte is in flight");
+      } else if (Model->Phase != I2cModelPhaseReceive) {
+        I2cModelError (Model, "Receive started outside of a read transfer");
+      } else {
+        if (Model->ReadNaked) {
+          I2cModelError (Model, "Receive started after the last byte was NAKed");
+        }
+        I2cModelStartByte (Model, TRUE);
+      }
+    }
+    return Model->RxData;
+  default:
+    I2cModelError (Model, "Read of an unknown I2C register");
+    return 0;
+  }
+}
+
+STATIC
+VOID
+I2cModelWrite (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width,
+  IN  UINT32  Value
+  )
+{
+  I2C_MODEL   *Model;
+
+  Model = Context;
+  switch (Offset) {
+  case I2C_MODEL_IADR:
+    Model->Iadr = (UINT16)Value;
+    break;
+  case I2C_MODEL_IFDR:
+    Model->Ifdr = (UINT16)Value;
+    break;
+  case I2C_MODEL_I2CR:
+    I2cModelWriteI2cr (Model, (UINT16)Value);
+    break;
+  case I2C_MODEL_I2SR:
+    // IIF and IAL are cleared by writing zero, other bits are read only
+    Model->I2sr &= ~(~Value & (IMX_I2C_I2SR_IIF | IMX_I2C_I2SR_IAL));
+    break;
+  case I2C_MODEL_I2DR:
+    if (((Model->I2cr & I2C_MODEL_I2CR_MSTA) == 0) ||
+        ((Model->I2cr & I2C_MODEL_I2CR_MTX) == 0)) {
+      I2cModelError (Model, "I2DR written outside of master transmit mode");
+      break;
+    }
+    if (Model->ByteInFlight) {
+      I2cModelError (Model, "I2DR written while a byte is in flight");
+      break;
+    }
+    Model->TxData = (UINT8)Value;
+    I2cModelStartByte (Model, FALSE);
+    break;
+  default:
+    I2cModelError (Model, "Write of an unknown I2C register");
+    break;
+  }
+}
+
+VOID
+I2cModelInitialize (
+  OUT I2C_MODEL   *Model,
+  IN  UINTN       Base,
+  IN  UINT32      BusFrequency
+  )
+{
+  ZeroMem (Model, sizeof (*Model));
+  Model->Base = Base;
+  Model->BitTimeInNs = 1000000000ULL / BusFrequency;
+  HostMmioRegister (Base, I2C_MODEL_WINDOW, Model, I2cModelRead, I2cModelWrite, I2cModelTick);
+}
+
+VOID
+I2cModelAddSlave (
+  IN  I2C_MODEL         *Model,
+  IN  I2C_MODEL_SLAVE   *Slave,
+  IN  UINT8             Address,
+  IN  UINT32            AddressBytes,
+  IN  UINT32            Size,
+  IN  UINT32            PageSize,
+  IN  UINT64            WriteCycleInNs
+  )
+{
+  ASSERT (Model->SlaveCount < I2C_MODEL_SLAVE_MAX);
+  ASSERT (Size <= I2C_MODEL_MEMORY_SIZE);
+
+  ZeroMem (Slave, sizeof (*Slave));
+  Slave->Address = Address;
+  Slave->AddressBytes = AddressBytes;
+  Slave->Size = Size;
+  Slave->PageSize = PageSize;
+  Slave->WriteCycleInNs = WriteCycleInNs;
+  Model->Slave[Model->SlaveCount++] = Slave;
+}
@@ -0,0 +1,105 @@
+/** @file
+*
+*  Behavioral model of the i.MX I2C controller and of simple I2C slaves.
+*
+*  The model follows the controller programming model closely enough to catch
+*  sequencing mistakes of the driver: writing I2DR while a byte is in flight,
+*  starting a receive after the slave was NAKed, ACKing the last byte of a
+*  read, or touching registers outside the controller window.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _I2C_MODEL_H_
+#define _I2C_MODEL_H_
+
+#include <Base.h>
+
+#define I2C_MODEL_SLAVE_MAX     4
+#define I2C_MODEL_MEMORY_SIZE   0x10000
+
+//
+// Memory like slave: an EEPROM or a register file with an auto-incrementing
+// address pointer. An EEPROM does not ACK its address for WriteCycleInNs
+// after a write transfer.
+//
+typedef struct {
+  UINT8     Address;
+  UINT32    AddressBytes;
+  UINT32    Size;
+  UINT32    PageSize;
+  UINT64    WriteCycleInNs;
+  UINT8     Memory[I2C_MODEL_MEMORY_SIZE];
+
+  UINT32    Pointer;
+  UINT32    AddressBytesReceived;
+  BOOLEAN   Written;
+  UINT64    BusyUntilInNs;
+  UINT32    NakCount;
+} I2C_MODEL_SLAVE;
+
+typedef enum {
+  I2cModelPhaseIdle,
+  I2cModelPhaseAddress,
+  I2cModelPhaseTransmit,
+  I2cModelPhaseReceive,
+} I2C_MODEL_PHASE;
+
+typedef struct {
+  UINTN             Base;
+  UINT64            BitTimeInNs;
+
+  UINT16            Iadr;
+  UINT16            Ifdr;
+  UINT16            I2cr;
+  UINT16            I2sr;
+  UINT8             RxData;
+
+  I2C_MODEL_PHASE   Phase;
+  I2C_MODEL_SLAVE   *Selected;
+  BOOLEAN           SlaveNaked;
+  BOOLEAN           LastReadAcked;
+  BOOLEAN           ReadNaked;
+  BOOLEAN           ByteInFlight;
+  BOOLEAN           ByteIsReceive;
+  UINT8             TxData;
+  UINT64            ByteDoneInNs;
+
+  I2C_MODEL_SLAVE   *Slave[I2C_MODEL_SLAVE_MAX];
+  UINT32            SlaveCount;
+
+  UINT32            StartCount;
+  UINT32            EnableCount;
+  UINT64            ByteCount;
+  UINT64            BusTimeInNs;
+  UINT32            ProtocolErrorCount;
+} I2C_MODEL;
+
+VOID
+I2cModelInitialize (
+  OUT I2C_MODEL   *Model,
+  IN  UINTN       Base,
+  IN  UINT32      BusFrequency
+  );
+
+VOID
+I2cModelAddSlave (
+  IN  I2C_MODEL         *Model,
+  IN  I2C_MODEL_SLAVE   *Slave,
+  IN  UINT8             Address,
+  IN  UINT32            AddressBytes,
+  IN  UINT32            Size,
+  IN  UINT32            PageSize,
+  IN  UINT64            WriteCycleInNs
+  );
+
+#endif
@@ -0,0 +1,24 @@
+/** @file
+*
+*  Host build replacement for ArmPkg AsmMacroIoLib.h, for assembling the ARM
+*  sources of a library with a cross compiler.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_ASM_MACRO_IO_LIB_H_
+#define _HOST_ASM_MACRO_IO_LIB_H_
+
+#define ASM_PFX(Name)           Name
+#define GCC_ASM_EXPORT(Name)    .global Name ; .type Name, %function
+
+#endif
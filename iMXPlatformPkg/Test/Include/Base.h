@@ -0,0 +1,134 @@
+/** @file
+*
+*  Host build replacement for MdePkg Base.h.
+*
+*  Only the subset used by the iMXPlatformPkg libraries under host test is
+*  provided. Types keep their UEFI widths on a 64-bit host.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_BASE_H_
+#define _HOST_BASE_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t     UINT8;
+typedef uint16_t    UINT16;
+typedef uint32_t    UINT32;
+typedef uint64_t    UINT64;
+typedef int8_t      INT8;
+typedef int16_t     INT16;
+typedef int32_t     INT32;
+typedef int64_t     INT64;
+typedef uintptr_t   UINTN;
+typedef intptr_t    INTN;
+typedef uint8_t     BOOLEAN;
+typedef char        CHAR8;
+typedef uint16_t    CHAR16;
+typedef void        VOID;
+
+typedef struct {
+  UINT32  Data1;
+  UINT16  Data2;
+  UINT16  Data3;
+  UINT8   Data4[8];
+} GUID;
+
+typedef UINTN RETURN_STATUS;
+typedef UINT64 PHYSICAL_ADDRESS;
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST     const
+#define STATIC    static
+#define EFIAPI
+#define GLOBAL_REMOVE_IF_UNREFERENCED
+
+#define TRUE      ((BOOLEAN)(1 == 1))
+#define FALSE     ((BOOLEAN)(0 == 1))
+#ifndef NULL
+#define NULL      ((VOID *)0)
+#endif
+
+#define MAX_UINT8   ((UINT8)0xFF)
+#define MAX_UINT16  ((UINT16)0xFFFF)
+#define MAX_UINT32  ((UINT32)0xFFFFFFFF)
+#define MAX_UINT64  ((UINT64)0xFFFFFFFFFFFFFFFFULL)
+#define MAX_INT32   ((INT32)0x7FFFFFFF)
+#define MAX_UINTN   ((UINTN)-1)
+#define MAX_BIT     ((UINTN)1 << (sizeof (UINTN) * 8 - 1))
+
+#define BIT0    0x00000001
+#define BIT1    0x00000002
+#define BIT2    0x00000004
+#define BIT3    0x00000008
+#define BIT4    0x00000010
+#define BIT5    0x00000020
+#define BIT6    0x00000040
+#define BIT7    0x00000080
+#define BIT8    0x00000100
+#define BIT9    0x00000200
+#define BIT10   0x00000400
+#define BIT11   0x00000800
+#define BIT12   0x00001000
+#define BIT13   0x00002000
+#define BIT14   0x00004000
+#define BIT15   0x00008000
+
+#define SIZE_1KB    0x00000400
+#define SIZE_4KB    0x00001000
+#define SIZE_64KB   0x00010000
+
+#define ARRAY_SIZE(Array)       (sizeof (Array) / sizeof ((Array)[0]))
+#define MIN(a, b)               (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)               (((a) > (b)) ? (a) : (b))
+#define ABS(a)                  (((a) < 0) ? (-(a)) : (a))
+#define ALIGN_VALUE(Value, Alignment) \
+  ((Value) + (((Alignment) - (Value)) & ((Alignment) - 1)))
+#define OFFSET_OF(TYPE, Field)  ((UINTN) offsetof (TYPE, Field))
+#define BASE_CR(Record, TYPE, Field) \
+  ((TYPE *) ((CHAR8 *) (Record) - OFFSET_OF (TYPE, Field)))
+
+#define SIGNATURE_16(A, B)        ((A) | (B << 8))
+#define SIGNATURE_32(A, B, C, D)  (SIGNATURE_16 (A, B) | (SIGNATURE_16 (C, D) << 16))
+
+#define VA_LIST           va_list
+#define VA_START(M, P)    va_start (M, P)
+#define VA_ARG(M, T)      va_arg (M, T)
+#define VA_END(M)         va_end (M)
+
+#define ENCODE_ERROR(a)             ((RETURN_STATUS)(MAX_BIT | (a)))
+#define RETURN_ERROR(a)             (((INTN)(RETURN_STATUS)(a)) < 0)
+
+#define RETURN_SUCCESS              0
+#define RETURN_LOAD_ERROR           ENCODE_ERROR (1)
+#define RETURN_INVALID_PARAMETER    ENCODE_ERROR (2)
+#define RETURN_UNSUPPORTED          ENCODE_ERROR (3)
+#define RETURN_BAD_BUFFER_SIZE      ENCODE_ERROR (4)
+#define RETURN_BUFFER_TOO_SMALL     ENCODE_ERROR (5)
+#define RETURN_NOT_READY            ENCODE_ERROR (6)
+#define RETURN_DEVICE_ERROR         ENCODE_ERROR (7)
+#define RETURN_WRITE_PROTECTED      ENCODE_ERROR (8)
+#define RETURN_OUT_OF_RESOURCES     ENCODE_ERROR (9)
+#define RETURN_NOT_FOUND            ENCODE_ERROR (14)
+#define RETURN_ACCESS_DENIED        ENCODE_ERROR (15)
+#define RETURN_TIMEOUT              ENCODE_ERROR (18)
+#define RETURN_NOT_STARTED          ENCODE_ERROR (19)
+#define RETURN_ALREADY_STARTED      ENCODE_ERROR (20)
+#define RETURN_ABORTED              ENCODE_ERROR (21)
+#define RETURN_CRC_ERROR            ENCODE_ERROR (27)
+
+#endif
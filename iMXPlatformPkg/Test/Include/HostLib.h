@@ -0,0 +1,150 @@
+/** @file
+*
+*  Host test support shared by the iMXPlatformPkg host tests.
+*
+*  Device models register an MMIO window and a tick handler. MMIO accesses
+*  from the code under test are routed to the window that contains the
+*  address, and every advance of the simulated clock is forwarded to the tick
+*  handlers so the models can complete their transfers.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_LIB_H_
+#define _HOST_LIB_H_
+
+#include <Base.h>
+
+#define HOST_MMIO_WINDOW_MAX    4
+
+typedef
+UINT32
+(*HOST_MMIO_READ) (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width
+  );
+
+typedef
+VOID
+(*HOST_MMIO_WRITE) (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width,
+  IN  UINT32  Value
+  );
+
+typedef
+VOID
+(*HOST_TICK) (
+  IN  VOID    *Context,
+  IN  UINT64  NowInNs
+  );
+
+//
+// Called once, before the first MMIO access made with interrupts enabled after
+// the armed number of accesses, so a test can run a preempting client in the
+// middle of a transfer.
+//
+typedef
+VOID
+(*HOST_INTERRUPT) (
+  IN  VOID    *Context
+  );
+
+typedef struct {
+  UINT64  MmioReadCount;
+  UINT64  MmioWriteCount;
+  UINT64  DelayInUs;
+  UINT64  UnmappedCount;
+  UINT64  CacheCleanCount;
+  UINT64  CacheInvalidateCount;
+} HOST_COUNTERS;
+
+extern HOST_COUNTERS  gHostCounters;
+
+VOID
+HostReset (
+  VOID
+  );
+
+VOID
+HostMmioRegister (
+  IN  UINTN             Base,
+  IN  UINTN             Size,
+  IN  VOID              *Context,
+  IN  HOST_MMIO_READ    Read,
+  IN  HOST_MMIO_WRITE   Write,
+  IN  HOST_TICK         Tick
+  );
+
+VOID
+HostSetInterrupt (
+  IN  HOST_INTERRUPT    Interrupt,
+  IN  VOID              *Context,
+  IN  UINT32            AccessCount
+  );
+
+UINT64
+HostNow (
+  VOID
+  );
+
+VOID
+HostAdvance (
+  IN  UINT64  NanoSeconds
+  );
+
+//
+// Signal every open event created with exactly Type, e.g. EVT_TIMER |
+// EVT_NOTIFY_SIGNAL for the periodic timers or EVT_SIGNAL_EXIT_BOOT_SERVICES.
+// The notify functions run at their TPL.
+//
+VOID
+HostSignalEvents (
+  IN  UINT32  Type
+  );
+
+UINT32
+HostOpenEventCount (
+  VOID
+  );
+
+//
+// Minimal test reporting. HOST_CHECK records a failure and keeps going so a
+// single run reports every broken expectation.
+//
+extern UINT32  gHostCheckCount;
+extern UINT32  gHostFailCount;
+
+#define HOST_CHECK(Expression)                                    \
+  do {                                                            \
+    ++gHostCheckCount;                                            \
+    if (!(Expression)) {                                          \
+      ++gHostFailCount;                                           \
+      HostReportFailure (__FILE__, __LINE__, #Expression);        \
+    }                                                             \
+  } while (FALSE)
+
+VOID
+HostReportFailure (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  );
+
+INTN
+HostSummary (
+  IN  CONST CHAR8   *Name
+  );
+
+#endif
@@ -0,0 +1,78 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/BaseLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_BASE_LIB_H_
+#define _HOST_BASE_LIB_H_
+
+UINT64
+EFIAPI
+DivU64x32 (
+  IN  UINT64  Dividend,
+  IN  UINT32  Divisor
+  );
+
+UINT64
+EFIAPI
+DivU64x64Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT64  Divisor,
+  OUT UINT64  *Remainder  OPTIONAL
+  );
+
+UINT64
+EFIAPI
+MultU64x32 (
+  IN  UINT64  Multiplicand,
+  IN  UINT32  Multiplier
+  );
+
+INTN
+EFIAPI
+HighBitSet32 (
+  IN  UINT32  Operand
+  );
+
+INTN
+EFIAPI
+HighBitSet64 (
+  IN  UINT64  Operand
+  );
+
+BOOLEAN
+EFIAPI
+SaveAndDisableInterrupts (
+  VOID
+  );
+
+BOOLEAN
+EFIAPI
+SetInterruptState (
+  IN  BOOLEAN   InterruptState
+  );
+
+BOOLEAN
+EFIAPI
+GetInterruptState (
+  VOID
+  );
+
+VOID
+EFIAPI
+CpuPause (
+  VOID
+  );
+
+#endif
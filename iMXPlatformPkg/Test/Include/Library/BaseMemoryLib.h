@@ -0,0 +1,59 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/BaseMemoryLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_BASE_MEMORY_LIB_H_
+#define _HOST_BASE_MEMORY_LIB_H_
+
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID        *DestinationBuffer,
+  IN  CONST VOID  *SourceBuffer,
+  IN  UINTN       Length
+  );
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length,
+  IN  UINT8   Value
+  );
+
+VOID *
+EFIAPI
+SetMem32 (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length,
+  IN  UINT32  Value
+  );
+
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length
+  );
+
+INTN
+EFIAPI
+CompareMem (
+  IN  CONST VOID  *DestinationBuffer,
+  IN  CONST VOID  *SourceBuffer,
+  IN  UINTN       Length
+  );
+
+#endif
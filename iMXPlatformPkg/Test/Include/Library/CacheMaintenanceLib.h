@@ -0,0 +1,34 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/CacheMaintenanceLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_CACHE_MAINTENANCE_LIB_H_
+#define _HOST_CACHE_MAINTENANCE_LIB_H_
+
+VOID *
+EFIAPI
+WriteBackDataCacheRange (
+  IN  VOID    *Address,
+  IN  UINTN   Length
+  );
+
+VOID *
+EFIAPI
+InvalidateDataCacheRange (
+  IN  VOID    *Address,
+  IN  UINTN   Length
+  );
+
+#endif
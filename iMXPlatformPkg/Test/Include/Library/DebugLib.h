@@ -0,0 +1,66 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/DebugLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_DEBUG_LIB_H_
+#define _HOST_DEBUG_LIB_H_
+
+#define DEBUG_INIT      0x00000001
+#define DEBUG_WARN      0x00000002
+#define DEBUG_LOAD      0x00000004
+#define DEBUG_INFO      0x00000040
+#define DEBUG_VERBOSE   0x00400000
+#define DEBUG_ERROR     0x80000000
+
+//
+// DEBUG_ERROR messages are counted so a test can check that a failure path
+// was taken. Messages are only printed when HOST_TEST_VERBOSE is set in the
+// environment.
+//
+extern UINT32 gHostDebugErrorCount;
+
+VOID
+EFIAPI
+DebugPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  ...
+  );
+
+VOID
+EFIAPI
+DebugAssert (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  );
+
+#define DEBUG(Expression)   DebugPrint Expression
+
+#define ASSERT(Expression)                                \
+  do {                                                    \
+    if (!(Expression)) {                                  \
+      DebugAssert (__FILE__, __LINE__, #Expression);      \
+    }                                                     \
+  } while (FALSE)
+
+#define ASSERT_EFI_ERROR(StatusParameter)   ASSERT (!EFI_ERROR (StatusParameter))
+#define ASSERT_RETURN_ERROR(StatusParameter)  ASSERT (!RETURN_ERROR (StatusParameter))
+
+#define DEBUG_CODE_BEGIN()  do { if (TRUE) { UINT8  __DebugCodeLocal
+#define DEBUG_CODE_END()    __DebugCodeLocal = 0; __DebugCodeLocal++; } } while (FALSE)
+#define DEBUG_CODE(Expression)  DEBUG_CODE_BEGIN (); Expression DEBUG_CODE_END ()
+
+#endif
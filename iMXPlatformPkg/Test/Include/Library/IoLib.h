@@ -0,0 +1,86 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/IoLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_IO_LIB_H_
+#define _HOST_IO_LIB_H_
+
+//
+// MMIO accesses are routed to the device models registered with
+// HostMmioRegister in HostLib.h. Nothing is ever dereferenced.
+//
+
+UINT8
+EFIAPI
+MmioRead8 (
+  IN  UINTN   Address
+  );
+
+UINT16
+EFIAPI
+MmioRead16 (
+  IN  UINTN   Address
+  );
+
+UINT32
+EFIAPI
+MmioRead32 (
+  IN  UINTN   Address
+  );
+
+UINT8
+EFIAPI
+MmioWrite8 (
+  IN  UINTN   Address,
+  IN  UINT8   Value
+  );
+
+UINT16
+EFIAPI
+MmioWrite16 (
+  IN  UINTN   Address,
+  IN  UINT16  Value
+  );
+
+UINT32
+EFIAPI
+MmioWrite32 (
+  IN  UINTN   Address,
+  IN  UINT32  Value
+  );
+
+UINT32
+EFIAPI
+MmioOr32 (
+  IN  UINTN   Address,
+  IN  UINT32  OrData
+  );
+
+UINT32
+EFIAPI
+MmioAnd32 (
+  IN  UINTN   Address,
+  IN  UINT32  AndData
+  );
+
+UINT32
+EFIAPI
+MmioAndThenOr32 (
+  IN  UINTN   Address,
+  IN  UINT32  AndData,
+  IN  UINT32  OrData
+  );
+
+#endif
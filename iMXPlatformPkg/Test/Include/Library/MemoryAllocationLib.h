@@ -0,0 +1,33 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/MemoryAllocationLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_MEMORY_ALLOCATION_LIB_H_
+#define _HOST_MEMORY_ALLOCATION_LIB_H_
+
+VOID *
+EFIAPI
+AllocatePages (
+  IN  UINTN   Pages
+  );
+
+VOID
+EFIAPI
+FreePages (
+  IN  VOID    *Buffer,
+  IN  UINTN   Pages
+  );
+
+#endif
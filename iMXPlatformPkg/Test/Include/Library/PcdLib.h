@@ -0,0 +1,35 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/PcdLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_PCD_LIB_H_
+#define _HOST_PCD_LIB_H_
+
+//
+// PCDs are plain globals named gHostPcd_<Name>, so a test can flip them at
+// run time. Each test declares the PCDs of the code under test in its
+// AutoGen.h and defines the globals.
+//
+#define FeaturePcdGet(TokenName)    (gHostPcd_##TokenName)
+#define FixedPcdGet8(TokenName)     (gHostPcd_##TokenName)
+#define FixedPcdGet16(TokenName)    (gHostPcd_##TokenName)
+#define FixedPcdGet32(TokenName)    (gHostPcd_##TokenName)
+#define FixedPcdGet64(TokenName)    (gHostPcd_##TokenName)
+#define FixedPcdGetBool(TokenName)  (gHostPcd_##TokenName)
+#define PcdGet32(TokenName)         (gHostPcd_##TokenName)
+#define PcdGet64(TokenName)         (gHostPcd_##TokenName)
+#define PcdGetBool(TokenName)       (gHostPcd_##TokenName)
+
+#endif
@@ -0,0 +1,98 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/SerialPortLib.h, including the
+*  serial types it pulls in from Protocol/SerialIo.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_SERIAL_PORT_LIB_H_
+#define _HOST_SERIAL_PORT_LIB_H_
+
+typedef enum {
+  DefaultParity,
+  NoParity,
+  EvenParity,
+  OddParity,
+  MarkParity,
+  SpaceParity
+} EFI_PARITY_TYPE;
+
+typedef enum {
+  DefaultStopBits,
+  OneStopBit,
+  OneFiveStopBits,
+  TwoStopBits
+} EFI_STOP_BITS_TYPE;
+
+#define EFI_SERIAL_CLEAR_TO_SEND                  0x00000010
+#define EFI_SERIAL_DATA_SET_READY                 0x00000020
+#define EFI_SERIAL_RING_INDICATE                  0x00000040
+#define EFI_SERIAL_CARRIER_DETECT                 0x00000080
+#define EFI_SERIAL_REQUEST_TO_SEND                0x00000002
+#define EFI_SERIAL_DATA_TERMINAL_READY            0x00000001
+#define EFI_SERIAL_INPUT_BUFFER_EMPTY             0x00000100
+#define EFI_SERIAL_OUTPUT_BUFFER_EMPTY            0x00000200
+#define EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE       0x00001000
+#define EFI_SERIAL_SOFTWARE_LOOPBACK_ENABLE       0x00002000
+#define EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE   0x00004000
+
+RETURN_STATUS
+EFIAPI
+SerialPortInitialize (
+  VOID
+  );
+
+UINTN
+EFIAPI
+SerialPortWrite (
+  IN  UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  );
+
+UINTN
+EFIAPI
+SerialPortRead (
+  OUT UINT8   *Buffer,
+  IN  UINTN   NumberOfBytes
+  );
+
+BOOLEAN
+EFIAPI
+SerialPortPoll (
+  VOID
+  );
+
+RETURN_STATUS
+EFIAPI
+SerialPortSetControl (
+  IN  UINT32  Control
+  );
+
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32  *Control
+  );
+
+RETURN_STATUS
+EFIAPI
+SerialPortSetAttributes (
+  IN OUT  UINT64              *BaudRate,
+  IN OUT  UINT32              *ReceiveFifoDepth,
+  IN OUT  UINT32              *Timeout,
+  IN OUT  EFI_PARITY_TYPE     *Parity,
+  IN OUT  UINT8               *DataBits,
+  IN OUT  EFI_STOP_BITS_TYPE  *StopBits
+  );
+
+#endif
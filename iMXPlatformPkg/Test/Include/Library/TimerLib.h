@@ -0,0 +1,56 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/TimerLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_TIMER_LIB_H_
+#define _HOST_TIMER_LIB_H_
+
+//
+// Time is simulated. MicroSecondDelay advances the simulated clock, and the
+// performance counter is the simulated clock in nanoseconds.
+//
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN  UINTN   MicroSeconds
+  );
+
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN  UINTN   NanoSeconds
+  );
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  );
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64  *StartValue,  OPTIONAL
+  OUT UINT64  *EndValue     OPTIONAL
+  );
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN  UINT64  Ticks
+  );
+
+#endif
@@ -0,0 +1,22 @@
+/** @file
+*
+*  Host build replacement for MdePkg Library/UefiBootServicesTableLib.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_UEFI_BOOT_SERVICES_TABLE_LIB_H_
+#define _HOST_UEFI_BOOT_SERVICES_TABLE_LIB_H_
+
+extern EFI_BOOT_SERVICES  *gBS;
+
+#endif
@@ -0,0 +1,82 @@
+/** @file
+*
+*  Host build replacement for MdePkg Uefi.h.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _HOST_UEFI_H_
+#define _HOST_UEFI_H_
+
+#include <Base.h>
+
+typedef RETURN_STATUS     EFI_STATUS;
+typedef GUID              EFI_GUID;
+typedef VOID              *EFI_HANDLE;
+typedef VOID              *EFI_EVENT;
+typedef UINTN             EFI_TPL;
+typedef UINT64            EFI_PHYSICAL_ADDRESS;
+
+#define EFI_SUCCESS               RETURN_SUCCESS
+#define EFI_INVALID_PARAMETER     RETURN_INVALID_PARAMETER
+#define EFI_UNSUPPORTED           RETURN_UNSUPPORTED
+#define EFI_BUFFER_TOO_SMALL      RETURN_BUFFER_TOO_SMALL
+#define EFI_NOT_READY             RETURN_NOT_READY
+#define EFI_DEVICE_ERROR          RETURN_DEVICE_ERROR
+#define EFI_OUT_OF_RESOURCES      RETURN_OUT_OF_RESOURCES
+#define EFI_NOT_FOUND             RETURN_NOT_FOUND
+#define EFI_TIMEOUT               RETURN_TIMEOUT
+#define EFI_ABORTED               RETURN_ABORTED
+#define EFI_ERROR(A)              RETURN_ERROR (A)
+
+#define TPL_APPLICATION   4
+#define TPL_CALLBACK      8
+#define TPL_NOTIFY        16
+#define TPL_HIGH_LEVEL    31
+
+#define EVT_TIMER                         0x80000000
+#define EVT_NOTIFY_SIGNAL                 0x00000200
+#define EVT_SIGNAL_EXIT_BOOT_SERVICES     0x00000201
+
+typedef
+VOID
+(EFIAPI *EFI_EVENT_NOTIFY) (
+  IN  EFI_EVENT   Event,
+  IN  VOID        *Context
+  );
+
+typedef enum {
+  TimerCancel,
+  TimerPeriodic,
+  TimerRelative
+} EFI_TIMER_DELAY;
+
+//
+// Only the boot services used by the code under test. HostLib implements
+// them on top of a small event table, see HostSignalEvents.
+//
+typedef struct {
+  EFI_TPL     (EFIAPI *RaiseTPL) (IN EFI_TPL NewTpl);
+  VOID        (EFIAPI *RestoreTPL) (IN EFI_TPL OldTpl);
+  EFI_STATUS  (EFIAPI *CreateEvent) (IN UINT32 Type, IN EFI_TPL NotifyTpl,
+                                     IN EFI_EVENT_NOTIFY NotifyFunction,
+                                     IN VOID *NotifyContext, OUT EFI_EVENT *Event);
+  EFI_STATUS  (EFIAPI *SetTimer) (IN EFI_EVENT Event, IN EFI_TIMER_DELAY Type,
+                                  IN UINT64 TriggerTime);
+  EFI_STATUS  (EFIAPI *CloseEvent) (IN EFI_EVENT Event);
+} EFI_BOOT_SERVICES;
+
+#define EFI_PAGE_SIZE             SIZE_4KB
+#define EFI_SIZE_TO_PAGES(Size)   (((Size) >> 12) + (((Size) & 0xFFF) ? 1 : 0))
+#define EFI_PAGES_TO_SIZE(Pages)  ((Pages) << 12)
+
+#endif
@@ -0,0 +1,792 @@
+/** @file
+*
+*  Host implementation of the MdePkg library classes used by the
+*  iMXPlatformPkg libraries under host test.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <HostLib.h>
+
+// Cost of a single peripheral register access on the simulated bus
+#define HOST_MMIO_ACCESS_NS   50
+
+#define HOST_EVENT_MAX        8
+
+// 32-bit hosts only have low addresses
+#ifndef MAP_32BIT
+#define MAP_32BIT             0
+#endif
+
+typedef struct {
+  UINTN             Base;
+  UINTN             Size;
+  VOID              *Context;
+  HOST_MMIO_READ    Read;
+  HOST_MMIO_WRITE   Write;
+  HOST_TICK         Tick;
+} HOST_MMIO_WINDOW;
+
+typedef struct {
+  BOOLEAN           Open;
+  UINT32            Type;
+  EFI_TPL           NotifyTpl;
+  EFI_EVENT_NOTIFY  NotifyFunction;
+  VOID              *NotifyContext;
+} HOST_EVENT;
+
+HOST_COUNTERS  gHostCounters;
+UINT32         gHostDebugErrorCount;
+UINT32         gHostCheckCount;
+UINT32         gHostFailCount;
+
+STATIC HOST_MMIO_WINDOW   mWindow[HOST_MMIO_WINDOW_MAX];
+STATIC UINT32             mWindowCount;
+STATIC UINT64             mNowInNs;
+STATIC BOOLEAN            mInterruptState = TRUE;
+STATIC HOST_INTERRUPT     mInterrupt;
+STATIC VOID               *mInterruptContext;
+STATIC UINT32             mInterruptCountdown;
+STATIC HOST_EVENT         mEvent[HOST_EVENT_MAX];
+STATIC EFI_TPL            mTpl = TPL_APPLICATION;
+
+VOID
+HostReset (
+  VOID
+  )
+{
+  ZeroMem (mWindow, sizeof (mWindow));
+  ZeroMem (&gHostCounters, sizeof (gHostCounters));
+  mWindowCount = 0;
+  mNowInNs = 0;
+  mInterruptState = TRUE;
+  mInterrupt = NULL;
+  mInterruptContext = NULL;
+  mInterruptCountdown = 0;
+  ZeroMem (mEvent, sizeof (mEvent));
+  mTpl = TPL_APPLICATION;
+  gHostDebugErrorCount = 0;
+}
+
+VOID
+HostMmioRegister (
+  IN  UINTN             Base,
+  IN  UINTN             Size,
+  IN  VOID              *Context,
+  IN  HOST_MMIO_READ    Read,
+  IN  HOST_MMIO_WRITE   Write,
+  IN  HOST_TICK         Tick
+  )
+{
+  HOST_MMIO_WINDOW  *Window;
+
+  if (mWindowCount >= HOST_MMIO_WINDOW_MAX) {
+    fprintf (stderr, "HostMmioRegister: too many windows\n");
+    abort ();
+  }
+
+  Window = &mWindow[mWindowCount++];
+  Window->Base = Base;
+  Window->Size = Size;
+  Window->Context = Context;
+  Window->Read = Read;
+  Window->Write = Write;
+  Window->Tick = Tick;
+}
+
+VOID
+HostSetInterrupt (
+  IN  HOST_INTERRUPT    Interrupt,
+  IN  VOID              *Context,
+  IN  UINT32            AccessCount
+  )
+{
+  mInterrupt = Interrupt;
+  mInterruptContext = Context;
+  mInterruptCountdown = AccessCount;
+}
+
+UINT64
+HostNow (
+  VOID
+  )
+{
+  return mNowInNs;
+}
+
+VOID
+HostAdvance (
+  IN  UINT64  NanoSeconds
+  )
+{
+  UINT32  Index;
+
+  mNowInNs += NanoSeconds;
+  for (Index = 0; Index < mWindowCount; ++Index) {
+    if (mWindow[Index].Tick != NULL) {
+      mWindow[Index].Tick (mWindow[Index].Context, mNowInNs);
+    }
+  }
+}
+
+STATIC
+HOST_MMIO_WINDOW *
+HostMmioAccess (
+  IN  UINTN   Address
+  )
+{
+  HOST_INTERRUPT  Interrupt;
+  UINT32          Index;
+
+  // The interrupt is one shot, it is delivered on the first access made with
+  // interrupts enabled once AccessCount accesses have been made.
+  if (mInterruptCountdown > 0) {
+    --mInterruptCountdown;
+  } else if (mInterruptState && (mInterrupt != NULL)) {
+    Interrupt = mInterrupt;
+    mInterrupt = NULL;
+    Interrupt (mInterruptContext);
+  }
+
+  HostAdvance (HOST_MMIO_ACCESS_NS);
+  for (Index = 0; Index < mWindowCount; ++Index) {
+    if ((Address >= mWindow[Index].Base) &&
+        (Address < mWindow[Index].Base + mWindow[Index].Size)) {
+      return &mWindow[Index];
+    }
+  }
+
+  ++gHostCounters.UnmappedCount;
+  return NULL;
+}
+
+STATIC
+UINT32
+HostMmioRead (
+  IN  UINTN   Address,
+  IN  UINT32  Width
+  )
+{
+  HOST_MMIO_WINDOW  *Window;
+
+  ++gHostCounters.MmioReadCount;
+  Window = HostMmioAccess (Address);
+  if (Window == NULL) {
+    return 0;
+  }
+
+  return Window->Read (Window->Context, (UINT32)(Address - Window->Base), Width);
+}
+
+STATIC
+VOID
+HostMmioWrite (
+  IN  UINTN   Address,
+  IN  UINT32  Width,
+  IN  UINT32  Value
+  )
+{
+  HOST_MMIO_WINDOW  *Window;
+
+  ++gHostCounters.MmioWriteCount;
+  Window = HostMmioAccess (Address);
+  if (Window != NULL) {
+    Window->Write (Window->Context, (UINT32)(Address - Window->Base), Width, Value);
+  }
+}
+
+UINT8
+EFIAPI
+MmioRead8 (
+  IN  UINTN   Address
+  )
+{
+  return (UINT8)HostMmioRead (Address, 1);
+}
+
+UINT16
+EFIAPI
+MmioRead16 (
+  IN  UINTN   Address
+  )
+{
+  return (UINT16)HostMmioRead (Address, 2);
+}
+
+UINT32
+EFIAPI
+MmioRead32 (
+  IN  UINTN   Address
+  )
+{
+  return HostMmioRead (Address, 4);
+}
+
+UINT8
+EFIAPI
+MmioWrite8 (
+  IN  UINTN   Address,
+  IN  UINT8   Value
+  )
+{
+  HostMmioWrite (Address, 1, Value);
+  return Value;
+}
+
+UINT16
+EFIAPI
+MmioWrite16 (
+  IN  UINTN   Address,
+  IN  UINT16  Value
+  )
+{
+  HostMmioWrite (Address, 2, Value);
+  return Value;
+}
+
+UINT32
+EFIAPI
+MmioWrite32 (
+  IN  UINTN   Address,
+  IN  UINT32  Value
+  )
+{
+  HostMmioWrite (Address, 4, Value);
+  return Value;
+}
+
+UINT32
+EFIAPI
+MmioOr32 (
+  IN  UINTN   Address,
+  IN  UINT32  OrData
+  )
+{
+  return MmioWrite32 (Address, MmioRead32 (Address) | OrData);
+}
+
+UINT32
+EFIAPI
+MmioAnd32 (
+  IN  UINTN   Address,
+  IN  UINT32  AndData
+  )
+{
+  return MmioWrite32 (Address, MmioRead32 (Address) & AndData);
+}
+
+UINT32
+EFIAPI
+MmioAndThenOr32 (
+  IN  UINTN   Address,
+  IN  UINT32  AndData,
+  IN  UINT32  OrData
+  )
+{
+  return MmioWrite32 (Address, (MmioRead32 (Address) & AndData) | OrData);
+}
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN  UINTN   MicroSeconds
+  )
+{
+  gHostCounters.DelayInUs += MicroSeconds;
+  HostAdvance ((UINT64)MicroSeconds * 1000);
+  return MicroSeconds;
+}
+
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN  UINTN   NanoSeconds
+  )
+{
+  HostAdvance (NanoSeconds);
+  return NanoSeconds;
+}
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  return mNowInNs;
+}
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64  *StartValue,  OPTIONAL
+  OUT UINT64  *EndValue     OPTIONAL
+  )
+{
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+  return 1000000000ULL;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN  UINT64  Ticks
+  )
+{
+  return Ticks;
+}
+
+UINT64
+EFIAPI
+DivU64x32 (
+  IN  UINT64  Dividend,
+  IN  UINT32  Divisor
+  )
+{
+  return Dividend / Divisor;
+}
+
+UINT64
+EFIAPI
+DivU64x64Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT64  Divisor,
+  OUT UINT64  *Remainder  OPTIONAL
+  )
+{
+  if (Remainder != NULL) {
+    *Remainder = Dividend % Divisor;
+  }
+  return Dividend / Divisor;
+}
+
+UINT64
+EFIAPI
+MultU64x32 (
+  IN  UINT64  Multiplicand,
+  IN  UINT32  Multiplier
+  )
+{
+  return Multiplicand * Multiplier;
+}
+
+INTN
+EFIAPI
+HighBitSet32 (
+  IN  UINT32  Operand
+  )
+{
+  return (Operand == 0) ? -1 : 31 - __builtin_clz (Operand);
+}
+
+INTN
+EFIAPI
+HighBitSet64 (
+  IN  UINT64  Operand
+  )
+{
+  return (Operand == 0) ? -1 : 63 - __builtin_clzll (Operand);
+}
+
+BOOLEAN
+EFIAPI
+SaveAndDisableInterrupts (
+  VOID
+  )
+{
+  BOOLEAN   InterruptState;
+
+  InterruptState = mInterruptState;
+  mInterruptState = FALSE;
+  return InterruptState;
+}
+
+BOOLEAN
+EFIAPI
+SetInterruptState (
+  IN  BOOLEAN   InterruptState
+  )
+{
+  mInterruptState = InterruptState;
+  return InterruptState;
+}
+
+BOOLEAN
+EFIAPI
+GetInterruptState (
+  VOID
+  )
+{
+  return mInterruptState;
+}
+
+VOID
+EFIAPI
+CpuPause (
+  VOID
+  )
+{
+}
+
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID        *DestinationBuffer,
+  IN  CONST VOID  *SourceBuffer,
+  IN  UINTN       Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length,
+  IN  UINT8   Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+VOID *
+EFIAPI
+SetMem32 (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length,
+  IN  UINT32  Value
+  )
+{
+  UINT32  *Cursor;
+  UINTN   Index;
+
+  Cursor = Buffer;
+  for (Index = 0; Index < Length / sizeof (UINT32); ++Index) {
+    Cursor[Index] = Value;
+  }
+  return Buffer;
+}
+
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length
+  )
+{
+  return memset (Buffer, 0, Length);
+}
+
+INTN
+EFIAPI
+CompareMem (
+  IN  CONST VOID  *DestinationBuffer,
+  IN  CONST VOID  *SourceBuffer,
+  IN  UINTN       Length
+  )
+{
+  return memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+//
+// Pages are mapped in the low 4GB, where DMA models can reach them, between
+// two inaccessible guard pages that catch overruns.
+//
+VOID *
+EFIAPI
+AllocatePages (
+  IN  UINTN   Pages
+  )
+{
+  UINT8   *Mapping;
+
+  Mapping = mmap (NULL, EFI_PAGES_TO_SIZE (Pages + 2), PROT_NONE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  if (Mapping == MAP_FAILED) {
+    return NULL;
+  }
+
+  if (mprotect (Mapping + EFI_PAGE_SIZE, EFI_PAGES_TO_SIZE (Pages), PROT_READ | PROT_WRITE) != 0) {
+    munmap (Mapping, EFI_PAGES_TO_SIZE (Pages + 2));
+    return NULL;
+  }
+
+  return Mapping + EFI_PAGE_SIZE;
+}
+
+VOID
+EFIAPI
+FreePages (
+  IN  VOID    *Buffer,
+  IN  UINTN   Pages
+  )
+{
+  munmap ((UINT8 *)Buffer - EFI_PAGE_SIZE, EFI_PAGES_TO_SIZE (Pages + 2));
+}
+
+VOID *
+EFIAPI
+WriteBackDataCacheRange (
+  IN  VOID    *Address,
+  IN  UINTN   Length
+  )
+{
+  ++gHostCounters.CacheCleanCount;
+  return Address;
+}
+
+VOID *
+EFIAPI
+InvalidateDataCacheRange (
+  IN  VOID    *Address,
+  IN  UINTN   Length
+  )
+{
+  ++gHostCounters.CacheInvalidateCount;
+  return Address;
+}
+
+STATIC
+EFI_TPL
+EFIAPI
+HostRaiseTpl (
+  IN  EFI_TPL   NewTpl
+  )
+{
+  EFI_TPL   OldTpl;
+
+  if (NewTpl < mTpl) {
+    ++gHostFailCount;
+    HostReportFailure (__FILE__, __LINE__, "RaiseTPL to a lower TPL");
+  }
+  OldTpl = mTpl;
+  mTpl = NewTpl;
+  return OldTpl;
+}
+
+STATIC
+VOID
+EFIAPI
+HostRestoreTpl (
+  IN  EFI_TPL   OldTpl
+  )
+{
+  if (OldTpl > mTpl) {
+    ++gHostFailCount;
+    HostReportFailure (__FILE__, __LINE__, "RestoreTPL to a higher TPL");
+  }
+  mTpl = OldTpl;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction,
+  IN  VOID              *NotifyContext,
+  OUT EFI_EVENT         *Event
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < HOST_EVENT_MAX; ++Index) {
+    if (!mEvent[Index].Open) {
+      mEvent[Index].Open = TRUE;
+      mEvent[Index].Type = Type;
+      mEvent[Index].NotifyTpl = NotifyTpl;
+      mEvent[Index].NotifyFunction = NotifyFunction;
+      mEvent[Index].NotifyContext = NotifyContext;
+      *Event = &mEvent[Index];
+      return EFI_SUCCESS;
+    }
+  }
+  return EFI_OUT_OF_RESOURCES;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostSetTimer (
+  IN  EFI_EVENT         Event,
+  IN  EFI_TIMER_DELAY   Type,
+  IN  UINT64            TriggerTime
+  )
+{
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCloseEvent (
+  IN  EFI_EVENT   Event
+  )
+{
+  HOST_EVENT  *HostEvent;
+
+  HostEvent = Event;
+  if (!HostEvent->Open) {
+    ++gHostFailCount;
+    HostReportFailure (__FILE__, __LINE__, "CloseEvent of a closed event");
+    return EFI_INVALID_PARAMETER;
+  }
+  HostEvent->Open = FALSE;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_BOOT_SERVICES  mBootServices = {
+  HostRaiseTpl,
+  HostRestoreTpl,
+  HostCreateEvent,
+  HostSetTimer,
+  HostCloseEvent
+};
+
+EFI_BOOT_SERVICES  *gBS = &mBootServices;
+
+VOID
+HostSignalEvents (
+  IN  UINT32  Type
+  )
+{
+  UINT32    Index;
+  EFI_TPL   OldTpl;
+
+  for (Index = 0; Index < HOST_EVENT_MAX; ++Index) {
+    if (mEvent[Index].Open && (mEvent[Index].Type == Type)) {
+      OldTpl = HostRaiseTpl (mEvent[Index].NotifyTpl);
+      mEvent[Index].NotifyFunction (&mEvent[Index], mEvent[Index].NotifyContext);
+      HostRestoreTpl (OldTpl);
+    }
+  }
+}
+
+UINT32
+HostOpenEventCount (
+  VOID
+  )
+{
+  UINT32  Count;
+  UINT32  Index;
+
+  Count = 0;
+  for (Index = 0; Index < HOST_EVENT_MAX; ++Index) {
+    if (mEvent[Index].Open) {
+      ++Count;
+    }
+  }
+  return Count;
+}
+
+VOID
+EFIAPI
+DebugPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  ...
+  )
+{
+  CONST CHAR8   *Cursor;
+  CHAR8         HostFormat[256];
+  UINTN         Index;
+  VA_LIST       Marker;
+
+  if (ErrorLevel == DEBUG_ERROR) {
+    ++gHostDebugErrorCount;
+  }
+
+  if (getenv ("HOST_TEST_VERBOSE") == NULL) {
+    return;
+  }
+
+  // Translate the PrintLib conversions that differ from the C library: %a is
+  // an ASCII string and %r a status code.
+  Cursor = Format;
+  Index = 0;
+  while ((*Cursor != '\0') && (Index < sizeof (HostFormat) - 3)) {
+    HostFormat[Index++] = *Cursor;
+    if (*Cursor++ != '%') {
+      continue;
+    }
+    while ((*Cursor != '\0') && (strchr ("-+ #0123456789.", *Cursor) != NULL)) {
+      HostFormat[Index++] = *Cursor++;
+    }
+    if (*Cursor == 'a') {
+      HostFormat[Index++] = 's';
+      ++Cursor;
+    } else if (*Cursor == 'r') {
+      HostFormat[Index++] = 'l';
+      HostFormat[Index++] = 'x';
+      ++Cursor;
+    }
+  }
+  HostFormat[Index] = '\0';
+
+  VA_START (Marker, Format);
+  vprintf (HostFormat, Marker);
+  VA_END (Marker);
+}
+
+VOID
+EFIAPI
+DebugAssert (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  )
+{
+  fprintf (stderr, "ASSERT %s(%lu): %s\n", FileName, (unsigned long)LineNumber, Description);
+  abort ();
+}
+
+VOID
+HostReportFailure (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  )
+{
+  fprintf (stderr, "FAIL %s(%lu): %s\n", FileName, (unsigned long)LineNumber, Description);
+}
+
+INTN
+HostSummary (
+  IN  CONST CHAR8   *Name
+  )
+{
+  printf ("%s: %u checks, %u failed\n", Name, gHostCheckCount, gHostFailCount);
+  return (gHostFailCount == 0) ? 0 : 1;
+}
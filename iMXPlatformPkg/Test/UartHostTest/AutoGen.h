@@ -0,0 +1,41 @@
+/** @file
+*
+*  PCDs of the code under test, the host counterpart of the AutoGen.h
+*  generated by the EDK2 build.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _UART_HOST_TEST_AUTOGEN_H_
+#define _UART_HOST_TEST_AUTOGEN_H_
+
+#include <Base.h>
+
+// The EDK2 AutoGen.h brings PcdLib into every source file
+#include <Library/PcdLib.h>
+
+extern UINT32   gHostPcd_PcdSerialRegisterBase;
+extern UINT32   gHostPcd_PcdSerialClockFrequency;
+extern UINT64   gHostPcd_PcdUartDefaultBaudRate;
+extern UINT8    gHostPcd_PcdUartDefaultDataBits;
+extern UINT8    gHostPcd_PcdUartDefaultParity;
+extern UINT8    gHostPcd_PcdUartDefaultStopBits;
+extern UINT32   gHostPcd_PcdUartDefaultTimeout;
+extern BOOLEAN  gHostPcd_PcdSerialUseHardwareFlowControl;
+extern UINT32   gHostPcd_PcdSerialDmaThreshold;
+extern UINT32   gHostPcd_PcdSerialSdmaRxEvent;
+extern UINT32   gHostPcd_PcdSerialSdmaTxEvent;
+extern UINT32   gHostPcd_PcdSdmaBase;
+extern UINT32   gHostPcd_PcdSdmaMcuToAppScript;
+extern UINT32   gHostPcd_PcdSdmaUartToMcuScript;
+
+#endif
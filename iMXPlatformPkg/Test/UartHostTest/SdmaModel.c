@@ -0,0 +1,492 @@
+/** @file
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXUart.h>
+
+#include "SdmaModel.h"
+
+#define SDMA_MODEL_UART_RXD     0x00
+#define SDMA_MODEL_UART_TXD     0x40
+#define SDMA_MODEL_WINDOW       0x4000
+
+#define SDMA_MODEL_REGISTER(Model, Offset)  \
+  (((UINT32 *)&(Model)->Registers)[(Offset) / sizeof (UINT32)])
+
+STATIC
+VOID
+SdmaModelError (
+  IN  SDMA_MODEL    *Model,
+  IN  CONST CHAR8   *Description
+  )
+{
+  ++Model->ProtocolErrorCount;
+  ++gHostFailCount;
+  HostReportFailure (__FILE__, __LINE__, Description);
+}
+
+STATIC
+IMX_SDMA_CHANNEL_CONTROL *
+SdmaModelCcb (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  return (IMX_SDMA_CHANNEL_CONTROL *)(UINTN)Model->Registers.Mc0Ptr + Channel;
+}
+
+STATIC
+IMX_SDMA_BUFFER_DESCRIPTOR *
+SdmaModelBd (
+  IN  UINT32  Address
+  )
+{
+  return (IMX_SDMA_BUFFER_DESCRIPTOR *)(UINTN)Address;
+}
+
+STATIC
+BOOLEAN
+SdmaModelOwnedByHost (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel,
+  IN  BOOLEAN     EventDriven
+  )
+{
+  UINT32  Bit;
+
+  // A channel the ARM core starts has HOSTOVR and DSPOVR set to 0 and 1. Its
+  // EVTOVR bit is 0 when it also waits for an event, 1 when it does not.
+  Bit = 1U << Channel;
+  return ((Model->Registers.HostOvr & Bit) == 0) &&
+         ((Model->Registers.DspOvr & Bit) != 0) &&
+         (((Model->Registers.EvtOvr & Bit) == 0) == EventDriven);
+}
+
+STATIC
+VOID
+SdmaModelStop (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  Model->Running &= ~(1U << Channel);
+  if ((Channel != 0) && (Model->Registers.Mc0Ptr != 0)) {
+    SdmaModelCcb (Model, Channel)->CurrentBdPointer = Model->CurrentBd[Channel];
+  }
+}
+
+/**
+  Load a channel context into the data memory model.
+
+**/
+STATIC
+VOID
+SdmaModelRunChannel0 (
+  IN  SDMA_MODEL  *Model
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR  *Bd;
+  UINT32                      Channel;
+
+  Model->Running &= ~BIT0;
+  if (Model->Registers.Mc0Ptr == 0) {
+    SdmaModelError (Model, "Channel 0 started without MC0PTR");
+    return;
+  }
+  if (!SdmaModelOwnedByHost (Model, 0, FALSE) || (Model->Registers.ChnPri[0] == 0)) {
+    SdmaModelError (Model, "Channel 0 is not set up to be started by the ARM core");
+    return;
+  }
+  if ((Model->Registers.Chn0Addr & IMX_SDMA_CHN0ADDR_SMSZ) == 0) {
+    SdmaModelError (Model, "Channel 0 started with 24 word contexts");
+    return;
+  }
+
+  Bd = SdmaModelBd (SdmaModelCcb (Model, 0)->CurrentBdPointer);
+  if ((Bd == NULL) || ((Bd->Status & IMX_SDMA_BD_DONE) == 0)) {
+    SdmaModelError (Model, "Channel 0 started without a buffer descriptor");
+    return;
+  }
+  if ((Bd->Command != IMX_SDMA_BD_COMMAND_SETDM) ||
+      (Bd->Count != sizeof (IMX_SDMA_CONTEXT) / sizeof (UINT32)) ||
+      (Bd->ExtBufferAddress < IMX_SDMA_CONTEXT_ADDRESS (0)) ||
+      (Bd->ExtBufferAddress >= IMX_SDMA_CONTEXT_ADDRESS (IMX_SDMA_CHANNEL_COUNT)) ||
+      ((Bd->ExtBufferAddress - IMX_SDMA_CONTEXT_ADDRESS (0)) % 32 != 0)) {
+    SdmaModelError (Model, "Channel 0 command is not a context load");
+    Bd->Status = (Bd->Status & ~IMX_SDMA_BD_DONE) | IMX_SDMA_BD_ERROR;
+    return;
+  }
+
+  Channel = (Bd->ExtBufferAddress - IMX_SDMA_CONTEXT_ADDRESS (0)) / 32;
+  CopyMem (&Model->Context[Channel], (VOID *)(UINTN)Bd->BufferAddress, sizeof (IMX_SDMA_CONTEXT));
+  Model->Loaded[Channel] = TRUE;
+  ++Model->ContextLoadCount;
+
+  Bd->Status &= ~IMX_SDMA_BD_DONE;
+  Model->Registers.Intr |= BIT0;
+}
+
+STATIC
+BOOLEAN
+SdmaModelIsTx (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  return (Model->Context[Channel].ChannelState[0] & IMX_SDMA_CONTEXT_PC_MASK) ==
+         Model->McuToAppScript;
+}
+
+STATIC
+UINT32
+SdmaModelEventMask (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel,
+  IN  UINT32      Event
+  )
+{
+  return (Event >= 32) ? Model->Context[Channel].GeneralRegister[0] & (1U << (Event - 32)) :
+                         Model->Context[Channel].GeneralRegister[1] & (1U << Event);
+}
+
+/**
+  Start a peripheral channel on the buffer descriptor its channel control
+  block points to.
+
+**/
+STATIC
+VOID
+SdmaModelStart (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR  *Bd;
+  IMX_SDMA_CONTEXT            *Context;
+  UINT32                      Event;
+  UINT32                      FifoAddress;
+  UINT32                      Pc;
+
+  // Starting a running channel has no effect
+  if ((Model->Running & (1U << Channel)) != 0) {
+    return;
+  }
+
+  if (Model->Registers.Mc0Ptr == 0) {
+    SdmaModelError (Model, "Channel started without MC0PTR");
+    return;
+  }
+  if (!Model->Loaded[Channel]) {
+    SdmaModelError (Model, "Channel started without a context");
+    return;
+  }
+
+  Context = &Model->Context[Channel];
+  Pc = Context->ChannelState[0] & IMX_SDMA_CONTEXT_PC_MASK;
+  if (Pc == Model->McuToAppScript) {
+    Event = Model->TxEvent;
+    FifoAddress = (UINT32)Model->Uart->Base + SDMA_MODEL_UART_TXD;
+  } else if (Pc == Model->UartToMcuScript) {
+    Event = Model->RxEvent;
+    FifoAddress = (UINT32)Model->Uart->Base + SDMA_MODEL_UART_RXD;
+  } else {
+    SdmaModelError (Model, "Channel context runs an unknown script");
+    return;
+  }
+
+  if ((SdmaModelEventMask (Model, Channel, Event) == 0) ||
+      ((Model->Registers.ChnEnbl[Event] & (1U << Channel)) == 0)) {
+    SdmaModelError (Model, "Channel is not triggered by the UART event");
+  }
+  if (Context->GeneralRegister[2] != FifoAddress) {
+    SdmaModelError (Model, "Channel context has the wrong FIFO address");
+  }
+  if (Context->GeneralRegister[7] == 0) {
+    SdmaModelError (Model, "Channel context has no watermark");
+  }
+  if (!SdmaModelOwnedByHost (Model, Channel, TRUE)) {
+    SdmaModelError (Model, "Channel is not set up to be started by the ARM core");
+  }
+  if (Model->Registers.ChnPri[Channel] == 0) {
+    SdmaModelError (Model, "Channel started with priority 0");
+  }
+
+  Model->CurrentBd[Channel] = SdmaModelCcb (Model, Channel)->CurrentBdPointer;
+  Model->BdOffset[Channel] = 0;
+  Bd = SdmaModelBd (Model->CurrentBd[Channel]);
+  if ((Bd == NULL) || ((Bd->Status & IMX_SDMA_BD_DONE) == 0)) {
+    SdmaModelError (Model, "Channel started on a buffer descriptor it does not own");
+    return;
+  }
+  if (Bd->Command != IMX_SDMA_BD_COMMAND_WIDTH_8) {
+    SdmaModelError (Model, "UART buffer descriptor is not 8 bits wide");
+  }
+
+  Model->Running |= 1U << Channel;
+}
+
+/**
+  Hand the current buffer descriptor back to the ARM core and move on to the
+  next one, stopping when the SDMA does not own it.
+
+**/
+STATIC
+VOID
+SdmaModelCompleteBd (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR  *Bd;
+  UINT8                       Status;
+
+  Bd = SdmaModelBd (Model->CurrentBd[Channel]);
+  Status = Bd->Status;
+  Bd->Count = (UINT16)Model->BdOffset[Channel];
+  Bd->Status = Status & ~IMX_SDMA_BD_DONE;
+  if ((Status & IMX_SDMA_BD_INTR) != 0) {
+    Model->Registers.Intr |= 1U << Channel;
+  }
+
+  if ((Status & IMX_SDMA_BD_WRAP) != 0) {
+    Model->CurrentBd[Channel] = SdmaModelCcb (Model, Channel)->BaseBdPointer;
+  } else {
+    Model->CurrentBd[Channel] += sizeof (IMX_SDMA_BUFFER_DESCRIPTOR);
+  }
+  Model->BdOffset[Channel] = 0;
+
+  if (((Status & IMX_SDMA_BD_CONT) == 0) ||
+      ((SdmaModelBd (Model->CurrentBd[Channel])->Status & IMX_SDMA_BD_DONE) == 0)) {
+    SdmaModelStop (Model, Channel);
+  }
+}
+
+/**
+  mcu_2_app: a burst from the buffer to UTXD per transmit request.
+
+**/
+STATIC
+VOID
+SdmaModelRunTx (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  IMX_SDMA_BUFFER_DESCRIPTOR  *Bd;
+  UINT8                       *Buffer;
+  UINT32                      Burst;
+
+  while (((Model->Running & (1U << Channel)) != 0) && UartModelTxDmaRequest (Model->Uart)) {
+    Bd = SdmaModelBd (Model->CurrentBd[Channel]);
+    Buffer = (UINT8 *)(UINTN)Bd->BufferAddress;
+    for (Burst = Model->Context[Channel].GeneralRegister[7];
+         (Burst > 0) && (Model->BdOffset[Channel] < Bd->Count);
+         --Burst) {
+      UartModelDmaWrite (Model->Uart, Buffer[Model->BdOffset[Channel]++]);
+      ++Model->DmaTxByteCount;
+    }
+
+    if (Model->BdOffset[Channel] == Bd->Count) {
+      SdmaModelCompleteBd (Model, Channel);
+    }
+  }
+}
+
+/**
+  uart_2_mcu: a burst from URXD to the buffer per receive request. An aging
+  request empties the FIFO and closes the buffer early.
+
+**/
+STATIC
+VOID
+SdmaModelRunRx (
+  IN  SDMA_MODEL  *Model,
+  IN  UINT32      Channel
+  )
+{
+  BOOLEAN                     Aging;
+  IMX_SDMA_BUFFER_DESCRIPTOR  *Bd;
+  UINT8                       *Buffer;
+  UINT32                      Burst;
+  UINT32                      Data;
+
+  while (((Model->Running & (1U << Channel)) != 0) &&
+         UartModelRxDmaRequest (Model->Uart, &Aging)) {
+    Bd = SdmaModelBd (Model->CurrentBd[Channel]);
+    Buffer = (UINT8 *)(UINTN)Bd->BufferAddress;
+    Burst = Aging ? Model->Uart->RxCount : Model->Context[Channel].GeneralRegister[7];
+    for (; (Burst > 0) && (Model->BdOffset[Channel] < Bd->Count); --Burst) {
+      Data = UartModelDmaRead (Model->Uart);
+      if ((Data & MX6UART_RXD_ERR) != 0) {
+        Bd->Status |= IMX_SDMA_BD_ERROR;
+      }
+      Buffer[Model->BdOffset[Channel]++] = (UINT8)Data;
+      ++Model->DmaRxByteCount;
+    }
+
+    if (Aging || (Model->BdOffset[Channel] == Bd->Count)) {
+      SdmaModelCompleteBd (Model, Channel);
+    }
+  }
+}
+
+STATIC
+VOID
+SdmaModelTick (
+  IN  VOID    *Context,
+  IN  UINT64  NowInNs
+  )
+{
+  UINT32      Channel;
+  UINT32      Event;
+  SDMA_MODEL  *Model;
+
+  Model = Context;
+
+  if (Model->Channel0Pending) {
+    Model->Channel0Pending = FALSE;
+    SdmaModelRunChannel0 (Model);
+  }
+
+  if (Model->Registers.Mc0Ptr == 0) {
+    return;
+  }
+
+  for (Channel = 1; Channel < IMX_SDMA_CHANNEL_COUNT; ++Channel) {
+    if (((Model->Running & (1U << Channel)) == 0) || (Model->Registers.ChnPri[Channel] == 0)) {
+      continue;
+    }
+
+    Event = SdmaModelIsTx (Model, Channel) ? Model->TxEvent : Model->RxEvent;
+    if ((Model->Registers.ChnEnbl[Event] & (1U << Channel)) == 0) {
+      continue;
+    }
+
+    if (SdmaModelIsTx (Model, Channel)) {
+      SdmaModelRunTx (Model, Channel);
+    } else {
+      SdmaModelRunRx (Model, Channel);
+    }
+  }
+}
+
+STATIC
+UINT32
+SdmaModelRead (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width
+  )
+{
+  SDMA_MODEL  *Model;
+
+  Model = Context;
+  if ((Width != 4) || (Offset >= sizeof (IMX_SDMA_REGISTERS))) {
+    SdmaModelError (Model, "Read of an unknown SDMA register");
+    return 0;
+  }
+
+  switch (Offset) {
+  case OFFSET_OF (IMX_SDMA_REGISTERS, StopStat):
+  case OFFSET_OF (IMX_SDMA_REGISTERS, HStart):
+    return Model->Running;
+  default:
+    return SDMA_MODEL_REGISTER (Model, Offset);
+  }
+}
+
+STATIC
+VOID
+SdmaModelWrite (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width,
+  IN  UINT32  Value
+  )
+{
+  UINT32      Channel;
+  SDMA_MODEL  *Model;
+
+  Model = Context;
+  if ((Width != 4) || (Offset >= sizeof (IMX_SDMA_REGISTERS))) {
+    SdmaModelError (Model, "Write of an unknown SDMA register");
+    return;
+  }
+
+  switch (Offset) {
+  case OFFSET_OF (IMX_SDMA_REGISTERS, Intr):
+    Model->Registers.Intr &= ~Value;
+    break;
+  case OFFSET_OF (IMX_SDMA_REGISTERS, StopStat):
+    for (Channel = 0; Channel < IMX_SDMA_CHANNEL_COUNT; ++Channel) {
+      if ((Value & (1U << Channel) & Model->Running) != 0) {
+        SdmaModelStop (Model, Channel);
+      }
+    }
+    break;
+  case OFFSET_OF (IMX_SDMA_REGISTERS, HStart):
+    // Channel 0 runs on the next tick, so its start can be observed
+    if ((Value & BIT0) != 0) {
+      Model->Running |= BIT0;
+      Model->Channel0Pending = TRUE;
+    }
+    for (Channel = 1; Channel < IMX_SDMA_CHANNEL_COUNT; ++Channel) {
+      if ((Value & (1U << Channel)) != 0) {
+        SdmaModelStart (Model, Channel);
+      }
+    }
+    break;
+  case OFFSET_OF (IMX_SDMA_REGISTERS, Mc0Ptr):
+    if ((Model->Running & ~BIT0) != 0) {
+      SdmaModelError (Model, "MC0PTR changed while channels are running");
+    }
+    Model->Registers.Mc0Ptr = Value;
+    break;
+  default:
+    SDMA_MODEL_REGISTER (Model, Offset) = Value;
+    break;
+  }
+}
+
+/**
+  Reset the model to the state left by the boot ROM: MC0PTR clear, no channel
+  enabled and the ROM scripts at the given addresses.
+
+**/
+VOID
+SdmaModelInitialize (
+  OUT SDMA_MODEL  *Model,
+  IN  UINTN       Base,
+  IN  UART_MODEL  *Uart,
+  IN  UINT32      McuToAppScript,
+  IN  UINT32      UartToMcuScript,
+  IN  UINT32      TxEvent,
+  IN  UINT32      RxEvent
+  )
+{
+  ZeroMem (Model, sizeof (*Model));
+  Model->Base = Base;
+  Model->Uart = Uart;
+  Model->McuToAppScript = McuToAppScript;
+  Model->UartToMcuScript = UartToMcuScript;
+  Model->TxEvent = TxEvent;
+  Model->RxEvent = RxEvent;
+
+  HostMmioRegister (Base, SDMA_MODEL_WINDOW, Model, SdmaModelRead, SdmaModelWrite, SdmaModelTick);
+}
@@ -0,0 +1,71 @@
+/** @file
+*
+*  Behavioral model of the i.MX SDMA running the UART ROM scripts.
+*
+*  Channel 0 loads channel contexts into a model of the SDMA data memory. The
+*  other channels run the mcu_2_app and uart_2_mcu scripts on their buffer
+*  descriptors, moving a burst per UART DMA request. The model catches the
+*  setup mistakes that leave a channel silent on hardware: a wrong script or
+*  FIFO address in the context, a channel without priority or event, channel
+*  ownership not set to the ARM core, and descriptors the SDMA does not own.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _SDMA_MODEL_H_
+#define _SDMA_MODEL_H_
+
+#include <Base.h>
+#include <iMXSdma.h>
+
+#include "UartModel.h"
+
+typedef struct {
+  UINTN               Base;
+  UART_MODEL          *Uart;
+  UINT32              McuToAppScript;
+  UINT32              UartToMcuScript;
+  UINT32              TxEvent;
+  UINT32              RxEvent;
+
+  IMX_SDMA_REGISTERS  Registers;
+  UINT32              Running;
+  BOOLEAN             Channel0Pending;
+
+  //
+  // Per channel state. Loaded marks contexts written by channel 0, CurrentBd
+  // is the descriptor the channel works on and BdOffset the bytes already
+  // moved to or from its buffer.
+  //
+  BOOLEAN             Loaded[IMX_SDMA_CHANNEL_COUNT];
+  IMX_SDMA_CONTEXT    Context[IMX_SDMA_CHANNEL_COUNT];
+  UINT32              CurrentBd[IMX_SDMA_CHANNEL_COUNT];
+  UINT32              BdOffset[IMX_SDMA_CHANNEL_COUNT];
+
+  UINT64              ContextLoadCount;
+  UINT64              DmaTxByteCount;
+  UINT64              DmaRxByteCount;
+  UINT32              ProtocolErrorCount;
+} SDMA_MODEL;
+
+VOID
+SdmaModelInitialize (
+  OUT SDMA_MODEL  *Model,
+  IN  UINTN       Base,
+  IN  UART_MODEL  *Uart,
+  IN  UINT32      McuToAppScript,
+  IN  UINT32      UartToMcuScript,
+  IN  UINT32      TxEvent,
+  IN  UINT32      RxEvent
+  );
+
+#endif
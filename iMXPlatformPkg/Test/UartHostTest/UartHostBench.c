@@ -0,0 +1,278 @@
+/** @file
+*
+*  Host benchmark of UartSerialPortLib against the UART model.
+*
+*  The simulated time is what the transfer would take on the target. Line
+*  usage compares it to the time the characters need on the wire, the status
+*  reads per byte show how much of it the CPU spends polling the FIFO. The
+*  host time only measures the cost of the model.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <stdio.h>
+#include <time.h>
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SerialPortLib.h>
+
+#include <HostLib.h>
+#include <iMXUart.h>
+
+#include "SdmaModel.h"
+#include "UartModel.h"
+#include "UartSerialPortLib.h"
+
+#define BENCH_UART_BASE         0x02020000
+#define BENCH_UART_CLOCK        80000000
+#define BENCH_SDMA_BASE         0x020EC000
+#define BENCH_PAYLOAD_SIZE      4096
+
+UINT32  gHostPcd_PcdSerialRegisterBase = BENCH_UART_BASE;
+UINT32  gHostPcd_PcdSerialClockFrequency = BENCH_UART_CLOCK;
+UINT64  gHostPcd_PcdUartDefaultBaudRate = 115200;
+UINT8   gHostPcd_PcdUartDefaultDataBits = 8;
+UINT8   gHostPcd_PcdUartDefaultParity = NoParity;
+UINT8   gHostPcd_PcdUartDefaultStopBits = OneStopBit;
+UINT32  gHostPcd_PcdUartDefaultTimeout = 1000000;
+BOOLEAN gHostPcd_PcdSerialUseHardwareFlowControl = FALSE;
+UINT32  gHostPcd_PcdSerialDmaThreshold = 256;
+UINT32  gHostPcd_PcdSerialSdmaRxEvent = 25;
+UINT32  gHostPcd_PcdSerialSdmaTxEvent = 26;
+UINT32  gHostPcd_PcdSdmaBase = BENCH_SDMA_BASE;
+UINT32  gHostPcd_PcdSdmaMcuToAppScript = 747;
+UINT32  gHostPcd_PcdSdmaUartToMcuScript = 817;
+
+STATIC UART_MODEL   mModel;
+STATIC SDMA_MODEL   mSdmaModel;
+STATIC UINT8        mBuffer[BENCH_PAYLOAD_SIZE];
+
+typedef
+UINTN
+(*BENCH_FUNCTION) (
+  VOID
+  );
+
+STATIC
+UINTN
+BenchWrite (
+  VOID
+  )
+{
+  UINTN   Length;
+
+  Length = SerialPortWrite (mBuffer, BENCH_PAYLOAD_SIZE);
+  while ((mModel.TxCount != 0) || mModel.TxShifting) {
+    HostAdvance (UartModelCharacterTime (&mModel));
+  }
+  return (mModel.OutputCount == BENCH_PAYLOAD_SIZE) ? Length : 0;
+}
+
+STATIC
+UINTN
+BenchWriteSingle (
+  VOID
+  )
+{
+  // A reserved watermark makes the library check TXFULL for every byte
+  mModel.Ufcr &= ~MX6UART_UFCR_TXTL_MASK;
+  return BenchWrite ();
+}
+
+//
+// Non blocking refill from a periodic timer, as the DXE transmit ring does.
+// The timer period leaves the FIFO half empty between calls.
+//
+STATIC
+UINTN
+BenchWriteTimer (
+  VOID
+  )
+{
+  UINTN   Length;
+
+  Length = 0;
+  while (Length < BENCH_PAYLOAD_SIZE) {
+    Length += UartSerialPortWriteFifo (mBuffer + Length, BENCH_PAYLOAD_SIZE - Length, FALSE);
+    HostAdvance (UartModelCharacterTime (&mModel) * MX6UART_FIFO_COUNT / 2);
+  }
+  while ((mModel.TxCount != 0) || mModel.TxShifting) {
+    HostAdvance (UartModelCharacterTime (&mModel));
+  }
+  return (mModel.OutputCount == BENCH_PAYLOAD_SIZE) ? Length : 0;
+}
+
+STATIC
+UINTN
+BenchWriteTimerSingle (
+  VOID
+  )
+{
+  mModel.Ufcr &= ~MX6UART_UFCR_TXTL_MASK;
+  return BenchWriteTimer ();
+}
+
+STATIC
+UINTN
+BenchRead (
+  VOID
+  )
+{
+  UINTN   Length;
+
+  UartModelReceive (&mModel, mBuffer, BENCH_PAYLOAD_SIZE);
+  Length = 0;
+  while ((Length < BENCH_PAYLOAD_SIZE) && (mModel.OverrunCount == 0)) {
+    if (SerialPortPoll ()) {
+      Length += SerialPortRead (mBuffer + Length, BENCH_PAYLOAD_SIZE - Length);
+    }
+  }
+  return Length;
+}
+
+//
+// The models only interact between ticks, so the SDMA benchmarks advance one
+// character time at a time and poll every 16 characters, about the period of
+// the DXE timer events at 115200 baud.
+//
+STATIC
+VOID
+BenchAdvance (
+  IN  UINT32  Count
+  )
+{
+  while (Count-- > 0) {
+    HostAdvance (UartModelCharacterTime (&mModel));
+  }
+}
+
+STATIC
+UINTN
+BenchWriteSdma (
+  VOID
+  )
+{
+  UINT8   *Buffer;
+  UINTN   Length;
+
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (BENCH_PAYLOAD_SIZE));
+  CopyMem (Buffer, mBuffer, BENCH_PAYLOAD_SIZE);
+  Length = 0;
+  if (UartSdmaInitialize () == RETURN_SUCCESS) {
+    Length = UartSdmaTxStart (Buffer, BENCH_PAYLOAD_SIZE);
+    do {
+      BenchAdvance (16);
+    } while (!UartSdmaTxDone ());
+    while ((mModel.TxCount != 0) || mModel.TxShifting) {
+      BenchAdvance (1);
+    }
+    UartSdmaUninitialize ();
+  }
+  FreePages (Buffer, EFI_SIZE_TO_PAGES (BENCH_PAYLOAD_SIZE));
+  return (mModel.OutputCount == BENCH_PAYLOAD_SIZE) ? Length : 0;
+}
+
+STATIC
+UINTN
+BenchReadSdma (
+  VOID
+  )
+{
+  UINTN   Length;
+
+  if ((UartSdmaInitialize () != RETURN_SUCCESS) || (UartSdmaRxStart () != RETURN_SUCCESS)) {
+    return 0;
+  }
+
+  UartModelReceive (&mModel, mBuffer, BENCH_PAYLOAD_SIZE);
+  Length = 0;
+  while ((Length < BENCH_PAYLOAD_SIZE) && (mModel.OverrunCount == 0)) {
+    BenchAdvance (16);
+    Length += UartSdmaRxRead (mBuffer + Length, BENCH_PAYLOAD_SIZE - Length, NULL);
+  }
+  UartSdmaUninitialize ();
+  return Length;
+}
+
+STATIC
+VOID
+BenchRun (
+  IN  CONST CHAR8     *Name,
+  IN  BENCH_FUNCTION  Function,
+  IN  UINT32          BaudRate
+  )
+{
+  UINT64            HostInNs;
+  UINT64            LineInNs;
+  UINT64            SimulatedInNs;
+  struct timespec   Start;
+  struct timespec   Stop;
+
+  HostReset ();
+  UartModelInitialize (&mModel, BENCH_UART_BASE, BENCH_UART_CLOCK, BaudRate);
+  SdmaModelInitialize (&mSdmaModel, BENCH_SDMA_BASE, &mModel,
+                       gHostPcd_PcdSdmaMcuToAppScript, gHostPcd_PcdSdmaUartToMcuScript,
+                       gHostPcd_PcdSerialSdmaTxEvent, gHostPcd_PcdSerialSdmaRxEvent);
+  SerialPortInitialize ();
+  SetMem (mBuffer, sizeof (mBuffer), 0x55);
+  ZeroMem (&gHostCounters, sizeof (gHostCounters));
+  mModel.StatusReadCount = 0;
+
+  clock_gettime (CLOCK_MONOTONIC, &Start);
+  if (Function () != BENCH_PAYLOAD_SIZE) {
+    printf ("%-18s %7u failed, %u overruns\n", Name, BaudRate, mModel.OverrunCount);
+    return;
+  }
+  clock_gettime (CLOCK_MONOTONIC, &Stop);
+
+  HostInNs = (Stop.tv_sec - Start.tv_sec) * 1000000000ULL + Stop.tv_nsec - Start.tv_nsec;
+  SimulatedInNs = HostNow ();
+  LineInNs = UartModelCharacterTime (&mModel) * BENCH_PAYLOAD_SIZE;
+
+  printf ("%-18s %7u baud %9.0f bytes/s  line %5.1f%%  mmio %8.1f/byte  status %8.1f/byte  host %8.1f us\n",
+          Name,
+          BaudRate,
+          BENCH_PAYLOAD_SIZE * 1e9 / SimulatedInNs,
+          100.0 * LineInNs / SimulatedInNs,
+          (double)(gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount) / BENCH_PAYLOAD_SIZE,
+          (double)mModel.StatusReadCount / BENCH_PAYLOAD_SIZE,
+          HostInNs / 1000.0);
+  if ((mModel.ProtocolErrorCount != 0) || (mSdmaModel.ProtocolErrorCount != 0)) {
+    printf ("%-18s %u protocol errors\n", Name,
+            mModel.ProtocolErrorCount + mSdmaModel.ProtocolErrorCount);
+  }
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  STATIC CONST UINT32 Rates[] = { 115200, 921600, 4000000 };
+  UINT32              Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Rates); ++Index) {
+    BenchRun ("Write4K", BenchWrite, Rates[Index]);
+    BenchRun ("WriteSingle4K", BenchWriteSingle, Rates[Index]);
+    BenchRun ("WriteTimer4K", BenchWriteTimer, Rates[Index]);
+    BenchRun ("WriteTimerSingle4K", BenchWriteTimerSingle, Rates[Index]);
+    BenchRun ("WriteSdma4K", BenchWriteSdma, Rates[Index]);
+    BenchRun ("Read4K", BenchRead, Rates[Index]);
+    BenchRun ("ReadSdma4K", BenchReadSdma, Rates[Index]);
+  }
+  return 0;
+}
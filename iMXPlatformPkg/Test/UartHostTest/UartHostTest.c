@@ -0,0 +1,697 @@
+/** @file
+*
+*  Host functional tests of UartSerialPortLib against the UART model.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/TimerLib.h>
+
+#include <HostLib.h>
+#include <iMXUart.h>
+
+#include "SdmaModel.h"
+#include "UartModel.h"
+#include "UartSerialPortLib.h"
+
+#define TEST_UART_BASE          0x02020000
+#define TEST_UART_CLOCK         80000000
+#define TEST_UART_BAUD_RATE     115200
+#define TEST_SDMA_BASE          0x020EC000
+#define TEST_SDMA_THRESHOLD     64
+
+UINT32  gHostPcd_PcdSerialRegisterBase = TEST_UART_BASE;
+UINT32  gHostPcd_PcdSerialClockFrequency = TEST_UART_CLOCK;
+UINT64  gHostPcd_PcdUartDefaultBaudRate = TEST_UART_BAUD_RATE;
+UINT8   gHostPcd_PcdUartDefaultDataBits = 8;
+UINT8   gHostPcd_PcdUartDefaultParity = NoParity;
+UINT8   gHostPcd_PcdUartDefaultStopBits = OneStopBit;
+UINT32  gHostPcd_PcdUartDefaultTimeout = 1000000;
+BOOLEAN gHostPcd_PcdSerialUseHardwareFlowControl = FALSE;
+UINT32  gHostPcd_PcdSerialDmaThreshold = TEST_SDMA_THRESHOLD;
+UINT32  gHostPcd_PcdSerialSdmaRxEvent = 25;
+UINT32  gHostPcd_PcdSerialSdmaTxEvent = 26;
+UINT32  gHostPcd_PcdSdmaBase = TEST_SDMA_BASE;
+UINT32  gHostPcd_PcdSdmaMcuToAppScript = 747;
+UINT32  gHostPcd_PcdSdmaUartToMcuScript = 817;
+
+STATIC UART_MODEL   mModel;
+STATIC SDMA_MODEL   mSdmaModel;
+STATIC UINT8        mPattern[1024];
+
+STATIC
+VOID
+TestSetup (
+  VOID
+  )
+{
+  UINT32  Index;
+
+  HostReset ();
+  UartModelInitialize (&mModel, TEST_UART_BASE, TEST_UART_CLOCK, TEST_UART_BAUD_RATE);
+  SdmaModelInitialize (&mSdmaModel, TEST_SDMA_BASE, &mModel,
+                       gHostPcd_PcdSdmaMcuToAppScript, gHostPcd_PcdSdmaUartToMcuScript,
+                       gHostPcd_PcdSerialSdmaTxEvent, gHostPcd_PcdSerialSdmaRxEvent);
+  HOST_CHECK (SerialPortInitialize () == RETURN_SUCCESS);
+  for (Index = 0; Index < sizeof (mPattern); ++Index) {
+    mPattern[Index] = (UINT8)(Index * 7 + 3);
+  }
+}
+
+//
+// Let the line run until the transmitter is idle, or give up after Limit
+// character times.
+//
+STATIC
+VOID
+TestWaitIdle (
+  IN  UINT32  Limit
+  )
+{
+  while ((Limit-- > 0) && ((mModel.TxCount != 0) || mModel.TxShifting)) {
+    HostAdvance (UartModelCharacterTime (&mModel));
+  }
+}
+
+STATIC
+VOID
+TestInitialize (
+  VOID
+  )
+{
+  TestSetup ();
+  HOST_CHECK (((mModel.Ufcr & MX6UART_UFCR_TXTL_MASK) >> MX6UART_UFCR_TXTL_SHIFT) ==
+              MX6UART_TX_WATERMARK_MIN);
+
+  // The boot loader is expected to have enabled the UART
+  mModel.Ucr1 &= ~MX6UART_UCR1_UARTEN;
+  HOST_CHECK (SerialPortInitialize () == RETURN_DEVICE_ERROR);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestWrite (
+  VOID
+  )
+{
+  UINT32  Length;
+  UINT32  Watermark;
+
+  // Per byte TXFULL writes for the reserved watermarks 0 and 1, burst writes
+  // below the TRDY watermark once SerialPortInitialize set it
+  for (Watermark = 0; Watermark < 3; ++Watermark) {
+    for (Length = 1; Length <= 100; Length += 33) {
+      TestSetup ();
+      if (Watermark < 2) {
+        mModel.Ufcr = (mModel.Ufcr & ~MX6UART_UFCR_TXTL_MASK) |
+                      (Watermark << MX6UART_UFCR_TXTL_SHIFT);
+      }
+      HOST_CHECK (SerialPortWrite (mPattern, Length) == Length);
+      TestWaitIdle (Length + 1);
+      HOST_CHECK (mModel.OutputCount == Length);
+      HOST_CHECK (CompareMem (mModel.Output, mPattern, Length) == 0);
+      HOST_CHECK (mModel.ProtocolErrorCount == 0);
+      HOST_CHECK (gHostCounters.UnmappedCount == 0);
+    }
+  }
+
+  // Without waiting only what fits below the watermark is queued
+  TestSetup ();
+  Length = (UINT32)UartSerialPortWriteFifo (mPattern, 100, FALSE);
+  HOST_CHECK (Length == MX6UART_FIFO_COUNT - MX6UART_TX_WATERMARK_MIN);
+  Length += (UINT32)UartSerialPortWriteFifo (mPattern + Length, 100 - Length, FALSE);
+  HOST_CHECK (Length == MX6UART_FIFO_COUNT - MX6UART_TX_WATERMARK_MIN);
+  TestWaitIdle (Length + 1);
+  HOST_CHECK (mModel.OutputCount == Length);
+  HOST_CHECK (CompareMem (mModel.Output, mPattern, Length) == 0);
+
+  // Checking TXFULL fills the FIFO, the first character already moved to the
+  // shift register
+  TestSetup ();
+  mModel.Ufcr &= ~MX6UART_UFCR_TXTL_MASK;
+  Length = (UINT32)UartSerialPortWriteFifo (mPattern, 100, FALSE);
+  HOST_CHECK (Length == MX6UART_FIFO_COUNT + 1);
+  TestWaitIdle (Length + 1);
+  HOST_CHECK (mModel.OutputCount == Length);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+
+  // A peer holding RTS_B stops the output without losing characters
+  TestSetup ();
+  mModel.Ufcr &= ~MX6UART_UFCR_TXTL_MASK;
+  mModel.TxStall = TRUE;
+  Length = (UINT32)UartSerialPortWriteFifo (mPattern, 100, FALSE);
+  HOST_CHECK (Length == MX6UART_FIFO_COUNT);
+  HostAdvance (10 * UartModelCharacterTime (&mModel));
+  HOST_CHECK (mModel.OutputCount == 0);
+  mModel.TxStall = FALSE;
+  TestWaitIdle (Length + 1);
+  HOST_CHECK (mModel.OutputCount == Length);
+  HOST_CHECK (CompareMem (mModel.Output, mPattern, Length) == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestRead (
+  VOID
+  )
+{
+  UINT8   Buffer[64];
+  UINT32  Errors;
+  UINTN   Length;
+
+  TestSetup ();
+  HOST_CHECK (!SerialPortPoll ());
+  HOST_CHECK (SerialPortRead (Buffer, sizeof (Buffer)) == 0);
+
+  UartModelReceive (&mModel, mPattern, 20);
+  HostAdvance (20 * UartModelCharacterTime (&mModel));
+  HOST_CHECK (SerialPortPoll ());
+  SetMem (Buffer, sizeof (Buffer), 0xEE);
+  Length = SerialPortRead (Buffer, 8);
+  HOST_CHECK (Length == 8);
+  Length += SerialPortRead (Buffer + Length, sizeof (Buffer) - Length);
+  HOST_CHECK (Length == 20);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 20) == 0);
+  HOST_CHECK (Buffer[20] == 0xEE);
+  HOST_CHECK (!SerialPortPoll ());
+
+  // Characters received while the FIFO is full are lost and reported once
+  TestSetup ();
+  UartModelReceive (&mModel, mPattern, 40);
+  HostAdvance (40 * UartModelCharacterTime (&mModel));
+  HOST_CHECK (mModel.OverrunCount == 40 - MX6UART_FIFO_COUNT);
+  Length = UartSerialPortReadFifo (Buffer, sizeof (Buffer), &Errors);
+  HOST_CHECK (Length == MX6UART_FIFO_COUNT);
+  HOST_CHECK (CompareMem (Buffer, mPattern, MX6UART_FIFO_COUNT) == 0);
+  HOST_CHECK ((Errors & MX6UART_RXD_OVRRUN) != 0);
+  HOST_CHECK (!mModel.Overrun);
+
+  UartModelReceive (&mModel, mPattern, 4);
+  HostAdvance (4 * UartModelCharacterTime (&mModel));
+  Length = UartSerialPortReadFifo (Buffer, sizeof (Buffer), &Errors);
+  HOST_CHECK (Length == 4);
+  HOST_CHECK (Errors == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestSetAttributes (
+  VOID
+  )
+{
+  UINT64              BaudRate;
+  UINT8               DataBits;
+  UINT32              Index;
+  EFI_PARITY_TYPE     Parity;
+  UINT32              ReceiveFifoDepth;
+  RETURN_STATUS       Status;
+  EFI_STOP_BITS_TYPE  StopBits;
+  UINT32              Timeout;
+  UINT32              Ubir;
+  UINT32              Ubmr;
+  UINT32              Ucr2;
+  UINT32              Ufcr;
+
+  STATIC CONST UINT64 Rates[] = { 300, 9600, 115200, 921600, 1500000, 4000000 };
+
+  // The achieved rate is reported back and within 0.5% of the request
+  for (Index = 0; Index < ARRAY_SIZE (Rates); ++Index) {
+    TestSetup ();
+    BaudRate = Rates[Index];
+    ReceiveFifoDepth = 0;
+    Timeout = 0;
+    Parity = DefaultParity;
+    DataBits = 0;
+    StopBits = DefaultStopBits;
+    Status = SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                      &Parity, &DataBits, &StopBits);
+    HOST_CHECK (Status == RETURN_SUCCESS);
+    HOST_CHECK (BaudRate == UartModelBaudRate (&mModel));
+    HOST_CHECK (BaudRate * 200 >= Rates[Index] * 199);
+    HOST_CHECK (BaudRate * 200 <= Rates[Index] * 201);
+    HOST_CHECK (ReceiveFifoDepth == MX6UART_FIFO_COUNT);
+    HOST_CHECK (Timeout == gHostPcd_PcdUartDefaultTimeout);
+    HOST_CHECK (Parity == NoParity);
+    HOST_CHECK (DataBits == 8);
+    HOST_CHECK (StopBits == OneStopBit);
+
+    HOST_CHECK (SerialPortWrite (mPattern, 8) == 8);
+    TestWaitIdle (9);
+    HOST_CHECK (CompareMem (mModel.Output, mPattern, 8) == 0);
+  }
+
+  TestSetup ();
+  BaudRate = 57600;
+  ReceiveFifoDepth = 8;
+  Timeout = 0;
+  Parity = OddParity;
+  DataBits = 7;
+  StopBits = TwoStopBits;
+  Status = SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                    &Parity, &DataBits, &StopBits);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK ((mModel.Ucr2 & MX6UART_UCR2_WS) == 0);
+  HOST_CHECK ((mModel.Ucr2 & (MX6UART_UCR2_PREN | MX6UART_UCR2_PROE)) ==
+              (MX6UART_UCR2_PREN | MX6UART_UCR2_PROE));
+  HOST_CHECK ((mModel.Ucr2 & MX6UART_UCR2_STPB) != 0);
+  HOST_CHECK ((mModel.Ucr2 & (MX6UART_UCR2_TXEN | MX6UART_UCR2_RXEN)) ==
+              (MX6UART_UCR2_TXEN | MX6UART_UCR2_RXEN));
+  HOST_CHECK ((mModel.Ufcr & MX6UART_UFCR_RXTL_MASK) == 8);
+  HOST_CHECK (((mModel.Ufcr & MX6UART_UFCR_TXTL_MASK) >> MX6UART_UFCR_TXTL_SHIFT) ==
+              MX6UART_TX_WATERMARK_MIN);
+  HOST_CHECK (ReceiveFifoDepth == 8);
+
+  // Invalid attributes leave the hardware and the caller values untouched
+  for (Index = 0; Index < 5; ++Index) {
+    TestSetup ();
+    BaudRate = 115200;
+    ReceiveFifoDepth = 0;
+    Timeout = 0;
+    Parity = DefaultParity;
+    DataBits = 0;
+    StopBits = DefaultStopBits;
+    switch (Index) {
+    case 0:
+      BaudRate = TEST_UART_CLOCK;
+      break;
+    case 1:
+      DataBits = 6;
+      break;
+    case 2:
+      Parity = MarkParity;
+      break;
+    case 3:
+      StopBits = OneFiveStopBits;
+      break;
+    case 4:
+      ReceiveFifoDepth = MX6UART_FIFO_COUNT + 1;
+      break;
+    }
+
+    Ucr2 = mModel.Ucr2;
+    Ufcr = mModel.Ufcr;
+    Ubir = mModel.Ubir;
+    Ubmr = mModel.Ubmr;
+    Status = SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                      &Parity, &DataBits, &StopBits);
+    HOST_CHECK (Status == RETURN_INVALID_PARAMETER);
+    HOST_CHECK ((mModel.Ucr2 == Ucr2) && (mModel.Ufcr == Ufcr));
+    HOST_CHECK ((mModel.Ubir == Ubir) && (mModel.Ubmr == Ubmr));
+    HOST_CHECK (Timeout == 0);
+    HOST_CHECK ((Index == 0) || (BaudRate == 115200));
+    HOST_CHECK ((Index == 1) || (DataBits == 0));
+    HOST_CHECK ((Index == 2) || (Parity == DefaultParity));
+    HOST_CHECK ((Index == 3) || (StopBits == DefaultStopBits));
+    HOST_CHECK ((Index == 4) || (ReceiveFifoDepth == 0));
+  }
+
+  // Pending characters go out at the old rate before the divider changes.
+  // The model flags a divider or frame change while transmitting.
+  TestSetup ();
+  HOST_CHECK (SerialPortWrite (mPattern, 64) == 64);
+  BaudRate = 9600;
+  ReceiveFifoDepth = 0;
+  Timeout = 0;
+  Parity = EvenParity;
+  DataBits = 0;
+  StopBits = DefaultStopBits;
+  Status = SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                    &Parity, &DataBits, &StopBits);
+  HOST_CHECK (Status == RETURN_SUCCESS);
+  HOST_CHECK (mModel.OutputCount == 64);
+  HOST_CHECK (CompareMem (mModel.Output, mPattern, 64) == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+
+  // A peer holding the line forever makes the drain time out instead of
+  // hanging, and nothing is changed
+  TestSetup ();
+  mModel.TxStall = TRUE;
+  HOST_CHECK (SerialPortWrite (mPattern, 4) == 4);
+  Ucr2 = mModel.Ucr2;
+  Ufcr = mModel.Ufcr;
+  Ubir = mModel.Ubir;
+  Ubmr = mModel.Ubmr;
+  BaudRate = 9600;
+  ReceiveFifoDepth = 0;
+  Timeout = 10;
+  Parity = DefaultParity;
+  DataBits = 0;
+  StopBits = DefaultStopBits;
+  Status = SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                    &Parity, &DataBits, &StopBits);
+  HOST_CHECK (Status == RETURN_TIMEOUT);
+  HOST_CHECK (gHostCounters.DelayInUs >= (MX6UART_FIFO_COUNT + 1) * 10);
+  HOST_CHECK ((mModel.Ucr2 == Ucr2) && (mModel.Ufcr == Ufcr));
+  HOST_CHECK ((mModel.Ubir == Ubir) && (mModel.Ubmr == Ubmr));
+  HOST_CHECK ((BaudRate == 9600) && (Timeout == 10) && (DataBits == 0));
+  mModel.TxStall = FALSE;
+  TestWaitIdle (5);
+  HOST_CHECK (mModel.OutputCount == 4);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+STATIC
+VOID
+TestControl (
+  VOID
+  )
+{
+  UINT8   Buffer[16];
+  UINT32  Control;
+
+  TestSetup ();
+  HOST_CHECK (SerialPortGetControl (&Control) == RETURN_SUCCESS);
+  HOST_CHECK ((Control & EFI_SERIAL_CLEAR_TO_SEND) != 0);
+  HOST_CHECK ((Control & EFI_SERIAL_INPUT_BUFFER_EMPTY) != 0);
+  HOST_CHECK ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) != 0);
+  HOST_CHECK ((Control & EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE) == 0);
+
+  HOST_CHECK (SerialPortSetControl (EFI_SERIAL_DATA_TERMINAL_READY) == RETURN_UNSUPPORTED);
+
+  // Internal loopback returns the transmitted characters to the receiver
+  HOST_CHECK (SerialPortSetControl (EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE |
+                                    EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE) == RETURN_SUCCESS);
+  HOST_CHECK (SerialPortGetControl (&Control) == RETURN_SUCCESS);
+  HOST_CHECK ((Control & EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE) != 0);
+  HOST_CHECK ((Control & EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE) != 0);
+  HOST_CHECK (SerialPortWrite (mPattern, 12) == 12);
+  HOST_CHECK (SerialPortGetControl (&Control) == RETURN_SUCCESS);
+  HOST_CHECK ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) == 0);
+  TestWaitIdle (13);
+  HOST_CHECK (SerialPortRead (Buffer, sizeof (Buffer)) == 12);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 12) == 0);
+  HOST_CHECK (mModel.OutputCount == 0);
+
+  HOST_CHECK (SerialPortSetControl (0) == RETURN_SUCCESS);
+  mModel.TxStall = TRUE;
+  HOST_CHECK (SerialPortGetControl (&Control) == RETURN_SUCCESS);
+  HOST_CHECK ((Control & (EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE |
+                          EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE |
+                          EFI_SERIAL_CLEAR_TO_SEND)) == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+}
+
+//
+// Let the line and the SDMA run for Count character times. The models only
+// interact between ticks, so time advances one character at a time.
+//
+STATIC
+VOID
+TestSdmaAdvance (
+  IN  UINT32  Count
+  )
+{
+  while (Count-- > 0) {
+    HostAdvance (UartModelCharacterTime (&mModel));
+  }
+}
+
+//
+// Poll for the completion of a transmit transfer every 16 character times,
+// or give up after Limit polls.
+//
+STATIC
+BOOLEAN
+TestSdmaWaitTx (
+  IN  UINT32  Limit
+  )
+{
+  while (Limit-- > 0) {
+    TestSdmaAdvance (16);
+    if (UartSdmaTxDone ()) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+STATIC
+VOID
+TestSdmaInitialize (
+  VOID
+  )
+{
+  UINT32  Index;
+  UINT64  MmioCount;
+
+  // Disabled by a zero threshold or base, the SDMA is left alone
+  TestSetup ();
+  MmioCount = gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount;
+  gHostPcd_PcdSerialDmaThreshold = 0;
+  HOST_CHECK (UartSdmaInitialize () == RETURN_UNSUPPORTED);
+  gHostPcd_PcdSerialDmaThreshold = TEST_SDMA_THRESHOLD;
+  gHostPcd_PcdSdmaBase = 0;
+  HOST_CHECK (UartSdmaInitialize () == RETURN_UNSUPPORTED);
+  gHostPcd_PcdSdmaBase = TEST_SDMA_BASE;
+  HOST_CHECK (gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount == MmioCount);
+  HOST_CHECK (UartSdmaTxStart (mPattern, sizeof (mPattern)) == 0);
+  HOST_CHECK (UartSdmaRxStart () == RETURN_UNSUPPORTED);
+
+  // An SDMA set up by someone else is not taken over
+  TestSetup ();
+  mSdmaModel.Registers.Mc0Ptr = 0x1000;
+  HOST_CHECK (UartSdmaInitialize () == RETURN_UNSUPPORTED);
+  HOST_CHECK (mSdmaModel.Registers.Mc0Ptr == 0x1000);
+  HOST_CHECK (mSdmaModel.ContextLoadCount == 0);
+  mSdmaModel.Registers.Mc0Ptr = 0;
+
+  // Both contexts are loaded through channel 0, stop gives the SDMA back
+  TestSetup ();
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  HOST_CHECK (mSdmaModel.ContextLoadCount == 2);
+  HOST_CHECK (mSdmaModel.Registers.Mc0Ptr != 0);
+  HOST_CHECK (mSdmaModel.Running == 0);
+  HOST_CHECK (mSdmaModel.Registers.ChnEnbl[gHostPcd_PcdSerialSdmaTxEvent] != 0);
+  HOST_CHECK (mSdmaModel.Registers.ChnEnbl[gHostPcd_PcdSerialSdmaRxEvent] != 0);
+  HOST_CHECK (gHostCounters.DelayInUs < 10);
+
+  HOST_CHECK (UartSdmaRxStart () == RETURN_SUCCESS);
+  HOST_CHECK (UartSdmaRxActive ());
+  UartSdmaStop ();
+  UartSdmaStop ();
+  HOST_CHECK (!UartSdmaRxActive ());
+  HOST_CHECK (mSdmaModel.Registers.Mc0Ptr == 0);
+  HOST_CHECK (mSdmaModel.Running == 0);
+  for (Index = 0; Index < IMX_SDMA_EVENT_COUNT; ++Index) {
+    HOST_CHECK (mSdmaModel.Registers.ChnEnbl[Index] == 0);
+  }
+  HOST_CHECK ((mModel.Ucr1 & (MX6UART_UCR1_TXDMAEN | MX6UART_UCR1_RXDMAEN)) == 0);
+  HOST_CHECK (UartSdmaTxStart (mPattern, sizeof (mPattern)) == 0);
+  UartSdmaUninitialize ();
+  HOST_CHECK (mSdmaModel.ProtocolErrorCount == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+  HOST_CHECK (gHostCounters.UnmappedCount == 0);
+}
+
+STATIC
+VOID
+TestSdmaWrite (
+  VOID
+  )
+{
+  UINT8   *Buffer;
+  UINT32  Index;
+  UINTN   Length;
+  UINT64  MmioCount;
+
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (SIZE_64KB));
+  HOST_CHECK (Buffer != NULL);
+  for (Index = 0; Index < SIZE_64KB; ++Index) {
+    Buffer[Index] = (UINT8)(Index * 13 + 5);
+  }
+
+  // The SDMA refills the FIFO, the CPU only checks for completion
+  TestSetup ();
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  MmioCount = gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount;
+  Length = UartSdmaTxStart (Buffer, 4096);
+  HOST_CHECK (Length == 4096);
+  HOST_CHECK ((mModel.Ucr1 & MX6UART_UCR1_TXDMAEN) != 0);
+  HOST_CHECK (TestSdmaWaitTx (4096));
+  HOST_CHECK ((mModel.Ucr1 & MX6UART_UCR1_TXDMAEN) == 0);
+  HOST_CHECK (mSdmaModel.DmaTxByteCount == 4096);
+  HOST_CHECK (gHostCounters.MmioReadCount + gHostCounters.MmioWriteCount - MmioCount < 4096 / 8);
+
+  // Output written after completion follows the transfer
+  HOST_CHECK (UartSerialPortWriteFifo (mPattern, 10, TRUE) == 10);
+  TestWaitIdle (MX6UART_FIFO_COUNT + 11);
+  HOST_CHECK (mModel.OutputCount == 4096 + 10);
+  HOST_CHECK (CompareMem (mModel.Output, Buffer, 4096) == 0);
+  HOST_CHECK (CompareMem (mModel.Output + 4096, mPattern, 10) == 0);
+
+  // Transfers are limited to what a buffer descriptor counts
+  UartSdmaUninitialize ();
+  TestSetup ();
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  HOST_CHECK (UartSdmaTxStart (Buffer, SIZE_64KB) == MAX_UINT16);
+  HOST_CHECK (TestSdmaWaitTx (MAX_UINT16));
+  TestWaitIdle (MX6UART_FIFO_COUNT + 1);
+  HOST_CHECK (mModel.OutputCount == MAX_UINT16);
+  HOST_CHECK (CompareMem (mModel.Output, Buffer, MAX_UINT16) == 0);
+
+  UartSdmaUninitialize ();
+  FreePages (Buffer, EFI_SIZE_TO_PAGES (SIZE_64KB));
+  HOST_CHECK (mSdmaModel.ProtocolErrorCount == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+  HOST_CHECK (gHostCounters.UnmappedCount == 0);
+}
+
+//
+// Receive Length characters from the line through the SDMA, reading at most
+// Chunk bytes every 16 character times.
+//
+STATIC
+UINTN
+TestSdmaReceive (
+  OUT UINT8   *Buffer,
+  IN  UINT32  Length,
+  IN  UINT32  Chunk
+  )
+{
+  UINTN   BytesRead;
+  UINT32  Limit;
+
+  UartModelReceive (&mModel, mPattern, Length);
+  BytesRead = 0;
+  for (Limit = Length + 16; (Limit > 0) && (BytesRead < Length); --Limit) {
+    TestSdmaAdvance (16);
+    BytesRead += UartSdmaRxRead (Buffer + BytesRead, MIN (Chunk, Length - BytesRead), NULL);
+  }
+  return BytesRead;
+}
+
+STATIC
+VOID
+TestSdmaRead (
+  VOID
+  )
+{
+  UINT64              BaudRate;
+  UINT8               Buffer[1024];
+  UINT8               DataBits;
+  UINT32              Errors;
+  UINTN               Length;
+  EFI_PARITY_TYPE     Parity;
+  UINT32              ReceiveFifoDepth;
+  EFI_STOP_BITS_TYPE  StopBits;
+  UINT32              Timeout;
+  UINT32              Ufcr;
+
+  TestSetup ();
+  Ufcr = mModel.Ufcr;
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  HOST_CHECK (UartSdmaRxStart () == RETURN_SUCCESS);
+  HOST_CHECK ((mModel.Ufcr & MX6UART_UFCR_RXTL_MASK) > 8);
+  HOST_CHECK (UartSdmaRxActive ());
+  HOST_CHECK (!UartSdmaRxPoll ());
+
+  // Bursts fill the buffers, aging flushes the tail below the trigger level,
+  // more data than all buffers hold needs them handed back
+  Length = TestSdmaReceive (Buffer, 300, sizeof (Buffer));
+  HOST_CHECK (Length == 300);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 300) == 0);
+  HOST_CHECK (mSdmaModel.DmaRxByteCount == 300);
+
+  // Reads smaller than a buffer return it in pieces
+  Length = TestSdmaReceive (Buffer, 200, 5);
+  HOST_CHECK (Length == 200);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 200) == 0);
+  HOST_CHECK (!UartSdmaRxPoll ());
+
+  // Received data is polled from the FIFO and the completed buffers
+  UartModelReceive (&mModel, mPattern, 3);
+  TestSdmaAdvance (4);
+  HOST_CHECK (UartSdmaRxPoll ());
+  TestSdmaAdvance (10);
+  HOST_CHECK (UartSdmaRxPoll ());
+  HOST_CHECK (UartSdmaRxRead (Buffer, sizeof (Buffer), &Errors) == 3);
+  HOST_CHECK (Errors == 0);
+  HOST_CHECK (!UartSdmaRxPoll ());
+
+  // Once all buffers are full the FIFO overflows, which is reported
+  UartSdmaUninitialize ();
+  TestSetup ();
+  HOST_CHECK (UartSdmaInitialize () == RETURN_SUCCESS);
+  HOST_CHECK (UartSdmaRxStart () == RETURN_SUCCESS);
+  UartModelReceive (&mModel, mPattern, 4 * TEST_SDMA_THRESHOLD + MX6UART_FIFO_COUNT + 10);
+  TestSdmaAdvance (4 * TEST_SDMA_THRESHOLD + MX6UART_FIFO_COUNT + 20);
+  HOST_CHECK (mModel.OverrunCount == 10);
+  Length = UartSdmaRxRead (Buffer, sizeof (Buffer), &Errors);
+  HOST_CHECK (Length == 4 * TEST_SDMA_THRESHOLD);
+  HOST_CHECK ((Errors & MX6UART_RXD_OVRRUN) != 0);
+  HOST_CHECK (!mModel.Overrun);
+  TestSdmaAdvance (20);
+  Length += UartSdmaRxRead (Buffer + Length, sizeof (Buffer) - Length, &Errors);
+  HOST_CHECK (Length == 4 * TEST_SDMA_THRESHOLD + MX6UART_FIFO_COUNT);
+  HOST_CHECK (CompareMem (Buffer, mPattern, Length) == 0);
+  HOST_CHECK (Errors == 0);
+
+  // The trigger level is left to the SDMA
+  BaudRate = 0;
+  ReceiveFifoDepth = 1;
+  Timeout = 0;
+  Parity = DefaultParity;
+  DataBits = 0;
+  StopBits = DefaultStopBits;
+  HOST_CHECK (SerialPortSetAttributes (&BaudRate, &ReceiveFifoDepth, &Timeout,
+                                       &Parity, &DataBits, &StopBits) == RETURN_SUCCESS);
+  HOST_CHECK (ReceiveFifoDepth == MX6UART_FIFO_COUNT);
+  HOST_CHECK ((mModel.Ufcr & MX6UART_UFCR_RXTL_MASK) > 8);
+  Length = TestSdmaReceive (Buffer, 100, sizeof (Buffer));
+  HOST_CHECK (Length == 100);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 100) == 0);
+
+  // Stopping gives the FIFO back to the CPU with the old trigger level
+  UartSdmaRxStop ();
+  UartSdmaRxStop ();
+  HOST_CHECK (!UartSdmaRxActive ());
+  HOST_CHECK ((mModel.Ucr1 & (MX6UART_UCR1_RXDMAEN | MX6UART_UCR1_ATDMAEN)) == 0);
+  HOST_CHECK ((mModel.Ufcr & MX6UART_UFCR_RXTL_MASK) == (Ufcr & MX6UART_UFCR_RXTL_MASK));
+  HOST_CHECK (UartSdmaRxRead (Buffer, sizeof (Buffer), NULL) == 0);
+  UartModelReceive (&mModel, mPattern, 4);
+  TestSdmaAdvance (5);
+  HOST_CHECK (SerialPortRead (Buffer, sizeof (Buffer)) == 4);
+  HOST_CHECK (CompareMem (Buffer, mPattern, 4) == 0);
+
+  UartSdmaUninitialize ();
+  HOST_CHECK (mModel.OverrunCount == 10);
+  HOST_CHECK (mSdmaModel.ProtocolErrorCount == 0);
+  HOST_CHECK (mModel.ProtocolErrorCount == 0);
+  HOST_CHECK (gHostCounters.UnmappedCount == 0);
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  TestInitialize ();
+  TestWrite ();
+  TestRead ();
+  TestSetAttributes ();
+  TestControl ();
+  TestSdmaInitialize ();
+  TestSdmaWrite ();
+  TestSdmaRead ();
+  return (int)HostSummary ("UartHostTest");
+}
@@ -0,0 +1,548 @@
+/** @file
+*
+*  Behavioral model of the i.MX UART.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include <HostLib.h>
+#include <iMXUart.h>
+
+#include "UartModel.h"
+
+#define UART_MODEL_RXD      0x00
+#define UART_MODEL_TXD      0x40
+#define UART_MODEL_UCR1     0x80
+#define UART_MODEL_UCR2     0x84
+#define UART_MODEL_UCR3     0x88
+#define UART_MODEL_UCR4     0x8C
+#define UART_MODEL_UFCR     0x90
+#define UART_MODEL_USR1     0x94
+#define UART_MODEL_USR2     0x98
+#define UART_MODEL_UESC     0x9C
+#define UART_MODEL_UTIM     0xA0
+#define UART_MODEL_UBIR     0xA4
+#define UART_MODEL_UBMR     0xA8
+#define UART_MODEL_UBRC     0xAC
+#define UART_MODEL_ONEMS    0xB0
+#define UART_MODEL_UTS      0xB4
+#define UART_MODEL_UMCR     0xB8
+#define UART_MODEL_WINDOW   0x4000
+
+#define UART_MODEL_UCR2_FRAME   (MX6UART_UCR2_WS | MX6UART_UCR2_STPB | \
+                                 MX6UART_UCR2_PREN | MX6UART_UCR2_PROE)
+
+// Module clock divider selected by each UFCR.RFDIV encoding
+STATIC CONST UINT32 mRfDivider[] = { 6, 5, 4, 3, 2, 1, 7, 1 };
+
+STATIC
+VOID
+UartModelError (
+  IN  UART_MODEL    *Model,
+  IN  CONST CHAR8   *Description
+  )
+{
+  ++Model->ProtocolErrorCount;
+  ++gHostFailCount;
+  HostReportFailure (__FILE__, __LINE__, Description);
+}
+
+STATIC
+BOOLEAN
+UartModelTransmitting (
+  IN  UART_MODEL  *Model
+  )
+{
+  return Model->TxShifting || (Model->TxCount != 0);
+}
+
+STATIC
+UINT64
+UartModelReferenceClock (
+  IN  UART_MODEL  *Model
+  )
+{
+  return Model->ModuleClock /
+         mRfDivider[(Model->Ufcr & MX6UART_UFCR_RFDIV_MASK) >> 7];
+}
+
+UINT64
+UartModelBaudRate (
+  IN  UART_MODEL  *Model
+  )
+{
+  return UartModelReferenceClock (Model) * (Model->Ubir + 1) /
+         (16ULL * (Model->Ubmr + 1));
+}
+
+UINT64
+UartModelCharacterTime (
+  IN  UART_MODEL  *Model
+  )
+{
+  UINT64  Bits;
+
+  // Start bit, data bits, optional parity and stop bits
+  Bits = 1 + (((Model->Ucr2 & MX6UART_UCR2_WS) != 0) ? 8 : 7) +
+         (((Model->Ucr2 & MX6UART_UCR2_PREN) != 0) ? 1 : 0) +
+         (((Model->Ucr2 & MX6UART_UCR2_STPB) != 0) ? 2 : 1);
+
+  return Bits * 16 * (Model->Ubmr + 1) * 1000000000ULL /
+         (UartModelReferenceClock (Model) * (Model->Ubir + 1));
+}
+
+STATIC
+VOID
+UartModelPushRx (
+  IN  UART_MODEL  *Model,
+  IN  UINT8       Data
+  )
+{
+  if ((Model->Ucr2 & MX6UART_UCR2_RXEN) == 0) {
+    return;
+  }
+
+  if (Model->RxCount == UART_MODEL_FIFO_SIZE) {
+    Model->Overrun = TRUE;
+    ++Model->OverrunCount;
+    return;
+  }
+
+  Model->RxFifo[(Model->RxHead + Model->RxCount) % UART_MODEL_FIFO_SIZE] = Data;
+  ++Model->RxCount;
+  ++Model->RxByteCount;
+  Model->RxLastInNs = HostNow ();
+}
+
+STATIC
+UINT32
+UartModelPopRx (
+  IN  UART_MODEL  *Model
+  )
+{
+  UINT32  Value;
+
+  if (Model->RxCount == 0) {
+    return 0;
+  }
+
+  Value = MX6UART_RXD_CHARRDY | Model->RxFifo[Model->RxHead];
+  Model->RxHead = (Model->RxHead + 1) % UART_MODEL_FIFO_SIZE;
+  --Model->RxCount;
+  return Value;
+}
+
+STATIC
+BOOLEAN
+UartModelStartTx (
+  IN  UART_MODEL  *Model,
+  IN  UINT64      StartInNs
+  )
+{
+  if ((Model->TxCount == 0) || Model->TxStall) {
+    return FALSE;
+  }
+
+  Model->TxShift = Model->TxFifo[Model->TxHead];
+  Model->TxHead = (Model->TxHead + 1) % UART_MODEL_FIFO_SIZE;
+  --Model->TxCount;
+  Model->TxShifting = TRUE;
+  Model->TxDoneInNs = StartInNs + UartModelCharacterTime (Model);
+  return TRUE;
+}
+
+STATIC
+VOID
+UartModelPushTx (
+  IN  UART_MODEL  *Model,
+  IN  UINT8       Data
+  )
+{
+  if (((Model->Ucr1 & MX6UART_UCR1_UARTEN) == 0) ||
+      ((Model->Ucr2 & MX6UART_UCR2_TXEN) == 0)) {
+    UartModelError (Model, "UTXD written while the transmitter is disabled");
+    return;
+  }
+  if (Model->TxCount == UART_MODEL_FIFO_SIZE) {
+    UartModelError (Model, "UTXD written while the TX FIFO is full");
+    return;
+  }
+  Model->TxFifo[(Model->TxHead + Model->TxCount) % UART_MODEL_FIFO_SIZE] = Data;
+  ++Model->TxCount;
+  if (!Model->TxShifting) {
+    UartModelStartTx (Model, HostNow ());
+  }
+}
+
+STATIC
+VOID
+UartModelTick (
+  IN  VOID    *Context,
+  IN  UINT64  NowInNs
+  )
+{
+  UART_MODEL  *Model;
+
+  Model = Context;
+
+  // Characters go out back to back while the FIFO holds data
+  while (Model->TxShifting && (NowInNs >= Model->TxDoneInNs)) {
+    Model->TxShifting = FALSE;
+    ++Model->TxByteCount;
+    if ((Model->Uts & MX6UART_UTS_LOOP) != 0) {
+      UartModelPushRx (Model, Model->TxShift);
+    } else if (Model->OutputCount < UART_MODEL_LINE_SIZE) {
+      Model->Output[Model->OutputCount++] = Model->TxShift;
+    }
+    UartModelStartTx (Model, Model->TxDoneInNs);
+  }
+
+  if (!Model->TxShifting) {
+    UartModelStartTx (Model, NowInNs);
+  }
+
+  while ((Model->InputCount != 0) && (NowInNs >= Model->InputNextInNs)) {
+    UartModelPushRx (Model, Model->Input[Model->InputHead]);
+    Model->InputHead = (Model->InputHead + 1) % UART_MODEL_LINE_SIZE;
+    --Model->InputCount;
+    Model->InputNextInNs += UartModelCharacterTime (Model);
+  }
+}
+
+STATIC
+UINT32
+UartModelRead (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width
+  )
+{
+  UART_MODEL  *Model;
+  UINT32      Value;
+
+  Model = Context;
+  switch (Offset) {
+  case UART_MODEL_RXD:
+    if ((Model->Ucr1 & MX6UART_UCR1_RXDMAEN) != 0) {
+      UartModelError (Model, "URXD read by the CPU while the SDMA receives");
+    }
+    return UartModelPopRx (Model);
+  case UART_MODEL_TXD:
+    return 0;
+  case UART_MODEL_UCR1:
+    return Model->Ucr1;
+  case UART_MODEL_UCR2:
+    return Model->Ucr2;
+  case UART_MODEL_UCR3:
+    return Model->Ucr3;
+  case UART_MODEL_UCR4:
+    return Model->Ucr4;
+  case UART_MODEL_UFCR:
+    return Model->Ufcr;
+  case UART_MODEL_USR1:
+    ++Model->StatusReadCount;
+    Value = 0;
+    if (Model->TxCount <= ((Model->Ufcr & MX6UART_UFCR_TXTL_MASK) >> MX6UART_UFCR_TXTL_SHIFT)) {
+      Value |= MX6UART_USR1_TRDY;
+    }
+    if ((Model->RxCount != 0) &&
+        (Model->RxCount >= ((Model->Ufcr & MX6UART_UFCR_RXTL_MASK) >> MX6UART_UFCR_RXTL_SHIFT))) {
+      Value |= MX6UART_USR1_RRDY;
+    }
+    if (!Model->TxStall) {
+      Value |= MX6UART_USR1_RTSS;
+    }
+    return Value;
+  case UART_MODEL_USR2:
+    ++Model->StatusReadCount;
+    Value = 0;
+    if (Model->RxCount != 0) {
+      Value |= MX6UART_USR2_RDR;
+    }
+    if (Model->Overrun) {
+      Value |= MX6UART_USR2_ORE;
+    }
+    if (!UartModelTransmitting (Model)) {
+      Value |= MX6UART_USR2_TXDC;
+    }
+    if (Model->TxCount == 0) {
+      Value |= MX6UART_USR2_TXFE;
+    }
+    return Value;
+  case UART_MODEL_UESC:
+    return Model->Uesc;
+  case UART_MODEL_UTIM:
+    return Model->Utim;
+  case UART_MODEL_UBIR:
+    return Model->Ubir;
+  case UART_MODEL_UBMR:
+    return Model->Ubmr;
+  case UART_MODEL_UBRC:
+    return 0;
+  case UART_MODEL_ONEMS:
+    return Model->Onems;
+  case UART_MODEL_UTS:
+    ++Model->StatusReadCount;
+    Value = Model->Uts;
+    if (Model->TxCount == UART_MODEL_FIFO_SIZE) {
+      Value |= MX6UART_UTS_TXFULL;
+    }
+    if (Model->TxCount == 0) {
+      Value |= MX6UART_UTS_TXEMPTY;
+    }
+    if (Model->RxCount == 0) {
+      Value |= MX6UART_UTS_RXEMPTY;
+    }
+    if (Model->RxCount == UART_MODEL_FIFO_SIZE) {
+      Value |= MX6UART_UTS_RXFULL;
+    }
+    return Value;
+  case UART_MODEL_UMCR:
+    return Model->Umcr;
+  default:
+    UartModelError (Model, "Read of an unknown UART register");
+    return 0;
+  }
+}
+
+STATIC
+VOID
+UartModelWrite (
+  IN  VOID    *Context,
+  IN  UINT32  Offset,
+  IN  UINT32  Width,
+  IN  UINT32  Value
+  )
+{
+  UART_MODEL  *Model;
+
+  Model = Context;
+  switch (Offset) {
+  case UART_MODEL_TXD:
+    if ((Model->Ucr1 & MX6UART_UCR1_TXDMAEN) != 0) {
+      UartModelError (Model, "UTXD written by the CPU while the SDMA transmits");
+    }
+    UartModelPushTx (Model, (UINT8)Value);
+    break;
+  case UART_MODEL_UCR1:
+    Model->Ucr1 = Value;
+    break;
+  case UART_MODEL_UCR2:
+    if (UartModelTransmitting (Model) &&
+        (((Model->Ucr2 ^ Value) & UART_MODEL_UCR2_FRAME) != 0)) {
+      UartModelError (Model, "Frame format changed while transmitting");
+    }
+    Model->Ucr2 = Value;
+    break;
+  case UART_MODEL_UCR3:
+    Model->Ucr3 = Value;
+    break;
+  case UART_MODEL_UCR4:
+    Model->Ucr4 = Value;
+    break;
+  case UART_MODEL_UFCR:
+    if (UartModelTransmitting (Model) &&
+        (((Model->Ufcr ^ Value) & MX6UART_UFCR_RFDIV_MASK) != 0)) {
+      UartModelError (Model, "Reference clock divider changed while transmitting");
+    }
+    Model->Ufcr = Value;
+    break;
+  case UART_MODEL_USR1:
+    // Status bits of interest here are not write one to clear
+    break;
+  case UART_MODEL_USR2:
+    if ((Value & MX6UART_USR2_ORE) != 0) {
+      Model->Overrun = FALSE;
+    }
+    break;
+  case UART_MODEL_UESC:
+    Model->Uesc = Value;
+    break;
+  case UART_MODEL_UTIM:
+    Model->Utim = Value;
+    break;
+  case UART_MODEL_UBIR:
+  case UART_MODEL_UBMR:
+    if (UartModelTransmitting (Model) &&
+        (((Offset == UART_MODEL_UBIR) ? Model->Ubir : Model->Ubmr) != Value)) {
+      UartModelError (Model, "Baud rate divider changed while transmitting");
+    }
+    if (Offset == UART_MODEL_UBIR) {
+      Model->Ubir = Value & 0xFFFF;
+    } else {
+      Model->Ubmr = Value & 0xFFFF;
+    }
+    break;
+  case UART_MODEL_ONEMS:
+    Model->Onems = Value;
+    break;
+  case UART_MODEL_UTS:
+    // FIFO status bits are read only
+    Model->Uts = Value & ~(MX6UART_UTS_TXFULL | MX6UART_UTS_TXEMPTY |
+                           MX6UART_UTS_RXFULL | MX6UART_UTS_RXEMPTY);
+    break;
+  case UART_MODEL_UMCR:
+    Model->Umcr = Value;
+    break;
+  default:
+    UartModelError (Model, "Write of an unknown UART register");
+    break;
+  }
+}
+
+/**
+  DMA request lines of the UART. The transmit request is raised while
+  UCR1.TXDMAEN is set and the TX FIFO is at or below its trigger level. The
+  receive request is raised while UCR1.RXDMAEN is set and the RX FIFO reached
+  its trigger level, or with UCR1.ATDMAEN set, when characters below the
+  trigger level waited for 8 character times. Aging is set in that case.
+
+**/
+BOOLEAN
+UartModelTxDmaRequest (
+  IN  UART_MODEL  *Model
+  )
+{
+  return ((Model->Ucr1 & MX6UART_UCR1_TXDMAEN) != 0) &&
+         (Model->TxCount <= ((Model->Ufcr & MX6UART_UFCR_TXTL_MASK) >> MX6UART_UFCR_TXTL_SHIFT));
+}
+
+BOOLEAN
+UartModelRxDmaRequest (
+  IN  UART_MODEL  *Model,
+  OUT BOOLEAN     *Aging
+  )
+{
+  UINT32  TriggerLevel;
+
+  *Aging = FALSE;
+  if (((Model->Ucr1 & MX6UART_UCR1_RXDMAEN) == 0) || (Model->RxCount == 0)) {
+    return FALSE;
+  }
+
+  TriggerLevel = (Model->Ufcr & MX6UART_UFCR_RXTL_MASK) >> MX6UART_UFCR_RXTL_SHIFT;
+  if (Model->RxCount >= TriggerLevel) {
+    return TRUE;
+  }
+
+  if (((Model->Ucr1 & MX6UART_UCR1_ATDMAEN) != 0) &&
+      (HostNow () - Model->RxLastInNs >= 8 * UartModelCharacterTime (Model))) {
+    *Aging = TRUE;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Accesses of the SDMA to the data registers.
+
+**/
+VOID
+UartModelDmaWrite (
+  IN  UART_MODEL  *Model,
+  IN  UINT8       Data
+  )
+{
+  UartModelPushTx (Model, Data);
+}
+
+UINT32
+UartModelDmaRead (
+  IN  UART_MODEL  *Model
+  )
+{
+  if (Model->RxCount == 0) {
+    UartModelError (Model, "URXD read by the SDMA while the RX FIFO is empty");
+  }
+  return UartModelPopRx (Model);
+}
+
+/**
+  Queue characters sent by the peer. They reach the receive FIFO one
+  character time apart, starting one character time from now.
+
+**/
+VOID
+UartModelReceive (
+  IN  UART_MODEL  *Model,
+  IN  CONST UINT8 *Buffer,
+  IN  UINT32      Length
+  )
+{
+  UINT32  Index;
+
+  ASSERT (Model->InputCount + Length <= UART_MODEL_LINE_SIZE);
+
+  if (Model->InputCount == 0) {
+    Model->InputNextInNs = HostNow () + UartModelCharacterTime (Model);
+  }
+
+  for (Index = 0; Index < Length; ++Index) {
+    Model->Input[(Model->InputHead + Model->InputCount) % UART_MODEL_LINE_SIZE] = Buffer[Index];
+    ++Model->InputCount;
+  }
+}
+
+/**
+  Reset the model to the state left by the boot loader: UART enabled at
+  BaudRate with 8N1 framing, no flow control and the RTS_B input asserted.
+
+**/
+VOID
+UartModelInitialize (
+  OUT UART_MODEL  *Model,
+  IN  UINTN       Base,
+  IN  UINT32      ModuleClock,
+  IN  UINT32      BaudRate
+  )
+{
+  UINT64  Numerator;
+  UINT64  Denominator;
+  UINT64  Value0;
+  UINT64  Value1;
+  UINT64  Remainder;
+
+  ZeroMem (Model, sizeof (*Model));
+  Model->Base = Base;
+  Model->ModuleClock = ModuleClock;
+  Model->Ucr1 = MX6UART_UCR1_UARTEN;
+  Model->Ucr2 = MX6UART_UCR2_SRST | MX6UART_UCR2_RXEN | MX6UART_UCR2_TXEN |
+                MX6UART_UCR2_WS | MX6UART_UCR2_IRTS;
+  Model->Ucr3 = MX6UART_UCR3_RXDMUXSEL;
+  Model->Ufcr = MX6UART_UFCR_RFDIV_1 |
+                (2 << MX6UART_UFCR_TXTL_SHIFT) |
+                (1 << MX6UART_UFCR_RXTL_SHIFT);
+
+  Numerator = 16ULL * BaudRate;
+  Denominator = ModuleClock;
+  Value0 = Numerator;
+  Value1 = Denominator;
+  while (Value1 != 0) {
+    Remainder = Value0 % Value1;
+    Value0 = Value1;
+    Value1 = Remainder;
+  }
+  Numerator /= Value0;
+  Denominator /= Value0;
+  ASSERT ((Numerator <= 0x10000) && (Denominator <= 0x10000));
+  Model->Ubir = (UINT32)Numerator - 1;
+  Model->Ubmr = (UINT32)Denominator - 1;
+  Model->Onems = ModuleClock / 1000;
+
+  HostMmioRegister (Base, UART_MODEL_WINDOW, Model, UartModelRead, UartModelWrite, UartModelTick);
+}
@@ -0,0 +1,129 @@
+/** @file
+*
+*  Behavioral model of the i.MX UART.
+*
+*  The model keeps the 32 character FIFOs and the transmit shift register and
+*  moves characters at the line rate given by the programmed dividers and
+*  frame format. It catches the sequencing mistakes that corrupt a console on
+*  hardware: writing UTXD while the FIFO is full or the transmitter is
+*  disabled, and changing the baud rate or frame format while characters are
+*  still being shifted out.
+*
+*  Copyright (c) 2018 Microsoft Corporation. All rights reserved.
+*
+*  This program and the accompanying materials
+*  are licensed and made available under the terms and conditions of the BSD License
+*  which accompanies this distribution.  The full text of the license may be found at
+*  http://opensource.org/licenses/bsd-license.php
+*
+*  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+*
+**/
+
+#ifndef _UART_MODEL_H_
+#define _UART_MODEL_H_
+
+#include <Base.h>
+
+#define UART_MODEL_FIFO_SIZE      32
+#define UART_MODEL_LINE_SIZE      0x10000
+
+typedef struct {
+  UINTN     Base;
+  UINT32    ModuleClock;
+
+  UINT32    Ucr1;
+  UINT32    Ucr2;
+  UINT32    Ucr3;
+  UINT32    Ucr4;
+  UINT32    Ufcr;
+  UINT32    Uesc;
+  UINT32    Utim;
+  UINT32    Ubir;
+  UINT32    Ubmr;
+  UINT32    Onems;
+  UINT32    Uts;
+  UINT32    Umcr;
+  BOOLEAN   Overrun;
+
+  UINT8     TxFifo[UART_MODEL_FIFO_SIZE];
+  UINT32    TxHead;
+  UINT32    TxCount;
+  BOOLEAN   TxShifting;
+  UINT8     TxShift;
+  UINT64    TxDoneInNs;
+
+  UINT16    RxFifo[UART_MODEL_FIFO_SIZE];
+  UINT32    RxHead;
+  UINT32    RxCount;
+  UINT64    RxLastInNs;
+
+  //
+  // Line side. TxStall models a peer holding off the transmitter through
+  // RTS_B. Characters queued with UartModelReceive arrive back to back at
+  // the line rate, transmitted characters are captured in Output.
+  //
+  BOOLEAN   TxStall;
+  UINT8     Input[UART_MODEL_LINE_SIZE];
+  UINT32    InputHead;
+  UINT32    InputCount;
+  UINT64    InputNextInNs;
+  UINT8     Output[UART_MODEL_LINE_SIZE];
+  UINT32    OutputCount;
+
+  UINT64    StatusReadCount;
+  UINT64    TxByteCount;
+  UINT64    RxByteCount;
+  UINT32    OverrunCount;
+  UINT32    ProtocolErrorCount;
+} UART_MODEL;
+
+VOID
+UartModelInitialize (
+  OUT UART_MODEL  *Model,
+  IN  UINTN       Base,
+  IN  UINT32      ModuleClock,
+  IN  UINT32      BaudRate
+  );
+
+UINT64
+UartModelBaudRate (
+  IN  UART_MODEL  *Model
+  );
+
+UINT64
+UartModelCharacterTime (
+  IN  UART_MODEL  *Model
+  );
+
+VOID
+UartModelReceive (
+  IN  UART_MODEL  *Model,
+  IN  CONST UINT8 *Buffer,
+  IN  UINT32      Length
+  );
+
+BOOLEAN
+UartModelTxDmaRequest (
+  IN  UART_MODEL  *Model
+  );
+
+BOOLEAN
+UartModelRxDmaRequest (
+  IN  UART_MODEL  *Model,
+  OUT BOOLEAN     *Aging
+  );
+
+VOID
+UartModelDmaWrite (
+  IN  UART_MODEL  *Model,
+  IN  UINT8       Data
+  );
+
+UINT32
+UartModelDmaRead (
+  IN  UART_MODEL  *Model
+  );
+
+#endif